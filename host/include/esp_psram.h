@@ -0,0 +1,20 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the simulated PSRAM, HOST_PSRAM_SIZE bytes (8 MB default)
+ */
+size_t esp_psram_get_size(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdkconfig.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE             ((BaseType_t) 0)
+#define pdTRUE              ((BaseType_t) 1)
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+
+#define portMAX_DELAY       ((TickType_t) 0xffffffffUL)
+#define portTICK_PERIOD_MS  ((TickType_t) 1)
+#define pdMS_TO_TICKS(ms)   ((TickType_t) (ms))
@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host task shim: tasks are pthreads, ticks are milliseconds. vTaskDelay()
+ * returns immediately unless HOST_TASK_DELAY=1 is set in the environment,
+ * since there is no task watchdog to feed on the host and the delays in the
+ * application only exist for that reason.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*TaskFunction_t)(void *);
+typedef void *TaskHandle_t;
+
+#define tskNO_AFFINITY      ((BaseType_t) 0x7fffffff)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core_id);
+
+static inline BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                                     uint32_t stack_depth, void *arg,
+                                     UBaseType_t priority, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, handle,
+                                   tskNO_AFFINITY);
+}
+
+/* Deleting another task is not supported, tasks must return on their own */
+void vTaskDelete(TaskHandle_t handle);
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+BaseType_t xPortGetCoreID(void);
+
+#ifdef __cplusplus
+}
+#endif
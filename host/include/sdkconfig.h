@@ -0,0 +1,19 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host (Linux) stand-in for the sdkconfig.h that ESP-IDF generates from
+ * menuconfig. Only the options the application and esp-nn look at are set.
+ */
+
+#pragma once
+
+#define CONFIG_IDF_TARGET_LINUX 1
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 2
+
+/* Application defaults from main/Kconfig.projbuild */
+#define CONFIG_TFLITE_SPLIT_ARENA 1
+#define CONFIG_TFLITE_ARENA_INTERNAL_LIMIT 256
+
+/* Pick the generic `_opt` esp-nn kernels, the same as a non-S3/P4 chip */
+#define CONFIG_NN_OPTIMIZED 1
+#define CONFIG_NN_OPTIMIZATIONS 1
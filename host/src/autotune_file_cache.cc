@@ -0,0 +1,54 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "autotune_file_cache.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+
+namespace {
+
+std::string cache_path;
+std::map<uint32_t, uint8_t> choices;
+
+bool Load(uint32_t key, uint8_t* choice, void* user) {
+  const auto it = choices.find(key);
+  if (it == choices.end()) {
+    return false;
+  }
+  *choice = it->second;
+  return true;
+}
+
+void Store(uint32_t key, uint8_t choice, void* user) {
+  choices[key] = choice;
+  FILE* file = fopen(cache_path.c_str(), "a");
+  if (file == nullptr) {
+    perror(cache_path.c_str());
+    return;
+  }
+  fprintf(file, "%08x %u\n", static_cast<unsigned>(key),
+          static_cast<unsigned>(choice));
+  fclose(file);
+}
+
+const tflite::AutotuneCache cache = {Load, Store, nullptr};
+
+}  // namespace
+
+void AutotuneFileCacheInstall(const char* path) {
+  cache_path = path;
+  choices.clear();
+  if (FILE* file = fopen(path, "r")) {
+    unsigned key, choice;
+    while (fscanf(file, "%x %u", &key, &choice) == 2) {
+      choices[key] = static_cast<uint8_t>(choice);
+    }
+    fclose(file);
+  }
+  tflite::SetAutotuneCache(&cache);
+}
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PERSON_DETECTION_HOST_AUTOTUNE_FILE_CACHE_H_
+#define PERSON_DETECTION_HOST_AUTOTUNE_FILE_CACHE_H_
+
+// Kernel autotuning cache (see autotune.h) in a text file of "key choice"
+// lines, standing in for the device's NVS one. The choices in the file are
+// read when it is installed and new ones are appended to it.
+void AutotuneFileCacheInstall(const char* path);
+
+#endif  // PERSON_DETECTION_HOST_AUTOTUNE_FILE_CACHE_H_
@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Feeds synthetic frames to the camera driver's line by line downscale in
+// DMA buffer sized chunks, and checks the frames it writes against
+// ConvertToGrayscale() for the default centred crop and against a per-pixel
+// reference for a region of interest and the int8 offset.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "cam_downscale.h"
+#include "image_convert.h"
+
+namespace {
+
+uint8_t ReferenceLuma(const uint8_t* pixel, cam_downscale_input_t input) {
+  if (input != CAM_DOWNSCALE_RGB565) {
+    return pixel[0];
+  }
+  const uint16_t value = (pixel[0] << 8) | pixel[1];
+  const int r = ((value >> 11) & 0x1F) << 3;
+  const int g = ((value >> 5) & 0x3F) << 2;
+  const int b = (value & 0x1F) << 3;
+  return (305 * r + 600 * g + 119 * b) >> 10;
+}
+
+void ReferenceCrop(const uint8_t* src, int src_width, cam_downscale_input_t input,
+                   int crop_x, int crop_y, int crop_width, int crop_height,
+                   uint8_t* dst, int dst_width, int dst_height, uint8_t xor_mask) {
+  const int bpp = input == CAM_DOWNSCALE_Y8 ? 1 : 2;
+  for (int oy = 0; oy < dst_height; oy++) {
+    const int y0 = crop_y + oy * crop_height / dst_height;
+    const int y1 = crop_y + (oy + 1) * crop_height / dst_height;
+    for (int ox = 0; ox < dst_width; ox++) {
+      const int x0 = crop_x + ox * crop_width / dst_width;
+      const int x1 = crop_x + (ox + 1) * crop_width / dst_width;
+      uint32_t sum = 0;
+      for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+          sum += ReferenceLuma(src + (y * src_width + x) * bpp, input);
+        }
+      }
+      const uint32_t area = (x1 - x0) * (y1 - y0);
+      dst[oy * dst_width + ox] = ((sum + area / 2) / area) ^ xor_mask;
+    }
+  }
+}
+
+// Feeds `src` in chunks of `chunk` bytes, the last one shorter, or of random
+// sizes if 0, the way cam_task() drains the DMA half buffers.
+std::vector<uint8_t> Downscale(cam_downscale_t* ds, const std::vector<uint8_t>& src,
+                               size_t chunk) {
+  std::vector<uint8_t> out(ds->out_width * ds->out_height + ds->out_width);
+  size_t written = 0;
+  cam_downscale_start(ds);
+  for (size_t offset = 0; offset < src.size();) {
+    size_t len = chunk;
+    if (len == 0) {
+      len = (1 + rand() % 700) * ds->in_bytes_per_pixel;
+    }
+    if (len > src.size() - offset) {
+      len = src.size() - offset;
+    }
+    written += cam_downscale_lines(ds, &out[written], &src[offset], len);
+    offset += len;
+  }
+  out.resize(written);
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  struct {
+    int width;
+    int height;
+  } const sizes[] = {{96, 96}, {160, 120}, {176, 144}, {240, 240},
+                     {320, 240}, {400, 296}, {640, 480}, {98, 101}};
+  const cam_downscale_input_t inputs[] = {CAM_DOWNSCALE_Y8, CAM_DOWNSCALE_RGB565,
+                                          CAM_DOWNSCALE_YUYV};
+  const ImageFormat formats[] = {kImageFormatGrayscale, kImageFormatRgb565,
+                                 kImageFormatYuv422};
+  const char* const input_names[] = {"y8", "rgb565", "yuyv"};
+  constexpr int kDst = 96;
+
+  static cam_downscale_t ds;
+  int failures = 0;
+  srand(1);
+  for (const auto& size : sizes) {
+    for (int f = 0; f < 3; f++) {
+      const int bpp = inputs[f] == CAM_DOWNSCALE_Y8 ? 1 : 2;
+      std::vector<uint32_t> words((size.width * size.height * bpp + 3) / 4);
+      std::vector<uint8_t> src(size.width * size.height * bpp);
+      for (auto& byte : src) {
+        byte = rand() & 0xFF;
+      }
+      memcpy(words.data(), src.data(), src.size());
+
+      // The default crop, whole lines and random chunks, twice in a row
+      std::vector<uint8_t> ref(kDst * kDst);
+      bool match = ConvertToGrayscale(reinterpret_cast<uint8_t*>(words.data()),
+                                      size.width, size.height, formats[f],
+                                      ref.data(), kDst, kDst, nullptr, 1) &&
+                   cam_downscale_init(&ds, size.width, size.height, inputs[f], 0, 0,
+                                      0, 0, kDst, kDst, false);
+      match = match && Downscale(&ds, src, size.width * bpp * 4) == ref &&
+              Downscale(&ds, src, 0) == ref && Downscale(&ds, src, 0) == ref;
+
+      // A region of interest at the bottom right, to int8
+      const int crop_width = size.width * 3 / 4 < kDst ? kDst : size.width * 3 / 4;
+      const int crop_height = size.height * 2 / 3 < kDst ? kDst : size.height * 2 / 3;
+      const int crop_x = size.width - crop_width;
+      const int crop_y = size.height - crop_height;
+      std::vector<uint8_t> roi_ref(kDst * kDst);
+      ReferenceCrop(src.data(), size.width, inputs[f], crop_x, crop_y, crop_width,
+                    crop_height, roi_ref.data(), kDst, kDst, 0x80);
+      match = match &&
+              cam_downscale_init(&ds, size.width, size.height, inputs[f], crop_x,
+                                 crop_y, crop_width, crop_height, kDst, kDst, true) &&
+              Downscale(&ds, src, 0) == roi_ref;
+
+      printf("%-6s %4dx%-4d %s\n", input_names[f], size.width, size.height,
+             match ? "passed" : "FAILED");
+      failures += !match;
+    }
+  }
+
+  // Crops that don't fit are refused
+  const bool refused =
+      !cam_downscale_init(&ds, 160, 120, CAM_DOWNSCALE_Y8, 100, 0, 96, 96, kDst, kDst, false) &&
+      !cam_downscale_init(&ds, 80, 80, CAM_DOWNSCALE_Y8, 0, 0, 0, 0, kDst, kDst, false);
+  printf("invalid crops %s\n", refused ? "passed" : "FAILED");
+  failures += !refused;
+  return failures == 0 ? 0 : 1;
+}
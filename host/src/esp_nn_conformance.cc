@@ -0,0 +1,1308 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Conformance and throughput suite of the esp-nn kernels the TFLite Micro
+// kernels in kernels/esp_nn/ call: conv, depthwise conv, fully connected and
+// pooling. Runs a seeded sweep of shapes, strides, paddings, dilations,
+// channel multipliers and zero points, followed by every such layer of the
+// model in person_detect_model_data.cc with its own weights and
+// quantization.
+//
+// Each case goes through the `_ansi` kernel, the one esp_nn.h dispatches
+// to and, for convs and fully connected layers, the im2col + GEMM one, and
+// for 3x3 stride 1 unpadded convs, Winograd F(2x2, 3x3), with the arguments
+// kernels/esp_nn/ would pass them (including the folded bias of
+// folded_bias.h where it applies), and their output has to be bit-exact
+// with reference_integer_ops, the kernels TFLite Micro falls back to. The
+// kernels have no dilation of their own, kernels/esp_nn/ hands dilated convs
+// to the reference; dilated cases run them on the filter spread out with
+// zero taps, which is the same convolution. Int4 cases, with weights in
+// [-8, 7], also run the packed int4 kernels on the filter packed two values
+// per byte, as kernels/esp_nn/ passes a kTfLiteInt4 tensor.
+//
+// Prints one JSON object with every case, the exactness of every kernel and
+// the best of --repeat runs in esp_cpu_get_cycle_count() ticks (the TSC on
+// a host), to stdout or --json FILE. Pools count one MAC per filter tap.
+// Exits with 1 if any kernel is not bit-exact.
+//
+// usage: esp_nn_conformance [--model-only] [--repeat N] [--json FILE]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <esp_cpu.h>
+#include <esp_nn.h>
+
+#include "person_detect_model_data.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_conv.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/pooling.h"
+#include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/folded_bias.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+
+// The kernel a dispatching esp_nn_* macro of esp_nn.h resolves to.
+#define KERNEL_NAME(kernel) KERNEL_NAME_(kernel)
+#define KERNEL_NAME_(kernel) #kernel
+
+namespace {
+
+// Bytes after every output that no kernel may write.
+constexpr int kGuardSize = 16;
+constexpr int8_t kGuardValue = 0x5a;
+
+enum class OpKind {
+  kConv,
+  kDepthwiseConv,
+  kFullyConnected,
+  kMaxPool,
+  kAveragePool,
+};
+
+const char* OpName(OpKind op) {
+  switch (op) {
+    case OpKind::kConv:
+      return "CONV_2D";
+    case OpKind::kDepthwiseConv:
+      return "DEPTHWISE_CONV_2D";
+    case OpKind::kFullyConnected:
+      return "FULLY_CONNECTED";
+    case OpKind::kMaxPool:
+      return "MAX_POOL_2D";
+    case OpKind::kAveragePool:
+      return "AVERAGE_POOL_2D";
+  }
+  return "";
+}
+
+// One layer, NHWC with a batch of 1. A fully connected layer has an
+// input_depth long row and output_depth channels.
+struct Case {
+  OpKind op;
+  std::string source;
+  int input_height = 1;
+  int input_width = 1;
+  int input_depth = 1;
+  int filter_height = 1;
+  int filter_width = 1;
+  int output_height = 1;
+  int output_width = 1;
+  int output_depth = 1;
+  int stride_height = 1;
+  int stride_width = 1;
+  int dilation_height = 1;
+  int dilation_width = 1;
+  TfLitePaddingValues padding = {};
+  int depth_multiplier = 1;
+  // The kernels get `input` plus 128, with the zero point to match.
+  bool uint8_input = false;
+  // The filter values fit in int4, and the int4 kernels get them packed.
+  bool int4_filter = false;
+  bool per_channel = true;
+  int32_t input_zero_point = 0;
+  int32_t filter_zero_point = 0;
+  int32_t output_zero_point = 0;
+  int32_t activation_min = std::numeric_limits<int8_t>::min();
+  int32_t activation_max = std::numeric_limits<int8_t>::max();
+  std::vector<int8_t> input;
+  std::vector<int8_t> filter;
+  std::vector<int32_t> bias;
+  // One per output channel, or one if not per_channel.
+  std::vector<int32_t> multiplier;
+  std::vector<int32_t> shift;
+
+  int OutputSize() const {
+    return output_height * output_width * output_depth;
+  }
+
+  int64_t Macs() const {
+    const int64_t outputs = OutputSize();
+    switch (op) {
+      case OpKind::kConv:
+        return outputs * filter_height * filter_width * input_depth;
+      case OpKind::kFullyConnected:
+        return outputs * input_depth;
+      default:
+        return outputs * filter_height * filter_width;
+    }
+  }
+
+  // Whether kernels/esp_nn/ would run it with the input offset folded into
+  // the bias. SAME padding can leave the top and left unpadded and still pad
+  // the bottom or right (the offsets).
+  bool FoldsInputOffset() const {
+    if (op == OpKind::kConv) {
+      return padding.width == 0 && padding.height == 0 &&
+             padding.width_offset == 0 && padding.height_offset == 0;
+    }
+    return op == OpKind::kFullyConnected && filter_zero_point == 0;
+  }
+};
+
+struct KernelResult {
+  std::string name;
+  int mismatches = 0;
+  bool overrun = false;
+  uint32_t cycles = 0;
+
+  bool exact() const { return mismatches == 0 && !overrun; }
+};
+
+[[noreturn]] void Fail(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "esp_nn_conformance: ");
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+  exit(1);
+}
+
+std::string Format(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  char buffer[1024];
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return buffer;
+}
+
+// Computes the output size and padding the way the kernels' Prepare() does,
+// false if the filter does not fit.
+bool SetOutputShape(TfLitePadding padding, Case* c) {
+  c->padding = tflite::ComputePaddingHeightWidth(
+      c->stride_height, c->stride_width, c->dilation_height,
+      c->dilation_width, c->input_height, c->input_width, c->filter_height,
+      c->filter_width, padding, &c->output_height, &c->output_width);
+  return c->output_height > 0 && c->output_width > 0;
+}
+
+class Random {
+ public:
+  explicit Random(uint32_t seed) : engine_(seed) {}
+
+  int Int(int min, int max) {
+    return std::uniform_int_distribution<int>(min, max)(engine_);
+  }
+  template <typename T>
+  T Pick(const std::vector<T>& values) {
+    return values[Int(0, static_cast<int>(values.size()) - 1)];
+  }
+  std::vector<int8_t> Int8(int size) {
+    std::vector<int8_t> values(size);
+    for (int8_t& value : values) {
+      value = static_cast<int8_t>(Int(-128, 127));
+    }
+    return values;
+  }
+  // Filter values; -128 is not a valid symmetric int8 weight.
+  std::vector<int8_t> Weights(int size) {
+    std::vector<int8_t> values(size);
+    for (int8_t& value : values) {
+      value = static_cast<int8_t>(Int(-127, 127));
+    }
+    return values;
+  }
+  std::vector<int8_t> Int4Weights(int size) {
+    std::vector<int8_t> values(size);
+    for (int8_t& value : values) {
+      value = static_cast<int8_t>(Int(-8, 7));
+    }
+    return values;
+  }
+
+  // Bias and requantization for `channels` outputs of `row_size` taps each,
+  // of filter values up to `max_weight`, scaled so that the outputs spread
+  // over the int8 range rather than saturate.
+  void Quantization(int row_size, int channels, Case* c,
+                    int max_weight = 127) {
+    const double typical = std::sqrt(static_cast<double>(row_size)) * 5000.0 *
+                           max_weight / 127.0;
+    c->bias.resize(c->output_depth);
+    for (int32_t& bias : c->bias) {
+      bias = Int(-static_cast<int>(typical), static_cast<int>(typical));
+    }
+    c->multiplier.clear();
+    c->shift.clear();
+    for (int i = 0; i < channels; i++) {
+      int32_t multiplier;
+      int shift;
+      tflite::QuantizeMultiplier(Int(256, 2048) / (256.0 * typical),
+                                 &multiplier, &shift);
+      c->multiplier.push_back(multiplier);
+      c->shift.push_back(shift);
+    }
+  }
+
+  // The activation range of a random output zero point, with or without a
+  // fused RELU.
+  void Activation(Case* c) {
+    c->output_zero_point = Pick<int32_t>({-128, -5, 0, 64, 127});
+    c->activation_min = Int(0, 1) ? c->output_zero_point : -128;
+    c->activation_max = 127;
+  }
+
+ private:
+  std::mt19937 engine_;
+};
+
+void AddSweep(std::vector<Case>* cases) {
+  Random random(2024);
+  const std::vector<int> sizes = {1, 2, 5, 8, 13};
+  const std::vector<int32_t> input_zero_points = {-128, -1, 0, 3, 127};
+  const std::vector<TfLitePadding> paddings = {kTfLitePaddingValid,
+                                               kTfLitePaddingSame};
+
+  for (int count = 0; count < 120;) {
+    Case c;
+    c.op = OpKind::kConv;
+    c.source = "sweep";
+    c.input_height = random.Pick(sizes);
+    c.input_width = random.Pick(sizes);
+    c.input_depth = random.Pick<int>({1, 2, 3, 4, 7, 8, 16, 33});
+    c.output_depth = random.Pick<int>({1, 3, 4, 8, 16, 20});
+    c.filter_height = random.Pick<int>({1, 2, 3, 5});
+    c.filter_width = random.Pick<int>({1, 2, 3, 5});
+    c.stride_height = random.Pick<int>({1, 2, 3});
+    c.stride_width = random.Pick<int>({1, 2, 3});
+    c.dilation_height = random.Pick<int>({1, 1, 1, 2, 3});
+    c.dilation_width = random.Pick<int>({1, 1, 1, 2, 3});
+    if (!SetOutputShape(random.Pick(paddings), &c)) {
+      continue;
+    }
+    c.uint8_input = random.Int(0, 3) == 0;
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    const int row_size = c.filter_height * c.filter_width * c.input_depth;
+    c.filter = random.Weights(c.output_depth * row_size);
+    random.Quantization(row_size, c.output_depth, &c);
+    random.Activation(&c);
+    cases->push_back(c);
+    count++;
+  }
+
+  // 3x3 stride 1 VALID convs, the ones Winograd F(2x2, 3x3) runs, with odd
+  // and even output sizes.
+  for (int count = 0; count < 30; count++) {
+    Case c;
+    c.op = OpKind::kConv;
+    c.source = "sweep";
+    c.input_height = random.Pick<int>({3, 4, 5, 8, 13});
+    c.input_width = random.Pick<int>({3, 4, 5, 8, 13});
+    c.input_depth = random.Pick<int>({1, 3, 8, 33, 96});
+    c.output_depth = random.Pick<int>({1, 4, 16, 20});
+    c.filter_height = 3;
+    c.filter_width = 3;
+    c.stride_height = 1;
+    c.stride_width = 1;
+    c.dilation_height = 1;
+    c.dilation_width = 1;
+    SetOutputShape(kTfLitePaddingValid, &c);
+    c.uint8_input = random.Int(0, 3) == 0;
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    const int row_size = 9 * c.input_depth;
+    c.filter = random.Weights(c.output_depth * row_size);
+    random.Quantization(row_size, c.output_depth, &c);
+    random.Activation(&c);
+    cases->push_back(c);
+  }
+
+  for (int count = 0; count < 80;) {
+    Case c;
+    c.op = OpKind::kDepthwiseConv;
+    c.source = "sweep";
+    c.input_height = random.Pick(sizes);
+    c.input_width = random.Pick(sizes);
+    c.input_depth = random.Pick<int>({1, 2, 3, 4, 8, 16, 17, 32});
+    c.depth_multiplier = random.Pick<int>({1, 1, 2, 3});
+    c.output_depth = c.input_depth * c.depth_multiplier;
+    c.filter_height = random.Pick<int>({1, 2, 3, 5});
+    c.filter_width = random.Pick<int>({1, 2, 3, 5});
+    c.stride_height = random.Pick<int>({1, 2, 3});
+    c.stride_width = random.Pick<int>({1, 2, 3});
+    c.dilation_height = random.Pick<int>({1, 1, 1, 2, 3});
+    c.dilation_width = random.Pick<int>({1, 1, 1, 2, 3});
+    if (!SetOutputShape(random.Pick(paddings), &c)) {
+      continue;
+    }
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    c.filter = random.Weights(c.filter_height * c.filter_width *
+                              c.output_depth);
+    random.Quantization(c.filter_height * c.filter_width, c.output_depth, &c);
+    random.Activation(&c);
+    cases->push_back(c);
+    count++;
+  }
+
+  for (int count = 0; count < 60; count++) {
+    Case c;
+    c.op = OpKind::kFullyConnected;
+    c.source = "sweep";
+    c.input_depth = random.Pick<int>({1, 3, 4, 15, 16, 31, 64, 100, 257});
+    c.output_depth = random.Pick<int>({1, 2, 5, 16, 33});
+    c.per_channel = random.Int(0, 1);
+    // Only per-tensor int8 weights may have a zero point.
+    c.filter_zero_point =
+        c.per_channel ? 0 : random.Pick<int32_t>({0, 0, -3, 11});
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_depth);
+    c.filter = random.Weights(c.output_depth * c.input_depth);
+    random.Quantization(c.input_depth, c.per_channel ? c.output_depth : 1,
+                        &c);
+    random.Activation(&c);
+    cases->push_back(c);
+  }
+
+  for (OpKind op : {OpKind::kMaxPool, OpKind::kAveragePool}) {
+    for (int count = 0; count < 40;) {
+      Case c;
+      c.op = op;
+      c.source = "sweep";
+      c.input_height = random.Pick(sizes);
+      c.input_width = random.Pick(sizes);
+      c.input_depth = random.Pick<int>({1, 3, 4, 8, 16, 20});
+      c.output_depth = c.input_depth;
+      c.filter_height = random.Pick<int>({1, 2, 3});
+      c.filter_width = random.Pick<int>({1, 2, 3});
+      c.stride_height = random.Pick<int>({1, 2});
+      c.stride_width = random.Pick<int>({1, 2});
+      if (!SetOutputShape(random.Pick(paddings), &c)) {
+        continue;
+      }
+      c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+      c.activation_min = random.Pick<int32_t>({-128, -10, 0});
+      c.activation_max = random.Pick<int32_t>({127, 100});
+      cases->push_back(c);
+      count++;
+    }
+  }
+
+  // Int4 filters, which kernels/esp_nn/ runs packed for int8 inputs and no
+  // dilation.
+  for (int count = 0; count < 40;) {
+    Case c;
+    c.op = OpKind::kConv;
+    c.source = "sweep";
+    c.int4_filter = true;
+    c.input_height = random.Pick(sizes);
+    c.input_width = random.Pick(sizes);
+    c.input_depth = random.Pick<int>({1, 2, 3, 7, 8, 33});
+    c.output_depth = random.Pick<int>({1, 3, 4, 16});
+    c.filter_height = random.Pick<int>({1, 2, 3, 5});
+    c.filter_width = random.Pick<int>({1, 2, 3, 5});
+    c.stride_height = random.Pick<int>({1, 2});
+    c.stride_width = random.Pick<int>({1, 2});
+    if (!SetOutputShape(random.Pick(paddings), &c)) {
+      continue;
+    }
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    const int row_size = c.filter_height * c.filter_width * c.input_depth;
+    c.filter = random.Int4Weights(c.output_depth * row_size);
+    random.Quantization(row_size, c.output_depth, &c, 8);
+    random.Activation(&c);
+    cases->push_back(c);
+    count++;
+  }
+
+  for (int count = 0; count < 30;) {
+    Case c;
+    c.op = OpKind::kDepthwiseConv;
+    c.source = "sweep";
+    c.int4_filter = true;
+    c.input_height = random.Pick(sizes);
+    c.input_width = random.Pick(sizes);
+    c.input_depth = random.Pick<int>({1, 2, 3, 8, 17});
+    c.depth_multiplier = random.Pick<int>({1, 1, 2, 3});
+    c.output_depth = c.input_depth * c.depth_multiplier;
+    c.filter_height = random.Pick<int>({1, 2, 3, 5});
+    c.filter_width = random.Pick<int>({1, 2, 3, 5});
+    c.stride_height = random.Pick<int>({1, 2});
+    c.stride_width = random.Pick<int>({1, 2});
+    if (!SetOutputShape(random.Pick(paddings), &c)) {
+      continue;
+    }
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    c.filter = random.Int4Weights(c.filter_height * c.filter_width *
+                                  c.output_depth);
+    random.Quantization(c.filter_height * c.filter_width, c.output_depth, &c,
+                        8);
+    random.Activation(&c);
+    cases->push_back(c);
+    count++;
+  }
+
+  for (int count = 0; count < 30; count++) {
+    Case c;
+    c.op = OpKind::kFullyConnected;
+    c.source = "sweep";
+    c.int4_filter = true;
+    c.input_depth = random.Pick<int>({1, 3, 15, 16, 64, 257});
+    c.output_depth = random.Pick<int>({1, 2, 5, 33});
+    c.per_channel = random.Int(0, 1);
+    c.filter_zero_point = c.per_channel ? 0 : random.Pick<int32_t>({0, 0, -3});
+    c.input_zero_point = random.Pick(input_zero_points);
+    c.input = random.Int8(c.input_depth);
+    c.filter = random.Int4Weights(c.output_depth * c.input_depth);
+    random.Quantization(c.input_depth, c.per_channel ? c.output_depth : 1, &c,
+                        8);
+    random.Activation(&c);
+    cases->push_back(c);
+  }
+}
+
+// The layers of the model, with their weights and quantization and a random
+// input.
+class ModelCases {
+ public:
+  explicit ModelCases(const tflite::Model* model)
+      : model_(model), subgraph_(model->subgraphs()->Get(0)) {}
+
+  void Add(std::vector<Case>* cases);
+
+ private:
+  const tflite::Operator* Op(int index) const {
+    return subgraph_->operators()->Get(index);
+  }
+  tflite::BuiltinOperator Code(const tflite::Operator* op) const {
+    return tflite::GetBuiltinCode(
+        model_->operator_codes()->Get(op->opcode_index()));
+  }
+  const tflite::Tensor* Tensor(int index) const {
+    return subgraph_->tensors()->Get(index);
+  }
+  std::vector<int> Shape(int tensor) const {
+    const auto* shape = Tensor(tensor)->shape();
+    return std::vector<int>(shape->begin(), shape->end());
+  }
+  float Scale(int tensor, int channel = 0) const {
+    const auto* scales = Tensor(tensor)->quantization()->scale();
+    return scales->Get(scales->size() > 1 ? channel : 0);
+  }
+  int32_t ZeroPoint(int tensor) const {
+    const auto* quantization = Tensor(tensor)->quantization();
+    if (quantization == nullptr || quantization->zero_point() == nullptr ||
+        quantization->zero_point()->size() == 0) {
+      return 0;
+    }
+    return static_cast<int32_t>(quantization->zero_point()->Get(0));
+  }
+  template <typename T>
+  std::vector<T> Data(int tensor) const {
+    if (tensor < 0) {
+      return {};
+    }
+    const auto* data = model_->buffers()->Get(Tensor(tensor)->buffer())->data();
+    if (data == nullptr) {
+      Fail("tensor %d is not constant", tensor);
+    }
+    std::vector<T> values(data->size() / sizeof(T));
+    memcpy(values.data(), data->data(), values.size() * sizeof(T));
+    return values;
+  }
+  // Whether `tensor` is the int8 output of a QUANTIZE of a uint8 tensor,
+  // which the interpreter folds into the uint8 conv.
+  bool QuantizedFromUint8(int tensor) const;
+  void Activation(int tensor, tflite::ActivationFunctionType activation,
+                  Case* c) const;
+  void Requantization(int input, int filter, int output, Case* c) const;
+
+  const tflite::Model* model_;
+  const tflite::SubGraph* subgraph_;
+};
+
+bool ModelCases::QuantizedFromUint8(int tensor) const {
+  for (const auto* op : *subgraph_->operators()) {
+    if (op->outputs()->Get(0) == tensor) {
+      return Code(op) == tflite::BuiltinOperator_QUANTIZE &&
+             Tensor(op->inputs()->Get(0))->type() ==
+                 tflite::TensorType_UINT8;
+    }
+  }
+  return false;
+}
+
+// CalculateActivationRangeQuantized() of the int8 `tensor`.
+void ModelCases::Activation(int tensor,
+                            tflite::ActivationFunctionType activation,
+                            Case* c) const {
+  c->output_zero_point = ZeroPoint(tensor);
+  auto quantize = [&](float f) {
+    return c->output_zero_point +
+           static_cast<int32_t>(std::round(f / Scale(tensor)));
+  };
+  c->activation_min = std::numeric_limits<int8_t>::min();
+  c->activation_max = std::numeric_limits<int8_t>::max();
+  switch (activation) {
+    case tflite::ActivationFunctionType_NONE:
+      break;
+    case tflite::ActivationFunctionType_RELU:
+      c->activation_min = std::max(c->activation_min, quantize(0.0f));
+      break;
+    case tflite::ActivationFunctionType_RELU6:
+      c->activation_min = std::max(c->activation_min, quantize(0.0f));
+      c->activation_max = std::min(c->activation_max, quantize(6.0f));
+      break;
+    case tflite::ActivationFunctionType_RELU_N1_TO_1:
+      c->activation_min = std::max(c->activation_min, quantize(-1.0f));
+      c->activation_max = std::min(c->activation_max, quantize(1.0f));
+      break;
+    default:
+      Fail("unsupported fused activation %d", activation);
+  }
+}
+
+// The multipliers of PopulateConvolutionQuantizationParams(), per channel
+// if c->per_channel.
+void ModelCases::Requantization(int input, int filter, int output,
+                                Case* c) const {
+  const int channels = c->per_channel ? c->output_depth : 1;
+  for (int channel = 0; channel < channels; channel++) {
+    const double effective_scale =
+        static_cast<double>(Scale(input)) *
+        static_cast<double>(Scale(filter, channel)) /
+        static_cast<double>(Scale(output));
+    int32_t multiplier;
+    int shift;
+    tflite::QuantizeMultiplier(effective_scale, &multiplier, &shift);
+    c->multiplier.push_back(multiplier);
+    c->shift.push_back(shift);
+  }
+}
+
+void ModelCases::Add(std::vector<Case>* cases) {
+  Random random(96);
+  for (int index = 0; index < static_cast<int>(subgraph_->operators()->size());
+       index++) {
+    const tflite::Operator* op = Op(index);
+    const int input = op->inputs()->Get(0);
+    const int output = op->outputs()->Get(0);
+    const std::vector<int> in_shape = Shape(input);
+    const std::vector<int> out_shape = Shape(output);
+    Case c;
+    c.source = Format("model operator %d", index);
+    switch (Code(op)) {
+      case tflite::BuiltinOperator_CONV_2D:
+      case tflite::BuiltinOperator_DEPTHWISE_CONV_2D: {
+        const bool depthwise =
+            Code(op) == tflite::BuiltinOperator_DEPTHWISE_CONV_2D;
+        const int filter = op->inputs()->Get(1);
+        const std::vector<int> filter_shape = Shape(filter);
+        TfLitePadding padding;
+        tflite::ActivationFunctionType activation;
+        if (depthwise) {
+          const auto* options = op->builtin_options_as_DepthwiseConv2DOptions();
+          c.op = OpKind::kDepthwiseConv;
+          c.stride_height = options->stride_h();
+          c.stride_width = options->stride_w();
+          c.dilation_height = options->dilation_h_factor();
+          c.dilation_width = options->dilation_w_factor();
+          c.depth_multiplier = filter_shape[3] / in_shape[3];
+          padding = options->padding() == tflite::Padding_SAME
+                        ? kTfLitePaddingSame
+                        : kTfLitePaddingValid;
+          activation = options->fused_activation_function();
+        } else {
+          const auto* options = op->builtin_options_as_Conv2DOptions();
+          c.op = OpKind::kConv;
+          c.stride_height = options->stride_h();
+          c.stride_width = options->stride_w();
+          c.dilation_height = options->dilation_h_factor();
+          c.dilation_width = options->dilation_w_factor();
+          padding = options->padding() == tflite::Padding_SAME
+                        ? kTfLitePaddingSame
+                        : kTfLitePaddingValid;
+          activation = options->fused_activation_function();
+        }
+        c.input_height = in_shape[1];
+        c.input_width = in_shape[2];
+        c.input_depth = in_shape[3];
+        c.filter_height = filter_shape[1];
+        c.filter_width = filter_shape[2];
+        c.output_depth = out_shape[3];
+        if (!SetOutputShape(padding, &c) || c.output_height != out_shape[1] ||
+            c.output_width != out_shape[2]) {
+          Fail("operator %d: output shape mismatch", index);
+        }
+        c.uint8_input = !depthwise && QuantizedFromUint8(input);
+        c.input_zero_point = ZeroPoint(input);
+        c.filter = Data<int8_t>(filter);
+        c.bias = Data<int32_t>(
+            op->inputs()->size() > 2 ? op->inputs()->Get(2) : -1);
+        Requantization(input, filter, output, &c);
+        Activation(output, activation, &c);
+        break;
+      }
+      case tflite::BuiltinOperator_FULLY_CONNECTED: {
+        const auto* options = op->builtin_options_as_FullyConnectedOptions();
+        const int filter = op->inputs()->Get(1);
+        const std::vector<int> filter_shape = Shape(filter);
+        c.op = OpKind::kFullyConnected;
+        c.input_depth = filter_shape[1];
+        c.output_depth = filter_shape[0];
+        c.per_channel = Tensor(filter)->quantization()->scale()->size() > 1;
+        c.input_zero_point = ZeroPoint(input);
+        c.filter_zero_point = ZeroPoint(filter);
+        c.filter = Data<int8_t>(filter);
+        c.bias = Data<int32_t>(
+            op->inputs()->size() > 2 ? op->inputs()->Get(2) : -1);
+        Requantization(input, filter, output, &c);
+        Activation(output, options->fused_activation_function(), &c);
+        break;
+      }
+      case tflite::BuiltinOperator_MAX_POOL_2D:
+      case tflite::BuiltinOperator_AVERAGE_POOL_2D: {
+        const auto* options = op->builtin_options_as_Pool2DOptions();
+        c.op = Code(op) == tflite::BuiltinOperator_MAX_POOL_2D
+                   ? OpKind::kMaxPool
+                   : OpKind::kAveragePool;
+        c.input_height = in_shape[1];
+        c.input_width = in_shape[2];
+        c.input_depth = in_shape[3];
+        c.output_depth = out_shape[3];
+        c.filter_height = options->filter_height();
+        c.filter_width = options->filter_width();
+        c.stride_height = options->stride_h();
+        c.stride_width = options->stride_w();
+        if (!SetOutputShape(options->padding() == tflite::Padding_SAME
+                                ? kTfLitePaddingSame
+                                : kTfLitePaddingValid,
+                            &c) ||
+            c.output_height != out_shape[1] || c.output_width != out_shape[2]) {
+          Fail("operator %d: output shape mismatch", index);
+        }
+        Activation(output, options->fused_activation_function(), &c);
+        break;
+      }
+      default:
+        continue;
+    }
+    c.input = random.Int8(c.input_height * c.input_width * c.input_depth);
+    cases->push_back(c);
+  }
+}
+
+tflite::RuntimeShape MakeShape(std::vector<int32_t> dims) {
+  return tflite::RuntimeShape(static_cast<int>(dims.size()), dims.data());
+}
+
+std::vector<int8_t> Reference(const Case& c) {
+  std::vector<int8_t> output(c.OutputSize());
+  const tflite::RuntimeShape input_shape =
+      MakeShape({1, c.input_height, c.input_width, c.input_depth});
+  const tflite::RuntimeShape output_shape =
+      MakeShape({1, c.output_height, c.output_width, c.output_depth});
+  const tflite::RuntimeShape bias_shape = MakeShape({c.output_depth});
+  const int32_t* bias = c.bias.empty() ? nullptr : c.bias.data();
+  switch (c.op) {
+    case OpKind::kConv: {
+      tflite::ConvParams params = {};
+      params.padding_values.width = c.padding.width;
+      params.padding_values.height = c.padding.height;
+      params.stride_width = c.stride_width;
+      params.stride_height = c.stride_height;
+      params.dilation_width_factor = c.dilation_width;
+      params.dilation_height_factor = c.dilation_height;
+      params.input_offset = -c.input_zero_point;
+      params.output_offset = c.output_zero_point;
+      params.quantized_activation_min = c.activation_min;
+      params.quantized_activation_max = c.activation_max;
+      tflite::reference_integer_ops::ConvPerChannel(
+          params, c.multiplier.data(), c.shift.data(), input_shape,
+          c.input.data(),
+          MakeShape({c.output_depth, c.filter_height, c.filter_width,
+                     c.input_depth}),
+          c.filter.data(), bias_shape, bias, output_shape, output.data());
+      break;
+    }
+    case OpKind::kDepthwiseConv: {
+      tflite::DepthwiseParams params = {};
+      params.padding_values.width = c.padding.width;
+      params.padding_values.height = c.padding.height;
+      params.stride_width = c.stride_width;
+      params.stride_height = c.stride_height;
+      params.dilation_width_factor = c.dilation_width;
+      params.dilation_height_factor = c.dilation_height;
+      params.depth_multiplier = c.depth_multiplier;
+      params.input_offset = -c.input_zero_point;
+      params.output_offset = c.output_zero_point;
+      params.quantized_activation_min = c.activation_min;
+      params.quantized_activation_max = c.activation_max;
+      tflite::reference_integer_ops::DepthwiseConvPerChannel(
+          params, c.multiplier.data(), c.shift.data(), input_shape,
+          c.input.data(),
+          MakeShape({1, c.filter_height, c.filter_width, c.output_depth}),
+          c.filter.data(), bias_shape, bias, output_shape, output.data());
+      break;
+    }
+    case OpKind::kFullyConnected: {
+      tflite::FullyConnectedParams params = {};
+      params.input_offset = -c.input_zero_point;
+      params.weights_offset = -c.filter_zero_point;
+      params.output_offset = c.output_zero_point;
+      params.quantized_activation_min = c.activation_min;
+      params.quantized_activation_max = c.activation_max;
+      const tflite::RuntimeShape fc_input_shape = MakeShape({1, c.input_depth});
+      const tflite::RuntimeShape filter_shape =
+          MakeShape({c.output_depth, c.input_depth});
+      const tflite::RuntimeShape fc_output_shape =
+          MakeShape({1, c.output_depth});
+      if (c.per_channel) {
+        const std::vector<int> shift(c.shift.begin(), c.shift.end());
+        tflite::reference_integer_ops::FullyConnectedPerChannel(
+            params, c.multiplier.data(), shift.data(), fc_input_shape,
+            c.input.data(), filter_shape, c.filter.data(), bias_shape, bias,
+            fc_output_shape, output.data());
+      } else {
+        params.output_multiplier = c.multiplier[0];
+        params.output_shift = c.shift[0];
+        tflite::reference_integer_ops::FullyConnected(
+            params, fc_input_shape, c.input.data(), filter_shape,
+            c.filter.data(), bias_shape, bias, fc_output_shape,
+            output.data());
+      }
+      break;
+    }
+    case OpKind::kMaxPool:
+    case OpKind::kAveragePool: {
+      tflite::PoolParams params = {};
+      params.padding_values.width = c.padding.width;
+      params.padding_values.height = c.padding.height;
+      params.stride_width = c.stride_width;
+      params.stride_height = c.stride_height;
+      params.filter_width = c.filter_width;
+      params.filter_height = c.filter_height;
+      params.quantized_activation_min = c.activation_min;
+      params.quantized_activation_max = c.activation_max;
+      if (c.op == OpKind::kMaxPool) {
+        tflite::reference_integer_ops::MaxPool(params, input_shape,
+                                               c.input.data(), output_shape,
+                                               output.data());
+      } else {
+        tflite::reference_integer_ops::AveragePool(params, input_shape,
+                                                   c.input.data(),
+                                                   output_shape, output.data());
+      }
+      break;
+    }
+  }
+  return output;
+}
+
+// Runs `kernel` `repeat` times into a guarded buffer first filled with the
+// complement of `expected`, so that any output the kernel leaves out counts
+// as a mismatch.
+template <typename Kernel>
+KernelResult Measure(const std::string& name,
+                     const std::vector<int8_t>& expected, int repeat,
+                     Kernel kernel) {
+  std::vector<int8_t> output(expected.size() + kGuardSize, kGuardValue);
+  for (size_t i = 0; i < expected.size(); i++) {
+    output[i] = static_cast<int8_t>(~expected[i]);
+  }
+  KernelResult result;
+  result.name = name;
+  result.cycles = std::numeric_limits<uint32_t>::max();
+  for (int i = 0; i < repeat; i++) {
+    const uint32_t start = esp_cpu_get_cycle_count();
+    kernel(output.data());
+    result.cycles = std::min(result.cycles, esp_cpu_get_cycle_count() - start);
+  }
+  for (size_t i = 0; i < expected.size(); i++) {
+    result.mismatches += output[i] != expected[i];
+  }
+  for (size_t i = expected.size(); i < output.size(); i++) {
+    result.overrun |= output[i] != kGuardValue;
+  }
+  return result;
+}
+
+// The filter of a dilated conv with the taps it skips as zeros, for
+// kernels that have no dilation.
+std::vector<int8_t> SpreadFilter(const Case& c, int* filter_height,
+                                 int* filter_width) {
+  *filter_height = (c.filter_height - 1) * c.dilation_height + 1;
+  *filter_width = (c.filter_width - 1) * c.dilation_width + 1;
+  const int outer = c.op == OpKind::kConv ? c.output_depth : 1;
+  const int inner = c.op == OpKind::kConv ? c.input_depth : c.output_depth;
+  std::vector<int8_t> spread(outer * *filter_height * *filter_width * inner, 0);
+  for (int o = 0; o < outer; o++) {
+    for (int y = 0; y < c.filter_height; y++) {
+      for (int x = 0; x < c.filter_width; x++) {
+        memcpy(&spread[((o * *filter_height + y * c.dilation_height) *
+                            *filter_width +
+                        x * c.dilation_width) *
+                       inner],
+               &c.filter[((o * c.filter_height + y) * c.filter_width + x) *
+                         inner],
+               inner);
+      }
+    }
+  }
+  return spread;
+}
+
+// Int4 values packed two per byte, the even one in the low nibble, the way
+// TFLite stores a kTfLiteInt4 tensor.
+std::vector<int8_t> PackInt4(const std::vector<int8_t>& values) {
+  std::vector<int8_t> packed((values.size() + 1) / 2, 0);
+  for (size_t i = 0; i < values.size(); i++) {
+    const int nibble = values[i] & 0x0f;
+    packed[i / 2] |= static_cast<int8_t>(i % 2 ? nibble << 4 : nibble);
+  }
+  return packed;
+}
+
+// A 16 byte aligned esp-nn scratch buffer of `size` bytes, null if none.
+class Scratch {
+ public:
+  explicit Scratch(int size) : buffer_(size > 0 ? size + 16 : 0) {}
+  void* data() {
+    if (buffer_.empty()) {
+      return nullptr;
+    }
+    const uintptr_t address = reinterpret_cast<uintptr_t>(buffer_.data());
+    return buffer_.data() + ((16 - address % 16) % 16);
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+};
+
+std::vector<KernelResult> RunKernels(const Case& c,
+                                     const std::vector<int8_t>& expected,
+                                     int repeat) {
+  std::vector<KernelResult> results;
+  // Each kernel, then the dispatched one unless esp_nn.h picks the _ansi one.
+  auto run = [&](const char* ansi_name, const char* name, auto ansi,
+                 auto dispatched) {
+    results.push_back(Measure(ansi_name, expected, repeat, ansi));
+    if (strcmp(ansi_name, name) != 0) {
+      results.push_back(Measure(name, expected, repeat, dispatched));
+    }
+  };
+
+  const data_dims_t input_dims = {c.input_width, c.input_height, c.input_depth,
+                                  1};
+  const data_dims_t output_dims = {c.output_width, c.output_height,
+                                   c.output_depth, 1};
+  const int32_t* bias = c.bias.empty() ? nullptr : c.bias.data();
+  quant_data_t quant_data = {const_cast<int32_t*>(c.shift.data()),
+                             const_cast<int32_t*>(c.multiplier.data())};
+
+  switch (c.op) {
+    case OpKind::kConv: {
+      int filter_height, filter_width;
+      const std::vector<int8_t> filter =
+          SpreadFilter(c, &filter_height, &filter_width);
+      const data_dims_t filter_dims = {filter_width, filter_height, 0, 0};
+      // The uint8 input of a folded QUANTIZE, and its zero point.
+      std::vector<uint8_t> input_u8(c.input.size());
+      for (size_t i = 0; i < c.input.size(); i++) {
+        input_u8[i] = static_cast<uint8_t>(c.input[i] + 128);
+      }
+      const int32_t input_offset =
+          -(c.input_zero_point + (c.uint8_input ? 128 : 0));
+      const conv_params_t params = {
+          input_offset,       c.output_zero_point, {c.stride_width, c.stride_height},
+          {c.padding.width, c.padding.height}, {0, 0},
+          {c.activation_min, c.activation_max}};
+      Scratch scratch(esp_nn_get_conv_scratch_size(&input_dims, &filter_dims,
+                                                   &output_dims, &params));
+
+      auto conv = [&](const conv_params_t& params, const int32_t* bias) {
+        if (c.uint8_input) {
+          run(KERNEL_NAME(esp_nn_conv_u8_s8_ansi),
+              KERNEL_NAME(esp_nn_conv_u8_s8),
+              [&](int8_t* output) {
+                esp_nn_conv_u8_s8_ansi(&input_dims, input_u8.data(),
+                                       &filter_dims, filter.data(), bias,
+                                       &output_dims, output, &params,
+                                       &quant_data);
+              },
+              [&](int8_t* output) {
+                esp_nn_set_conv_scratch_buf(scratch.data());
+                esp_nn_conv_u8_s8(&input_dims, input_u8.data(), &filter_dims,
+                                  filter.data(), bias, &output_dims, output,
+                                  &params, &quant_data);
+              });
+        } else {
+          run(KERNEL_NAME(esp_nn_conv_s8_ansi), KERNEL_NAME(esp_nn_conv_s8),
+              [&](int8_t* output) {
+                esp_nn_conv_s8_ansi(&input_dims, c.input.data(), &filter_dims,
+                                    filter.data(), bias, &output_dims, output,
+                                    &params, &quant_data);
+              },
+              [&](int8_t* output) {
+                esp_nn_set_conv_scratch_buf(scratch.data());
+                esp_nn_conv_s8(&input_dims, c.input.data(), &filter_dims,
+                               filter.data(), bias, &output_dims, output,
+                               &params, &quant_data);
+              });
+        }
+        // The im2col + GEMM kernel kernel autotuning can pick.
+        Scratch gemm_scratch(esp_nn_get_conv_scratch_size_gemm(
+            &input_dims, &filter_dims, &output_dims, &params));
+        results.push_back(Measure(
+            c.uint8_input ? KERNEL_NAME(esp_nn_conv_u8_s8_gemm)
+                          : KERNEL_NAME(esp_nn_conv_s8_gemm),
+            expected, repeat, [&](int8_t* output) {
+              esp_nn_set_conv_scratch_buf_gemm(gemm_scratch.data());
+              if (c.uint8_input) {
+                esp_nn_conv_u8_s8_gemm(&input_dims, input_u8.data(),
+                                       &filter_dims, filter.data(), bias,
+                                       &output_dims, output, &params,
+                                       &quant_data);
+              } else {
+                esp_nn_conv_s8_gemm(&input_dims, c.input.data(), &filter_dims,
+                                    filter.data(), bias, &output_dims, output,
+                                    &params, &quant_data);
+              }
+            }));
+        // Winograd F(2x2, 3x3), for the layers it takes.
+        if (!esp_nn_conv_winograd_supported(&input_dims, &filter_dims,
+                                            &params)) {
+          return;
+        }
+        std::vector<int16_t> winograd_filter(
+            esp_nn_get_conv_winograd_filter_size(&input_dims, &output_dims) /
+            sizeof(int16_t));
+        esp_nn_conv_winograd_filter_s8(filter.data(), c.input_depth,
+                                       c.output_depth, winograd_filter.data());
+        Scratch winograd_scratch(esp_nn_get_conv_scratch_size_winograd(
+            &input_dims, &filter_dims, &output_dims, &params));
+        results.push_back(Measure(
+            c.uint8_input ? KERNEL_NAME(esp_nn_conv_u8_s8_winograd)
+                          : KERNEL_NAME(esp_nn_conv_s8_winograd),
+            expected, repeat, [&](int8_t* output) {
+              esp_nn_set_conv_scratch_buf_winograd(winograd_scratch.data());
+              if (c.uint8_input) {
+                esp_nn_conv_u8_s8_winograd(&input_dims, input_u8.data(),
+                                           winograd_filter.data(), bias,
+                                           &output_dims, output, &params,
+                                           &quant_data);
+              } else {
+                esp_nn_conv_s8_winograd(&input_dims, c.input.data(),
+                                        winograd_filter.data(), bias,
+                                        &output_dims, output, &params,
+                                        &quant_data);
+              }
+            }));
+      };
+      conv(params, bias);
+      if (c.int4_filter) {
+        const std::vector<int8_t> packed = PackInt4(filter);
+        results.push_back(Measure(
+            KERNEL_NAME(esp_nn_conv_s8_s4), expected, repeat,
+            [&](int8_t* output) {
+              esp_nn_conv_s8_s4(&input_dims, c.input.data(), &filter_dims,
+                                packed.data(), bias, &output_dims, output,
+                                &params, &quant_data);
+            }));
+      }
+      if (c.FoldsInputOffset()) {
+        std::vector<int32_t> folded_bias(c.output_depth);
+        tflite::FoldInputOffset(filter.data(), bias, input_offset,
+                                c.output_depth,
+                                filter_height * filter_width * c.input_depth,
+                                folded_bias.data());
+        conv_params_t folded_params = params;
+        folded_params.in_offset = 0;
+        const size_t first = results.size();
+        conv(folded_params, folded_bias.data());
+        for (size_t i = first; i < results.size(); i++) {
+          results[i].name += "+folded_bias";
+        }
+      }
+      break;
+    }
+    case OpKind::kDepthwiseConv: {
+      int filter_height, filter_width;
+      const std::vector<int8_t> filter =
+          SpreadFilter(c, &filter_height, &filter_width);
+      const data_dims_t filter_dims = {filter_width, filter_height, 0, 0};
+      const dw_conv_params_t params = {
+          -c.input_zero_point, c.output_zero_point, c.depth_multiplier,
+          {c.stride_width, c.stride_height}, {c.padding.width, c.padding.height},
+          {0, 0}, {c.activation_min, c.activation_max}};
+      Scratch scratch(esp_nn_get_depthwise_conv_scratch_size(
+          &input_dims, &filter_dims, &output_dims, &params));
+      run(KERNEL_NAME(esp_nn_depthwise_conv_s8_ansi),
+          KERNEL_NAME(esp_nn_depthwise_conv_s8),
+          [&](int8_t* output) {
+            esp_nn_depthwise_conv_s8_ansi(&input_dims, c.input.data(),
+                                          &filter_dims, filter.data(), bias,
+                                          &output_dims, output, &params,
+                                          &quant_data);
+          },
+          [&](int8_t* output) {
+            esp_nn_set_depthwise_conv_scratch_buf(scratch.data());
+            esp_nn_depthwise_conv_s8(&input_dims, c.input.data(), &filter_dims,
+                                     filter.data(), bias, &output_dims, output,
+                                     &params, &quant_data);
+          });
+      if (c.int4_filter) {
+        const std::vector<int8_t> packed = PackInt4(filter);
+        results.push_back(Measure(
+            KERNEL_NAME(esp_nn_depthwise_conv_s8_s4), expected, repeat,
+            [&](int8_t* output) {
+              esp_nn_depthwise_conv_s8_s4(&input_dims, c.input.data(),
+                                          &filter_dims, packed.data(), bias,
+                                          &output_dims, output, &params,
+                                          &quant_data);
+            }));
+      }
+      break;
+    }
+    case OpKind::kFullyConnected: {
+      auto fully_connected = [&](int32_t input_offset, const int32_t* bias) {
+        if (c.per_channel) {
+          run(KERNEL_NAME(esp_nn_fully_connected_per_ch_s8_ansi),
+              KERNEL_NAME(esp_nn_fully_connected_per_ch_s8),
+              [&](int8_t* output) {
+                esp_nn_fully_connected_per_ch_s8_ansi(
+                    c.input.data(), input_offset, c.input_depth,
+                    c.filter.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift.data(),
+                    c.multiplier.data(), c.activation_min, c.activation_max);
+              },
+              [&](int8_t* output) {
+                esp_nn_fully_connected_per_ch_s8(
+                    c.input.data(), input_offset, c.input_depth,
+                    c.filter.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift.data(),
+                    c.multiplier.data(), c.activation_min, c.activation_max);
+              });
+        } else {
+          run(KERNEL_NAME(esp_nn_fully_connected_s8_ansi),
+              KERNEL_NAME(esp_nn_fully_connected_s8),
+              [&](int8_t* output) {
+                esp_nn_fully_connected_s8_ansi(
+                    c.input.data(), input_offset, c.input_depth,
+                    c.filter.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift[0],
+                    c.multiplier[0], c.activation_min, c.activation_max);
+              },
+              [&](int8_t* output) {
+                esp_nn_fully_connected_s8(
+                    c.input.data(), input_offset, c.input_depth,
+                    c.filter.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift[0],
+                    c.multiplier[0], c.activation_min, c.activation_max);
+              });
+        }
+      };
+      fully_connected(-c.input_zero_point, bias);
+      if (c.int4_filter) {
+        const std::vector<int8_t> packed = PackInt4(c.filter);
+        results.push_back(Measure(
+            c.per_channel ? KERNEL_NAME(esp_nn_fully_connected_per_ch_s8_s4)
+                          : KERNEL_NAME(esp_nn_fully_connected_s8_s4),
+            expected, repeat, [&](int8_t* output) {
+              if (c.per_channel) {
+                esp_nn_fully_connected_per_ch_s8_s4(
+                    c.input.data(), -c.input_zero_point, c.input_depth,
+                    packed.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift.data(),
+                    c.multiplier.data(), c.activation_min, c.activation_max);
+              } else {
+                esp_nn_fully_connected_s8_s4(
+                    c.input.data(), -c.input_zero_point, c.input_depth,
+                    packed.data(), -c.filter_zero_point, bias, output,
+                    c.output_depth, c.output_zero_point, c.shift[0],
+                    c.multiplier[0], c.activation_min, c.activation_max);
+              }
+            }));
+      }
+      if (c.FoldsInputOffset()) {
+        std::vector<int32_t> folded_bias(c.output_depth);
+        tflite::FoldInputOffset(c.filter.data(), bias, -c.input_zero_point,
+                                c.output_depth, c.input_depth,
+                                folded_bias.data());
+        const size_t first = results.size();
+        fully_connected(0, folded_bias.data());
+        // What fully_connected.cc runs for more than one batch.
+        if (c.per_channel) {
+          results.push_back(Measure(
+              KERNEL_NAME(esp_nn_gemm_s8), expected, repeat,
+              [&](int8_t* output) {
+                esp_nn_gemm_s8(c.input.data(), 1, c.filter.data(),
+                               c.output_depth, c.input_depth,
+                               folded_bias.data(), output, c.output_depth,
+                               c.output_zero_point, c.shift.data(),
+                               c.multiplier.data(), c.activation_min,
+                               c.activation_max);
+              }));
+        }
+        for (size_t i = first; i < results.size(); i++) {
+          results[i].name += "+folded_bias";
+        }
+      }
+      break;
+    }
+    case OpKind::kMaxPool:
+    case OpKind::kAveragePool: {
+      const bool max_pool = c.op == OpKind::kMaxPool;
+      auto pool = [&](auto kernel) {
+        return [&, kernel](int8_t* output) {
+          kernel(c.input.data(), c.input_width, c.input_height, output,
+                 c.output_width, c.output_height, c.stride_width,
+                 c.stride_height, c.filter_width, c.filter_height,
+                 c.padding.width, c.padding.height, c.activation_min,
+                 c.activation_max, c.input_depth);
+        };
+      };
+      // Like pooling.cc, which keeps other depths on the _ansi kernel.
+      const bool dispatch = c.input_depth % 4 == 0;
+      if (max_pool) {
+        run(KERNEL_NAME(esp_nn_max_pool_s8_ansi),
+            dispatch ? KERNEL_NAME(esp_nn_max_pool_s8)
+                     : KERNEL_NAME(esp_nn_max_pool_s8_ansi),
+            pool(esp_nn_max_pool_s8_ansi), pool(esp_nn_max_pool_s8));
+      } else {
+        run(KERNEL_NAME(esp_nn_avg_pool_s8_ansi),
+            dispatch ? KERNEL_NAME(esp_nn_avg_pool_s8)
+                     : KERNEL_NAME(esp_nn_avg_pool_s8_ansi),
+            pool(esp_nn_avg_pool_s8_ansi), pool(esp_nn_avg_pool_s8));
+      }
+      break;
+    }
+  }
+  return results;
+}
+
+std::string Json(const Case& c, uint32_t reference_cycles,
+                 const std::vector<KernelResult>& results) {
+  std::string out = Format(
+      "    {\"op\": \"%s\", \"source\": \"%s\", \"input\": [%d, %d, %d], "
+      "\"filter\": [%d, %d], \"output\": [%d, %d, %d], \"stride\": [%d, %d], "
+      "\"dilation\": [%d, %d], \"padding\": [%d, %d], "
+      "\"depth_multiplier\": %d, \"input_type\": \"%s\", "
+      "\"filter_type\": \"%s\", \"per_channel\": %s, ",
+      OpName(c.op), c.source.c_str(), c.input_height, c.input_width,
+      c.input_depth, c.filter_height, c.filter_width, c.output_height,
+      c.output_width, c.output_depth, c.stride_height, c.stride_width,
+      c.dilation_height, c.dilation_width, c.padding.height, c.padding.width,
+      c.depth_multiplier, c.uint8_input ? "uint8" : "int8",
+      c.int4_filter ? "int4" : "int8", c.per_channel ? "true" : "false");
+  out += Format(
+      "\"input_zero_point\": %ld, \"filter_zero_point\": %ld, "
+      "\"output_zero_point\": %ld, \"activation\": [%ld, %ld], "
+      "\"macs\": %lld, \"reference_cycles\": %lu,\n     \"kernels\": [",
+      static_cast<long>(c.input_zero_point),
+      static_cast<long>(c.filter_zero_point),
+      static_cast<long>(c.output_zero_point),
+      static_cast<long>(c.activation_min), static_cast<long>(c.activation_max),
+      static_cast<long long>(c.Macs()),
+      static_cast<unsigned long>(reference_cycles));
+  for (size_t i = 0; i < results.size(); i++) {
+    const KernelResult& r = results[i];
+    out += Format(
+        "%s{\"name\": \"%s\", \"exact\": %s, \"mismatches\": %d, "
+        "\"overrun\": %s, \"cycles\": %lu, \"macs_per_cycle\": %.4f}",
+        i > 0 ? ",\n                 " : "", r.name.c_str(),
+        r.exact() ? "true" : "false", r.mismatches,
+        r.overrun ? "true" : "false", static_cast<unsigned long>(r.cycles),
+        static_cast<double>(c.Macs()) / std::max<uint32_t>(r.cycles, 1));
+  }
+  return out + "]}";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool model_only = false;
+  int repeat = 5;
+  const char* json_path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--model-only") == 0) {
+      model_only = true;
+    } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+      repeat = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else {
+      fprintf(stderr,
+              "usage: esp_nn_conformance [--model-only] [--repeat N] "
+              "[--json FILE]\n");
+      return 2;
+    }
+  }
+
+  std::vector<Case> cases;
+  if (!model_only) {
+    AddSweep(&cases);
+  }
+  ModelCases(tflite::GetModel(g_person_detect_model_data)).Add(&cases);
+
+  std::string json = Format(
+      "{\n  \"cycle_counter\": \"esp_cpu_get_cycle_count\", \"repeat\": %d,\n"
+      "  \"dispatch\": {\"conv\": \"%s\", \"conv_u8\": \"%s\", "
+      "\"depthwise_conv\": \"%s\", \"fully_connected\": \"%s\", "
+      "\"fully_connected_per_ch\": \"%s\", \"max_pool\": \"%s\", "
+      "\"avg_pool\": \"%s\"},\n  \"cases\": [\n",
+      repeat, KERNEL_NAME(esp_nn_conv_s8), KERNEL_NAME(esp_nn_conv_u8_s8),
+      KERNEL_NAME(esp_nn_depthwise_conv_s8),
+      KERNEL_NAME(esp_nn_fully_connected_s8),
+      KERNEL_NAME(esp_nn_fully_connected_per_ch_s8),
+      KERNEL_NAME(esp_nn_max_pool_s8), KERNEL_NAME(esp_nn_avg_pool_s8));
+  int failures = 0;
+  for (size_t i = 0; i < cases.size(); i++) {
+    const Case& c = cases[i];
+    const uint32_t start = esp_cpu_get_cycle_count();
+    const std::vector<int8_t> expected = Reference(c);
+    const uint32_t reference_cycles = esp_cpu_get_cycle_count() - start;
+    const std::vector<KernelResult> results = RunKernels(c, expected, repeat);
+    json += Json(c, reference_cycles, results) +
+            (i + 1 < cases.size() ? ",\n" : "\n");
+
+    for (const KernelResult& r : results) {
+      if (!r.exact()) {
+        failures++;
+        fprintf(stderr, "case %zu (%s %s): %s %d mismatches%s\n", i,
+                c.source.c_str(), OpName(c.op), r.name.c_str(), r.mismatches,
+                r.overrun ? ", wrote past the output" : "");
+      }
+    }
+    if (c.source != "sweep") {
+      const KernelResult& best = *std::min_element(
+          results.begin(), results.end(),
+          [](const KernelResult& a, const KernelResult& b) {
+            return a.cycles < b.cycles;
+          });
+      fprintf(stderr, "%s %s %dx%dx%d -> %dx%dx%d: %s %.3f MACs/cycle\n",
+              c.source.c_str(), OpName(c.op), c.input_height, c.input_width,
+              c.input_depth, c.output_height, c.output_width, c.output_depth,
+              best.name.c_str(),
+              static_cast<double>(c.Macs()) / std::max<uint32_t>(best.cycles, 1));
+    }
+  }
+  json += Format("  ],\n  \"failures\": %d\n}\n", failures);
+
+  FILE* out = stdout;
+  if (json_path != nullptr && (out = fopen(json_path, "w")) == nullptr) {
+    Fail("cannot write %s", json_path);
+  }
+  fputs(json.c_str(), out);
+  if (out != stdout) {
+    fclose(out);
+  }
+  fprintf(stderr, "%zu cases, %d kernel results not bit-exact\n", cases.size(),
+          failures);
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host driver of the esp-nn tests (managed_components/espressif__esp-nn/tests),
+ * the counterpart of its test_app: every test compares the reference `_ansi`
+ * kernel with the one esp_nn.h dispatches to, here built for one host
+ * backend. The profile callbacks count nanoseconds instead of cycles.
+ *
+ * Exits with 77 (skipped) when the CPU lacks ESP_NN_TEST_CPU, the
+ * instruction set the backend was built for.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <test_functions.h>
+
+#ifndef ESP_NN_TEST_BACKEND
+#define ESP_NN_TEST_BACKEND "opt"
+#endif
+
+static uint64_t start_c, start_opt;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+void profile_c_start()
+{
+    start_c = now_ns();
+}
+
+uint32_t profile_c_end()
+{
+    return (uint32_t) (now_ns() - start_c);
+}
+
+void profile_opt_start()
+{
+    start_opt = now_ns();
+}
+
+uint32_t profile_opt_end()
+{
+    return (uint32_t) (now_ns() - start_opt);
+}
+
+int main(void)
+{
+#if defined(ESP_NN_TEST_CPU) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports(ESP_NN_TEST_CPU)) {
+        printf("esp-nn %s backend: CPU has no %s, skipped\n", ESP_NN_TEST_BACKEND, ESP_NN_TEST_CPU);
+        return 77;
+    }
+#endif
+    printf("esp-nn %s backend\n", ESP_NN_TEST_BACKEND);
+
+    esp_nn_add_elementwise_s8_test();
+    esp_nn_mul_elementwise_s8_test();
+    esp_nn_depthwise_conv_s8_test();
+    esp_nn_conv_s8_test();
+    esp_nn_conv_u8_s8_test();
+
+    esp_nn_relu6_s8_test();
+    esp_nn_avg_pool_s8_test();
+    esp_nn_max_pool_s8_test();
+    esp_nn_fully_connected_s8_test();
+    esp_nn_fully_connected_per_ch_s8_test();
+    esp_nn_softmax_s8_test();
+    return 0;
+}
@@ -0,0 +1,365 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host implementations of the ESP-IDF services the application uses:
+ * esp_timer, heap_caps, esp_psram and a pthread backed subset of FreeRTOS tasks
+ * and queues.
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_heap_caps.h"
+#include "esp_psram.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+/******************************** esp_timer ***********************************/
+
+static int64_t timer_origin_us;
+
+static int64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    if (timer_origin_us == 0) {
+        timer_origin_us = monotonic_us();
+    }
+    return monotonic_us() - timer_origin_us;
+}
+
+/******************************** heap_caps ***********************************/
+
+#define HOST_INTERNAL_RAM_SIZE  (512 * 1024)
+#define HOST_PSRAM_DEFAULT_SIZE (8 * 1024 * 1024)
+
+/* Every block carries this header so frees can be accounted to the right pool */
+typedef struct {
+    void *base;
+    size_t size;
+    int spiram;
+} block_hdr_t;
+
+typedef struct {
+    size_t total;
+    size_t used;
+    size_t peak;
+} heap_pool_t;
+
+static heap_pool_t pools[2];
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+size_t esp_psram_get_size(void)
+{
+    const char *env = getenv("HOST_PSRAM_SIZE");
+    return env ? (size_t) strtoull(env, NULL, 0) : HOST_PSRAM_DEFAULT_SIZE;
+}
+
+static heap_pool_t *pool_for(uint32_t caps)
+{
+    heap_pool_t *pool = &pools[(caps & MALLOC_CAP_SPIRAM) ? 1 : 0];
+    if (pool->total == 0) {
+        pools[0].total = HOST_INTERNAL_RAM_SIZE;
+        pools[1].total = esp_psram_get_size();
+    }
+    return pool;
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+    int spiram = (caps & MALLOC_CAP_SPIRAM) != 0;
+    heap_pool_t *pool = pool_for(caps);
+
+    pthread_mutex_lock(&heap_lock);
+    if (size > pool->total - pool->used) {
+        /* Behave like the device: fail instead of silently using host RAM */
+        pthread_mutex_unlock(&heap_lock);
+        return NULL;
+    }
+    pool->used += size;
+    if (pool->used > pool->peak) {
+        pool->peak = pool->used;
+    }
+    pthread_mutex_unlock(&heap_lock);
+
+    void *base = malloc(size + alignment + sizeof(block_hdr_t));
+    if (!base) {
+        return NULL;
+    }
+    uintptr_t ptr = ((uintptr_t) base + sizeof(block_hdr_t) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    block_hdr_t *hdr = (block_hdr_t *) ptr - 1;
+    hdr->base = base;
+    hdr->size = size;
+    hdr->spiram = spiram;
+    return (void *) ptr;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return heap_caps_aligned_alloc(sizeof(void *), size, caps);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_malloc(n * size, caps);
+    if (ptr) {
+        memset(ptr, 0, n * size);
+    }
+    return ptr;
+}
+
+void heap_caps_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    block_hdr_t *hdr = (block_hdr_t *) ptr - 1;
+    pthread_mutex_lock(&heap_lock);
+    pools[hdr->spiram].used -= hdr->size;
+    pthread_mutex_unlock(&heap_lock);
+    free(hdr->base);
+}
+
+static size_t sum_pools(uint32_t caps, size_t (*field)(const heap_pool_t *))
+{
+    size_t total = 0;
+    pool_for(caps);
+    /* MALLOC_CAP_8BIT covers both pools, like on the device */
+    if (!(caps & MALLOC_CAP_SPIRAM)) {
+        total += field(&pools[0]);
+    }
+    if ((caps & MALLOC_CAP_SPIRAM) || !(caps & MALLOC_CAP_INTERNAL)) {
+        total += field(&pools[1]);
+    }
+    return total;
+}
+
+static size_t pool_total(const heap_pool_t *p) { return p->total; }
+static size_t pool_free(const heap_pool_t *p) { return p->total - p->used; }
+static size_t pool_min_free(const heap_pool_t *p) { return p->total - p->peak; }
+
+size_t heap_caps_get_total_size(uint32_t caps)
+{
+    return sum_pools(caps, pool_total);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return sum_pools(caps, pool_free);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return sum_pools(caps, pool_min_free);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+/******************************** FreeRTOS ************************************/
+
+typedef struct {
+    TaskFunction_t fn;
+    void *arg;
+    BaseType_t core_id;
+} task_start_t;
+
+static __thread BaseType_t current_core_id;
+
+static void *task_trampoline(void *p)
+{
+    task_start_t start = *(task_start_t *) p;
+    free(p);
+    current_core_id = start.core_id == tskNO_AFFINITY ? 0 : start.core_id;
+    start.fn(start.arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack_depth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core_id)
+{
+    task_start_t *start = malloc(sizeof(task_start_t));
+    if (!start) {
+        return pdFAIL;
+    }
+    start->fn = fn;
+    start->arg = arg;
+    start->core_id = core_id;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, task_trampoline, start) != 0) {
+        free(start);
+        return pdFAIL;
+    }
+    pthread_setname_np(thread, name);
+    pthread_detach(thread);
+    if (handle) {
+        *handle = (TaskHandle_t) thread;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    if (handle == NULL) {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    static int honour_delay = -1;
+    if (honour_delay < 0) {
+        const char *env = getenv("HOST_TASK_DELAY");
+        honour_delay = env && env[0] == '1';
+    }
+    if (honour_delay) {
+        struct timespec ts = {ticks / 1000, (ticks % 1000) * 1000000L};
+        nanosleep(&ts, NULL);
+    } else {
+        sched_yield();
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t) (esp_timer_get_time() / 1000);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return current_core_id;
+}
+
+/********************************** queues ************************************/
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+};
+
+/* Waits on the queue's condition variable; returns 0 once `ticks` ran out */
+static int queue_wait(struct host_queue *q, TickType_t ticks,
+                      const struct timespec *deadline)
+{
+    if (ticks == 0) {
+        return 0;
+    }
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(&q->changed, &q->lock);
+        return 1;
+    }
+    return pthread_cond_timedwait(&q->changed, &q->lock, deadline) == 0;
+}
+
+static struct timespec queue_deadline(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    if (ticks != portMAX_DELAY) {
+        ts.tv_sec += ticks / 1000;
+        ts.tv_nsec += (long) (ticks % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+    }
+    return ts;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *q = calloc(1, sizeof(struct host_queue));
+    if (!q) {
+        return NULL;
+    }
+    q->items = malloc((size_t) length * item_size);
+    if (!q->items) {
+        free(q);
+        return NULL;
+    }
+    q->length = length;
+    q->item_size = item_size;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->changed, NULL);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    if (!q) {
+        return;
+    }
+    pthread_cond_destroy(&q->changed);
+    pthread_mutex_destroy(&q->lock);
+    free(q->items);
+    free(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    const struct timespec deadline = queue_deadline(ticks);
+    pthread_mutex_lock(&q->lock);
+    while (q->count == q->length) {
+        if (!queue_wait(q, ticks, &deadline)) {
+            pthread_mutex_unlock(&q->lock);
+            return errQUEUE_FULL;
+        }
+    }
+    UBaseType_t tail = (q->head + q->count) % q->length;
+    memcpy(q->items + (size_t) tail * q->item_size, item, q->item_size);
+    q->count++;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    const struct timespec deadline = queue_deadline(ticks);
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0) {
+        if (!queue_wait(q, ticks, &deadline)) {
+            pthread_mutex_unlock(&q->lock);
+            return errQUEUE_EMPTY;
+        }
+    }
+    memcpy(item, q->items + (size_t) q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    pthread_cond_broadcast(&q->changed);
+    pthread_mutex_unlock(&q->lock);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->lock);
+    UBaseType_t count = q->count;
+    pthread_mutex_unlock(&q->lock);
+    return count;
+}
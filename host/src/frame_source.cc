@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "frame_source.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "image_pack.h"
+#include "model_settings.h"
+
+namespace {
+
+struct Frame {
+  std::string name;
+  std::vector<uint8_t> pixels;
+  int label = -1;
+};
+
+std::vector<Frame> frames;
+size_t next_frame = 0;
+int capture_time_us = 0;
+ImageFormat capture_format = kImageFormatGrayscale;
+int capture_width = kNumCols;
+int capture_height = kNumRows;
+
+// Adds the frames of an image pack, with their names and labels, as uint8.
+int AddPack(const std::string& path, const std::vector<uint8_t>& data) {
+  image_pack_t pack;
+  if (image_pack_open(&pack, data.data(), data.size(), kNumCols, kNumRows,
+                      kNumChannels) != 0) {
+    fprintf(stderr, "%s: not a valid %dx%d image pack\n", path.c_str(), kNumCols,
+            kNumRows);
+    return -1;
+  }
+  const std::string base = path.substr(path.find_last_of('/') + 1);
+  const uint8_t xor_mask = pack.header->pixel_type == IMAGE_PACK_INT8 ? 0x80 : 0;
+  const uint32_t count = image_pack_count(&pack);
+  for (uint32_t i = 0; i < count; i++) {
+    Frame frame;
+    const char* name = image_pack_name(&pack, i);
+    frame.name = name != nullptr ? name : base + "#" + std::to_string(i);
+    const uint8_t* pixels = image_pack_frame(&pack, i);
+    frame.pixels.resize(kMaxImageSize);
+    for (int p = 0; p < kMaxImageSize; p++) {
+      frame.pixels[p] = pixels[p] ^ xor_mask;
+    }
+    frame.label = image_pack_label(&pack, i);
+    frames.push_back(std::move(frame));
+  }
+  return static_cast<int>(count);
+}
+
+int AddFile(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    fprintf(stderr, "Can't open %s\n", path.c_str());
+    return -1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+    data.insert(data.end(), chunk, chunk + n);
+  }
+  fclose(f);
+
+  if (data.size() >= 4 && memcmp(data.data(), IMAGE_PACK_MAGIC, 4) == 0) {
+    return AddPack(path, data);
+  }
+  if (data.empty() || data.size() % kMaxImageSize != 0) {
+    fprintf(stderr, "%s: %zu bytes is not a multiple of a %dx%d frame\n",
+            path.c_str(), data.size(), kNumCols, kNumRows);
+    return -1;
+  }
+  const size_t count = data.size() / kMaxImageSize;
+  const std::string base = path.substr(path.find_last_of('/') + 1);
+  for (size_t i = 0; i < count; i++) {
+    Frame frame;
+    frame.name = count == 1 ? base : base + "#" + std::to_string(i);
+    frame.pixels.assign(data.begin() + i * kMaxImageSize,
+                        data.begin() + (i + 1) * kMaxImageSize);
+    frames.push_back(std::move(frame));
+  }
+  return static_cast<int>(count);
+}
+
+}  // namespace
+
+int FrameSourceAdd(const char* path) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "Can't stat %s\n", path);
+    return -1;
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    return AddFile(path);
+  }
+
+  DIR* dir = opendir(path);
+  if (dir == nullptr) {
+    fprintf(stderr, "Can't open directory %s\n", path);
+    return -1;
+  }
+  std::vector<std::string> names;
+  while (struct dirent* entry = readdir(dir)) {
+    const std::string file = std::string(path) + "/" + entry->d_name;
+    // Skip dot files and the README that sits next to the sample images.
+    if (entry->d_name[0] == '.' || stat(file.c_str(), &st) != 0 ||
+        !S_ISREG(st.st_mode) || st.st_size % kMaxImageSize != 0) {
+      continue;
+    }
+    names.push_back(file);
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+
+  int added = 0;
+  for (const std::string& name : names) {
+    const int count = AddFile(name);
+    if (count < 0) {
+      return -1;
+    }
+    added += count;
+  }
+  return added;
+}
+
+int FrameSourceCount() { return static_cast<int>(frames.size()); }
+
+const char* FrameSourceName(int index) { return frames[index].name.c_str(); }
+
+int FrameSourceLabel(int index) { return frames[index].label; }
+
+const uint8_t* FrameSourceFrame(int index) {
+  return frames[index].pixels.data();
+}
+
+const uint8_t* FrameSourceNext() {
+  if (frames.empty()) {
+    return nullptr;
+  }
+  const uint8_t* frame = frames[next_frame].pixels.data();
+  next_frame = (next_frame + 1) % frames.size();
+  return frame;
+}
+
+void FrameSourceSetCaptureTime(int us) { capture_time_us = us; }
+
+int FrameSourceCaptureTime() { return capture_time_us; }
+
+void FrameSourceSetCaptureFormat(ImageFormat format, int width, int height) {
+  capture_format = format;
+  capture_width = width;
+  capture_height = height;
+}
+
+ImageFormat FrameSourceCaptureFormat() { return capture_format; }
+
+int FrameSourceCaptureWidth() { return capture_width; }
+
+int FrameSourceCaptureHeight() { return capture_height; }
+
+void FrameSourceRender(const uint8_t* frame, uint8_t* sensor) {
+  // Same centred square crop as ConvertToGrayscale(), for a square model.
+  const int side = std::min(capture_width, capture_height);
+  const int crop_x = ((capture_width - side) / 2) & ~1;
+  const int crop_y = (capture_height - side) / 2;
+  for (int y = 0; y < capture_height; y++) {
+    for (int x = 0; x < capture_width; x++) {
+      uint8_t level = 0;
+      if (x >= crop_x && x < crop_x + side && y >= crop_y &&
+          y < crop_y + side) {
+        level = frame[(y - crop_y) * kNumRows / side * kNumCols +
+                      (x - crop_x) * kNumCols / side];
+      }
+      const int i = y * capture_width + x;
+      switch (capture_format) {
+        case kImageFormatRgb565: {
+          const uint16_t value =
+              ((level >> 3) << 11) | ((level >> 2) << 5) | (level >> 3);
+          sensor[2 * i] = value >> 8;
+          sensor[2 * i + 1] = value & 0xFF;
+          break;
+        }
+        case kImageFormatYuv422:
+          sensor[2 * i] = level;
+          sensor[2 * i + 1] = 128;
+          break;
+        default:
+          sensor[i] = level;
+          break;
+      }
+    }
+  }
+}
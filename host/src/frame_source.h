@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PERSON_DETECTION_HOST_FRAME_SOURCE_H_
+#define PERSON_DETECTION_HOST_FRAME_SOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "image_convert.h"
+
+// Synthetic camera for the host build. Frames are raw 8-bit grayscale images
+// of kNumCols x kNumRows pixels, the same format as static_images/sample_images.
+// A file holding several frames back to back counts as that many frames, and
+// an image pack (see image_pack.h) as the frames it holds.
+
+// Adds every frame found at `path`, which can be a single raw file or a
+// directory of them (read in name order). Returns the number of frames added,
+// or -1 if the path can't be read or a file isn't a whole number of frames.
+int FrameSourceAdd(const char* path);
+
+int FrameSourceCount();
+
+// Name of the file frame `index` was read from, or its name in the pack.
+const char* FrameSourceName(int index);
+
+// Category frame `index` is labelled with in its image pack, -1 if none.
+int FrameSourceLabel(int index);
+
+const uint8_t* FrameSourceFrame(int index);
+
+// Returns the next frame in round-robin order, as a camera would keep
+// delivering frames for as long as it is asked to.
+const uint8_t* FrameSourceNext();
+
+// Makes every GetImage() take at least `us` microseconds, to stand in for the
+// sensor's frame time when comparing serial and pipelined capture.
+void FrameSourceSetCaptureTime(int us);
+int FrameSourceCaptureTime();
+
+// Makes the camera deliver `format` frames of width x height instead of the
+// raw 96x96 grayscale ones: every frame is scaled up (nearest neighbour) into
+// the centre of a sensor-sized image, gray in RGB565/YUV422, so GetImage()
+// has to crop and convert it back as on a device capturing at that size.
+void FrameSourceSetCaptureFormat(ImageFormat format, int width, int height);
+ImageFormat FrameSourceCaptureFormat();
+int FrameSourceCaptureWidth();
+int FrameSourceCaptureHeight();
+
+// Renders `frame` as the camera would deliver it into `sensor`, which must
+// hold width * height * bytes-per-pixel bytes.
+void FrameSourceRender(const uint8_t* frame, uint8_t* sensor);
+
+#endif  // PERSON_DETECTION_HOST_FRAME_SOURCE_H_
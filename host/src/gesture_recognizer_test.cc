@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Feeds GestureRecognizer synthetic score streams: a held gesture with a
+// single noisy frame in it, the repeat suppression, a blank scene going
+// idle and waking up, and frames out of time order.
+
+#include <cstdio>
+
+#include "gesture_recognizer.h"
+#include "model_settings.h"
+
+namespace {
+
+constexpr int32_t kFrameMs = 100;
+
+// Scores of a frame showing `category` with `score`, the rest shared evenly.
+void Scores(int category, float score, float* scores) {
+  for (int i = 0; i < kCategoryCount; i++) {
+    scores[i] = i == category ? score : (1.0f - score) / (kCategoryCount - 1);
+  }
+}
+
+bool Check(const char* name, bool passed) {
+  printf("%-28s %s\n", name, passed ? "passed" : "FAILED");
+  return passed;
+}
+
+}  // namespace
+
+int main() {
+  float scores[kCategoryCount];
+  GestureResult result;
+  int failures = 0;
+
+  // Gesture 2 held for 2 s with one confident 5 in the middle: 2 is
+  // reported on the third frame, again once the suppression is over, and 5
+  // never.
+  GestureRecognizer recognizer;
+  int reported_2 = 0;
+  int reported_other = 0;
+  int first_report = -1;
+  for (int n = 0; n < 20; n++) {
+    if (n == 8) {
+      Scores(k5Index, 1.0f, scores);
+    } else {
+      Scores(k2Index, 0.9f, scores);
+    }
+    recognizer.ProcessLatestResults(scores, n * kFrameMs, &result);
+    if (result.is_new && result.category == k2Index) {
+      reported_2++;
+      first_report = first_report < 0 ? n : first_report;
+    } else if (result.is_new) {
+      reported_other++;
+    }
+  }
+  failures += !Check("noisy frame ignored", reported_other == 0);
+  failures += !Check("reported after 3 frames", first_report == 2);
+  failures += !Check("repeat suppressed", reported_2 == 2);
+
+  // After a gap longer than the window there is no verdict until the window
+  // fills up again.
+  Scores(k2Index, 0.9f, scores);
+  recognizer.ProcessLatestResults(scores, 20 * kFrameMs + 5000, &result);
+  failures += !Check("no verdict after gap", result.category == -1 && !result.is_new);
+
+  // A weak gesture stays under the threshold.
+  recognizer.Reset();
+  bool weak_reported = false;
+  for (int n = 0; n < 10; n++) {
+    Scores(k3Index, 0.5f, scores);
+    recognizer.ProcessLatestResults(scores, n * kFrameMs, &result);
+    weak_reported |= result.is_new;
+  }
+  failures += !Check("below threshold", !weak_reported && result.category == k3Index);
+
+  // Blank for 3 s goes idle, the first other frame wakes it up.
+  recognizer.Reset();
+  int32_t time_ms = 0;
+  int idle_at = -1;
+  for (int n = 0; n < 40; n++, time_ms += kFrameMs) {
+    Scores(kBlankIndex, 0.95f, scores);
+    recognizer.ProcessLatestResults(scores, time_ms, &result);
+    if (result.idle && idle_at < 0) {
+      idle_at = time_ms;
+    }
+  }
+  failures += !Check("idle after blank", idle_at == 3000 && recognizer.idle());
+  Scores(k4Index, 0.6f, scores);
+  recognizer.ProcessLatestResults(scores, time_ms, &result);
+  failures += !Check("awake on gesture", !result.idle && !recognizer.idle());
+
+  // Time going backwards is refused.
+  failures += !Check("out of order refused",
+                     recognizer.ProcessLatestResults(scores, time_ms - 1, &result) ==
+                         kTfLiteError);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,377 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Host runner for the person_detection pipeline. Replays raw 96x96 frames
+// through the same setup()/run_inference()/loop()/loop_pipelined() the device
+// runs and reports a per-inference latency, throughput and allocation
+// baseline.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "autotune_file_cache.h"
+#include "bench.h"
+#include "esp_heap_caps.h"
+#include "esp_main.h"
+#include "esp_timer.h"
+#include "frame_pipeline.h"
+#include "frame_source.h"
+#include "image_convert.h"
+#include "main_functions.h"
+#include "model_settings.h"
+#include "slow_weight_memory.h"
+
+namespace {
+
+void Usage(const char* prog) {
+  fprintf(stderr,
+          "usage: %s [-n iterations] [--loop | --pipeline] [--no-drop]\n"
+          "          [--capture-us US] [--capture-format FMT] [--capture-size WxH]\n"
+          "          [--profile] [--internal-limit KB] [--arena-placement]\n"
+          "          [--weight-tile BYTES] [--slow-weights NS]\n"
+          "          [--autotune] [--autotune-cache PATH] [--winograd]\n"
+          "          [--threads N] [--parallel-min-macs MACS] [--row-bands N]\n"
+          "          [--idle-interval MS] [--bench [--warmup N] [--json]]\n"
+          "          <frame dir or file>...\n"
+          "       %s --arena-report | --arena-header PATH\n"
+          "  -n N            run every frame N times (default 1)\n"
+          "  --loop          drive loop() through the host camera instead of\n"
+          "                  calling run_inference() on each frame\n"
+          "  --pipeline      like --loop, but capture on a second thread and\n"
+          "                  infer with loop_pipelined()\n"
+          "  --no-drop       make the pipeline wait for inference instead of\n"
+          "                  dropping stale frames\n"
+          "  --capture-us US make each camera capture take US microseconds\n"
+          "  --capture-format FMT\n"
+          "                  camera pixel format: gray (default), rgb565 or\n"
+          "                  yuv422\n"
+          "  --capture-size WxH\n"
+          "                  camera frame size (default 96x96); frames are\n"
+          "                  cropped and downscaled back to the model input\n"
+          "  --profile       print the per-node profile after the run, like\n"
+          "                  the device's `profile` console command\n"
+          "  --internal-limit KB\n"
+          "                  internal RAM the split tensor arena may use,\n"
+          "                  the rest of the activations go to PSRAM\n"
+          "  --arena-placement\n"
+          "                  print where every arena buffer was placed\n"
+          "  --weight-tile BYTES\n"
+          "                  stream conv and FC weights through two arena\n"
+          "                  tiles of at most BYTES each\n"
+          "  --slow-weights NS\n"
+          "                  simulate weights in slow memory that takes NS\n"
+          "                  nanoseconds per byte to read\n"
+          "  --autotune      pick the fastest conv kernel of every layer\n"
+          "  --autotune-cache PATH\n"
+          "                  reuse the kernel choices in PATH and append new\n"
+          "                  ones to it\n"
+          "  --winograd      run 3x3 stride 1 convs as Winograd F(2x2, 3x3)\n"
+          "  --threads N     split conv, depthwise, pool and FC layers across\n"
+          "                  N threads (default 1)\n"
+          "  --parallel-min-macs MACS\n"
+          "                  run layers of fewer MACs on one thread\n"
+          "                  (default 100000)\n"
+          "  --row-bands N   run the first N conv and pool stages row band by\n"
+          "                  row band\n"
+          "  --idle-interval MS\n"
+          "                  with --loop or --pipeline, time between\n"
+          "                  inferences once the frames have been Blank for a\n"
+          "                  while, 0 for none (default 500; the delay is only\n"
+          "                  slept with HOST_TASK_DELAY=1)\n"
+          "  --bench         benchmark like the device's `bench` console command:\n"
+          "                  infer on every frame untimed --warmup times\n"
+          "                  (default 1), then -n times timed, and report\n"
+          "                  latency, per-op profile, top-1 accuracy on the\n"
+          "                  labelled frames and heap peaks\n"
+          "  --json          print the --bench report as one line of JSON\n"
+          "  --arena-report  measure the tensor arena the model needs and\n"
+          "                  print its breakdown\n"
+          "  --arena-header PATH\n"
+          "                  measure the tensor arena and write the sizes\n"
+          "                  header (main/tensor_arena_size.h) to PATH\n",
+          prog, prog);
+}
+
+void PrintBaseline(std::vector<int64_t> latencies, int64_t wall_us) {
+  std::sort(latencies.begin(), latencies.end());
+  int64_t sum = 0;
+  for (int64_t l : latencies) {
+    sum += l;
+  }
+  const size_t n = latencies.size();
+  printf("baseline: inferences=%zu latency_us min=%lld median=%lld max=%lld "
+         "mean=%lld\n",
+         n, (long long) latencies[0], (long long) latencies[n / 2],
+         (long long) latencies[n - 1], (long long) (sum / (int64_t) n));
+  printf("baseline: fps=%.2f\n", n * 1e6 / wall_us);
+
+  const size_t internal_peak =
+      heap_caps_get_total_size(MALLOC_CAP_INTERNAL) -
+      heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  const size_t spiram_peak = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) -
+                             heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+  printf("baseline: heap_peak internal=%zu spiram=%zu\n", internal_peak,
+         spiram_peak);
+}
+
+// Writes the generated tensor arena sizes header with the GENERIC sizes
+// measured here. Target sizes measured on a device
+// (CONFIG_TFLITE_ARENA_SIZING) and pasted into an existing header at `path`
+// are carried over.
+bool WriteArenaSizeHeader(const char* path, size_t size, size_t persistent,
+                          size_t non_persistent) {
+  std::string target_sizes;
+  if (FILE* old = fopen(path, "r")) {
+    char line[256];
+    while (fgets(line, sizeof(line), old) != nullptr) {
+      char name[64];
+      unsigned long value;
+      if (sscanf(line, "#define %63s %lu", name, &value) == 2 &&
+          strncmp(name, "TENSOR_ARENA_", strlen("TENSOR_ARENA_")) == 0 &&
+          strstr(name, "_ESP32") != nullptr) {
+        target_sizes += line;
+      }
+    }
+    fclose(old);
+  }
+
+  FILE* file = fopen(path, "w");
+  if (file == nullptr) {
+    perror(path);
+    return false;
+  }
+  fprintf(file,
+          "/*\n"
+          " * SPDX-License-Identifier: Apache-2.0\n"
+          " */\n"
+          "\n"
+          "// Generated by `person_detection_host --arena-header`, do not edit\n"
+          "// except to add the TENSOR_ARENA_*_<TARGET> lines a device prints\n"
+          "// with CONFIG_TFLITE_ARENA_SIZING enabled. Sizes are exact for the\n"
+          "// model and kernels they were measured with, plus alignment headroom;\n"
+          "// rerun both after changing either.\n"
+          "//\n"
+          "// TENSOR_ARENA_SIZE is the size of a single arena,\n"
+          "// TENSOR_ARENA_PERSISTENT_SIZE and TENSOR_ARENA_NON_PERSISTENT_SIZE\n"
+          "// those of the two parts of a split one.\n"
+          "\n"
+          "#ifndef TENSOR_ARENA_SIZE_H_\n"
+          "#define TENSOR_ARENA_SIZE_H_\n"
+          "\n"
+          "#include \"sdkconfig.h\"\n"
+          "\n"
+          "// Targets with the generic esp-nn kernels.\n"
+          "#define TENSOR_ARENA_SIZE_GENERIC %zu\n"
+          "#define TENSOR_ARENA_PERSISTENT_SIZE_GENERIC %zu\n"
+          "#define TENSOR_ARENA_NON_PERSISTENT_SIZE_GENERIC %zu\n"
+          "%s"
+          "\n"
+          "// The esp32s3 and esp32p4 kernels need scratch buffers the host can't\n"
+          "// size, so those targets keep the old arena size until measured.\n"
+          "#if defined(CONFIG_IDF_TARGET_ESP32S3)\n"
+          "#ifdef TENSOR_ARENA_SIZE_ESP32S3\n"
+          "#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_ESP32S3\n"
+          "#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_ESP32S3\n"
+          "#define TENSOR_ARENA_NON_PERSISTENT_SIZE "
+          "TENSOR_ARENA_NON_PERSISTENT_SIZE_ESP32S3\n"
+          "#endif\n"
+          "#elif defined(CONFIG_IDF_TARGET_ESP32P4)\n"
+          "#ifdef TENSOR_ARENA_SIZE_ESP32P4\n"
+          "#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_ESP32P4\n"
+          "#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_ESP32P4\n"
+          "#define TENSOR_ARENA_NON_PERSISTENT_SIZE "
+          "TENSOR_ARENA_NON_PERSISTENT_SIZE_ESP32P4\n"
+          "#endif\n"
+          "#else\n"
+          "#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_GENERIC\n"
+          "#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_GENERIC\n"
+          "#define TENSOR_ARENA_NON_PERSISTENT_SIZE "
+          "TENSOR_ARENA_NON_PERSISTENT_SIZE_GENERIC\n"
+          "#endif\n"
+          "\n"
+          "#endif  // TENSOR_ARENA_SIZE_H_\n",
+          size, persistent, non_persistent, target_sizes.c_str());
+  return fclose(file) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = 1;
+  bool use_loop = false;
+  bool use_pipeline = false;
+  FramePipelineDropPolicy policy = kFramePipelineDropOldest;
+  bool profile = false;
+  bool arena_report = false;
+  bool arena_placement = false;
+  const char* arena_header = nullptr;
+  bool slow_weights = false;
+  bool bench = false;
+  int bench_warmup = 1;
+  bool bench_json = false;
+  ImageFormat capture_format = kImageFormatGrayscale;
+  int capture_width = kNumCols;
+  int capture_height = kNumRows;
+
+  // MicroPrintf goes to stderr; keep stdout in step with it.
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--loop") == 0) {
+      use_loop = true;
+    } else if (strcmp(argv[i], "--pipeline") == 0) {
+      use_pipeline = true;
+    } else if (strcmp(argv[i], "--no-drop") == 0) {
+      policy = kFramePipelineBlock;
+    } else if (strcmp(argv[i], "--capture-us") == 0 && i + 1 < argc) {
+      FrameSourceSetCaptureTime(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--capture-format") == 0 && i + 1 < argc) {
+      const char* format = argv[++i];
+      if (strcmp(format, "rgb565") == 0) {
+        capture_format = kImageFormatRgb565;
+      } else if (strcmp(format, "yuv422") == 0) {
+        capture_format = kImageFormatYuv422;
+      } else if (strcmp(format, "gray") == 0) {
+        capture_format = kImageFormatGrayscale;
+      } else {
+        Usage(argv[0]);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "--capture-size") == 0 && i + 1 < argc) {
+      if (sscanf(argv[++i], "%dx%d", &capture_width, &capture_height) != 2) {
+        Usage(argv[0]);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "--profile") == 0) {
+      profile = true;
+    } else if (strcmp(argv[i], "--internal-limit") == 0 && i + 1 < argc) {
+      arena_set_internal_limit(atoi(argv[++i]) * 1024);
+    } else if (strcmp(argv[i], "--arena-placement") == 0) {
+      arena_placement = true;
+    } else if (strcmp(argv[i], "--weight-tile") == 0 && i + 1 < argc) {
+      weight_tiling_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--slow-weights") == 0 && i + 1 < argc) {
+      SlowWeightMemoryInstall(atoi(argv[++i]));
+      slow_weights = true;
+    } else if (strcmp(argv[i], "--autotune") == 0) {
+      kernel_autotune_set(1);
+    } else if (strcmp(argv[i], "--autotune-cache") == 0 && i + 1 < argc) {
+      AutotuneFileCacheInstall(argv[++i]);
+    } else if (strcmp(argv[i], "--winograd") == 0) {
+      conv_winograd_set(1);
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      parallel_workers_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--parallel-min-macs") == 0 && i + 1 < argc) {
+      parallel_min_macs_set(atol(argv[++i]));
+    } else if (strcmp(argv[i], "--row-bands") == 0 && i + 1 < argc) {
+      row_band_stages_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--idle-interval") == 0 && i + 1 < argc) {
+      idle_frame_interval_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--bench") == 0) {
+      bench = true;
+    } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+      bench_warmup = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--json") == 0) {
+      bench_json = true;
+    } else if (strcmp(argv[i], "--arena-report") == 0) {
+      arena_report = true;
+    } else if (strcmp(argv[i], "--arena-header") == 0 && i + 1 < argc) {
+      arena_header = argv[++i];
+    } else if (argv[i][0] == '-') {
+      Usage(argv[0]);
+      return 2;
+    } else if (FrameSourceAdd(argv[i]) < 0) {
+      return 1;
+    }
+  }
+  if (arena_report || arena_header != nullptr) {
+    size_t required, persistent, non_persistent;
+    if (measure_arena(arena_report, &required, &persistent,
+                      &non_persistent) != 0) {
+      return 1;
+    }
+    if (arena_header != nullptr &&
+        !WriteArenaSizeHeader(arena_header, required, persistent,
+                              non_persistent)) {
+      return 1;
+    }
+    return 0;
+  }
+  if (FrameSourceCount() == 0 || iterations < 1) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  FrameSourceSetCaptureFormat(capture_format, capture_width, capture_height);
+
+  setup();
+  if (arena_placement) {
+    arena_print();
+  }
+  if (bench) {
+    std::vector<const uint8_t*> frames;
+    std::vector<int> labels;
+    std::vector<const char*> names;
+    for (int i = 0; i < FrameSourceCount(); i++) {
+      frames.push_back(FrameSourceFrame(i));
+      labels.push_back(FrameSourceLabel(i));
+      names.push_back(FrameSourceName(i));
+    }
+    bench_config_t config = {};
+    config.frames = frames.data();
+    config.labels = labels.data();
+    config.names = names.data();
+    config.count = FrameSourceCount();
+    config.warmup = bench_warmup;
+    config.runs = iterations;
+    config.json = bench_json;
+    return bench_run(&config) == 0 ? 0 : 1;
+  }
+  // The capture thread plays core 0, this one core 1 as on the device.
+  if (use_pipeline && FramePipelineStart(policy, 0) != kTfLiteOk) {
+    return 1;
+  }
+
+  std::vector<int64_t> latencies;
+  const int64_t run_start = esp_timer_get_time();
+  for (int itr = 0; itr < iterations; itr++) {
+    for (int i = 0; i < FrameSourceCount(); i++) {
+      const int64_t start = esp_timer_get_time();
+      if (use_pipeline) {
+        loop_pipelined();
+      } else if (use_loop) {
+        loop();
+      } else {
+        run_inference((void*) FrameSourceFrame(i));
+      }
+      const int64_t elapsed = esp_timer_get_time() - start;
+      latencies.push_back(elapsed);
+      printf("frame %s: %lld us\n", FrameSourceName(i), (long long) elapsed);
+    }
+  }
+
+  const int64_t wall_us = esp_timer_get_time() - run_start;
+
+  if (use_pipeline) {
+    FramePipelineStop();
+    const FramePipelineStats stats = FramePipelineGetStats();
+    printf("pipeline: captured=%u consumed=%u dropped=%u failed=%u\n",
+           (unsigned) stats.captured, (unsigned) stats.consumed,
+           (unsigned) stats.dropped, (unsigned) stats.failed);
+  }
+  PrintBaseline(latencies, wall_us);
+  if (slow_weights) {
+    SlowWeightMemoryPrintStats();
+  }
+  if (profile) {
+    profile_print(0);
+  }
+  return 0;
+}
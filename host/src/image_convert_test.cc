@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Checks ConvertToGrayscale() against a straightforward per-pixel reference
+// for every format over a few camera frame sizes.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "image_convert.h"
+
+namespace {
+
+uint8_t ReferenceLuma(const uint8_t* pixel, ImageFormat format) {
+  switch (format) {
+    case kImageFormatRgb565: {
+      const uint16_t value = (pixel[0] << 8) | pixel[1];
+      const int r = ((value >> 11) & 0x1F) << 3;
+      const int g = ((value >> 5) & 0x3F) << 2;
+      const int b = (value & 0x1F) << 3;
+      return (305 * r + 600 * g + 119 * b) >> 10;
+    }
+    case kImageFormatYuv422:
+      return pixel[0];
+    default:
+      return pixel[0];
+  }
+}
+
+void ReferenceConvert(const uint8_t* src, int src_width, int src_height,
+                      ImageFormat format, uint8_t* dst, int dst_width,
+                      int dst_height, uint16_t* display, int scale) {
+  const int bpp = format == kImageFormatGrayscale ? 1 : 2;
+  int crop_width = src_width;
+  int crop_height = src_height;
+  if (src_width * dst_height > src_height * dst_width) {
+    crop_width = src_height * dst_width / dst_height;
+  } else {
+    crop_height = src_width * dst_height / dst_width;
+  }
+  const int crop_x = ((src_width - crop_width) / 2) & ~1;
+  const int crop_y = (src_height - crop_height) / 2;
+  for (int oy = 0; oy < dst_height; oy++) {
+    const int y0 = crop_y + oy * crop_height / dst_height;
+    const int y1 = crop_y + (oy + 1) * crop_height / dst_height;
+    for (int ox = 0; ox < dst_width; ox++) {
+      const int x0 = crop_x + ox * crop_width / dst_width;
+      const int x1 = crop_x + (ox + 1) * crop_width / dst_width;
+      uint32_t sum = 0;
+      for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+          sum += ReferenceLuma(src + (y * src_width + x) * bpp, format);
+        }
+      }
+      const uint32_t area = (x1 - x0) * (y1 - y0);
+      const uint8_t level = (sum + area / 2) / area;
+      dst[oy * dst_width + ox] = level;
+
+      const uint8_t* first = src + (y0 * src_width + x0) * bpp;
+      uint8_t bytes[2];
+      if (format == kImageFormatRgb565) {
+        bytes[0] = first[0];
+        bytes[1] = first[1];
+      } else {
+        const uint16_t value =
+            ((level >> 3) << 11) | ((level >> 2) << 5) | (level >> 3);
+        bytes[0] = value >> 8;
+        bytes[1] = value & 0xFF;
+      }
+      for (int dy = 0; dy < scale; dy++) {
+        for (int dx = 0; dx < scale; dx++) {
+          uint8_t* out = reinterpret_cast<uint8_t*>(
+              display + (oy * scale + dy) * dst_width * scale + ox * scale + dx);
+          out[0] = bytes[0];
+          out[1] = bytes[1];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  struct {
+    int width;
+    int height;
+  } const sizes[] = {{96, 96}, {160, 120}, {176, 144}, {240, 240},
+                     {320, 240}, {400, 296}, {640, 480}, {98, 101}};
+  const ImageFormat formats[] = {kImageFormatGrayscale, kImageFormatRgb565,
+                                 kImageFormatYuv422};
+  const char* const format_names[] = {"gray", "rgb565", "yuv422"};
+  constexpr int kDst = 96;
+  constexpr int kScale = 2;
+
+  int failures = 0;
+  srand(1);
+  for (const auto& size : sizes) {
+    for (int f = 0; f < 3; f++) {
+      std::vector<uint32_t> words((size.width * size.height * 2 + 3) / 4);
+      uint8_t* src = reinterpret_cast<uint8_t*>(words.data());
+      for (size_t i = 0; i < words.size() * 4; i++) {
+        src[i] = rand() & 0xFF;
+      }
+      std::vector<uint8_t> dst(kDst * kDst), ref(kDst * kDst);
+      std::vector<uint16_t> display(kDst * kDst * kScale * kScale);
+      std::vector<uint16_t> ref_display(display.size());
+
+      const bool ok =
+          ConvertToGrayscale(src, size.width, size.height, formats[f],
+                             dst.data(), kDst, kDst, display.data(), kScale);
+      ReferenceConvert(src, size.width, size.height, formats[f], ref.data(),
+                       kDst, kDst, ref_display.data(), kScale);
+      const bool match = ok && dst == ref && display == ref_display;
+      printf("%-6s %4dx%-4d %s\n", format_names[f], size.width, size.height,
+             match ? "passed" : "FAILED");
+      failures += !match;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
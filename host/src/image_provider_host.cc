@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Host implementation of image_provider.h: the "camera" replays the frames
+// loaded into the frame source, so loop() runs unchanged on Linux.
+
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "esp_timer.h"
+#include "frame_source.h"
+#include "image_convert.h"
+#include "image_provider.h"
+#include "model_settings.h"
+
+TfLiteStatus InitCamera() {
+  if (FrameSourceCount() == 0) {
+    MicroPrintf("No frames loaded in the host frame source");
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+void *image_provider_get_display_buf() { return nullptr; }
+
+namespace {
+
+// Sleep rather than spin so a simulated capture leaves the CPU to the
+// inference thread, as the camera's DMA would.
+void WaitCaptureTime(int64_t start) {
+  const int64_t remaining =
+      FrameSourceCaptureTime() - (esp_timer_get_time() - start);
+  if (remaining > 0) {
+    struct timespec ts = {(time_t) (remaining / 1000000),
+                          (long) (remaining % 1000000) * 1000};
+    nanosleep(&ts, nullptr);
+  }
+}
+
+// True when the camera delivers frames that are already model input.
+bool NativeCapture() {
+  return FrameSourceCaptureFormat() == kImageFormatGrayscale &&
+         FrameSourceCaptureWidth() == kNumCols &&
+         FrameSourceCaptureHeight() == kNumRows;
+}
+
+}  // namespace
+
+TfLiteStatus GetImage(int image_width, int image_height, int channels,
+                      uint8_t* image_data) {
+  const uint8_t* frame = FrameSourceNext();
+  if (frame == nullptr ||
+      image_width * image_height * channels != kMaxImageSize) {
+    return kTfLiteError;
+  }
+  if (NativeCapture()) {
+    const int64_t start = esp_timer_get_time();
+    memcpy(image_data, frame, kMaxImageSize);
+    WaitCaptureTime(start);
+    return kTfLiteOk;
+  }
+
+  // Play the sensor: the rendering isn't part of the capture time, the
+  // conversion back to model input is.
+  const int width = FrameSourceCaptureWidth();
+  const int height = FrameSourceCaptureHeight();
+  // NOLINTNEXTLINE(runtime-global-variables)
+  static std::vector<uint32_t> sensor;
+  sensor.resize((width * height * 2 + 3) / 4);
+  uint8_t* sensor_data = reinterpret_cast<uint8_t*>(sensor.data());
+  FrameSourceRender(frame, sensor_data);
+  const int64_t start = esp_timer_get_time();
+  if (!ConvertToGrayscale(sensor_data, width, height,
+                          FrameSourceCaptureFormat(), image_data, image_width,
+                          image_height, nullptr, 0)) {
+    MicroPrintf("Can't convert a %dx%d frame to %dx%d", width, height,
+                image_width, image_height);
+    return kTfLiteError;
+  }
+  WaitCaptureTime(start);
+  return kTfLiteOk;
+}
+
+TfLiteStatus AcquireImage(int image_width, int image_height, int channels,
+                          uint8_t** image_data) {
+  if (!NativeCapture()) {
+    return kTfLiteError;
+  }
+  const int64_t start = esp_timer_get_time();
+  const uint8_t* frame = FrameSourceNext();
+  if (frame == nullptr ||
+      image_width * image_height * channels != kMaxImageSize) {
+    return kTfLiteError;
+  }
+  // Frames are only ever read through the input tensor.
+  *image_data = const_cast<uint8_t*>(frame);
+  WaitCaptureTime(start);
+  return kTfLiteOk;
+}
+
+void ReleaseImage() {}
@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Encodes synthetic frames with the camera component's JPEG encoder and
+// decodes them with jpg2gray(). Checks the output against ConvertToGrayscale()
+// of a full luma-only decode at the same IDCT scale, its error against the
+// luma of the source image next to that of the RGB decode the application
+// would otherwise run, and times the two.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "esp_jpg_decode.h"
+#include "image_convert.h"
+#include "jpge.h"
+
+namespace {
+
+constexpr int kDst = 96;
+
+class VectorStream : public jpge::output_stream {
+ public:
+  bool put_buf(const void* buf, int len) override {
+    if (buf != nullptr) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(buf);
+      data.insert(data.end(), bytes, bytes + len);
+    }
+    return true;
+  }
+  jpge::uint get_size() const override { return data.size(); }
+
+  std::vector<uint8_t> data;
+};
+
+int Luma(const uint8_t* rgb) {
+  return (305 * rgb[0] + 600 * rgb[1] + 119 * rgb[2]) >> 10;
+}
+
+// Gradients, a soft-edged disc and a little noise, in colour, scaled with the
+// frame so every size shows the same scene.
+std::vector<uint8_t> Scene(int width, int height) {
+  std::vector<uint8_t> rgb(width * height * 3);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      uint8_t* p = &rgb[(y * width + x) * 3];
+      const int dx = (x - width / 2) * 256 / width;
+      const int dy = (y - height / 3) * 256 / height;
+      const int d = dx * dx + dy * dy;
+      const int disc = d < 3000 ? 255 : d > 4000 ? 0 : (4000 - d) * 255 / 1000;
+      const int noise = rand() % 8;
+      p[0] = (disc * 220 + (255 - disc) * (8 + x * 240 / width)) / 255 - noise;
+      p[1] = (disc * 40 + (255 - disc) * (y * 240 / height)) / 255 + noise;
+      p[2] = 160 - disc / 3 + noise;
+    }
+  }
+  return rgb;
+}
+
+std::vector<uint8_t> Encode(const std::vector<uint8_t>& rgb, int width, int height,
+                            jpge::subsampling_t subsampling) {
+  const int channels = subsampling == jpge::Y_ONLY ? 1 : 3;
+  jpge::params params;
+  params.m_quality = 85;
+  params.m_subsampling = subsampling;
+  VectorStream stream;
+  jpge::jpeg_encoder encoder;
+  std::vector<uint8_t> line(width * channels);
+  if (!encoder.init(&stream, width, height, channels, params)) {
+    return {};
+  }
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const uint8_t* p = &rgb[(y * width + x) * 3];
+      if (channels == 1) {
+        line[x] = Luma(p);
+      } else {
+        memcpy(&line[x * 3], p, 3);
+      }
+    }
+    encoder.process_scanline(line.data());
+  }
+  encoder.process_scanline(nullptr);
+  encoder.deinit();
+  return stream.data;
+}
+
+// Full size decode, 1 byte per pixel for luma and 3 for RGB888.
+struct FullDecode {
+  const std::vector<uint8_t>* jpeg;
+  int channels;
+  int width;
+  int height;
+  std::vector<uint32_t> words;  // 4-byte aligned for ConvertToGrayscale()
+
+  uint8_t* bytes() { return reinterpret_cast<uint8_t*>(words.data()); }
+
+  static size_t Read(void* arg, size_t index, uint8_t* buf, size_t len) {
+    auto* decode = static_cast<FullDecode*>(arg);
+    if (buf != nullptr) {
+      memcpy(buf, decode->jpeg->data() + index, len);
+    }
+    return len;
+  }
+
+  static bool Write(void* arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t* data) {
+    auto* decode = static_cast<FullDecode*>(arg);
+    if (data == nullptr) {
+      if (x == 0 && y == 0) {
+        decode->width = w;
+        decode->height = h;
+        decode->words.assign((w * h * decode->channels + 3) / 4, 0);
+      }
+      return true;
+    }
+    for (int row = 0; row < h; row++) {
+      memcpy(decode->bytes() + ((y + row) * decode->width + x) * decode->channels,
+             data + row * w * decode->channels, w * decode->channels);
+    }
+    return true;
+  }
+};
+
+// The application's path without jpg2gray(): RGB888 at full size, then luma
+// and the downscale.
+bool RgbPath(const std::vector<uint8_t>& jpeg, uint8_t* out) {
+  FullDecode rgb{&jpeg, 3, 0, 0, {}};
+  if (esp_jpg_decode(jpeg.size(), JPG_SCALE_NONE, FullDecode::Read, FullDecode::Write, &rgb) !=
+      ESP_OK) {
+    return false;
+  }
+  std::vector<uint32_t> gray((rgb.width * rgb.height + 3) / 4);
+  uint8_t* g = reinterpret_cast<uint8_t*>(gray.data());
+  for (int i = 0; i < rgb.width * rgb.height; i++) {
+    g[i] = Luma(rgb.bytes() + i * 3);
+  }
+  return ConvertToGrayscale(g, rgb.width, rgb.height, kImageFormatGrayscale, out, kDst, kDst,
+                            nullptr, 1);
+}
+
+// Full luma decode at the scale jpg2gray() picks, the smallest one that
+// ConvertToGrayscale() accepts, then ConvertToGrayscale().
+bool LumaReference(const std::vector<uint8_t>& jpeg, uint8_t* out, int* scale) {
+  for (*scale = JPG_SCALE_MAX; *scale >= JPG_SCALE_NONE; (*scale)--) {
+    FullDecode luma{&jpeg, 1, 0, 0, {}};
+    if (esp_jpg_decode_luma(jpeg.size(), static_cast<jpg_scale_t>(*scale), FullDecode::Read,
+                            FullDecode::Write, &luma) == ESP_OK &&
+        ConvertToGrayscale(luma.bytes(), luma.width, luma.height, kImageFormatGrayscale, out,
+                           kDst, kDst, nullptr, 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Error(const uint8_t* a, const uint8_t* b, int* max, double* mean) {
+  int sum = 0;
+  *max = 0;
+  for (int i = 0; i < kDst * kDst; i++) {
+    const int d = abs(a[i] - b[i]);
+    sum += d;
+    *max = d > *max ? d : *max;
+  }
+  *mean = static_cast<double>(sum) / (kDst * kDst);
+}
+
+template <typename F>
+double MicrosPerCall(F f) {
+  constexpr int kRuns = 20;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; i++) {
+    f();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / kRuns;
+}
+
+}  // namespace
+
+int main() {
+  struct {
+    int width;
+    int height;
+    jpge::subsampling_t subsampling;
+  } const cases[] = {{96, 96, jpge::H1V1},    {160, 120, jpge::H2V1},  {176, 144, jpge::H1V1},
+                     {320, 240, jpge::H2V2},  {400, 296, jpge::H2V2},  {640, 480, jpge::H2V2},
+                     {800, 600, jpge::H2V1},  {201, 150, jpge::H2V2}};
+
+  int failures = 0;
+  srand(1);
+  for (const auto& c : cases) {
+    const std::vector<uint8_t> rgb = Scene(c.width, c.height);
+    const std::vector<uint8_t> jpeg = Encode(rgb, c.width, c.height, c.subsampling);
+
+    // Luma of the source, downscaled
+    std::vector<uint32_t> source((c.width * c.height + 3) / 4);
+    uint8_t* s = reinterpret_cast<uint8_t*>(source.data());
+    for (int i = 0; i < c.width * c.height; i++) {
+      s[i] = Luma(&rgb[i * 3]);
+    }
+    uint8_t source_gray[kDst * kDst];
+    ConvertToGrayscale(s, c.width, c.height, kImageFormatGrayscale, source_gray, kDst, kDst,
+                       nullptr, 1);
+
+    uint8_t gray[kDst * kDst];
+    int8_t gray_s8[kDst * kDst];
+    uint8_t reference[kDst * kDst];
+    uint8_t rgb_path[kDst * kDst];
+    int scale = 0;
+    bool match = !jpeg.empty() && jpg2gray(jpeg.data(), jpeg.size(), gray, kDst, kDst) &&
+                 jpg2gray_s8(jpeg.data(), jpeg.size(), gray_s8, kDst, kDst) &&
+                 LumaReference(jpeg, reference, &scale) && RgbPath(jpeg, rgb_path) &&
+                 memcmp(gray, reference, sizeof(gray)) == 0;
+    for (int i = 0; match && i < kDst * kDst; i++) {
+      match = static_cast<uint8_t>(gray_s8[i]) == (gray[i] ^ 0x80);
+    }
+
+    // Close to the source, no further off than the RGB decode
+    int luma_max = 0;
+    int rgb_max = 0;
+    double luma_mean = 0;
+    double rgb_mean = 0;
+    Error(gray, source_gray, &luma_max, &luma_mean);
+    Error(rgb_path, source_gray, &rgb_max, &rgb_mean);
+    match = match && luma_max <= 16 && luma_mean <= rgb_mean + 1.0;
+
+    const double luma_us = MicrosPerCall([&] { jpg2gray(jpeg.data(), jpeg.size(), gray, kDst, kDst); });
+    const double rgb_us = MicrosPerCall([&] { RgbPath(jpeg, rgb_path); });
+    printf("%4dx%-4d subsampling %d 1/%d: error max %2d mean %.2f (rgb %2d %.2f), "
+           "%7.1f us vs rgb %7.1f us, %.1fx: %s\n",
+           c.width, c.height, c.subsampling, 1 << scale, luma_max, luma_mean, rgb_max, rgb_mean,
+           luma_us, rgb_us, rgb_us / luma_us, match ? "passed" : "FAILED");
+    failures += !match;
+  }
+
+  // Smaller than the output, or not a JPEG
+  uint8_t gray[kDst * kDst];
+  const std::vector<uint8_t> small = Encode(Scene(64, 64), 64, 64, jpge::H2V2);
+  const uint8_t garbage[16] = {0xFF, 0xD8, 0x12};
+  const bool refused = !jpg2gray(small.data(), small.size(), gray, kDst, kDst) &&
+                       !jpg2gray(garbage, sizeof(garbage), gray, kDst, kDst);
+  printf("invalid inputs %s\n", refused ? "passed" : "FAILED");
+  failures += !refused;
+  return failures == 0 ? 0 : 1;
+}
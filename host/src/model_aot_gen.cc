@@ -0,0 +1,990 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Compiles the model in person_detect_model_data.cc ahead of time into
+// main/model_aot.cc (see main/model_aot.h).
+//
+// Walks the flatbuffer once, computes what the kernels' Prepare() would
+// (padding, activation ranges, per-channel multipliers, softmax scaling) the
+// same way TFLite Micro does, fuses the operator pairs
+// MicroInterpreterGraph::FuseOperators() fuses, plans the activations with
+// the interpreter's GreedyMemoryPlanner and prints the result as C++.
+//
+// usage: model_aot_gen [--check] main/model_aot.cc
+//   --check  fail if the file differs from what would be generated
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "person_detect_model_data.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+
+namespace {
+
+constexpr int kAlignment = 16;
+// Same as the interpreter's softmax.
+constexpr int kScaledDiffIntegerBits = 5;
+
+// Where a tensor lives in the generated code.
+enum Location { kInArena, kModelInput, kModelOutput, kWeights };
+
+struct Tensor {
+  tflite::TensorType type;
+  std::vector<int> shape;
+  std::vector<float> scales;
+  int32_t zero_point = 0;
+  Location location = kInArena;
+  // Offset of the data in g_person_detect_model_data, for kWeights.
+  size_t weights_offset = 0;
+  // The tensor whose data this one is (RESHAPE), or itself.
+  int alias = -1;
+  // First and last step using it, -1 if none.
+  int first_step = -1;
+  int last_step = -1;
+  // Planned arena offset, -1 if not in the arena.
+  int offset = -1;
+
+  int FlatSize() const {
+    int size = 1;
+    for (int dim : shape) {
+      size *= dim;
+    }
+    return size;
+  }
+};
+
+// One call in the generated ModelAotInvoke(), for one or two operators.
+// `call` reads $in and writes $out; fused steps also use $scratch, a buffer
+// of scratch_size bytes only the step uses.
+struct Step {
+  int first_op;
+  int last_op;
+  std::string comment;
+  int input = -1;
+  int output = -1;
+  int scratch_size = 0;
+  std::string scratch_name;
+  int scratch_offset = -1;
+  // Namespace scope constants and the call.
+  std::string constants;
+  std::string call;
+  // Sizes of the shared esp-nn scratch buffer this step needs.
+  std::string conv_scratch_size;
+  std::string softmax_scratch_size;
+
+  std::string Namespace() const { return "op" + std::to_string(first_op); }
+  std::string Operators() const {
+    if (first_op == last_op) {
+      return "operator " + std::to_string(first_op);
+    }
+    return "operators " + std::to_string(first_op) + "-" +
+           std::to_string(last_op);
+  }
+};
+
+[[noreturn]] void Fail(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "model_aot_gen: ");
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+  exit(1);
+}
+
+std::string Format(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  char buffer[1024];
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return buffer;
+}
+
+void Replace(std::string* text, const std::string& token,
+             const std::string& value) {
+  for (size_t at = text->find(token); at != std::string::npos;
+       at = text->find(token, at + value.size())) {
+    text->replace(at, token.size(), value);
+  }
+}
+
+int AlignUp(int size) {
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Also in the generated ModelAotCheck().
+uint32_t Fnv1a(const unsigned char* data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+std::string Array(const char* name, const std::vector<int32_t>& values) {
+  std::string out = Format("constexpr int32_t %s[] = {", name);
+  for (size_t i = 0; i < values.size(); i++) {
+    out += i % 6 == 0 ? "\n   " : "";
+    out += Format(" %ld,", static_cast<long>(values[i]));
+  }
+  return out + "\n};\n";
+}
+
+// data_dims_t of an NHWC tensor.
+std::string Dims(const char* name, const std::vector<int>& shape) {
+  return Format("constexpr data_dims_t %s = {%d, %d, %d, 1};\n", name,
+                shape[2], shape[1], shape[3]);
+}
+
+std::string ShapeString(const std::vector<int>& shape) {
+  std::string out;
+  for (size_t i = 0; i < shape.size(); i++) {
+    out += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+  }
+  return out;
+}
+
+TfLitePadding Padding(tflite::Padding padding) {
+  return padding == tflite::Padding_SAME ? kTfLitePaddingSame
+                                         : kTfLitePaddingValid;
+}
+
+class Generator {
+ public:
+  explicit Generator(const tflite::Model* model) : model_(model) {}
+
+  void Run();
+  std::string Emit() const;
+
+ private:
+  const tflite::Operator* Op(int index) const {
+    return subgraph_->operators()->Get(index);
+  }
+  tflite::BuiltinOperator Code(int index) const {
+    return tflite::GetBuiltinCode(
+        model_->operator_codes()->Get(Op(index)->opcode_index()));
+  }
+  int Input(int op, int i) const {
+    return i < static_cast<int>(Op(op)->inputs()->size())
+               ? Op(op)->inputs()->Get(i)
+               : -1;
+  }
+  int Output(int op) const { return Op(op)->outputs()->Get(0); }
+  int SoleConsumer(int tensor) const;
+
+  void ActivationRange(int tensor, tflite::ActivationFunctionType activation,
+                       int32_t* min, int32_t* max) const;
+  std::string Weights(int tensor, const char* type) const;
+  TfLitePaddingValues ConvPadding(int op) const;
+  bool FoldsInputOffset(int op) const;
+  std::string Bias(int op) const;
+  std::string FoldedBias(int op) const;
+  std::string PoolConstants(int op) const;
+  std::string ConvConstants(int op, const char* output_dims) const;
+  std::string FullyConnectedConstants(int op) const;
+  std::string SoftmaxConstants(int op) const;
+
+  void AddQuantize(int op);
+  void AddConv(int op);
+  void AddPool(int op);
+  void AddFullyConnected(int op);
+  void AddSoftmax(int op);
+  void Plan();
+
+  const tflite::Model* model_;
+  const tflite::SubGraph* subgraph_ = nullptr;
+  std::vector<Tensor> tensors_;
+  std::vector<Step> steps_;
+  int activations_size_ = 0;
+};
+
+// The only operator reading `tensor`, -1 if there are several, none, or the
+// tensor is also a model output.
+int Generator::SoleConsumer(int tensor) const {
+  for (int output : *subgraph_->outputs()) {
+    if (output == tensor) {
+      return -1;
+    }
+  }
+  int consumer = -1;
+  for (int op = 0; op < static_cast<int>(subgraph_->operators()->size());
+       op++) {
+    for (int input : *Op(op)->inputs()) {
+      if (input == tensor) {
+        if (consumer != -1 && consumer != op) {
+          return -1;
+        }
+        consumer = op;
+      }
+    }
+  }
+  return consumer;
+}
+
+// CalculateActivationRangeQuantized() of an int8 tensor.
+void Generator::ActivationRange(int tensor,
+                                tflite::ActivationFunctionType activation,
+                                int32_t* min, int32_t* max) const {
+  const Tensor& t = tensors_[tensor];
+  auto quantize = [&](float f) {
+    return t.zero_point + static_cast<int32_t>(std::round(f / t.scales[0]));
+  };
+  *min = std::numeric_limits<int8_t>::min();
+  *max = std::numeric_limits<int8_t>::max();
+  switch (activation) {
+    case tflite::ActivationFunctionType_NONE:
+      break;
+    case tflite::ActivationFunctionType_RELU:
+      *min = std::max(*min, quantize(0.0f));
+      break;
+    case tflite::ActivationFunctionType_RELU6:
+      *min = std::max(*min, quantize(0.0f));
+      *max = std::min(*max, quantize(6.0f));
+      break;
+    case tflite::ActivationFunctionType_RELU_N1_TO_1:
+      *min = std::max(*min, quantize(-1.0f));
+      *max = std::min(*max, quantize(1.0f));
+      break;
+    default:
+      Fail("unsupported fused activation %d", activation);
+  }
+}
+
+std::string Generator::Weights(int tensor, const char* type) const {
+  if (tensor < 0) {
+    return "nullptr";
+  }
+  if (tensors_[tensor].location != kWeights) {
+    Fail("tensor %d is not constant", tensor);
+  }
+  return Format("Weights<%s>(%zu)", type, tensors_[tensor].weights_offset);
+}
+
+TfLitePaddingValues Generator::ConvPadding(int op) const {
+  const auto* options = Op(op)->builtin_options_as_Conv2DOptions();
+  const Tensor& in = tensors_[Input(op, 0)];
+  const Tensor& filter = tensors_[Input(op, 1)];
+  int out_height, out_width;
+  const TfLitePaddingValues padding = tflite::ComputePaddingHeightWidth(
+      options->stride_h(), options->stride_w(), 1, 1, in.shape[1], in.shape[2],
+      filter.shape[1], filter.shape[2], Padding(options->padding()),
+      &out_height, &out_width);
+  if (out_height != tensors_[Output(op)].shape[1] ||
+      out_width != tensors_[Output(op)].shape[2]) {
+    Fail("operator %d: output shape mismatch", op);
+  }
+  return padding;
+}
+
+// Whether the input offset is folded into the bias, as conv.cc and
+// fully_connected.cc do (see kernels/esp_nn/folded_bias.h): when every
+// output reads a whole filter row and nothing else depends on the offset.
+// Unlike conv.cc, this also folds the uint8 offset of a folded QUANTIZE.
+bool Generator::FoldsInputOffset(int op) const {
+  if (Code(op) == tflite::BuiltinOperator_CONV_2D) {
+    const TfLitePaddingValues padding = ConvPadding(op);
+    return padding.width == 0 && padding.height == 0 &&
+           padding.width_offset == 0 && padding.height_offset == 0;
+  }
+  return tensors_[Input(op, 1)].zero_point == 0;
+}
+
+// The bias argument of a conv or fully connected step.
+std::string Generator::Bias(int op) const {
+  if (FoldsInputOffset(op)) {
+    return "op" + std::to_string(op) + "::kBias";
+  }
+  return Weights(Input(op, 2), "int32_t");
+}
+
+// kBias: the bias plus the input offset times each filter row's sum.
+std::string Generator::FoldedBias(int op) const {
+  const Tensor& in = tensors_[Input(op, 0)];
+  const Tensor& filter = tensors_[Input(op, 1)];
+  const int bias = Input(op, 2);
+  const int channels = filter.shape[0];
+  const int row_size = filter.FlatSize() / channels;
+  const auto* filter_data = reinterpret_cast<const int8_t*>(
+      g_person_detect_model_data + filter.weights_offset);
+  std::vector<int32_t> folded(channels, 0);
+  if (bias >= 0) {
+    Weights(bias, "int32_t");  // Fails unless constant
+    memcpy(folded.data(),
+           g_person_detect_model_data + tensors_[bias].weights_offset,
+           channels * sizeof(int32_t));
+  }
+  for (int c = 0; c < channels; c++) {
+    int32_t filter_sum = 0;
+    for (int i = 0; i < row_size; i++) {
+      filter_sum += filter_data[c * row_size + i];
+    }
+    folded[c] += -in.zero_point * filter_sum;
+  }
+  return Array("kBias", folded);
+}
+
+std::string Generator::PoolConstants(int op) const {
+  const auto* options = Op(op)->builtin_options_as_Pool2DOptions();
+  const Tensor& in = tensors_[Input(op, 0)];
+  const Tensor& out = tensors_[Output(op)];
+  int out_height, out_width;
+  const TfLitePaddingValues padding = tflite::ComputePaddingHeightWidth(
+      options->stride_h(), options->stride_w(), 1, 1, in.shape[1], in.shape[2],
+      options->filter_height(), options->filter_width(),
+      Padding(options->padding()), &out_height, &out_width);
+  if (out_height != out.shape[1] || out_width != out.shape[2]) {
+    Fail("operator %d: output shape mismatch", op);
+  }
+  int32_t min, max;
+  ActivationRange(Output(op), options->fused_activation_function(), &min,
+                  &max);
+  return Format(
+      "constexpr model_aot::PoolParams kPool = {%d, %d, %d, %d, %d, %d, %ld, "
+      "%ld};\n",
+      options->stride_w(), options->stride_h(), options->filter_width(),
+      options->filter_height(), padding.width, padding.height,
+      static_cast<long>(min), static_cast<long>(max)) +
+      Dims("kOutputDims", out.shape);
+}
+
+// PopulateConvolutionQuantizationParams() and the esp-nn arguments of
+// conv.cc. The output dims are called `output_dims`.
+std::string Generator::ConvConstants(int op, const char* output_dims) const {
+  const auto* options = Op(op)->builtin_options_as_Conv2DOptions();
+  const Tensor& in = tensors_[Input(op, 0)];
+  const Tensor& filter = tensors_[Input(op, 1)];
+  const Tensor& out = tensors_[Output(op)];
+  if (options->dilation_w_factor() != 1 || options->dilation_h_factor() != 1) {
+    Fail("operator %d: dilated CONV_2D", op);
+  }
+  if (filter.type != tflite::TensorType_INT8) {
+    Fail("operator %d: only int8 filters are supported", op);
+  }
+  const TfLitePaddingValues padding = ConvPadding(op);
+
+  std::vector<int32_t> shifts, multipliers;
+  for (int c = 0; c < filter.shape[0]; c++) {
+    const float filter_scale =
+        filter.scales.size() > 1 ? filter.scales[c] : filter.scales[0];
+    const double effective_scale = static_cast<double>(in.scales[0]) *
+                                   static_cast<double>(filter_scale) /
+                                   static_cast<double>(out.scales[0]);
+    int32_t multiplier;
+    int shift;
+    tflite::QuantizeMultiplier(effective_scale, &multiplier, &shift);
+    multipliers.push_back(multiplier);
+    shifts.push_back(shift);
+  }
+  int32_t min, max;
+  ActivationRange(Output(op), options->fused_activation_function(), &min,
+                  &max);
+
+  // For the uint8 model input of a folded QUANTIZE, in.zero_point is the
+  // uint8 one, which is what conv.cc's uint8 ConvKernel() ends up with.
+  const bool fold = FoldsInputOffset(op);
+  return Dims("kInputDims", in.shape) +
+         Format("constexpr data_dims_t kFilterDims = {%d, %d, 0, 0};\n",
+                filter.shape[2], filter.shape[1]) +
+         Dims(output_dims, out.shape) +
+         Format("constexpr conv_params_t kConvParams = {%ld, %ld, {%d, %d}, "
+                "{%d, %d}, {0, 0}, {%ld, %ld}};\n",
+                static_cast<long>(fold ? 0 : -in.zero_point),
+                static_cast<long>(out.zero_point), options->stride_w(),
+                options->stride_h(), padding.width, padding.height,
+                static_cast<long>(min), static_cast<long>(max)) +
+         (fold ? FoldedBias(op) : "") + Array("kShift", shifts) +
+         Array("kMultiplier", multipliers);
+}
+
+// CalculateOpDataFullyConnected() and the esp-nn arguments of
+// fully_connected.cc.
+std::string Generator::FullyConnectedConstants(int op) const {
+  const auto* options = Op(op)->builtin_options_as_FullyConnectedOptions();
+  const Tensor& in = tensors_[Input(op, 0)];
+  const Tensor& filter = tensors_[Input(op, 1)];
+  const Tensor& out = tensors_[Output(op)];
+  const int channels = filter.shape[0];
+  if (filter.type != tflite::TensorType_INT8 ||
+      options->weights_format() !=
+          tflite::FullyConnectedOptionsWeightsFormat_DEFAULT) {
+    Fail("operator %d: only int8 filters are supported", op);
+  }
+  if (in.FlatSize() != filter.shape[1] || out.FlatSize() != channels) {
+    Fail("operator %d: only batch 1 is supported", op);
+  }
+  int32_t min, max;
+  ActivationRange(Output(op), options->fused_activation_function(), &min,
+                  &max);
+
+  const bool fold = FoldsInputOffset(op);
+  std::string constants = Format(
+      "constexpr int32_t kAccumDepth = %d;\n"
+      "constexpr int32_t kChannels = %d;\n"
+      "constexpr int32_t kInputOffset = %ld;\n"
+      "constexpr int32_t kFilterOffset = %ld;\n"
+      "constexpr int32_t kOutputOffset = %ld;\n"
+      "constexpr int32_t kActivationMin = %ld;\n"
+      "constexpr int32_t kActivationMax = %ld;\n",
+      filter.shape[1], channels,
+      static_cast<long>(fold ? 0 : -in.zero_point),
+      static_cast<long>(-filter.zero_point), static_cast<long>(out.zero_point),
+      static_cast<long>(min), static_cast<long>(max));
+  if (fold) {
+    constants += FoldedBias(op);
+  }
+  if (filter.scales.size() > 1) {
+    std::vector<int32_t> shifts, multipliers;
+    for (int c = 0; c < channels; c++) {
+      const double effective_scale = static_cast<double>(in.scales[0]) *
+                                     static_cast<double>(filter.scales[c]) /
+                                     static_cast<double>(out.scales[0]);
+      int32_t multiplier;
+      int shift;
+      tflite::QuantizeMultiplier(effective_scale, &multiplier, &shift);
+      multipliers.push_back(multiplier);
+      shifts.push_back(shift);
+    }
+    return constants + Array("kShift", shifts) +
+           Array("kMultiplier", multipliers);
+  }
+  // GetQuantizedConvolutionMultipler() multiplies the scales as floats.
+  const double effective_scale =
+      static_cast<double>(in.scales[0] * filter.scales[0]) /
+      static_cast<double>(out.scales[0]);
+  int32_t multiplier;
+  int shift;
+  tflite::QuantizeMultiplier(effective_scale, &multiplier, &shift);
+  return constants + Format(
+                         "constexpr int32_t kShift = %d;\n"
+                         "constexpr int32_t kMultiplier = %ld;\n",
+                         shift, static_cast<long>(multiplier));
+}
+
+// CalculateSoftmaxParams() of an int8 softmax.
+std::string Generator::SoftmaxConstants(int op) const {
+  const auto* options = Op(op)->builtin_options_as_SoftmaxOptions();
+  const Tensor& out = tensors_[Output(op)];
+  if (out.type != tflite::TensorType_INT8 || out.zero_point != -128 ||
+      out.scales[0] != 1.f / 256) {
+    Fail("operator %d: SOFTMAX output must be int8 with scale 1/256", op);
+  }
+  int32_t multiplier;
+  int left_shift;
+  tflite::PreprocessSoftmaxScaling(
+      static_cast<double>(options->beta()),
+      static_cast<double>(tensors_[Input(op, 0)].scales[0]),
+      kScaledDiffIntegerBits, &multiplier, &left_shift);
+  const int32_t diff_min =
+      -1.0 * tflite::CalculateInputRadius(kScaledDiffIntegerBits, left_shift);
+  return Format(
+      "constexpr int32_t kSoftmaxMultiplier = %ld;\n"
+      "constexpr int32_t kSoftmaxShift = %d;\n"
+      "constexpr int32_t kSoftmaxDiffMin = %ld;\n",
+      static_cast<long>(multiplier), left_shift, static_cast<long>(diff_min));
+}
+
+void Generator::AddQuantize(int op) {
+  const int input = Input(op, 0);
+  const int output = Output(op);
+  const Tensor& in = tensors_[input];
+  const Tensor& out = tensors_[output];
+  const bool in_int8 = in.type == tflite::TensorType_INT8;
+  const bool out_int8 = out.type == tflite::TensorType_INT8;
+  if ((!in_int8 && in.type != tflite::TensorType_UINT8) ||
+      (!out_int8 && out.type != tflite::TensorType_UINT8) ||
+      in.scales[0] != out.scales[0]) {
+    Fail("operator %d: only QUANTIZE between int8 and uint8 of the same "
+         "scale is supported",
+         op);
+  }
+
+  // The uint8 model input quantized for a conv: the conv reads the input
+  // itself, as after MicroInterpreterGraph::FoldInputQuantize().
+  const int consumer = SoleConsumer(output);
+  if (in.location == kModelInput && !in_int8 && out_int8 &&
+      out.zero_point == in.zero_point - 128 && consumer != -1 &&
+      Code(consumer) == tflite::BuiltinOperator_CONV_2D &&
+      Input(consumer, 0) == output) {
+    tensors_[output] = in;
+    tensors_[output].alias = output;
+    return;
+  }
+
+  Step step;
+  step.first_op = step.last_op = op;
+  step.comment = "QUANTIZE";
+  step.input = input;
+  step.output = output;
+  step.call = Format("model_aot::Requantize($in, %d, %ld, %d, %d, $out);",
+                     in.FlatSize(),
+                     static_cast<long>(out.zero_point - in.zero_point),
+                     out_int8 ? -128 : 0, out_int8 ? 127 : 255);
+  steps_.push_back(step);
+}
+
+void Generator::AddConv(int op) {
+  Step step;
+  step.first_op = step.last_op = op;
+  step.input = Input(op, 0);
+  step.output = Output(op);
+  const std::string ns = step.Namespace();
+  const std::string weights =
+      Weights(Input(op, 1), "int8_t") + ", " + Bias(op);
+
+  // Fused with the max pool reading it, as by Register_CONV_2D_MAX_POOL_2D(),
+  // when there is no vertical padding to split into bands.
+  const int pool = SoleConsumer(step.output);
+  if (pool == op + 1 && Code(pool) == tflite::BuiltinOperator_MAX_POOL_2D &&
+      ConvPadding(op).height == 0) {
+    const Tensor& conv = tensors_[step.output];
+    step.last_op = pool;
+    step.comment = "CONV_2D + MAX_POOL_2D";
+    step.output = Output(pool);
+    step.scratch_name = Format("band%d", op);
+    step.scratch_size =
+        Op(pool)->builtin_options_as_Pool2DOptions()->filter_height() *
+        conv.shape[2] * conv.shape[3];
+    step.constants = ConvConstants(op, "kConvDims") + PoolConstants(pool);
+    step.conv_scratch_size = Format(
+        "model_aot::ConvScratchSize(\n"
+        "      %s::kInputDims, %s::kFilterDims,\n"
+        "      %s::kConvDims, %s::kConvParams)",
+        ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str());
+    step.call = Format(
+        "model_aot::ConvMaxPool(\n"
+        "      %s::kInputDims, $in, %s::kFilterDims,\n"
+        "      %s, %s::kConvDims,\n"
+        "      %s::kConvParams, model_aot::Quant(%s::kShift, "
+        "%s::kMultiplier),\n"
+        "      %s::kPool, %s::kOutputDims, $scratch, $out);",
+        ns.c_str(), ns.c_str(), weights.c_str(), ns.c_str(), ns.c_str(),
+        ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str());
+    steps_.push_back(step);
+    return;
+  }
+
+  step.comment = "CONV_2D";
+  step.constants = ConvConstants(op, "kOutputDims");
+  step.conv_scratch_size = Format(
+      "model_aot::ConvScratchSize(\n"
+      "      %s::kInputDims, %s::kFilterDims,\n"
+      "      %s::kOutputDims, %s::kConvParams)",
+      ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str());
+  step.call = Format(
+      "model_aot::Conv(%s::kInputDims, $in, %s::kFilterDims,\n"
+      "                  %s,\n"
+      "                  %s::kOutputDims, $out, %s::kConvParams,\n"
+      "                  model_aot::Quant(%s::kShift, %s::kMultiplier));",
+      ns.c_str(), ns.c_str(), weights.c_str(), ns.c_str(), ns.c_str(),
+      ns.c_str(), ns.c_str());
+  steps_.push_back(step);
+}
+
+void Generator::AddPool(int op) {
+  Step step;
+  step.first_op = step.last_op = op;
+  step.input = Input(op, 0);
+  step.output = Output(op);
+  const bool max = Code(op) == tflite::BuiltinOperator_MAX_POOL_2D;
+  const std::string ns = step.Namespace();
+  step.comment = max ? "MAX_POOL_2D" : "AVERAGE_POOL_2D";
+  step.constants =
+      Dims("kInputDims", tensors_[step.input].shape) + PoolConstants(op);
+  step.call = Format(
+      "model_aot::%s(%s::kInputDims, $in, %s::kPool,\n"
+      "                     %s::kOutputDims, $out);",
+      max ? "MaxPool" : "AveragePool", ns.c_str(), ns.c_str(), ns.c_str());
+  steps_.push_back(step);
+}
+
+void Generator::AddFullyConnected(int op) {
+  Step step;
+  step.first_op = step.last_op = op;
+  step.input = Input(op, 0);
+  step.output = Output(op);
+  const std::string ns = step.Namespace();
+  step.comment = "FULLY_CONNECTED";
+  step.constants = FullyConnectedConstants(op);
+  const bool per_channel = tensors_[Input(op, 1)].scales.size() > 1;
+  step.call = Format(
+      "%s(\n"
+      "      $in, %s::kInputOffset, %s::kAccumDepth,\n"
+      "      %s, %s::kFilterOffset,\n"
+      "      %s, $out, %s::kChannels,\n"
+      "      %s::kOutputOffset, %s::kShift, %s::kMultiplier,\n"
+      "      %s::kActivationMin, %s::kActivationMax);",
+      per_channel ? "esp_nn_fully_connected_per_ch_s8"
+                  : "esp_nn_fully_connected_s8",
+      ns.c_str(), ns.c_str(), Weights(Input(op, 1), "int8_t").c_str(),
+      ns.c_str(), Bias(op).c_str(), ns.c_str(),
+      ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str());
+
+  // Fused with the softmax reading it, as by
+  // Register_FULLY_CONNECTED_SOFTMAX(): the logits go to scratch.
+  const int softmax = SoleConsumer(step.output);
+  if (softmax == op + 1 && Code(softmax) == tflite::BuiltinOperator_SOFTMAX) {
+    const int depth = tensors_[step.output].shape.back();
+    step.last_op = softmax;
+    step.comment = "FULLY_CONNECTED + SOFTMAX";
+    step.scratch_name = Format("logits%d", op);
+    step.scratch_size = tensors_[step.output].FlatSize();
+    step.output = Output(softmax);
+    step.constants += SoftmaxConstants(softmax);
+    step.softmax_scratch_size =
+        Format("esp_nn_get_softmax_scratch_size(%d, 1)", depth);
+    Replace(&step.call, "$out", "$scratch");
+    step.call += Format(
+        "\n"
+        "  esp_nn_softmax_s8($scratch, 1, %s::kChannels, "
+        "%s::kSoftmaxMultiplier,\n"
+        "                    %s::kSoftmaxShift, %s::kSoftmaxDiffMin, $out);",
+        ns.c_str(), ns.c_str(), ns.c_str(), ns.c_str());
+  }
+  steps_.push_back(step);
+}
+
+void Generator::AddSoftmax(int op) {
+  Step step;
+  step.first_op = step.last_op = op;
+  step.input = Input(op, 0);
+  step.output = Output(op);
+  const std::string ns = step.Namespace();
+  const Tensor& in = tensors_[step.input];
+  const int depth = in.shape.back();
+  step.comment = "SOFTMAX";
+  step.constants = SoftmaxConstants(op);
+  step.softmax_scratch_size =
+      Format("esp_nn_get_softmax_scratch_size(%d, 1)", depth);
+  step.call = Format(
+      "esp_nn_softmax_s8($in, %d, %d, %s::kSoftmaxMultiplier,\n"
+      "                    %s::kSoftmaxShift, %s::kSoftmaxDiffMin, $out);",
+      in.FlatSize() / depth, depth, ns.c_str(), ns.c_str(), ns.c_str());
+  steps_.push_back(step);
+}
+
+void Generator::Run() {
+  if (model_->subgraphs()->size() != 1) {
+    Fail("only single subgraph models are supported");
+  }
+  subgraph_ = model_->subgraphs()->Get(0);
+  if (subgraph_->inputs()->size() != 1 || subgraph_->outputs()->size() != 1) {
+    Fail("the model needs one input and one output");
+  }
+
+  for (const tflite::Tensor* tensor : *subgraph_->tensors()) {
+    Tensor t;
+    t.type = tensor->type();
+    t.alias = static_cast<int>(tensors_.size());
+    if (tensor->shape() != nullptr) {
+      t.shape.assign(tensor->shape()->begin(), tensor->shape()->end());
+    }
+    if (const auto* quantization = tensor->quantization()) {
+      if (quantization->scale() != nullptr) {
+        t.scales.assign(quantization->scale()->begin(),
+                        quantization->scale()->end());
+      }
+      if (quantization->zero_point() != nullptr &&
+          quantization->zero_point()->size() > 0) {
+        t.zero_point = quantization->zero_point()->Get(0);
+      }
+    }
+    const auto* data = model_->buffers()->Get(tensor->buffer())->data();
+    if (data != nullptr && data->size() > 0) {
+      t.location = kWeights;
+      t.weights_offset = data->data() - g_person_detect_model_data;
+    }
+    tensors_.push_back(t);
+  }
+  Tensor& input = tensors_[subgraph_->inputs()->Get(0)];
+  Tensor& output = tensors_[subgraph_->outputs()->Get(0)];
+  input.location = kModelInput;
+  output.location = kModelOutput;
+  if (input.type != tflite::TensorType_UINT8 ||
+      output.type != tflite::TensorType_UINT8) {
+    Fail("ModelAotInvoke() takes a uint8 input and output");
+  }
+
+  const int op_count = subgraph_->operators()->size();
+  int op = 0;
+  while (op < op_count) {
+    const tflite::BuiltinOperator code = Code(op);
+    const Tensor& in = tensors_[Input(op, 0)];
+    const Tensor& out = tensors_[Output(op)];
+    if (in.shape.empty() || in.shape[0] != 1) {
+      Fail("operator %d: only batch 1 is supported", op);
+    }
+    if (code != tflite::BuiltinOperator_QUANTIZE &&
+        out.type != tflite::TensorType_INT8) {
+      Fail("operator %d: only int8 kernels are supported", op);
+    }
+
+    switch (code) {
+      case tflite::BuiltinOperator_RESHAPE:
+        // The data stays where it is under another shape.
+        if (in.location != kInArena || out.location != kInArena) {
+          Fail("operator %d: RESHAPE of the model input or output", op);
+        }
+        tensors_[Output(op)].alias = in.alias;
+        break;
+      case tflite::BuiltinOperator_QUANTIZE:
+        AddQuantize(op);
+        break;
+      case tflite::BuiltinOperator_CONV_2D:
+        AddConv(op);
+        break;
+      case tflite::BuiltinOperator_MAX_POOL_2D:
+      case tflite::BuiltinOperator_AVERAGE_POOL_2D:
+        AddPool(op);
+        break;
+      case tflite::BuiltinOperator_FULLY_CONNECTED:
+        AddFullyConnected(op);
+        break;
+      case tflite::BuiltinOperator_SOFTMAX:
+        AddSoftmax(op);
+        break;
+      default:
+        Fail("operator %d: %s is not supported", op,
+             tflite::EnumNameBuiltinOperator(code));
+    }
+    // Fused operators always follow the one they are fused with.
+    op = steps_.empty() ? op + 1 : std::max(op + 1, steps_.back().last_op + 1);
+  }
+  Plan();
+}
+
+// Plans every arena tensor and scratch buffer over the steps using it, like
+// the interpreter does over nodes.
+void Generator::Plan() {
+  for (int s = 0; s < static_cast<int>(steps_.size()); s++) {
+    for (int tensor : {steps_[s].input, steps_[s].output}) {
+      Tensor& t = tensors_[tensors_[tensor].alias];
+      if (t.first_step == -1) {
+        t.first_step = s;
+      }
+      t.last_step = s;
+    }
+  }
+
+  struct Buffer {
+    int size;
+    int first_step;
+    int last_step;
+    int* offset;
+  };
+  std::vector<Buffer> buffers;
+  for (Tensor& t : tensors_) {
+    if (t.location == kInArena && t.first_step != -1) {
+      buffers.push_back(
+          {AlignUp(t.FlatSize()), t.first_step, t.last_step, &t.offset});
+    }
+  }
+  for (int s = 0; s < static_cast<int>(steps_.size()); s++) {
+    if (steps_[s].scratch_size > 0) {
+      buffers.push_back(
+          {AlignUp(steps_[s].scratch_size), s, s, &steps_[s].scratch_offset});
+    }
+  }
+
+  std::vector<unsigned char> planner_memory(
+      tflite::GreedyMemoryPlanner::per_buffer_size() * buffers.size());
+  tflite::GreedyMemoryPlanner planner;
+  planner.Init(planner_memory.data(), planner_memory.size());
+  for (const Buffer& buffer : buffers) {
+    if (planner.AddBuffer(buffer.size, buffer.first_step, buffer.last_step) !=
+        kTfLiteOk) {
+      Fail("memory planning failed");
+    }
+  }
+  for (size_t i = 0; i < buffers.size(); i++) {
+    planner.GetOffsetForBuffer(i, buffers[i].offset);
+  }
+  activations_size_ = AlignUp(planner.GetMaximumMemorySize());
+}
+
+std::string Generator::Emit() const {
+  std::string out =
+      "/*\n"
+      " * SPDX-License-Identifier: Apache-2.0\n"
+      " */\n"
+      "\n"
+      "// Generated by `model_aot_gen main/model_aot.cc` from\n"
+      "// person_detect_model_data.cc, do not edit. See model_aot.h.\n"
+      "\n"
+      "#include \"model_aot.h\"\n"
+      "\n"
+      "#include <algorithm>\n"
+      "\n"
+      "#include \"model_aot_ops.h\"\n"
+      "#include \"person_detect_model_data.h\"\n"
+      "\n"
+      "namespace {\n"
+      "\n";
+  out += Format(
+      "constexpr int kModelSize = %d;\n"
+      "constexpr uint32_t kModelHash = 0x%08x;\n"
+      "\n"
+      "// Planned activations and scratch buffers, followed by the esp-nn\n"
+      "// scratch buffer.\n"
+      "constexpr size_t kActivationsSize = %d;\n"
+      "constexpr uintptr_t kAlignment = %d;\n"
+      "\n"
+      "template <typename T>\n"
+      "const T* Weights(size_t offset) {\n"
+      "  return reinterpret_cast<const T*>(g_person_detect_model_data + "
+      "offset);\n"
+      "}\n",
+      g_person_detect_model_data_len,
+      Fnv1a(g_person_detect_model_data, g_person_detect_model_data_len),
+      activations_size_, kAlignment);
+  for (const Step& step : steps_) {
+    if (step.constants.empty()) {
+      continue;
+    }
+    const std::string ns = step.Namespace();
+    out += Format("\n// %s, %s\nnamespace %s {\n\n", step.comment.c_str(),
+                  step.Operators().c_str(), ns.c_str());
+    out += step.constants;
+    out += Format("\n}  // namespace %s\n", ns.c_str());
+  }
+  out += "\n}  // namespace\n";
+
+  out +=
+      "\n"
+      "size_t ModelAotArenaSize() {\n"
+      "  int32_t scratch = 0;\n";
+  for (const Step& step : steps_) {
+    for (const std::string* size :
+         {&step.conv_scratch_size, &step.softmax_scratch_size}) {
+      if (!size->empty()) {
+        out += Format("  scratch = std::max(scratch, %s);\n", size->c_str());
+      }
+    }
+  }
+  out +=
+      "  return kAlignment - 1 + kActivationsSize + scratch;\n"
+      "}\n"
+      "\n"
+      "bool ModelAotCheck() {\n"
+      "  if (g_person_detect_model_data_len != kModelSize) {\n"
+      "    return false;\n"
+      "  }\n"
+      "  uint32_t hash = 2166136261u;\n"
+      "  for (int i = 0; i < kModelSize; i++) {\n"
+      "    hash = (hash ^ g_person_detect_model_data[i]) * 16777619u;\n"
+      "  }\n"
+      "  return hash == kModelHash;\n"
+      "}\n"
+      "\n"
+      "void ModelAotInvoke(uint8_t* arena, const uint8_t* input, "
+      "uint8_t* output) {\n"
+      "  int8_t* const activations = reinterpret_cast<int8_t*>(\n"
+      "      (reinterpret_cast<uintptr_t>(arena) + kAlignment - 1) &\n"
+      "      ~(kAlignment - 1));\n"
+      "  esp_nn_set_conv_scratch_buf(activations + kActivationsSize);\n"
+      "  esp_nn_set_softmax_scratch_buf(activations + kActivationsSize);\n"
+      "\n";
+  for (size_t i = 0; i < tensors_.size(); i++) {
+    const Tensor& t = tensors_[i];
+    if (t.offset != -1) {
+      out += Format("  int8_t* const tensor%zu = activations + %d;  // %s\n",
+                    i, t.offset, ShapeString(t.shape).c_str());
+    }
+  }
+  for (const Step& step : steps_) {
+    if (step.scratch_offset != -1) {
+      out += Format("  int8_t* const %s = activations + %d;\n",
+                    step.scratch_name.c_str(), step.scratch_offset);
+    }
+  }
+
+  auto location = [&](int tensor) {
+    const Tensor& t = tensors_[tensor];
+    switch (t.location) {
+      case kModelInput:
+        return std::string("input");
+      case kModelOutput:
+        return std::string("output");
+      default:
+        return Format("tensor%d", t.alias);
+    }
+  };
+  for (const Step& step : steps_) {
+    std::string call = step.call;
+    Replace(&call, "$in", location(step.input));
+    Replace(&call, "$out", location(step.output));
+    Replace(&call, "$scratch", step.scratch_name);
+    out += Format("\n  // %s, %s\n", step.comment.c_str(),
+                  step.Operators().c_str());
+    out += "  " + call + "\n";
+  }
+  out += "}\n";
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool check = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (path == nullptr) {
+    fprintf(stderr, "usage: %s [--check] main/model_aot.cc\n", argv[0]);
+    return 2;
+  }
+
+  const tflite::Model* model = tflite::GetModel(g_person_detect_model_data);
+  Generator generator(model);
+  generator.Run();
+  const std::string source = generator.Emit();
+
+  if (check) {
+    std::string current;
+    if (FILE* file = fopen(path, "r")) {
+      char buffer[4096];
+      size_t n;
+      while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        current.append(buffer, n);
+      }
+      fclose(file);
+    }
+    if (current != source) {
+      printf("%s is out of date, regenerate it with `model_aot_gen %s`\n",
+             path, path);
+      return 1;
+    }
+    printf("%s is up to date\n", path);
+    return 0;
+  }
+
+  FILE* file = fopen(path, "w");
+  if (file == nullptr) {
+    perror(path);
+    return 1;
+  }
+  fwrite(source.data(), 1, source.size(), file);
+  if (fclose(file) != 0) {
+    perror(path);
+    return 1;
+  }
+  printf("wrote %s\n", path);
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Offline scorer for recorded frames. Feeds raw 96x96 frames through the
+// model N at a time with run_inference_batch(), prints every frame's scores
+// as CSV and the throughput.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "esp_main.h"
+#include "esp_timer.h"
+#include "frame_source.h"
+#include "main_functions.h"
+#include "model_settings.h"
+#include "slow_weight_memory.h"
+
+namespace {
+
+void Usage(const char* prog) {
+  fprintf(stderr,
+          "usage: %s [--batch N] [--threads N] [--row-bands N]\n"
+          "          [--weight-tile BYTES] [--slow-weights NS] [--quiet]\n"
+          "          <frame dir or file>...\n"
+          "  --batch N       frames per inference (default 8)\n"
+          "  --threads N     split layers across N threads (default 1)\n"
+          "  --row-bands N   run the first N conv and pool stages row band by\n"
+          "                  row band\n"
+          "  --weight-tile BYTES\n"
+          "                  stream conv and FC weights through two arena\n"
+          "                  tiles of at most BYTES each\n"
+          "  --slow-weights NS\n"
+          "                  simulate weights in slow memory that takes NS\n"
+          "                  nanoseconds per byte to read\n"
+          "  --quiet         only print the summary\n",
+          prog);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int batch = 8;
+  bool slow_weights = false;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+      batch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      parallel_workers_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--row-bands") == 0 && i + 1 < argc) {
+      row_band_stages_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--weight-tile") == 0 && i + 1 < argc) {
+      weight_tiling_set(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--slow-weights") == 0 && i + 1 < argc) {
+      SlowWeightMemoryInstall(atoi(argv[++i]));
+      slow_weights = true;
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      quiet = true;
+    } else if (argv[i][0] == '-') {
+      Usage(argv[0]);
+      return 2;
+    } else if (FrameSourceAdd(argv[i]) < 0) {
+      return 1;
+    }
+  }
+  if (FrameSourceCount() == 0 || batch < 1) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  batch_size_set(batch);
+  setup();
+  batch = batch_size_get();
+
+  const int count = FrameSourceCount();
+  std::vector<uint8_t> frames(batch * kMaxImageSize);
+  std::vector<uint8_t> scores(count * kCategoryCount);
+  const int64_t start = esp_timer_get_time();
+  for (int first = 0; first < count; first += batch) {
+    const int n = std::min(batch, count - first);
+    for (int i = 0; i < n; i++) {
+      memcpy(&frames[i * kMaxImageSize], FrameSourceFrame(first + i), kMaxImageSize);
+    }
+    if (run_inference_batch(frames.data(), n, &scores[first * kCategoryCount]) != 0) {
+      fprintf(stderr, "Scoring frames %d to %d failed\n", first, first + n - 1);
+      return 1;
+    }
+  }
+  const int64_t wall_us = std::max<int64_t>(1, esp_timer_get_time() - start);
+
+  if (!quiet) {
+    printf("frame,category");
+    for (int c = 0; c < kCategoryCount; c++) {
+      printf(",%s", kCategoryLabels[c]);
+    }
+    printf("\n");
+    for (int i = 0; i < count; i++) {
+      const uint8_t* frame_scores = &scores[i * kCategoryCount];
+      const int top = std::max_element(frame_scores, frame_scores + kCategoryCount) - frame_scores;
+      printf("%s,%s", FrameSourceName(i), kCategoryLabels[top]);
+      for (int c = 0; c < kCategoryCount; c++) {
+        printf(",%u", frame_scores[c]);
+      }
+      printf("\n");
+    }
+  }
+  printf("scored: frames=%d batch=%d inferences=%d wall_us=%lld fps=%.2f\n", count,
+         batch, (count + batch - 1) / batch, (long long) wall_us, count * 1e6 / wall_us);
+  if (slow_weights) {
+    SlowWeightMemoryPrintStats();
+  }
+  return 0;
+}
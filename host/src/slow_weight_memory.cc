@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "slow_weight_memory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "tensorflow/lite/micro/kernels/esp_nn/weight_stream.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int latency_ns_per_byte = 0;
+// When the last copy started is done.
+Clock::time_point copy_done;
+uint64_t bytes_in_place = 0;
+uint64_t bytes_copied = 0;
+Clock::duration in_place_stalled{0};
+Clock::duration copy_time{0};
+Clock::duration copy_stalled{0};
+
+// Busy waits, as the core would stall on the memory, so that the stall
+// shows in the inference latency like a real one.
+void StallUntil(Clock::time_point deadline, Clock::duration* stalled) {
+  const Clock::time_point start = Clock::now();
+  if (deadline <= start) {
+    return;
+  }
+  while (Clock::now() < deadline) {
+  }
+  *stalled += Clock::now() - start;
+}
+
+long long Microseconds(Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+
+Clock::duration Latency(size_t bytes) {
+  return std::chrono::nanoseconds(static_cast<int64_t>(bytes) *
+                                  latency_ns_per_byte);
+}
+
+void CopyStart(void* dst, const void* src, size_t bytes, void* user) {
+  // The data moves at once; the time it would take is only accounted.
+  memcpy(dst, src, bytes);
+  copy_done = std::max(copy_done, Clock::now()) + Latency(bytes);
+  copy_time += Latency(bytes);
+  bytes_copied += bytes;
+}
+
+void CopyWait(void* user) { StallUntil(copy_done, &copy_stalled); }
+
+void ReadInPlace(const void* src, size_t bytes, void* user) {
+  StallUntil(Clock::now() + Latency(bytes), &in_place_stalled);
+  bytes_in_place += bytes;
+}
+
+const tflite::WeightMemory kSlowWeightMemory = {CopyStart, CopyWait,
+                                                ReadInPlace, nullptr};
+
+}  // namespace
+
+void SlowWeightMemoryInstall(int ns_per_byte) {
+  latency_ns_per_byte = ns_per_byte;
+  tflite::SetWeightMemory(&kSlowWeightMemory);
+}
+
+void SlowWeightMemoryPrintStats() {
+  printf("weights: in_place=%llu stalled_us=%lld\n"
+         "weights: copied=%llu copy_us=%lld stalled_us=%lld hidden_us=%lld\n",
+         (unsigned long long) bytes_in_place, Microseconds(in_place_stalled),
+         (unsigned long long) bytes_copied, Microseconds(copy_time),
+         Microseconds(copy_stalled), Microseconds(copy_time - copy_stalled));
+}
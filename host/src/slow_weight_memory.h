@@ -0,0 +1,26 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PERSON_DETECTION_HOST_SLOW_WEIGHT_MEMORY_H_
+#define PERSON_DETECTION_HOST_SLOW_WEIGHT_MEMORY_H_
+
+#include <stdint.h>
+
+// Simulated slow weight memory for the host build, standing in for model
+// weights in memory-mapped flash. Reading weights costs `ns_per_byte`:
+// - in place, the kernel stalls for the whole read;
+// - through a weight tile copy, the copy runs like a DMA transfer in the
+//   background, back to back with the copies before it, and only
+//   copy_wait() stalls until it is done.
+// So with weight tiling (see weight_stream.h) the time spent computing one
+// tile hides the copy of the next.
+
+// Installs the simulated memory as the kernels' WeightMemory.
+void SlowWeightMemoryInstall(int ns_per_byte);
+
+// Prints the bytes read in place and through copies, the time the kernels
+// stalled waiting for them and how much of the copy time computing hid.
+void SlowWeightMemoryPrintStats();
+
+#endif  // PERSON_DETECTION_HOST_SLOW_WEIGHT_MEMORY_H_
@@ -70,11 +70,19 @@ int app_camera_init() {
 #endif // CONFIG_TFLITE_USE_BSP
 
   // Pixel format and frame size are specific configurations options for this application.
-  // Frame size must be 96x96 pixels to match the trained model.
+  // Frame size defaults to 96x96 pixels to match the trained model. Larger frames are cropped and downscaled to 96x96.
   // Pixel format defaults to grayscale to match the trained model.
   // With display support enabled, the pixel format is RGB565 to match the display. The frame is converted to grayscale before it is passed to the trained model.
   config.pixel_format = CAMERA_PIXEL_FORMAT;
   config.frame_size = CAMERA_FRAME_SIZE;
+#if CONFIG_TFLITE_CAMERA_DOWNSCALE
+  // The camera task reduces the frames to the model's 96x96 input as they are
+  // received, so the frame buffers are small enough for internal RAM.
+  config.downscale = (camera_downscale_config_t) {.out_width = 96, .out_height = 96};
+  config.fb_location = CAMERA_FB_IN_DRAM;
+#else
+  config.downscale = (camera_downscale_config_t) {0};
+#endif
 
   // camera init
   esp_err_t err = esp_camera_init(&config);
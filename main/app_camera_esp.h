@@ -30,7 +30,9 @@ limitations under the License.
  * PIXFORMAT_JPEG,      // JPEG/COMPRESSED
  * PIXFORMAT_RGB888,    // 3BPP/RGB888
  */
-#if defined DISPLAY_SUPPORT
+#if CONFIG_TFLITE_CAMERA_JPEG
+#define CAMERA_PIXEL_FORMAT PIXFORMAT_JPEG
+#elif defined DISPLAY_SUPPORT
 #define CAMERA_PIXEL_FORMAT PIXFORMAT_RGB565
 #else
 #define CAMERA_PIXEL_FORMAT PIXFORMAT_GRAYSCALE
@@ -49,7 +51,13 @@ limitations under the License.
  * FRAMESIZE_SXGA,     // 1280x1024
  * FRAMESIZE_UXGA,     // 1600x1200
  */
+#if CONFIG_TFLITE_CAMERA_FRAME_SIZE_QVGA
+#define CAMERA_FRAME_SIZE FRAMESIZE_QVGA
+#elif CONFIG_TFLITE_CAMERA_FRAME_SIZE_QQVGA
+#define CAMERA_FRAME_SIZE FRAMESIZE_QQVGA
+#else
 #define CAMERA_FRAME_SIZE FRAMESIZE_96X96
+#endif
 
 #if CONFIG_CAMERA_MODULE_WROVER_KIT
 #define CAMERA_MODULE_NAME "Wrover Kit"
@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "arena_sizing.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
+
+#include <esp_heap_caps.h>
+#include "sdkconfig.h"
+
+namespace {
+
+uint8_t* AllocateProbe(size_t size) {
+  // The probe is much larger than the real arena; keep it out of internal
+  // RAM where there is some.
+  uint8_t* buffer =
+      static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM));
+  if (buffer == nullptr) {
+    buffer = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_8BIT));
+  }
+  return buffer;
+}
+
+TfLiteStatus RecordAllocations(const tflite::Model* model,
+                               const tflite::MicroOpResolver& op_resolver,
+                               uint8_t* arena, size_t arena_size, bool verbose,
+                               ArenaUsage* usage) {
+  tflite::RecordingMicroInterpreter interpreter(model, op_resolver, arena,
+                                                arena_size);
+  TF_LITE_ENSURE_STATUS(interpreter.AllocateTensors());
+
+  const tflite::RecordingMicroAllocator& allocator =
+      interpreter.GetMicroAllocator();
+  const tflite::RecordedAllocation scratch = allocator.GetRecordedAllocation(
+      tflite::RecordedAllocationType::kScratchBufferData);
+  usage->scratch = scratch.used_bytes;
+  usage->scratch_buffers = scratch.count;
+  usage->non_persistent =
+      allocator.GetSimpleMemoryAllocator()->GetNonPersistentUsedBytes();
+  if (verbose) {
+    allocator.PrintAllocations();
+  }
+  return kTfLiteOk;
+}
+
+// Arena bytes a plain MicroInterpreter needs. The recording interpreter's
+// own objects are bigger, so its total can't be used as is.
+TfLiteStatus UsedBytes(const tflite::Model* model,
+                       const tflite::MicroOpResolver& op_resolver,
+                       uint8_t* arena, size_t arena_size, size_t* used) {
+  tflite::MicroInterpreter interpreter(model, op_resolver, arena, arena_size);
+  TF_LITE_ENSURE_STATUS(interpreter.AllocateTensors());
+  *used = interpreter.arena_used_bytes();
+  return kTfLiteOk;
+}
+
+// Persistent and non-persistent bytes with the two in separate arenas,
+// taken from the two halves of `arena`.
+TfLiteStatus SplitUsedBytes(const tflite::Model* model,
+                            const tflite::MicroOpResolver& op_resolver,
+                            uint8_t* arena, size_t arena_size,
+                            size_t* persistent, size_t* non_persistent) {
+  tflite::GreedyMemoryPlanner planner;
+  const size_t half = arena_size / 2;
+  tflite::MicroAllocator* allocator = tflite::MicroAllocator::Create(
+      arena, half, arena + half, arena_size - half, &planner);
+  tflite::MicroInterpreter interpreter(model, op_resolver, allocator);
+  TF_LITE_ENSURE_STATUS(interpreter.AllocateTensors());
+  *persistent = allocator->persistent_used_bytes();
+  *non_persistent = allocator->non_persistent_used_bytes();
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteStatus MeasureArena(const tflite::Model* model,
+                          const tflite::MicroOpResolver& op_resolver,
+                          size_t probe_size, bool verbose, ArenaUsage* usage) {
+  uint8_t* probe = AllocateProbe(probe_size);
+  if (probe == nullptr) {
+    MicroPrintf("Couldn't allocate a %u byte probe arena",
+                static_cast<unsigned>(probe_size));
+    return kTfLiteError;
+  }
+
+  TfLiteStatus status = RecordAllocations(model, op_resolver, probe,
+                                          probe_size, verbose, usage);
+  if (status == kTfLiteOk) {
+    status = UsedBytes(model, op_resolver, probe, probe_size, &usage->used);
+  }
+  size_t split_persistent = 0;
+  size_t split_non_persistent = 0;
+  if (status == kTfLiteOk) {
+    status = SplitUsedBytes(model, op_resolver, probe, probe_size,
+                            &split_persistent, &split_non_persistent);
+  }
+  heap_caps_free(probe);
+  if (status != kTfLiteOk) {
+    MicroPrintf("AllocateTensors() failed in the probe arena");
+    return status;
+  }
+
+  // The head starts at the first aligned address and the tail ends at the
+  // last one, so a misaligned arena loses up to one alignment at each end.
+  const size_t alignment = tflite::MicroArenaBufferAlignment();
+  usage->persistent = usage->used - usage->non_persistent;
+  usage->required = tflite::AlignSizeUp(usage->used, alignment) + alignment;
+  usage->required_persistent =
+      tflite::AlignSizeUp(split_persistent, alignment) + alignment;
+  usage->required_non_persistent =
+      tflite::AlignSizeUp(split_non_persistent, alignment) + alignment;
+
+  // Check the result the hard way, in an arena of exactly that size that
+  // starts one byte past an aligned address.
+  uint8_t* check = AllocateProbe(usage->required + alignment);
+  if (check == nullptr) {
+    MicroPrintf("Couldn't allocate a %u byte arena to verify the size",
+                static_cast<unsigned>(usage->required));
+    return kTfLiteError;
+  }
+  size_t used = 0;
+  status = UsedBytes(model, op_resolver,
+                     tflite::AlignPointerUp(check, alignment) + 1,
+                     usage->required, &used);
+  heap_caps_free(check);
+  if (status != kTfLiteOk) {
+    MicroPrintf("AllocateTensors() failed in a %u byte arena",
+                static_cast<unsigned>(usage->required));
+    return status;
+  }
+  return kTfLiteOk;
+}
+
+void PrintArenaUsage(const ArenaUsage& usage) {
+  printf("arena: persistent=%u non_persistent=%u scratch=%u (%d buffers) "
+         "used=%u required=%u verified\n"
+         "arena: split required_persistent=%u required_non_persistent=%u\n",
+         static_cast<unsigned>(usage.persistent),
+         static_cast<unsigned>(usage.non_persistent),
+         static_cast<unsigned>(usage.scratch), usage.scratch_buffers,
+         static_cast<unsigned>(usage.used),
+         static_cast<unsigned>(usage.required),
+         static_cast<unsigned>(usage.required_persistent),
+         static_cast<unsigned>(usage.required_non_persistent));
+}
+
+const char* ArenaSizeTarget() {
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+  return "ESP32S3";
+#elif defined(CONFIG_IDF_TARGET_ESP32P4)
+  return "ESP32P4";
+#else
+  return "GENERIC";
+#endif
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Tensor arena sizing. Runs AllocateTensors() once with a
+// RecordingMicroInterpreter in an oversized probe arena to break the arena
+// down per subsystem, then once with a plain MicroInterpreter to get the
+// exact number of bytes the real interpreter needs, and finally checks that
+// an arena of the reported size really is enough. A last run with separate
+// persistent and non-persistent arenas sizes the split arena.
+//
+// The result only holds for the target it was measured on: kernels request
+// scratch buffers sized for their own implementation (the esp32s3/esp32p4
+// esp-nn kernels do, the generic ones don't), so every target needs its own
+// measurement. ArenaSizeTarget() names the <TARGET> suffix of the
+// main/tensor_arena_size.h macros the measurement belongs in.
+
+#ifndef ARENA_SIZING_H_
+#define ARENA_SIZING_H_
+
+#include <cstddef>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+struct ArenaUsage {
+  // Tail of the arena: the interpreter's own objects, tensor and node
+  // structs, op data and every other buffer that lives as long as the
+  // interpreter.
+  size_t persistent;
+  // Head of the arena: activations and scratch buffers, as planned by the
+  // memory planner.
+  size_t non_persistent;
+  // Part of the head kernels asked for through RequestScratchBufferInArena().
+  size_t scratch;
+  int scratch_buffers;
+  // Bytes a plain MicroInterpreter uses, i.e. arena_used_bytes().
+  size_t used;
+  // Smallest arena to allocate: `used` plus room to align the head and tail
+  // of an arena that doesn't start on a buffer alignment boundary.
+  size_t required;
+  // The same for separate persistent and non-persistent arenas (see
+  // MicroAllocator::Create()), with the memory planner outside of both.
+  size_t required_persistent;
+  size_t required_non_persistent;
+};
+
+// Measures `model` using a temporary probe_size bytes arena. The probe arena
+// is released before returning, so call this before allocating the real one
+// when memory is tight. Prints the per-subsystem breakdown if `verbose`.
+TfLiteStatus MeasureArena(const tflite::Model* model,
+                          const tflite::MicroOpResolver& op_resolver,
+                          size_t probe_size, bool verbose, ArenaUsage* usage);
+
+// Prints the one-line summary of `usage`.
+void PrintArenaUsage(const ArenaUsage& usage);
+
+// "ESP32S3", "ESP32P4" or "GENERIC" for every other target, the host
+// included.
+const char* ArenaSizeTarget();
+
+#endif  // ARENA_SIZING_H_
@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "autotune_nvs_cache.h"
+
+#include <cstdio>
+
+#include <esp_log.h>
+#include <nvs.h>
+#include <nvs_flash.h>
+
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+
+namespace {
+
+const char* TAG = "autotune_nvs";
+
+nvs_handle_t handle;
+
+void Key(uint32_t key, char* name) {
+  // NVS keys are at most 15 characters.
+  snprintf(name, NVS_KEY_NAME_MAX_SIZE, "%08lx", (unsigned long) key);
+}
+
+bool Load(uint32_t key, uint8_t* choice, void* user) {
+  char name[NVS_KEY_NAME_MAX_SIZE];
+  Key(key, name);
+  return nvs_get_u8(handle, name, choice) == ESP_OK;
+}
+
+void Store(uint32_t key, uint8_t choice, void* user) {
+  char name[NVS_KEY_NAME_MAX_SIZE];
+  Key(key, name);
+  if (nvs_set_u8(handle, name, choice) != ESP_OK ||
+      nvs_commit(handle) != ESP_OK) {
+    ESP_LOGW(TAG, "Couldn't store the choice of %s", name);
+  }
+}
+
+const tflite::AutotuneCache cache = {Load, Store, nullptr};
+
+}  // namespace
+
+void AutotuneNvsCacheInstall() {
+  esp_err_t err = nvs_flash_init();
+  if (err == ESP_ERR_NVS_NO_FREE_PAGES ||
+      err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+    ESP_ERROR_CHECK(nvs_flash_erase());
+    err = nvs_flash_init();
+  }
+  if (err == ESP_OK) {
+    err = nvs_open("autotune", NVS_READWRITE, &handle);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGW(TAG, "No NVS (%s), tuning without a cache",
+             esp_err_to_name(err));
+    return;
+  }
+  tflite::SetAutotuneCache(&cache);
+}
@@ -0,0 +1,15 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Keeps the kernel autotuning choices (see autotune.h) in NVS, so that only
+// the first boot of a firmware tunes its layers.
+
+#ifndef AUTOTUNE_NVS_CACHE_H_
+#define AUTOTUNE_NVS_CACHE_H_
+
+// Initializes NVS, erasing it if its layout is stale, and installs the cache.
+// Without NVS the kernels are tuned at every boot.
+void AutotuneNvsCacheInstall();
+
+#endif  // AUTOTUNE_NVS_CACHE_H_
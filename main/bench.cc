@@ -0,0 +1,191 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "bench.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include "esp_main.h"
+#include "model_settings.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+namespace {
+
+// Yield this often during a long run, to keep the task watchdog fed.
+constexpr int64_t kYieldIntervalUs = 1000000;
+
+int TopCategory(const uint8_t* scores) {
+  return std::max_element(scores, scores + kCategoryCount) - scores;
+}
+
+// Nearest-rank percentile of the sorted `latencies`.
+int64_t Percentile(const std::vector<int64_t>& latencies, int percent) {
+  const size_t rank = (latencies.size() * percent + 99) / 100;
+  return latencies[rank > 0 ? rank - 1 : 0];
+}
+
+// Prints `text` as a JSON string, quotes included.
+void PrintJsonString(const char* text) {
+  putchar('"');
+  for (const char* c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      printf("\\%c", *c);
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      printf("\\u%04x", static_cast<unsigned char>(*c));
+    } else {
+      putchar(*c);
+    }
+  }
+  putchar('"');
+}
+
+}  // namespace
+
+int bench_run(const bench_config_t* config) {
+  if (config == nullptr || config->frames == nullptr || config->count < 1 ||
+      config->warmup < 0 || config->runs < 1) {
+    return -1;
+  }
+  const int count = config->count;
+
+  // int8 frames are shifted into this buffer outside the timed region.
+  std::vector<uint8_t> shifted(config->xor_mask != 0 ? kMaxImageSize : 0);
+  auto frame = [&](int index) {
+    const uint8_t* data = config->frames[index];
+    if (shifted.empty()) {
+      return data;
+    }
+    for (int i = 0; i < kMaxImageSize; i++) {
+      shifted[i] = data[i] ^ config->xor_mask;
+    }
+    return static_cast<const uint8_t*>(shifted.data());
+  };
+
+  uint8_t scores[kCategoryCount];
+  int64_t last_yield = esp_timer_get_time();
+  auto maybe_yield = [&]() {
+    if (esp_timer_get_time() - last_yield >= kYieldIntervalUs) {
+      vTaskDelay(1);
+      last_yield = esp_timer_get_time();
+    }
+  };
+
+  for (int pass = 0; pass < config->warmup; pass++) {
+    for (int i = 0; i < count; i++) {
+      if (run_inference_batch(frame(i), 1, scores) != 0) {
+        return -1;
+      }
+      maybe_yield();
+    }
+  }
+
+  // The per-op profile only covers the timed passes.
+  profile_reset();
+  std::vector<int64_t> latencies;
+  latencies.reserve(static_cast<size_t>(count) * config->runs);
+  std::vector<int> top(count, -1);
+  for (int pass = 0; pass < config->runs; pass++) {
+    for (int i = 0; i < count; i++) {
+      const uint8_t* input = frame(i);
+      const int64_t start = esp_timer_get_time();
+      const int status = run_inference_batch(input, 1, scores);
+      latencies.push_back(esp_timer_get_time() - start);
+      if (status != 0) {
+        return -1;
+      }
+      top[i] = TopCategory(scores);
+      maybe_yield();
+    }
+  }
+
+  int64_t sum = 0;
+  for (int64_t latency : latencies) {
+    sum += latency;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const int64_t mean = sum / static_cast<int64_t>(latencies.size());
+
+  // Labels outside the model's categories count as none.
+  auto label = [&](int index) {
+    const int value = config->labels != nullptr ? config->labels[index] : -1;
+    return value >= 0 && value < kCategoryCount ? value : -1;
+  };
+  int labelled = 0;
+  int correct = 0;
+  for (int i = 0; i < count; i++) {
+    if (label(i) >= 0) {
+      labelled++;
+      correct += top[i] == label(i);
+    }
+  }
+
+  const size_t internal_total = heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+  const size_t internal_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  const size_t spiram_total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+  const size_t spiram_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+
+  auto name = [&](int index) {
+    return config->names != nullptr && config->names[index] != nullptr
+               ? config->names[index]
+               : "";
+  };
+
+  if (config->json) {
+    printf("{\"frames\":%d,\"warmup\":%d,\"runs\":%d,\"inferences\":%zu,"
+           "\"latency_us\":{\"min\":%" PRId64 ",\"median\":%" PRId64
+           ",\"p99\":%" PRId64 ",\"max\":%" PRId64 ",\"mean\":%" PRId64 "},",
+           count, config->warmup, config->runs, latencies.size(), latencies.front(),
+           Percentile(latencies, 50), Percentile(latencies, 99), latencies.back(), mean);
+    printf("\"accuracy\":{\"labelled\":%d,\"correct\":%d,\"top1\":%.4f,\"misses\":[",
+           labelled, correct, labelled != 0 ? static_cast<double>(correct) / labelled : 0.0);
+    bool first = true;
+    for (int i = 0; i < count; i++) {
+      if (label(i) >= 0 && top[i] != label(i)) {
+        printf("%s{\"frame\":", first ? "" : ",");
+        PrintJsonString(name(i));
+        printf(",\"label\":%d,\"top1\":%d}", label(i), top[i]);
+        first = false;
+      }
+    }
+    printf("]},\"heap\":{\"internal_total\":%zu,\"internal_min_free\":%zu,"
+           "\"internal_peak\":%zu,\"spiram_total\":%zu,\"spiram_min_free\":%zu,"
+           "\"spiram_peak\":%zu},\"ops\":",
+           internal_total, internal_min_free, internal_total - internal_min_free,
+           spiram_total, spiram_min_free, spiram_total - spiram_min_free);
+    profile_print_ops(1);
+    printf("}\n");
+    return 0;
+  }
+
+  printf("bench: frames=%d warmup=%d runs=%d inferences=%zu\n", count, config->warmup,
+         config->runs, latencies.size());
+  printf("bench: latency_us min=%" PRId64 " median=%" PRId64 " p99=%" PRId64
+         " max=%" PRId64 " mean=%" PRId64 "\n",
+         latencies.front(), Percentile(latencies, 50), Percentile(latencies, 99),
+         latencies.back(), mean);
+  if (labelled != 0) {
+    printf("bench: top1 %d/%d (%.1f%%)\n", correct, labelled, 100.0 * correct / labelled);
+    for (int i = 0; i < count; i++) {
+      if (label(i) >= 0 && top[i] != label(i)) {
+        printf("bench: miss %s label=%s top1=%s\n", name(i), kCategoryLabels[label(i)],
+               kCategoryLabels[top[i]]);
+      }
+    }
+  } else {
+    printf("bench: top1 no labelled frames\n");
+  }
+  printf("bench: heap_peak internal=%zu spiram=%zu min_free internal=%zu spiram=%zu\n",
+         internal_total - internal_min_free, spiram_total - spiram_min_free,
+         internal_min_free, spiram_min_free);
+  profile_print_ops(0);
+  return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Inference benchmark over a set of frames, for the `bench` console command
+// and the host runner's --bench. Frames are inferred one at a time with
+// run_inference_batch(), so without run_inference()'s printing and delay,
+// first `warmup` passes over all of them untimed and then `runs` timed
+// passes. Reports the latency distribution, the per-op profile of the timed
+// passes, top-1 accuracy on the labelled frames and the heap high-water
+// marks, as text or as one line of JSON for CI.
+//
+// The heap figures are the minimum free sizes since boot, so they cover the
+// interpreter's setup as well as the benchmark.
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const uint8_t *const *frames;   // count frames of kMaxImageSize bytes
+    const int *labels;              // category of every frame, -1 if none; may be NULL
+    const char *const *names;       // may be NULL
+    int count;
+    int warmup;                     // untimed passes over all frames
+    int runs;                       // timed passes over all frames
+    int json;
+    uint8_t xor_mask;               // 0x80 for int8 frames, shifted back to uint8
+} bench_config_t;
+
+// Runs the benchmark and prints its report. Returns 0 on success, -1 if the
+// config is invalid or an inference fails.
+int bench_run(const bench_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BENCH_H_
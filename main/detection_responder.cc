@@ -60,42 +60,60 @@ static void create_gui(void)
 }
 #endif // DISPLAY_SUPPORT
 
-void RespondToDetection(float* gesture_score) {
-  float max_score = 0;
+#if DISPLAY_SUPPORT
+static void UpdateDisplay(bool gesture) {
+  if (!camera_canvas) {
+    create_gui();
+  }
+
+  uint16_t *buf = (uint16_t *) image_provider_get_display_buf();
+
+  bsp_display_lock(0);
+  if (gesture) {
+    lv_led_on(person_indicator);
+  } else {
+    lv_led_off(person_indicator);
+  }
+  lv_canvas_set_buffer(camera_canvas, buf, IMG_WD, IMG_HT, LV_IMG_CF_TRUE_COLOR);
+  bsp_display_unlock();
+}
+#endif // DISPLAY_SUPPORT
+
+void RespondToDetection(const float* gesture_score) {
+  // Dequantized scores can be negative, so start from the first one rather
+  // than from 0.
   int max_score_index = 0;
-  for (int i = 0; i < kCategoryCount; i++) {
-    if (gesture_score[i] > max_score) {
-      max_score = gesture_score[i];
+  for (int i = 1; i < kCategoryCount; i++) {
+    if (gesture_score[i] > gesture_score[max_score_index]) {
       max_score_index = i;
     }
   }
 #if DISPLAY_SUPPORT
-    if (!camera_canvas) {
-      create_gui();
-    }
-
-    uint16_t *buf = (uint16_t *) image_provider_get_display_buf();
-
-    bsp_display_lock(0);
-    if (person_score_int < 60) { // treat score less than 60% as no person
-      lv_led_off(person_indicator);
-    } else {
-      lv_led_on(person_indicator);
-    }
-    lv_canvas_set_buffer(camera_canvas, buf, IMG_WD, IMG_HT, LV_IMG_CF_TRUE_COLOR);
-    bsp_display_unlock();
+  UpdateDisplay(max_score_index != kBlankIndex);
 #endif // DISPLAY_SUPPORT
 
-  //for (int i = 0; i < kNumCols * kNumRows; i++) {
-  //  printf("%f, ", image[i]);
-  //}
-
   // Log the detected gesture.
   MicroPrintf("Detected gesture: %s", kCategoryLabels[max_score_index]);
-  
 
   // Print the scores of each gesture
   for (int i = 0; i < kCategoryCount; i++) {
     MicroPrintf("%s: %f", kCategoryLabels[i], gesture_score[i]);
   }
 }
+
+void RespondToGesture(const GestureResult& result) {
+  static bool was_idle = false;
+  if (result.idle != was_idle) {
+    MicroPrintf(result.idle ? "Idle, slowing down" : "Awake");
+    was_idle = result.idle;
+  }
+#if DISPLAY_SUPPORT
+  UpdateDisplay(result.category >= 0 && result.category != kBlankIndex);
+#endif // DISPLAY_SUPPORT
+  // Blank is no gesture; going idle is how a blank scene shows.
+  if (!result.is_new || result.category == kBlankIndex) {
+    return;
+  }
+  MicroPrintf("Detected gesture: %s (%f)", kCategoryLabels[result.category],
+              result.score);
+}
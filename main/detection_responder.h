@@ -19,14 +19,17 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_EXAMPLES_PERSON_DETECTION_DETECTION_RESPONDER_H_
 #define TENSORFLOW_LITE_MICRO_EXAMPLES_PERSON_DETECTION_DETECTION_RESPONDER_H_
 
+#include "gesture_recognizer.h"
 #include "tensorflow/lite/c/common.h"
 
-// Called every time the results of a person detection run are available. The
-// `person_score` has the numerical confidence that the captured image contains
-// a person, and `no_person_score` has the numerical confidence that the image
-// does not contain a person. Typically if person_score > no person score, the
-// image is considered to contain a person.  This threshold may be adjusted for
-// particular applications.
-void RespondToDetection(float* gesture_scores);
+// Called with the kCategoryCount dequantized scores of a single frame, such
+// as a static image of the console's detect_image. Logs the top category and
+// every score.
+void RespondToDetection(const float* gesture_scores);
+
+// Called with the recognizer's verdict on every camera frame. Only logs a
+// gesture other than Blank when it is newly recognised, and the changes of
+// the idle state.
+void RespondToGesture(const GestureResult& result);
 
 #endif  // TENSORFLOW_LITE_MICRO_EXAMPLES_PERSON_DETECTION_DETECTION_RESPONDER_H_
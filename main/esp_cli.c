@@ -19,25 +19,20 @@
 #include <esp_heap_caps.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_partition.h>
 
+#include "bench.h"
 #include "esp_main.h"
 #include "esp_cli.h"
 #include "esp_timer.h"
+#include "image_pack.h"
 
-#define IMAGE_COUNT 10
-static uint8_t *image_database[IMAGE_COUNT];
+// Data partition subtype of the image pack, next to the app in partitions.csv
+#define IMAGE_PACK_PARTITION_SUBTYPE 0x40
 
-
-extern const uint8_t image0_start[]   asm("_binary_image0_start");
-extern const uint8_t image1_start[]   asm("_binary_image1_start");
-extern const uint8_t image2_start[]   asm("_binary_image2_start");
-extern const uint8_t image3_start[]   asm("_binary_image3_start");
-extern const uint8_t image4_start[]   asm("_binary_image4_start");
-extern const uint8_t image5_start[]   asm("_binary_image5_start");
-extern const uint8_t image6_start[]   asm("_binary_image6_start");
-extern const uint8_t image7_start[]   asm("_binary_image7_start");
-extern const uint8_t image8_start[]   asm("_binary_image8_start");
-extern const uint8_t image9_start[]   asm("_binary_image9_start");
+// Frames for detect_image, read in place from the mapped `images` partition
+static image_pack_t image_pack;
+static int image_pack_mounted;
 
 static const char *TAG = "[esp_cli]";
 
@@ -106,21 +101,125 @@ static int inference_cli_handler(int argc, char *argv[])
     }
     int image_number = atoi(argv[1]);
 
-    if((image_number < 0) || (image_number >= IMAGE_COUNT)) {
-        ESP_LOGE(TAG, "Please Enter a valid Number ( 0 - %d)", IMAGE_COUNT-1);
+    if (!image_pack_mounted) {
+        ESP_LOGE(TAG, "No image pack in the images partition");
+        return -1;
+    }
+    if((image_number < 0) || ((uint32_t) image_number >= image_pack_count(&image_pack))) {
+        ESP_LOGE(TAG, "Please Enter a valid Number ( 0 - %d)", (int) image_pack_count(&image_pack) - 1);
         return -1;
     }
-   // char file_name[30];
-   // sprintf(file_name, "image%d.raw", image_number);
+    const char *name = image_pack_name(&image_pack, image_number);
+    int label = image_pack_label(&image_pack, image_number);
+    if (label >= 0) {
+        printf("%s, category %d\n", name ? name : "", label);
+    } else if (name) {
+        printf("%s\n", name);
+    }
+
+    // uint8 frames are inferred on where they are mapped, int8 ones shifted
+    // back to the model's uint8 input first.
+    const uint8_t *frame = image_pack_frame(&image_pack, image_number);
+    const uint32_t frame_size = image_pack.header->frame_size;
+    static uint8_t *shifted;
+    if (image_pack.header->pixel_type == IMAGE_PACK_INT8) {
+        if (!shifted && !(shifted = malloc(frame_size))) {
+            ESP_LOGE(TAG, "Memory not allocated for the frame.");
+            return -1;
+        }
+        for (uint32_t i = 0; i < frame_size; i++) {
+            shifted[i] = frame[i] ^ 0x80;
+        }
+        frame = shifted;
+    }
     unsigned detect_time;
     detect_time = esp_timer_get_time();
-    run_inference((void *)image_database[image_number]);
+    run_inference((void *)frame);
     detect_time = (esp_timer_get_time() - detect_time)/1000;
     ESP_LOGI(TAG,"Time required for the inference is %u ms", detect_time);
 
     return 0;
 }
 
+static int bench_cli_handler(int argc, char *argv[])
+{
+    /* Just to go to the next line */
+    printf("\n");
+    bench_config_t config = {
+        .warmup = 1,
+        .runs = 10,
+    };
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            config.warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            config.json = 1;
+        } else {
+            printf("%s: Incorrect arguments\n", TAG);
+            return 0;
+        }
+    }
+    if (!image_pack_mounted) {
+        ESP_LOGE(TAG, "No image pack in the images partition");
+        return -1;
+    }
+
+    const int count = image_pack_count(&image_pack);
+    const uint8_t **frames = malloc(count * sizeof(*frames));
+    int *labels = malloc(count * sizeof(*labels));
+    const char **names = malloc(count * sizeof(*names));
+    if (!frames || !labels || !names) {
+        ESP_LOGE(TAG, "Memory not allocated for the frame list.");
+        free(frames);
+        free(labels);
+        free(names);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        frames[i] = image_pack_frame(&image_pack, i);
+        labels[i] = image_pack_label(&image_pack, i);
+        names[i] = image_pack_name(&image_pack, i);
+    }
+    config.frames = frames;
+    config.labels = labels;
+    config.names = names;
+    config.count = count;
+    config.xor_mask = image_pack.header->pixel_type == IMAGE_PACK_INT8 ? 0x80 : 0;
+    if (bench_run(&config) != 0) {
+        ESP_LOGE(TAG, "Benchmark failed");
+    }
+    free(frames);
+    free(labels);
+    free(names);
+    return 0;
+}
+
+static int profile_cli_handler(int argc, char *argv[])
+{
+    /* Just to go to the next line */
+    printf("\n");
+    if (argc == 1) {
+        profile_print(0);
+    } else if (argc == 2 && strcmp(argv[1], "events") == 0) {
+        profile_print(1);
+    } else if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+        profile_reset();
+    } else {
+        printf("%s: Incorrect arguments\n", TAG);
+    }
+    return 0;
+}
+
+static int arena_cli_handler(int argc, char *argv[])
+{
+    /* Just to go to the next line */
+    printf("\n");
+    arena_print();
+    return 0;
+}
+
 static esp_console_cmd_t diag_cmds[] = {
     {
         .command = "mem-dump",
@@ -139,10 +238,31 @@ static esp_console_cmd_t diag_cmds[] = {
     },
     {
         .command = "detect_image",
-        .help = "detect_image <image_number>"
-                "Note: image numbers ranging from 0 - 9 only are valid",
+        .help = "detect_image <image_number>\n"
+                "Infer on a frame of the image pack in the images partition",
         .func = inference_cli_handler,
     },
+    {
+        .command = "bench",
+        .help = "bench [-w WARMUP] [-n RUNS] [-j]\n"
+                "Infer on every frame of the image pack WARMUP (default 1) times untimed, then RUNS "
+                "(default 10) times timed, and report latency min/median/p99, the per-op "
+                "profile, top-1 accuracy against the pack's labels and heap high-water marks. "
+                "-j prints one line of JSON",
+        .func = bench_cli_handler,
+    },
+    {
+        .command = "profile",
+        .help = "profile [events|reset]\n"
+                "Per-node cycles, MACs and bytes averaged over the inferences run so far. "
+                "'events' dumps the most recent node events as CSV, 'reset' clears them",
+        .func = profile_cli_handler,
+    },
+    {
+        .command = "arena",
+        .help = "Where every tensor arena buffer was placed, internal RAM (fast) or PSRAM (slow)",
+        .func = arena_cli_handler,
+    },
 };
 
 int esp_cli_register_cmds()
@@ -156,24 +276,42 @@ int esp_cli_register_cmds()
     return 0;
 }
 
-static void image_database_init()
+// Maps the whole `images` partition into the data address space for good,
+// so the frames can be handed to the interpreter without a copy.
+static void image_pack_mount()
 {
-    image_database[0] = (uint8_t *) image0_start;
-    image_database[1] = (uint8_t *) image1_start;
-    image_database[2] = (uint8_t *) image2_start;
-    image_database[3] = (uint8_t *) image3_start;
-    image_database[4] = (uint8_t *) image4_start;
-    image_database[5] = (uint8_t *) image5_start;
-    image_database[6] = (uint8_t *) image6_start;
-    image_database[7] = (uint8_t *) image7_start;
-    image_database[8] = (uint8_t *) image8_start;
-    image_database[9] = (uint8_t *) image9_start;
-
+    if (image_pack_mounted) {
+        return;
+    }
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                IMAGE_PACK_PARTITION_SUBTYPE, "images");
+    if (!partition) {
+        ESP_LOGW(TAG, "No images partition");
+        return;
+    }
+    const void *data;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA,
+                                       &data, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Can't map the images partition: %s", esp_err_to_name(err));
+        return;
+    }
+    int width, height, channels;
+    model_input_dims(&width, &height, &channels);
+    if (image_pack_open(&image_pack, data, partition->size, width, height, channels) != 0) {
+        ESP_LOGW(TAG, "No valid %dx%dx%d image pack in the images partition", width, height,
+                 channels);
+        esp_partition_munmap(handle);
+        return;
+    }
+    image_pack_mounted = 1;
+    ESP_LOGI(TAG, "Image pack: %u frames", (unsigned) image_pack_count(&image_pack));
 }
 
 int esp_cli_start()
 {
-    image_database_init();
+    image_pack_mount();
     static int cli_started;
     if (cli_started) {
         return 0;
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "sdkconfig.h"
 
 // Enable this to do inference on embedded images
@@ -31,6 +34,55 @@
 extern "C" {
 #endif
 extern void run_inference(void *ptr);
+// The model's input, kNumCols x kNumRows x kNumChannels of
+// model_settings.h, for C code that can't include it.
+extern void model_input_dims(int *width, int *height, int *channels);
+extern void profile_print(int raw_events);
+extern void profile_reset(void);
+// Prints the per-node profile summed by operator, as a table or, if `json`,
+// as a JSON array with no trailing newline.
+extern void profile_print_ops(int json);
+// Measures the tensor arena the model needs (see arena_sizing.h), prints the
+// usage and returns the sizes to allocate for a single arena and for the
+// persistent and non-persistent parts of a split one. Returns 0 on success.
+extern int measure_arena(int verbose, size_t *required,
+                         size_t *required_persistent,
+                         size_t *required_non_persistent);
+// Internal RAM the split tensor arena may use, takes effect in setup().
+extern void arena_set_internal_limit(size_t bytes);
+// Weight tile size of the conv and FC kernels (see weight_stream.h), 0 to
+// read weights in place. Takes effect in setup().
+extern void weight_tiling_set(size_t tile_bytes);
+// Whether Prepare() picks the fastest conv and depthwise conv kernel of
+// every layer (see autotune.h). Takes effect in setup().
+extern void kernel_autotune_set(int enabled);
+// Whether 3x3 stride 1 convs run as Winograd F(2x2, 3x3) (see winograd.h).
+// Takes effect in setup().
+extern void conv_winograd_set(int enabled);
+// Workers, 1 to kParallelMaxWorkers, layers are split across (see
+// parallel.h), and the MACs below which a layer runs on one. Take effect in
+// setup().
+extern void parallel_workers_set(int workers);
+extern void parallel_min_macs_set(long macs);
+// Fused conv and pool stages from the start of the model that run row band
+// by row band (see fusion.h), 0 for none. Takes effect in setup().
+extern void row_band_stages_set(int stages);
+// Time between inferences of the camera loop once the scene has been blank
+// for a while (see gesture_recognizer.h), 0 to keep inferring at full rate.
+extern void idle_frame_interval_set(int interval_ms);
+// Inputs every inference evaluates at once (see
+// MicroInterpreter::SetBatchSize), for scoring recorded frames. Takes effect
+// in setup(). batch_size_get() returns the batch in effect, 1 for the
+// ahead-of-time model. run_inference(), loop() and loop_pipelined() infer
+// single frames and refuse to run with a batch above 1.
+extern void batch_size_set(int size);
+extern int batch_size_get(void);
+// Scores `count` frames, 1 to the batch size, of kMaxImageSize bytes each
+// and back to back in `frames`, in one inference, and writes their
+// kCategoryCount uint8 scores each to `scores`. Returns 0 on success.
+extern int run_inference_batch(const uint8_t *frames, int count, uint8_t *scores);
+// Prints where every buffer of the tensor arena was placed.
+extern void arena_print(void);
 #ifdef __cplusplus
 }
 #endif
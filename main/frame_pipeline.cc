@@ -0,0 +1,202 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "frame_pipeline.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+#include "image_provider.h"
+#include "model_settings.h"
+
+namespace {
+
+const char* TAG = "frame_pipeline";
+
+// Frames waiting for inference. With two more slots than this the capture
+// task always has a slot to fill, even while the consumer holds one.
+constexpr int kQueueDepth = 1;
+constexpr int kNumSlots = kQueueDepth + 2;
+
+// How often blocked calls wake up to notice FramePipelineStop().
+constexpr TickType_t kPollTicks = pdMS_TO_TICKS(100);
+
+uint8_t* slots[kNumSlots];
+QueueHandle_t free_slots;   // Slots the capture task may fill.
+QueueHandle_t ready_slots;  // Filled slots, oldest first.
+QueueHandle_t stopped;      // Signalled by the capture task when it exits.
+
+int held_slot = -1;  // Slot acquired by the consumer, if any.
+
+FramePipelineDropPolicy drop_policy;
+std::atomic<bool> running;
+
+std::atomic<uint32_t> captured;
+std::atomic<uint32_t> consumed;
+std::atomic<uint32_t> dropped;
+std::atomic<uint32_t> failed;
+
+// Queues a filled slot, applying the drop policy if inference is behind.
+void PublishSlot(int slot) {
+  while (xQueueSend(ready_slots, &slot, 0) != pdTRUE) {
+    if (drop_policy == kFramePipelineBlock) {
+      if (xQueueSend(ready_slots, &slot, kPollTicks) == pdTRUE) {
+        return;
+      }
+      if (!running) {
+        xQueueSend(free_slots, &slot, 0);
+        return;
+      }
+      continue;
+    }
+    // The consumer may take the queued frame between our two calls, in which
+    // case there is nothing to drop and the next send succeeds.
+    int oldest;
+    if (xQueueReceive(ready_slots, &oldest, 0) == pdTRUE) {
+      dropped++;
+      xQueueSend(free_slots, &oldest, 0);
+    }
+  }
+}
+
+void CaptureTask(void* arg) {
+  ESP_LOGI(TAG, "Capture running on core %d", (int) xPortGetCoreID());
+  while (running) {
+    int slot;
+    if (xQueueReceive(free_slots, &slot, kPollTicks) != pdTRUE) {
+      continue;
+    }
+    if (GetImage(kNumCols, kNumRows, kNumChannels, slots[slot]) != kTfLiteOk) {
+      failed++;
+      xQueueSend(free_slots, &slot, 0);
+      continue;
+    }
+    captured++;
+    PublishSlot(slot);
+  }
+  int done = 1;
+  xQueueSend(stopped, &done, portMAX_DELAY);
+  vTaskDelete(NULL);
+}
+
+}  // namespace
+
+TfLiteStatus FramePipelineStart(FramePipelineDropPolicy policy,
+                                BaseType_t capture_core) {
+  if (running) {
+    return kTfLiteOk;
+  }
+  free_slots = xQueueCreate(kNumSlots, sizeof(int));
+  ready_slots = xQueueCreate(kQueueDepth, sizeof(int));
+  stopped = xQueueCreate(1, sizeof(int));
+  if (free_slots == NULL || ready_slots == NULL || stopped == NULL) {
+    ESP_LOGE(TAG, "Couldn't create pipeline queues");
+    FramePipelineStop();
+    return kTfLiteError;
+  }
+  for (int i = 0; i < kNumSlots; i++) {
+    slots[i] = (uint8_t*) heap_caps_malloc(kMaxImageSize,
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (slots[i] == NULL) {
+      ESP_LOGE(TAG, "Couldn't allocate frame slot of %d bytes", kMaxImageSize);
+      FramePipelineStop();
+      return kTfLiteError;
+    }
+    xQueueSend(free_slots, &i, 0);
+  }
+
+  drop_policy = policy;
+  captured = 0;
+  consumed = 0;
+  dropped = 0;
+  failed = 0;
+  running = true;
+  if (xTaskCreatePinnedToCore(&CaptureTask, "capture", 4 * 1024, NULL, 8, NULL,
+                              capture_core) != pdPASS) {
+    ESP_LOGE(TAG, "Couldn't start capture task");
+    running = false;
+    FramePipelineStop();
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus FramePipelineTake(uint8_t* image_data, TickType_t timeout) {
+  if (!running) {
+    return kTfLiteError;
+  }
+  int slot;
+  if (xQueueReceive(ready_slots, &slot, timeout) != pdTRUE) {
+    return kTfLiteError;
+  }
+  memcpy(image_data, slots[slot], kMaxImageSize);
+  xQueueSend(free_slots, &slot, 0);
+  consumed++;
+  return kTfLiteOk;
+}
+
+TfLiteStatus FramePipelineAcquire(uint8_t** image_data, TickType_t timeout) {
+  if (!running || held_slot >= 0) {
+    return kTfLiteError;
+  }
+  int slot;
+  if (xQueueReceive(ready_slots, &slot, timeout) != pdTRUE) {
+    return kTfLiteError;
+  }
+  held_slot = slot;
+  *image_data = slots[slot];
+  consumed++;
+  return kTfLiteOk;
+}
+
+void FramePipelineRelease() {
+  if (held_slot < 0) {
+    return;
+  }
+  if (free_slots != NULL) {
+    xQueueSend(free_slots, &held_slot, 0);
+  }
+  held_slot = -1;
+}
+
+void FramePipelineStop() {
+  if (running) {
+    running = false;
+    int done;
+    xQueueReceive(stopped, &done, portMAX_DELAY);
+  }
+  held_slot = -1;
+  for (int i = 0; i < kNumSlots; i++) {
+    heap_caps_free(slots[i]);
+    slots[i] = NULL;
+  }
+  if (free_slots != NULL) {
+    vQueueDelete(free_slots);
+    free_slots = NULL;
+  }
+  if (ready_slots != NULL) {
+    vQueueDelete(ready_slots);
+    ready_slots = NULL;
+  }
+  if (stopped != NULL) {
+    vQueueDelete(stopped);
+    stopped = NULL;
+  }
+}
+
+FramePipelineStats FramePipelineGetStats() {
+  FramePipelineStats stats;
+  stats.captured = captured;
+  stats.consumed = consumed;
+  stats.dropped = dropped;
+  stats.failed = failed;
+  return stats;
+}
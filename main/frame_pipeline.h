@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Capture/inference pipeline for dual-core targets. A capture task pinned to
+// one core keeps calling GetImage() into a pair of frame slots while the
+// caller (normally tf_main on the other core) runs inference on the most
+// recent complete frame, so steady-state throughput is bounded by
+// max(capture, inference) instead of their sum.
+//
+// One slot is being filled while another waits in a bounded queue of depth
+// one. The consumer either copies the waiting frame into the input tensor and
+// hands the slot straight back (FramePipelineTake), or holds on to the slot
+// and infers on it in place (FramePipelineAcquire/Release), which is what the
+// third slot is for. Either way capture overlaps the whole of Invoke().
+
+#ifndef FRAME_PIPELINE_H_
+#define FRAME_PIPELINE_H_
+
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "tensorflow/lite/c/common.h"
+
+// What the capture task does when a new frame is ready but inference hasn't
+// picked up the previous one yet.
+enum FramePipelineDropPolicy {
+  // Replace the queued frame with the new one, so inference always runs on
+  // the freshest frame. Camera rate is never throttled.
+  kFramePipelineDropOldest,
+  // Wait for inference to take the queued frame. No frames are lost, capture
+  // is throttled to the inference rate.
+  kFramePipelineBlock,
+};
+
+struct FramePipelineStats {
+  uint32_t captured;  // Frames converted into a slot.
+  uint32_t consumed;  // Frames handed to inference.
+  uint32_t dropped;   // Frames replaced before inference took them.
+  uint32_t failed;    // GetImage() errors.
+};
+
+// Allocates the frame slots and starts the capture task on `capture_core`.
+// The camera must already be initialized.
+TfLiteStatus FramePipelineStart(FramePipelineDropPolicy policy,
+                                BaseType_t capture_core);
+
+// Waits up to `timeout` ticks for a frame and copies it to `image_data`,
+// which must hold kMaxImageSize bytes. Returns kTfLiteError on timeout or if
+// the pipeline isn't running.
+TfLiteStatus FramePipelineTake(uint8_t* image_data, TickType_t timeout);
+
+// Zero-copy variant of FramePipelineTake: waits up to `timeout` ticks for a
+// frame and returns its slot in `image_data`. The slot stays valid, and is
+// not refilled, until FramePipelineRelease(). Only one frame may be held at a
+// time.
+TfLiteStatus FramePipelineAcquire(uint8_t** image_data, TickType_t timeout);
+
+// Hands the slot returned by FramePipelineAcquire() back to the capture task.
+void FramePipelineRelease();
+
+// Stops the capture task and frees the slots.
+void FramePipelineStop();
+
+FramePipelineStats FramePipelineGetStats();
+
+#endif  // FRAME_PIPELINE_H_
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "gesture_recognizer.h"
+
+#include "tensorflow/lite/micro/micro_log.h"
+
+GestureRecognizer::GestureRecognizer(int32_t average_window_ms,
+                                     float detection_threshold,
+                                     int32_t suppression_ms, int minimum_count,
+                                     int32_t idle_after_ms)
+    : average_window_ms_(average_window_ms),
+      detection_threshold_(detection_threshold),
+      suppression_ms_(suppression_ms),
+      minimum_count_(minimum_count),
+      idle_after_ms_(idle_after_ms) {}
+
+void GestureRecognizer::Reset() {
+  first_ = 0;
+  count_ = 0;
+  previous_top_ = -1;
+  previous_top_time_ms_ = 0;
+  blank_ = false;
+  blank_since_ms_ = 0;
+  idle_ = false;
+}
+
+TfLiteStatus GestureRecognizer::ProcessLatestResults(const float* scores,
+                                                     int32_t time_ms,
+                                                     GestureResult* result) {
+  if (count_ > 0 &&
+      time_ms < frames_[(first_ + count_ - 1) % kMaxFrames].time_ms) {
+    MicroPrintf("Gesture results must be fed in increasing time order, "
+                "%d is before %d",
+                (int) time_ms,
+                (int) frames_[(first_ + count_ - 1) % kMaxFrames].time_ms);
+    return kTfLiteError;
+  }
+
+  // Add this frame and drop those that fell out of the window.
+  if (count_ == kMaxFrames) {
+    first_ = (first_ + 1) % kMaxFrames;
+    count_--;
+  }
+  Frame& frame = frames_[(first_ + count_) % kMaxFrames];
+  frame.time_ms = time_ms;
+  int frame_top = 0;
+  for (int i = 0; i < kCategoryCount; i++) {
+    frame.scores[i] = scores[i];
+    if (scores[i] > scores[frame_top]) {
+      frame_top = i;
+    }
+  }
+  count_++;
+  while (count_ > 1 && time_ms - frames_[first_].time_ms > average_window_ms_) {
+    first_ = (first_ + 1) % kMaxFrames;
+    count_--;
+  }
+
+  // Idle once the scene has been blank frame after frame for idle_after_ms_,
+  // awake again on the first frame that isn't.
+  if (frame_top != kBlankIndex) {
+    blank_ = false;
+    idle_ = false;
+  } else if (!blank_) {
+    blank_ = true;
+    blank_since_ms_ = time_ms;
+  } else if (time_ms - blank_since_ms_ >= idle_after_ms_) {
+    idle_ = true;
+  }
+  result->idle = idle_;
+
+  if (count_ < minimum_count_) {
+    result->category = -1;
+    result->score = 0.0f;
+    result->is_new = false;
+    return kTfLiteOk;
+  }
+
+  float average[kCategoryCount] = {};
+  for (int n = 0; n < count_; n++) {
+    const Frame& f = frames_[(first_ + n) % kMaxFrames];
+    for (int i = 0; i < kCategoryCount; i++) {
+      average[i] += f.scores[i];
+    }
+  }
+  int top = 0;
+  for (int i = 0; i < kCategoryCount; i++) {
+    average[i] /= count_;
+    if (average[i] > average[top]) {
+      top = i;
+    }
+  }
+
+  const bool is_new =
+      average[top] > detection_threshold_ &&
+      (top != previous_top_ ||
+       time_ms - previous_top_time_ms_ > suppression_ms_);
+  if (is_new) {
+    previous_top_ = top;
+    previous_top_time_ms_ = time_ms;
+  }
+  result->category = top;
+  result->score = average[top];
+  result->is_new = is_new;
+  return kTfLiteOk;
+}
@@ -0,0 +1,81 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Streaming recognizer for the camera loop, after RecognizeCommands of the
+// micro_speech example. A single frame's argmax flips with every noisy
+// frame, so the dequantized scores of the frames of the last
+// `average_window_ms` are averaged instead, and a gesture is only reported
+// once its average clears `detection_threshold` over at least
+// `minimum_count` frames, and not again within `suppression_ms` unless
+// another gesture was reported in between.
+//
+// It also tells the capture loop when it may slow down: once every frame of
+// the last `idle_after_ms` has been kBlankIndex the recognizer is idle, until
+// the first frame that isn't.
+
+#ifndef GESTURE_RECOGNIZER_H_
+#define GESTURE_RECOGNIZER_H_
+
+#include <cstdint>
+
+#include "model_settings.h"
+#include "tensorflow/lite/c/common.h"
+
+struct GestureResult {
+  // Category with the highest average score, -1 while there are fewer than
+  // minimum_count frames in the window, at the start or after a gap.
+  int category;
+  float score;
+  // Whether `category` is a newly recognised gesture, to act on, as opposed
+  // to the one still being shown or one held back by the suppression.
+  bool is_new;
+  bool idle;
+};
+
+class GestureRecognizer {
+ public:
+  // Frames kept for the average; frames beyond this in one window are
+  // dropped oldest first.
+  static constexpr int kMaxFrames = 32;
+
+  explicit GestureRecognizer(int32_t average_window_ms = 1000,
+                             float detection_threshold = 0.6f,
+                             int32_t suppression_ms = 1500,
+                             int minimum_count = 3,
+                             int32_t idle_after_ms = 3000);
+
+  // Adds the kCategoryCount dequantized `scores` of the frame taken at
+  // `time_ms`, which must not be earlier than the previous frame's.
+  TfLiteStatus ProcessLatestResults(const float* scores, int32_t time_ms,
+                                    GestureResult* result);
+
+  bool idle() const { return idle_; }
+
+  // Forgets all frames, the last gesture and the idle state.
+  void Reset();
+
+ private:
+  struct Frame {
+    int32_t time_ms;
+    float scores[kCategoryCount];
+  };
+
+  int32_t average_window_ms_;
+  float detection_threshold_;
+  int32_t suppression_ms_;
+  int minimum_count_;
+  int32_t idle_after_ms_;
+
+  Frame frames_[kMaxFrames];
+  int first_ = 0;
+  int count_ = 0;
+
+  int previous_top_ = -1;
+  int32_t previous_top_time_ms_ = 0;
+  bool blank_ = false;
+  int32_t blank_since_ms_ = 0;
+  bool idle_ = false;
+};
+
+#endif  // GESTURE_RECOGNIZER_H_
@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "image_convert.h"
+
+#include <cstring>
+
+namespace {
+
+// Each helper takes a little-endian word holding two 2-byte pixels, first
+// pixel in the low half, and returns their luma in bits 0-7 and 16-23.
+
+// RGB565 bytes are RRRRRGGG GGGBBBBB. The weights are those of
+// (305 * R8 + 600 * G8 + 119 * B8) >> 10 folded onto the 5/6-bit channels,
+// which keeps every lane below 2^15 so the two never carry into each other.
+inline uint32_t LumaRgb565x2(uint32_t pixels) {
+  const uint32_t r = (pixels >> 3) & 0x001F001F;
+  const uint32_t g =
+      ((pixels & 0x00070007) << 3) | ((pixels >> 13) & 0x00070007);
+  const uint32_t b = (pixels >> 8) & 0x001F001F;
+  return ((r * 305 + g * 300 + b * 119) >> 7) & 0x00FF00FF;
+}
+
+// YUYV: the luma is every other byte already.
+inline uint32_t LumaYuv422x2(uint32_t pixels) { return pixels & 0x00FF00FF; }
+
+// Adds the luma of one crop row to the box sums in `acc`. Box `i` spans
+// columns [x_bound[i], x_bound[i + 1]), and every box is at least one pixel
+// wide.
+template <uint32_t (*Luma)(uint32_t)>
+void AccumulateRow16(const uint8_t* row, int width, const uint16_t* x_bound,
+                     uint32_t* acc) {
+  int box = 0;
+  int next = x_bound[1];
+  int x = 0;
+  for (; x + 1 < width; x += 2) {
+    uint32_t pixels;
+    memcpy(&pixels, __builtin_assume_aligned(row + 2 * x, 4), sizeof(pixels));
+    const uint32_t luma = Luma(pixels);
+    if (x == next) {
+      next = x_bound[++box + 1];
+    }
+    acc[box] += luma & 0xFF;
+    if (x + 1 == next) {
+      next = x_bound[++box + 1];
+    }
+    acc[box] += luma >> 16;
+  }
+  if (x < width) {
+    const uint32_t pixels = row[2 * x] | (row[2 * x + 1] << 8);
+    if (x == next) {
+      box++;
+    }
+    acc[box] += Luma(pixels) & 0xFF;
+  }
+}
+
+void AccumulateRow8(const uint8_t* row, int width, const uint16_t* x_bound,
+                    uint32_t* acc) {
+  int box = 0;
+  int next = x_bound[1];
+  for (int x = 0; x < width; x++) {
+    if (x == next) {
+      next = x_bound[++box + 1];
+    }
+    acc[box] += row[x];
+  }
+}
+
+// Converts one crop row when it maps 1:1 onto the output row.
+template <uint32_t (*Luma)(uint32_t)>
+void ConvertRow16(const uint8_t* row, int width, uint8_t* out) {
+  int x = 0;
+  for (; x + 1 < width; x += 2) {
+    uint32_t pixels;
+    memcpy(&pixels, __builtin_assume_aligned(row + 2 * x, 4), sizeof(pixels));
+    const uint32_t luma = Luma(pixels);
+    out[x] = luma;
+    out[x + 1] = luma >> 16;
+  }
+  if (x < width) {
+    out[x] = Luma(row[2 * x] | (row[2 * x + 1] << 8));
+  }
+}
+
+// Boxes must stay below this many pixels for Reciprocal() to be exact.
+constexpr int kMaxBoxArea = 2048;
+
+// 2^31 / area rounded up. (n * Reciprocal(area)) >> 31 equals n / area for
+// every n below 2^31 / area, which covers the rounded sum of any box smaller
+// than kMaxBoxArea.
+inline uint32_t Reciprocal(uint32_t area) {
+  return (((uint32_t) 1 << 31) + area - 1) / area;
+}
+
+// RGB565 gray level in the camera's (big endian) byte order.
+inline uint16_t Gray565(uint8_t level) {
+  const uint16_t value =
+      ((level >> 3) << 11) | ((level >> 2) << 5) | (level >> 3);
+  const uint8_t bytes[2] = {(uint8_t) (value >> 8), (uint8_t) value};
+  uint16_t pixel;
+  memcpy(&pixel, bytes, sizeof(pixel));
+  return pixel;
+}
+
+}  // namespace
+
+bool ConvertToGrayscale(const uint8_t* src, int src_width, int src_height,
+                        ImageFormat format, uint8_t* dst, int dst_width,
+                        int dst_height, uint16_t* display, int display_scale) {
+  const int bytes_per_pixel = format == kImageFormatGrayscale ? 1 : 2;
+  if (dst_width <= 0 || dst_height <= 0 || dst_width > kImageConvertMaxWidth ||
+      (bytes_per_pixel == 2 && (src_width & 1) != 0) ||
+      (display != nullptr && display_scale < 1)) {
+    return false;
+  }
+
+  // Largest centred crop with the output's aspect ratio. The left edge is
+  // kept even so pixel pairs (and YUYV macropixels) stay word aligned.
+  int crop_width = src_width;
+  int crop_height = src_height;
+  if (src_width * dst_height > src_height * dst_width) {
+    crop_width = src_height * dst_width / dst_height;
+  } else {
+    crop_height = src_width * dst_height / dst_width;
+  }
+  if (crop_width < dst_width || crop_height < dst_height ||
+      (crop_width / dst_width + 1) * (crop_height / dst_height + 1) >=
+          kMaxBoxArea) {
+    return false;
+  }
+  const int crop_x = ((src_width - crop_width) / 2) & ~1;
+  const int crop_y = (src_height - crop_height) / 2;
+
+  uint16_t x_bound[kImageConvertMaxWidth + 1];
+  for (int i = 0; i <= dst_width; i++) {
+    x_bound[i] = i * crop_width / dst_width;
+  }
+
+  const int stride = src_width * bytes_per_pixel;
+  const int display_width = dst_width * display_scale;
+  // Boxes are min_box_width or min_box_width + 1 pixels wide.
+  const int min_box_width = crop_width / dst_width;
+  const bool one_to_one = crop_width == dst_width && crop_height == dst_height;
+  uint32_t acc[kImageConvertMaxWidth];
+  for (int oy = 0; oy < dst_height; oy++) {
+    const int y0 = crop_y + oy * crop_height / dst_height;
+    const int y1 = crop_y + (oy + 1) * crop_height / dst_height;
+    uint8_t* out = dst + oy * dst_width;
+
+    if (one_to_one) {
+      const uint8_t* row = src + y0 * stride + crop_x * bytes_per_pixel;
+      switch (format) {
+        case kImageFormatRgb565:
+          ConvertRow16<LumaRgb565x2>(row, dst_width, out);
+          break;
+        case kImageFormatYuv422:
+          ConvertRow16<LumaYuv422x2>(row, dst_width, out);
+          break;
+        default:
+          memcpy(out, row, dst_width);
+          break;
+      }
+    } else {
+      memset(acc, 0, dst_width * sizeof(acc[0]));
+      for (int y = y0; y < y1; y++) {
+        const uint8_t* row = src + y * stride + crop_x * bytes_per_pixel;
+        switch (format) {
+          case kImageFormatRgb565:
+            AccumulateRow16<LumaRgb565x2>(row, crop_width, x_bound, acc);
+            break;
+          case kImageFormatYuv422:
+            AccumulateRow16<LumaYuv422x2>(row, crop_width, x_bound, acc);
+            break;
+          default:
+            AccumulateRow8(row, crop_width, x_bound, acc);
+            break;
+        }
+      }
+
+      // Rounded mean, with the two possible box areas of this row divided
+      // by reciprocal multiplication.
+      const uint32_t box_height = y1 - y0;
+      const uint32_t area[2] = {min_box_width * box_height,
+                                (min_box_width + 1) * box_height};
+      const uint32_t inverse[2] = {Reciprocal(area[0]), Reciprocal(area[1])};
+      for (int ox = 0; ox < dst_width; ox++) {
+        const int wide = x_bound[ox + 1] - x_bound[ox] - min_box_width;
+        out[ox] = ((uint64_t) (acc[ox] + area[wide] / 2) * inverse[wide]) >> 31;
+      }
+    }
+
+    if (display == nullptr) {
+      continue;
+    }
+    uint16_t* display_row = display + oy * display_scale * display_width;
+    const uint16_t* first_row = reinterpret_cast<const uint16_t*>(
+        src + y0 * stride + crop_x * bytes_per_pixel);
+    for (int ox = 0; ox < dst_width; ox++) {
+      const uint16_t pixel = format == kImageFormatRgb565
+                                 ? first_row[x_bound[ox]]
+                                 : Gray565(out[ox]);
+      if (display_scale == 2) {
+        // The usual 2x preview: one word store per pixel pair.
+        const uint32_t pair = pixel | ((uint32_t) pixel << 16);
+        memcpy(display_row + 2 * ox, &pair, sizeof(pair));
+      } else {
+        for (int i = 0; i < display_scale; i++) {
+          display_row[ox * display_scale + i] = pixel;
+        }
+      }
+    }
+    for (int i = 1; i < display_scale; i++) {
+      memcpy(display_row + i * display_width, display_row,
+             display_width * sizeof(display_row[0]));
+    }
+  }
+  return true;
+}
@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Camera frame to model input conversion. Turns an RGB565, YUV422 or
+// grayscale frame of any size into the model's 8-bit grayscale input with an
+// area-averaging downscale of the centre crop, and optionally renders the
+// display's upscaled RGB565 preview in the same pass over the frame.
+//
+// Pixels are converted two at a time in 16-bit lanes of a 32-bit word (SWAR),
+// so the per-pixel cost is a handful of ALU ops on every target instead of
+// the byte-wise unpacking GetImage() used to do.
+
+#ifndef IMAGE_CONVERT_H_
+#define IMAGE_CONVERT_H_
+
+#include <cstdint>
+
+enum ImageFormat {
+  kImageFormatGrayscale,  // 1 byte per pixel.
+  kImageFormatRgb565,     // 2 bytes per pixel, big endian as the camera sends it.
+  kImageFormatYuv422,     // YUYV, 2 bytes per pixel.
+};
+
+// Largest output width ConvertToGrayscale() handles; per-row state lives on
+// the stack.
+constexpr int kImageConvertMaxWidth = 256;
+
+// Converts the largest centred crop of `src` with the aspect ratio of `dst` to
+// dst_width x dst_height grayscale, each output pixel being the rounded mean
+// of the source pixels it covers. Luma of RGB565 is
+// (305 * R + 600 * G + 119 * B) >> 10 on the 8-bit expanded channels.
+//
+// If `display` is not null it receives a (dst_width * display_scale) x
+// (dst_height * display_scale) RGB565 preview in the camera's byte order:
+// the colour of the first source pixel of every box for RGB565 input, the
+// output gray level otherwise.
+//
+// `src` must be 4-byte aligned. Returns false, without touching the outputs,
+// for unsupported sizes.
+bool ConvertToGrayscale(const uint8_t* src, int src_width, int src_height,
+                        ImageFormat format, uint8_t* dst, int dst_width,
+                        int dst_height, uint16_t* display, int display_scale);
+
+#endif  // IMAGE_CONVERT_H_
@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "image_pack.h"
+
+#include <string.h>
+
+int image_pack_open(image_pack_t *pack, const void *data, size_t size,
+                    int width, int height, int channels)
+{
+    const image_pack_header_t *header = (const image_pack_header_t *) data;
+    if (size < sizeof(*header) || memcmp(header->magic, IMAGE_PACK_MAGIC, 4) != 0 ||
+        header->version != IMAGE_PACK_VERSION || header->header_size != sizeof(*header) ||
+        header->total_size > size || header->width != width || header->height != height ||
+        header->channels != channels || header->frame_size != (uint32_t) width * height * channels ||
+        header->pixel_type > IMAGE_PACK_INT8 || header->index_offset % 4 != 0 ||
+        header->index_offset > header->total_size ||
+        header->count > (header->total_size - header->index_offset) / sizeof(image_pack_entry_t)) {
+        return -1;
+    }
+
+    const uint8_t *bytes = (const uint8_t *) data;
+    const image_pack_entry_t *entries = (const image_pack_entry_t *) (bytes + header->index_offset);
+    for (uint32_t i = 0; i < header->count; i++) {
+        const image_pack_entry_t *entry = &entries[i];
+        if (entry->offset % IMAGE_PACK_FRAME_ALIGN != 0 || entry->offset > header->total_size ||
+            header->frame_size > header->total_size - entry->offset) {
+            return -1;
+        }
+        // The name must end before the pack does.
+        if (entry->name != 0 && (entry->name >= header->total_size ||
+                                 memchr(bytes + entry->name, 0, header->total_size - entry->name) == NULL)) {
+            return -1;
+        }
+    }
+
+    pack->data = bytes;
+    pack->header = header;
+    pack->entries = entries;
+    return 0;
+}
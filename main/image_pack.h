@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Packed set of test frames, for running many recorded frames through the
+// model without embedding them in the app. On the device the pack lives in
+// the `images` data partition and is read through a flash mapping; the host
+// build reads the same file. Frames are used where they are, so a mapped
+// pack costs no RAM.
+//
+// Layout, little endian, written by static_images/image_pack.py:
+//   image_pack_header_t
+//   image_pack_entry_t[count]       at index_offset
+//   frames, frame_size bytes each   16-byte aligned, at entry.offset
+//   names, NUL-terminated           at entry.name, if present
+//
+// An entry's label is the model category the frame shows, or -1 if the
+// frame is unlabelled.
+
+#ifndef IMAGE_PACK_H_
+#define IMAGE_PACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMAGE_PACK_MAGIC "IPAK"
+#define IMAGE_PACK_VERSION 1
+#define IMAGE_PACK_FRAME_ALIGN 16
+
+// Pixel types, the model input's or its int8 counterpart (pixel - 128).
+#define IMAGE_PACK_UINT8 0
+#define IMAGE_PACK_INT8 1
+
+typedef struct {
+    char magic[4];          // IMAGE_PACK_MAGIC
+    uint16_t version;       // IMAGE_PACK_VERSION
+    uint16_t header_size;   // sizeof(image_pack_header_t)
+    uint32_t count;         // Frames
+    uint16_t width;
+    uint16_t height;
+    uint8_t channels;
+    uint8_t pixel_type;     // IMAGE_PACK_UINT8 or IMAGE_PACK_INT8
+    uint16_t reserved;
+    uint32_t frame_size;    // width * height * channels
+    uint32_t index_offset;
+    uint32_t total_size;    // Bytes of the whole pack
+} image_pack_header_t;
+
+typedef struct {
+    uint32_t offset;        // Of the frame from the start of the pack
+    uint32_t name;          // Of the frame's name, 0 if it has none
+    int16_t label;          // Category, -1 if unlabelled
+    uint16_t reserved;
+} image_pack_entry_t;
+
+typedef struct {
+    const uint8_t *data;
+    const image_pack_header_t *header;
+    const image_pack_entry_t *entries;
+} image_pack_t;
+
+// Checks the `size` bytes at `data` hold a pack of width x height x channels
+// frames whose every frame and name lies within it, and sets up `pack` to
+// read them. `data` must stay valid while `pack` is used. Returns 0 on
+// success, -1 if it isn't such a pack.
+int image_pack_open(image_pack_t *pack, const void *data, size_t size,
+                    int width, int height, int channels);
+
+static inline uint32_t image_pack_count(const image_pack_t *pack)
+{
+    return pack->header->count;
+}
+
+static inline const uint8_t *image_pack_frame(const image_pack_t *pack, uint32_t index)
+{
+    return pack->data + pack->entries[index].offset;
+}
+
+static inline int image_pack_label(const image_pack_t *pack, uint32_t index)
+{
+    return pack->entries[index].label;
+}
+
+// Name of frame `index`, or NULL if it has none.
+static inline const char *image_pack_name(const image_pack_t *pack, uint32_t index)
+{
+    const uint32_t name = pack->entries[index].name;
+    return name ? (const char *) pack->data + name : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // IMAGE_PACK_H_
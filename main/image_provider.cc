@@ -26,6 +26,8 @@ limitations under the License.
 
 #include "app_camera_esp.h"
 #include "esp_camera.h"
+#include "esp_jpg_decode.h"
+#include "image_convert.h"
 #include "model_settings.h"
 #include "image_provider.h"
 #include "esp_main.h"
@@ -34,6 +36,10 @@ static const char* TAG = "app_camera";
 
 static uint16_t *display_buf; // buffer to hold data to be sent to display
 
+#if ESP_CAMERA_SUPPORTED
+static camera_fb_t *acquired_fb; // frame handed out by AcquireImage()
+#endif
+
 // Get the camera module ready
 TfLiteStatus InitCamera() {
 #if CLI_ONLY_INFERENCE
@@ -80,50 +86,46 @@ TfLiteStatus GetImage(int image_width, int image_height, int channels, uint8_t*
     return kTfLiteError;
   }
 
-#if DISPLAY_SUPPORT
-  // In case if display support is enabled, we initialise camera in rgb mode
-  // Hence, we need to convert this data to grayscale to send it to tf model
-  // For display we extra-polate the data to 192X192
-  for (int i = 0; i < kNumRows; i++) {
-    for (int j = 0; j < kNumCols; j++) {
-      uint16_t pixel = ((uint16_t *) (fb->buf))[i * kNumCols + j];
-
-      // for inference
-      uint8_t hb = pixel & 0xFF;
-      uint8_t lb = pixel >> 8;
-      uint8_t r = (lb & 0x1F) << 3;
-      uint8_t g = ((hb & 0x07) << 5) | ((lb & 0xE0) >> 3);
-      uint8_t b = (hb & 0xF8);
-
-      /**
-       * Gamma corected rgb to greyscale formula: Y = 0.299R + 0.587G + 0.114B
-       * for effiency we use some tricks on this + quantize to [-128, 127]
-       */
-      int8_t grey_pixel = ((305 * r + 600 * g + 119 * b) >> 10) - 128;
-
-      image_data[i * kNumCols + j] = grey_pixel;
-
-      // to display
-      display_buf[2 * i * kNumCols * 2 + 2 * j] = pixel;
-      display_buf[2 * i * kNumCols * 2 + 2 * j + 1] = pixel;
-      display_buf[(2 * i + 1) * kNumCols * 2 + 2 * j] = pixel;
-      display_buf[(2 * i + 1) * kNumCols * 2 + 2 * j + 1] = pixel;
+  // JPEG frames are decoded to the model's input directly, luma only.
+  if (fb->format == PIXFORMAT_JPEG) {
+    const bool decoded = channels == 1 &&
+        jpg2gray(fb->buf, fb->len, image_data, image_width, image_height);
+    if (!decoded) {
+      ESP_LOGE(TAG, "Can't decode a %dx%d JPEG frame to %dx%d", fb->width,
+               fb->height, image_width, image_height);
     }
+    esp_camera_fb_return(fb);
+    return decoded ? kTfLiteOk : kTfLiteError;
   }
-#else // DISPLAY_SUPPORT
-  MicroPrintf("Image Captured\n");
-  // We have initialised camera to grayscale
-  // Just quantize to int8_t
-  for (int i = 0; i < image_width * image_height; i++) {
-    image_data[i] = ((uint8_t *) fb->buf)[i];
+
+  // With display support the camera runs in RGB565 for the preview, and it
+  // may capture at a larger frame size than the model's for a better crop.
+  // Either way the frame is converted and downscaled in one pass, with the
+  // display buffer (null without a display) filled at 2x alongside.
+  ImageFormat format;
+  switch (fb->format) {
+    case PIXFORMAT_GRAYSCALE:
+      format = kImageFormatGrayscale;
+      break;
+    case PIXFORMAT_RGB565:
+      format = kImageFormatRgb565;
+      break;
+    case PIXFORMAT_YUV422:
+      format = kImageFormatYuv422;
+      break;
+    default:
+      ESP_LOGE(TAG, "Unsupported pixel format %d", fb->format);
+      esp_camera_fb_return(fb);
+      return kTfLiteError;
+  }
+  if (channels != 1 ||
+      !ConvertToGrayscale(fb->buf, fb->width, fb->height, format, image_data,
+                          image_width, image_height, display_buf, 2)) {
+    ESP_LOGE(TAG, "Can't convert a %dx%d frame to %dx%d", fb->width,
+             fb->height, image_width, image_height);
+    esp_camera_fb_return(fb);
+    return kTfLiteError;
   }
-  //for (int i = 0; i < image_width * image_height; i++) {
-    // Convert the uint8_t pixel to float32
-  //  float pixel = static_cast<float>(((uint8_t *) fb->buf)[i]);
-    // Normalize the pixel data to 0-1 range if your model expects this range
-  //  image_data[i] = pixel / 255.0f;
-  //}
-#endif // DISPLAY_SUPPORT
 
   esp_camera_fb_return(fb);
   /* here the esp camera can give you grayscale image directly */
@@ -132,3 +134,39 @@ TfLiteStatus GetImage(int image_width, int image_height, int channels, uint8_t*
   return kTfLiteError;
 #endif
 }
+
+TfLiteStatus AcquireImage(int image_width, int image_height, int channels, uint8_t** image_data) {
+#if ESP_CAMERA_SUPPORTED && !DISPLAY_SUPPORT
+  if (acquired_fb != NULL) {
+    ESP_LOGE(TAG, "Previous frame not released");
+    return kTfLiteError;
+  }
+  camera_fb_t* fb = esp_camera_fb_get();
+  if (!fb) {
+    ESP_LOGE(TAG, "Camera capture failed");
+    return kTfLiteError;
+  }
+  // The camera was initialised to grayscale at the model's resolution, so the
+  // frame buffer is already a valid uint8 input tensor.
+  if (fb->format != PIXFORMAT_GRAYSCALE || fb->width != (size_t) image_width ||
+      fb->height != (size_t) image_height || channels != 1) {
+    esp_camera_fb_return(fb);
+    return kTfLiteError;
+  }
+  acquired_fb = fb;
+  *image_data = fb->buf;
+  return kTfLiteOk;
+#else
+  // Display mode captures RGB565, which has to be converted.
+  return kTfLiteError;
+#endif
+}
+
+void ReleaseImage() {
+#if ESP_CAMERA_SUPPORTED
+  if (acquired_fb != NULL) {
+    esp_camera_fb_return(acquired_fb);
+    acquired_fb = NULL;
+  }
+#endif
+}
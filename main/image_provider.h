@@ -40,6 +40,15 @@ void *image_provider_get_display_buf();
 
 TfLiteStatus GetImage(int image_width, int image_height, int channels, uint8_t* image_data);
 
+// Zero-copy variant of GetImage(): when the camera already delivers frames in
+// the model's input format, returns the driver's frame buffer in image_data
+// instead of copying it. The buffer stays valid until ReleaseImage(), which
+// must be called before the next capture. Returns kTfLiteError (and holds
+// nothing) if the frame would need converting; use GetImage() then.
+TfLiteStatus AcquireImage(int image_width, int image_height, int channels, uint8_t** image_data);
+
+void ReleaseImage();
+
 TfLiteStatus InitCamera();
 
 #endif /* CONFIG_PERSON_DETECTION_STATIC */
@@ -20,6 +20,7 @@ limitations under the License.
 #include "freertos/task.h"
 
 #include "esp_main.h"
+#include "frame_pipeline.h"
 
 #if CLI_ONLY_INFERENCE
 #include "esp_cli.h"
@@ -31,6 +32,26 @@ void tf_main(void) {
   esp_cli_start();
   vTaskDelay(portMAX_DELAY);
 #else
+  // The camera loop infers one frame at a time.
+  if (batch_size_get() > 1) {
+    ESP_LOGE("tf_main", "CONFIG_TFLITE_INFERENCE_BATCH is %d, the camera loop needs 1",
+             batch_size_get());
+    vTaskDelay(portMAX_DELAY);
+  }
+#if CONFIG_TFLITE_PIPELINED_INFERENCE
+  // Capture and convert frames on core 0 while this task infers on core 1.
+#if CONFIG_TFLITE_PIPELINE_DROP_OLDEST
+  FramePipelineDropPolicy policy = kFramePipelineDropOldest;
+#else
+  FramePipelineDropPolicy policy = kFramePipelineBlock;
+#endif
+  if (FramePipelineStart(policy, 0) == kTfLiteOk) {
+    while (true) {
+      loop_pipelined();
+    }
+  }
+  ESP_LOGW("tf_main", "Capture pipeline unavailable, running serially");
+#endif
   while (true) {
     loop();
   }
@@ -38,6 +59,10 @@ void tf_main(void) {
 }
 
 extern "C" void app_main() {
+#if CONFIG_TFLITE_PIPELINED_INFERENCE && !CLI_ONLY_INFERENCE
+  xTaskCreatePinnedToCore((TaskFunction_t)&tf_main, "tf_main", 4 * 1024, NULL, 8, NULL, 1);
+#else
   xTaskCreate((TaskFunction_t)&tf_main, "tf_main", 4 * 1024, NULL, 8, NULL);
+#endif
   vTaskDelete(NULL);
 }
@@ -15,23 +15,48 @@ limitations under the License.
 
 #include "main_functions.h"
 
+#include "arena_sizing.h"
 #include "detection_responder.h"
+#include "frame_pipeline.h"
+#include "gesture_recognizer.h"
 #include "image_provider.h"
+#include "model_aot.h"
 #include "model_settings.h"
+#include "node_profiler.h"
+#include "parallel_executor.h"
 #include "person_detect_model_data.h"
+#include "tensor_arena_size.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/fusion.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/weight_stream.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/winograd.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/memory_planner/split_memory_planner.h"
+#include "tensorflow/lite/micro/micro_allocation_info.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_log.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <esp_heap_caps.h>
 #include <esp_timer.h>
 #include <esp_log.h>
 #include "esp_main.h"
 #include "esp_psram.h"
+#if CONFIG_TFLITE_KERNEL_AUTOTUNE_NVS
+#include "autotune_nvs_cache.h"
+#endif
 
 
 // Globals, used for compatibility with Arduino-style sketches.
@@ -47,20 +72,525 @@ namespace {
   // signed 8-bit integers is to subtract 128 from the unsigned value to get a
   // signed value.
 
-  #ifdef CONFIG_IDF_TARGET_ESP32S3
-  constexpr int scratchBufSize = 40 * 1024;
-  #else
-  constexpr int scratchBufSize = 0;
-  #endif
-  
+  // Arena size used before it was measured, now only the fallback for
+  // targets tensor_arena_size.h has no size for and the probe arena of
+  // measure_arena().
+  constexpr int kLegacyTensorArenaSize = 96 * 96 * 100 * sizeof(uint) + 1935000;
+
   // An area of memory to use for input, output, and intermediate arrays.
-  // quizas haya que modificar esta linea!!! depende del ttiempo 
-  //constexpr int kTensorArenaSize = 81 * 1024 + scratchBufSize;
-  constexpr int kTensorArenaSize = 96 * 96 * 100 * sizeof(uint) + 1935000;
-  //constexpr int kTensorArenaSize = 5621400;
-  static uint8_t *tensor_arena;//[kTensorArenaSize]; // Maybe we should move this to external
+#ifdef TENSOR_ARENA_SIZE
+  constexpr int kTensorArenaSize = TENSOR_ARENA_SIZE;
+#else
+  constexpr int kTensorArenaSize = kLegacyTensorArenaSize;
+#endif
+  static uint8_t *tensor_arena;
+
+#if CONFIG_TFLITE_AOT_MODEL
+  // The model compiled ahead of time (model_aot.h) runs in its own, smaller
+  // arena and replaces the interpreter.
+  uint8_t *aot_arena = nullptr;
+  // Where GetImage() puts frames the camera can't give in place.
+  uint8_t *aot_input = nullptr;
+  uint8_t aot_output[kCategoryCount];
+#endif
+
+  // Weight tile size of the esp_nn conv and FC kernels, 0 to read weights
+  // straight from flash (see weight_stream.h).
+#ifdef CONFIG_TFLITE_WEIGHT_TILE_SIZE
+  size_t weight_tile_size = CONFIG_TFLITE_WEIGHT_TILE_SIZE;
+#else
+  size_t weight_tile_size = 0;
+#endif
+
+  // Whether the conv kernels are tuned per layer (see autotune.h).
+#if CONFIG_TFLITE_KERNEL_AUTOTUNE
+  bool kernel_autotune = true;
+#else
+  bool kernel_autotune = false;
+#endif
+
+  // What a scratch buffer request costs besides the buffer itself: its
+  // handle in the persistent arena, and while the memory plan is made, its
+  // request, its allocation info and its greedy planner entry in the
+  // non-persistent one.
+  constexpr size_t kScratchHandleBytes = sizeof(tflite::ScratchBufferHandle);
+
+  size_t ScratchPlanBytes() {
+    return sizeof(tflite::internal::ScratchBufferRequest) + sizeof(tflite::AllocationInfo) +
+           tflite::GreedyMemoryPlanner::per_buffer_size();
+  }
+
+  // Elements of a tensor of the model, 0 if its shape is unknown.
+  size_t ModelTensorElements(int index) {
+    const auto *shape = model->subgraphs()->Get(0)->tensors()->Get(index)->shape();
+    if (shape == nullptr) {
+      return 0;
+    }
+    size_t elements = 1;
+    for (const int32_t dim : *shape) {
+      elements *= dim > 0 ? dim : 0;
+    }
+    return elements;
+  }
+
+  // Nodes whose Prepare() requests a weight tile: int8 convs without
+  // dilation whose filter fits in two tiles (conv.cc) and int8 FCs whose
+  // filter is larger than one (fully_connected.cc). A conv that may run as
+  // Winograd, which takes no tile, is still counted.
+  size_t WeightTileNodes() {
+    const auto *tensors = model->subgraphs()->Get(0)->tensors();
+    size_t nodes = 0;
+    for (const auto *op : *model->subgraphs()->Get(0)->operators()) {
+      const auto code = tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index()));
+      if (op->inputs() == nullptr || op->inputs()->size() < 2 ||
+          tensors->Get(op->inputs()->Get(0))->type() != tflite::TensorType_INT8 ||
+          tensors->Get(op->inputs()->Get(1))->type() != tflite::TensorType_INT8) {
+        continue;
+      }
+      const int filter = op->inputs()->Get(1);
+      if (code == tflite::BuiltinOperator_CONV_2D) {
+        const auto *options = op->builtin_options_as_Conv2DOptions();
+        nodes += options != nullptr && options->dilation_w_factor() == 1 &&
+                 options->dilation_h_factor() == 1 &&
+                 ModelTensorElements(filter) <= 2 * weight_tile_size;
+      } else if (code == tflite::BuiltinOperator_FULLY_CONNECTED) {
+        const auto *filter_shape = tensors->Get(filter)->shape();
+        const auto *output_shape = tensors->Get(op->outputs()->Get(0))->shape();
+        if (filter_shape == nullptr || filter_shape->size() == 0 ||
+            output_shape == nullptr || output_shape->size() == 0) {
+          continue;
+        }
+        const int32_t accum_depth = filter_shape->Get(filter_shape->size() - 1);
+        const int32_t output_depth = output_shape->Get(output_shape->size() - 1);
+        const size_t tile_rows = accum_depth > 0 ? weight_tile_size / accum_depth : 0;
+        nodes += tile_rows > 0 && tile_rows < static_cast<size_t>(output_depth);
+      }
+    }
+    return nodes;
+  }
+
+  // tensor_arena_size.h is measured without weight tiles, which add a
+  // scratch buffer to each of WeightTileNodes(): a handle more per node, its
+  // planning entries, and at most two tiles in the non-persistent arena.
+  // Scratch buffers of different nodes share memory, so the tiles only count
+  // once.
+  size_t WeightTileNodeHeadroom() {
+    if (weight_tile_size == 0) {
+      return 0;
+    }
+    return WeightTileNodes() * kScratchHandleBytes + tflite::MicroArenaBufferAlignment();
+  }
+
+  size_t WeightTileHeadroom() {
+    if (weight_tile_size == 0) {
+      return 0;
+    }
+    return 2 * (weight_tile_size + tflite::MicroArenaBufferAlignment()) +
+           WeightTileNodes() * ScratchPlanBytes();
+  }
+
+  // Nodes kernel autotuning may pick another kernel for.
+  size_t AutotuneNodes() {
+    size_t nodes = 0;
+    for (const auto *op : *model->subgraphs()->Get(0)->operators()) {
+      const auto code = tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index()));
+      nodes += code == tflite::BuiltinOperator_CONV_2D ||
+               code == tflite::BuiltinOperator_DEPTHWISE_CONV_2D;
+    }
+    return nodes;
+  }
+
+  // tensor_arena_size.h is also measured with the default kernels. A tuned
+  // kernel keeps the node's one scratch buffer request, but may make it
+  // where the default kernel makes none: a handle more per conv and
+  // depthwise conv. The buffer may also be larger, which
+  // kAutotuneArenaHeadroom bounds.
+  size_t AutotuneNodeHeadroom() {
+    if (!kernel_autotune) {
+      return 0;
+    }
+    return AutotuneNodes() * kScratchHandleBytes + tflite::MicroArenaBufferAlignment();
+  }
+
+  size_t AutotuneHeadroom() {
+    if (!kernel_autotune) {
+      return 0;
+    }
+    return tflite::kAutotuneArenaHeadroom + AutotuneNodes() * ScratchPlanBytes();
+  }
+
+  // Whether 3x3 stride 1 convs run as Winograd F(2x2, 3x3) (see winograd.h).
+#if CONFIG_TFLITE_CONV_WINOGRAD
+  bool conv_winograd = true;
+#else
+  bool conv_winograd = false;
+#endif
+
+  // Filter shape [out, 3, 3, in] of a CONV_2D that may run as Winograd,
+  // false for any other operator.
+  bool WinogradConvShape(const tflite::Operator *op, int32_t *in_channels,
+                         int32_t *out_channels) {
+    const auto *opcode = model->operator_codes()->Get(op->opcode_index());
+    const auto *options = op->builtin_options_as_Conv2DOptions();
+    if (tflite::GetBuiltinCode(opcode) != tflite::BuiltinOperator_CONV_2D ||
+        options == nullptr || options->padding() != tflite::Padding_VALID ||
+        options->stride_w() != 1 || options->stride_h() != 1 ||
+        options->dilation_w_factor() != 1 || options->dilation_h_factor() != 1) {
+      return false;
+    }
+    const auto *tensors = model->subgraphs()->Get(0)->tensors();
+    const auto *shape = tensors->Get(op->inputs()->Get(1))->shape();
+    if (shape->size() != 4 || shape->Get(1) != 3 || shape->Get(2) != 3) {
+      return false;
+    }
+    *out_channels = shape->Get(0);
+    *in_channels = shape->Get(3);
+    return true;
+  }
+
+  // tensor_arena_size.h is measured without Winograd either. conv.cc's
+  // Prepare() of a Winograd conv allocates its transformed filter in the
+  // persistent arena and requests a scratch buffer of an input tile per
+  // input channel, both sized by esp-nn as here.
+  // That request replaces the default kernel's, which may have none: one
+  // handle more per layer here, its planning entries in WinogradHeadroom().
+  size_t WinogradNodeHeadroom() {
+    if (!conv_winograd) {
+      return 0;
+    }
+    size_t bytes = 0;
+    int32_t in_channels, out_channels;
+    for (const auto *op : *model->subgraphs()->Get(0)->operators()) {
+      if (WinogradConvShape(op, &in_channels, &out_channels)) {
+        data_dims_t input_dims = {}, output_dims = {};
+        input_dims.channels = in_channels;
+        output_dims.channels = out_channels;
+        bytes += esp_nn_get_conv_winograd_filter_size(&input_dims, &output_dims) +
+                 tflite::MicroArenaBufferAlignment() + kScratchHandleBytes;
+      }
+    }
+    return bytes;
+  }
+
+  // Scratch buffers of different nodes share memory, so only the largest
+  // counts.
+  size_t WinogradHeadroom() {
+    if (!conv_winograd) {
+      return 0;
+    }
+    size_t scratch = 0;
+    size_t nodes = 0;
+    int32_t in_channels, out_channels;
+    for (const auto *op : *model->subgraphs()->Get(0)->operators()) {
+      if (WinogradConvShape(op, &in_channels, &out_channels)) {
+        data_dims_t input_dims = {}, filter_dims = {}, output_dims = {};
+        input_dims.channels = in_channels;
+        filter_dims.width = filter_dims.height = 3;
+        output_dims.channels = out_channels;
+        const conv_params_t params = {};
+        scratch = std::max<size_t>(
+            scratch, esp_nn_get_conv_scratch_size_winograd(&input_dims, &filter_dims,
+                                                           &output_dims, &params));
+        nodes++;
+      }
+    }
+    return scratch + tflite::MicroArenaBufferAlignment() + nodes * ScratchPlanBytes();
+  }
+
+  // Workers convs, depthwise convs, pools and fully connected layers are
+  // split across (see parallel.h), and the MACs below which a layer isn't.
+#ifdef CONFIG_TFLITE_PARALLEL_WORKERS
+  int parallel_workers = CONFIG_TFLITE_PARALLEL_WORKERS;
+#else
+  int parallel_workers = 1;
+#endif
+#ifdef CONFIG_TFLITE_PARALLEL_MIN_MACS
+  long parallel_min_macs = CONFIG_TFLITE_PARALLEL_MIN_MACS;
+#else
+  long parallel_min_macs = 100000;
+#endif
+
+  // Fused conv and pool stages run row band by row band (see fusion.h).
+#ifdef CONFIG_TFLITE_ROW_BAND_STAGES
+  int row_band_stages = CONFIG_TFLITE_ROW_BAND_STAGES;
+#else
+  int row_band_stages = 0;
+#endif
+
+  // tensor_arena_size.h is measured without row bands either, whose stack
+  // node keeps its params, data, the stages' node data and its buffer
+  // handles in the persistent arena. The stack needs less of the
+  // non-persistent one, not more.
+  size_t RowBandNodeHeadroom() {
+    if (row_band_stages < 2) {
+      return 0;
+    }
+    return tflite::RowBandPersistentBytes(row_band_stages);
+  }
+
+  // Inputs every Invoke() evaluates (see MicroInterpreter::SetBatchSize).
+#ifdef CONFIG_TFLITE_INFERENCE_BATCH
+  int batch_size = CONFIG_TFLITE_INFERENCE_BATCH;
+#else
+  int batch_size = 1;
+#endif
+
+  // tensor_arena_size.h is measured for one input, and every activation
+  // grows by the batch. Scratch buffers don't, so this is a bound. Every
+  // activation also gets dims of its own in the persistent arena.
+  size_t BatchHeadroom() {
+    if (batch_size <= 1) {
+      return 0;
+    }
+#ifdef TENSOR_ARENA_NON_PERSISTENT_SIZE
+    return (batch_size - 1) * TENSOR_ARENA_NON_PERSISTENT_SIZE;
+#else
+    return (batch_size - 1) * kTensorArenaSize;
+#endif
+  }
+
+  size_t BatchNodeHeadroom() {
+    if (batch_size <= 1) {
+      return 0;
+    }
+    return model->subgraphs()->Get(0)->tensors()->size() *
+           (TfLiteIntArrayGetSizeInBytes(4) + tflite::MicroArenaBufferAlignment());
+  }
+
+  // Dims of tensor `index`, an NHWC activation or an OHWI filter.
+  data_dims_t TensorDims(int32_t index) {
+    const auto *shape = model->subgraphs()->Get(0)->tensors()->Get(index)->shape();
+    data_dims_t dims = {};
+    if (shape != nullptr && shape->size() == 4) {
+      dims.extra = shape->Get(0);
+      dims.height = shape->Get(1);
+      dims.width = shape->Get(2);
+      dims.channels = shape->Get(3);
+    }
+    return dims;
+  }
+
+  // Padding of a SAME or VALID conv along one dimension.
+  int32_t ConvPadding(tflite::Padding padding, int32_t in, int32_t filter,
+                      int32_t stride, int32_t out) {
+    if (padding != tflite::Padding_SAME) {
+      return 0;
+    }
+    return std::max(0, ((out - 1) * stride + filter - in) / 2);
+  }
+
+  // tensor_arena_size.h is measured with one worker. Every other one gets a
+  // conv or depthwise conv scratch buffer of its own, of the largest
+  // candidate kernel since any may be tuned in, and a band buffer of a conv
+  // fused with the MAX_POOL_2D after it. Scratch buffers of different nodes
+  // share memory, so only the largest node counts.
+  size_t ParallelHeadroom() {
+    if (parallel_workers <= 1) {
+      return 0;
+    }
+    const size_t alignment = tflite::MicroArenaBufferAlignment();
+    const auto *operators = model->subgraphs()->Get(0)->operators();
+    size_t per_worker = 0;
+    for (size_t i = 0; i < operators->size(); i++) {
+      const auto *op = operators->Get(i);
+      const auto code = tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index()));
+      if (code != tflite::BuiltinOperator_CONV_2D &&
+          code != tflite::BuiltinOperator_DEPTHWISE_CONV_2D) {
+        continue;
+      }
+      const data_dims_t input_dims = TensorDims(op->inputs()->Get(0));
+      const data_dims_t filter_dims = TensorDims(op->inputs()->Get(1));
+      const data_dims_t output_dims = TensorDims(op->outputs()->Get(0));
+      int scratch = 0;
+      if (code == tflite::BuiltinOperator_CONV_2D) {
+        const auto *options = op->builtin_options_as_Conv2DOptions();
+        if (options == nullptr) {
+          continue;
+        }
+        conv_params_t params = {};
+        params.stride = {options->stride_w(), options->stride_h()};
+        params.padding = {
+            ConvPadding(options->padding(), input_dims.width, filter_dims.width,
+                        options->stride_w(), output_dims.width),
+            ConvPadding(options->padding(), input_dims.height, filter_dims.height,
+                        options->stride_h(), output_dims.height)};
+        params.dilation = {options->dilation_w_factor(), options->dilation_h_factor()};
+        for (int j = 0; j < tflite::ConvImplCount(); j++) {
+          scratch = std::max(scratch, tflite::GetConvImpl(j).get_scratch_size(
+                                          &input_dims, &filter_dims, &output_dims, &params));
+        }
+        if (conv_winograd) {
+          scratch = std::max(scratch, esp_nn_get_conv_scratch_size_winograd(
+                                          &input_dims, &filter_dims, &output_dims, &params));
+        }
+      } else {
+        const auto *options = op->builtin_options_as_DepthwiseConv2DOptions();
+        if (options == nullptr) {
+          continue;
+        }
+        dw_conv_params_t params = {};
+        params.ch_mult = options->depth_multiplier();
+        params.stride = {options->stride_w(), options->stride_h()};
+        params.padding = {
+            ConvPadding(options->padding(), input_dims.width, filter_dims.width,
+                        options->stride_w(), output_dims.width),
+            ConvPadding(options->padding(), input_dims.height, filter_dims.height,
+                        options->stride_h(), output_dims.height)};
+        params.dilation = {options->dilation_w_factor(), options->dilation_h_factor()};
+        for (int j = 0; j < tflite::DepthwiseConvImplCount(); j++) {
+          scratch = std::max(scratch, tflite::GetDepthwiseConvImpl(j).get_scratch_size(
+                                          &input_dims, &filter_dims, &output_dims, &params));
+        }
+      }
+      size_t bytes = scratch + alignment;
+      if (i + 1 < operators->size()) {
+        const auto *next = operators->Get(i + 1);
+        const auto *pool = next->builtin_options_as_Pool2DOptions();
+        if (tflite::GetBuiltinCode(model->operator_codes()->Get(next->opcode_index())) ==
+                tflite::BuiltinOperator_MAX_POOL_2D &&
+            pool != nullptr && next->inputs()->Get(0) == op->outputs()->Get(0)) {
+          bytes += pool->filter_height() * output_dims.width * output_dims.channels +
+                   alignment;
+        }
+      }
+      per_worker = std::max(per_worker, bytes);
+    }
+    return (parallel_workers - 1) * per_worker;
+  }
+
+#if CONFIG_TFLITE_SPLIT_ARENA && defined(TENSOR_ARENA_PERSISTENT_SIZE)
+  // Internal RAM the split arena may use for activations and scratch buffers.
+  size_t arena_internal_limit = CONFIG_TFLITE_ARENA_INTERNAL_LIMIT * 1024;
+  tflite::SplitMemoryPlanner* split_planner = nullptr;
+
+  // Puts the persistent part of the arena in PSRAM and as many activation and
+  // scratch buffers as fit in arena_internal_limit bytes of internal RAM,
+  // spilling the rest to PSRAM. Returns nullptr if either can't be allocated.
+  tflite::MicroAllocator* CreateSplitAllocator() {
+    const size_t alignment = tflite::MicroArenaBufferAlignment();
+    const size_t non_persistent_size =
+        TENSOR_ARENA_NON_PERSISTENT_SIZE + WeightTileHeadroom() + AutotuneHeadroom() +
+        WinogradHeadroom() + ParallelHeadroom() + BatchHeadroom();
+    const size_t fast_size =
+        std::min<size_t>(arena_internal_limit, non_persistent_size);
+    if (fast_size <= alignment) {
+      return nullptr;
+    }
+    // The persistent arena, then, unless everything fits in internal RAM,
+    // room to spill every buffer in the worst case.
+    const size_t spill_size =
+        fast_size < non_persistent_size ? non_persistent_size : 0;
+    uint8_t *fast = (uint8_t *) heap_caps_malloc(fast_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    const size_t persistent_size =
+        TENSOR_ARENA_PERSISTENT_SIZE + WeightTileNodeHeadroom() + AutotuneNodeHeadroom() +
+        WinogradNodeHeadroom() + RowBandNodeHeadroom() + BatchNodeHeadroom();
+    uint8_t *slow = (uint8_t *) heap_caps_malloc(
+        persistent_size + spill_size + alignment, MALLOC_CAP_SPIRAM);
+    if (fast == nullptr || slow == nullptr) {
+      heap_caps_free(fast);
+      heap_caps_free(slow);
+      return nullptr;
+    }
+    uint8_t *spill = tflite::AlignPointerUp(slow + persistent_size, alignment);
+
+    // The head loses up to one alignment to a misaligned `fast`.
+    // NOLINTNEXTLINE(runtime-global-variables)
+    static tflite::SplitMemoryPlanner planner(fast_size - alignment, spill, spill_size);
+    split_planner = &planner;
+    return tflite::MicroAllocator::Create(slow, persistent_size, fast, fast_size, &planner);
+  }
+#endif
+
+#if defined(COLLECT_CPU_STATS)
+  // Records cycles, MACs and bytes of every node the interpreter invokes.
+  NodeProfiler profiler;
+#endif
+
+  // Quantization of the output scores, read from the model in setup(). The
+  // softmax's uint8 output is usually 1/256 per step from 0.
+  float output_scale = 1.0f / 256;
+  int32_t output_zero_point = 0;
+
+  void ReadOutputQuantization() {
+    const tflite::Model *flatbuffer = tflite::GetModel(g_person_detect_model_data);
+    const auto *subgraph = flatbuffer->subgraphs()->Get(0);
+    const auto *quantization =
+        subgraph->tensors()->Get(subgraph->outputs()->Get(0))->quantization();
+    if (quantization != nullptr && quantization->scale() != nullptr &&
+        quantization->scale()->size() > 0 && quantization->zero_point() != nullptr &&
+        quantization->zero_point()->size() > 0) {
+      output_scale = quantization->scale()->Get(0);
+      output_zero_point = quantization->zero_point()->Get(0);
+    }
+  }
+
+  void DequantizeScores(const uint8_t *scores, float *gesture_scores) {
+    for (int i = 0; i < kCategoryCount; i++) {
+      gesture_scores[i] = (scores[i] - output_zero_point) * output_scale;
+    }
+  }
+
+  // Smooths the camera loop's scores over time and tells it when the scene
+  // has been blank long enough to slow down (see gesture_recognizer.h).
+#ifdef CONFIG_TFLITE_GESTURE_WINDOW_MS
+  GestureRecognizer recognizer(CONFIG_TFLITE_GESTURE_WINDOW_MS,
+                               CONFIG_TFLITE_GESTURE_THRESHOLD / 100.0f,
+                               CONFIG_TFLITE_GESTURE_SUPPRESSION_MS, 3,
+                               CONFIG_TFLITE_IDLE_AFTER_MS);
+#else
+  GestureRecognizer recognizer;
+#endif
+
+  // Time between inferences while the recognizer is idle, 0 to keep
+  // inferring at full rate.
+#ifdef CONFIG_TFLITE_IDLE_FRAME_INTERVAL_MS
+  int idle_frame_interval_ms = CONFIG_TFLITE_IDLE_FRAME_INTERVAL_MS;
+#else
+  int idle_frame_interval_ms = 500;
+#endif
+
+  // Pull in only the operation implementations we need.
+  // This relies on a complete list of all the ops needed by this graph.
+  // An easier approach is to just use the AllOpsResolver, but this will
+  // incur some penalty in code space for op implementations that are not
+  // needed by this graph.
+  //
+  // tflite::AllOpsResolver resolver;
+  const tflite::MicroOpResolver& OpResolver() {
+    // NOLINTNEXTLINE(runtime-global-variables)
+    static tflite::MicroMutableOpResolver<7> micro_op_resolver;
+    static bool registered = false;
+    if (!registered) {
+      micro_op_resolver.AddConv2D();
+      micro_op_resolver.AddMaxPool2D();        // Add for MaxPooling2D
+      micro_op_resolver.AddFullyConnected();   // Add for Dense layers
+      micro_op_resolver.AddAveragePool2D();
+      micro_op_resolver.AddReshape();
+      micro_op_resolver.AddSoftmax();
+      micro_op_resolver.AddQuantize();
+      registered = true;
+    }
+    return micro_op_resolver;
+  }
 }  // namespace
 
+int measure_arena(int verbose, size_t *required, size_t *required_persistent,
+                  size_t *required_non_persistent) {
+  // Unlike the other options, row bands are measured with: they shrink the
+  // arena.
+  tflite::SetRowBandStages(row_band_stages);
+  ArenaUsage usage;
+  if (MeasureArena(tflite::GetModel(g_person_detect_model_data), OpResolver(),
+                   kLegacyTensorArenaSize, verbose, &usage) != kTfLiteOk) {
+    return -1;
+  }
+  PrintArenaUsage(usage);
+  *required = usage.required;
+  *required_persistent = usage.required_persistent;
+  *required_non_persistent = usage.required_non_persistent;
+  return 0;
+}
+
 // The name of this function is important for Arduino compatibility.
 void setup() {
   // Initialize PSRAM
@@ -74,6 +604,24 @@ void setup() {
   printf("Total PSRAM size: %d\n", esp_psram_get_size());
   printf("Free PSRAM size: %d\n", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
 
+  ReadOutputQuantization();
+
+#if CONFIG_TFLITE_AOT_MODEL
+  if (!ModelAotCheck()) {
+    printf("model_aot.cc wasn't generated from this model, regenerate it\n");
+    return;
+  }
+  const size_t aot_arena_size = ModelAotArenaSize();
+  aot_arena = (uint8_t *) heap_caps_malloc(aot_arena_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (aot_arena == NULL) {
+    aot_arena = (uint8_t *) heap_caps_malloc(aot_arena_size, MALLOC_CAP_SPIRAM);
+  }
+  aot_input = (uint8_t *) heap_caps_malloc(kMaxImageSize, MALLOC_CAP_8BIT);
+  if (aot_arena == NULL || aot_input == NULL) {
+    printf("Couldn't allocate memory of %u bytes\n", (unsigned) aot_arena_size);
+    return;
+  }
+#else
   // Map the model into a usable data structure. This doesn't involve any
   // copying or parsing, it's a very lightweight operation.
   model = tflite::GetModel(g_person_detect_model_data);
@@ -83,38 +631,78 @@ void setup() {
     return;
   }
 
-  // Allocate tensor arena in PSRAM
-  if (tensor_arena == NULL) {
-    //tensor_arena = (uint8_t *) heap_caps_malloc(kTensorArenaSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-    tensor_arena = (uint8_t *) heap_caps_malloc(kTensorArenaSize, MALLOC_CAP_SPIRAM);
+  tflite::SetRowBandStages(row_band_stages);
+#if CONFIG_TFLITE_ARENA_SIZING
+  // Measure before the real arena takes its share of PSRAM.
+  ArenaUsage usage;
+  if (MeasureArena(model, OpResolver(), kLegacyTensorArenaSize, true, &usage) == kTfLiteOk) {
+    PrintArenaUsage(usage);
+    printf("Add to main/tensor_arena_size.h:\n"
+           "#define TENSOR_ARENA_SIZE_%s %u\n"
+           "#define TENSOR_ARENA_PERSISTENT_SIZE_%s %u\n"
+           "#define TENSOR_ARENA_NON_PERSISTENT_SIZE_%s %u\n",
+           ArenaSizeTarget(), (unsigned) usage.required,
+           ArenaSizeTarget(), (unsigned) usage.required_persistent,
+           ArenaSizeTarget(), (unsigned) usage.required_non_persistent);
   }
-  if (tensor_arena == NULL) {
-    printf("MIRAMEEEE OLAAAAA MIRAMEEEECouldn't allocate memory of %d bytes\n", kTensorArenaSize);
+#endif
+
+  tflite::SetWeightTileSize(weight_tile_size);
+  tflite::SetKernelAutotune(kernel_autotune);
+  tflite::SetConvWinograd(conv_winograd);
+  tflite::SetParallelMinMacs(parallel_min_macs);
+  if (ParallelExecutorStart(parallel_workers) != kTfLiteOk) {
+    printf("Couldn't start %d workers\n", parallel_workers);
     return;
   }
+#if CONFIG_TFLITE_KERNEL_AUTOTUNE_NVS
+  if (kernel_autotune) {
+    AutotuneNvsCacheInstall();
+  }
+#endif
+
+  tflite::MicroAllocator *allocator = nullptr;
+#if CONFIG_TFLITE_SPLIT_ARENA && defined(TENSOR_ARENA_PERSISTENT_SIZE)
+  allocator = CreateSplitAllocator();
+  if (allocator == nullptr) {
+    printf("Couldn't allocate the split arena, using a single one\n");
+  }
+#endif
+
+  if (allocator == nullptr) {
+    // Allocate the tensor arena, in internal RAM when it fits there.
+    const size_t arena_size = kTensorArenaSize + WeightTileHeadroom() + AutotuneHeadroom() +
+                              WinogradHeadroom() + WinogradNodeHeadroom() +
+                              ParallelHeadroom() + RowBandNodeHeadroom() +
+                              BatchHeadroom() + BatchNodeHeadroom();
+    if (tensor_arena == NULL) {
+      tensor_arena = (uint8_t *) heap_caps_malloc(arena_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (tensor_arena == NULL) {
+      tensor_arena = (uint8_t *) heap_caps_malloc(arena_size, MALLOC_CAP_SPIRAM);
+    }
+    if (tensor_arena == NULL) {
+      printf("Couldn't allocate memory of %u bytes\n", (unsigned) arena_size);
+      return;
+    }
+    allocator = tflite::MicroAllocator::Create(tensor_arena, arena_size);
+  }
 
-  // Pull in only the operation implementations we need.
-  // This relies on a complete list of all the ops needed by this graph.
-  // An easier approach is to just use the AllOpsResolver, but this will
-  // incur some penalty in code space for op implementations that are not
-  // needed by this graph.
-  //
-  // tflite::AllOpsResolver resolver;
-  // NOLINTNEXTLINE(runtime-global-variables)
-  static tflite::MicroMutableOpResolver<6> micro_op_resolver;
-  micro_op_resolver.AddConv2D();
-  micro_op_resolver.AddMaxPool2D();        // Add for MaxPooling2D
-  micro_op_resolver.AddFullyConnected();   // Add for Dense layers
-  micro_op_resolver.AddAveragePool2D();
-  micro_op_resolver.AddReshape();
-  micro_op_resolver.AddSoftmax();
-  micro_op_resolver.AddQuantize();
-  
   // Build an interpreter to run the model with.
+#if defined(COLLECT_CPU_STATS)
+  profiler.Init(model);
+  // NOLINTNEXTLINE(runtime-global-variables)
+  static tflite::MicroInterpreter static_interpreter(model, OpResolver(), allocator, nullptr, &profiler);
+#else
   // NOLINTNEXTLINE(runtime-global-variables)
-  static tflite::MicroInterpreter static_interpreter(model, micro_op_resolver, tensor_arena, kTensorArenaSize);
+  static tflite::MicroInterpreter static_interpreter(model, OpResolver(), allocator);
+#endif
   interpreter = &static_interpreter;
 
+  if (interpreter->SetBatchSize(batch_size) != kTfLiteOk) {
+    return;
+  }
+
   // Allocate memory from the tensor_arena for the model's tensors.
   TfLiteStatus allocate_status = interpreter->AllocateTensors();
   if (allocate_status != kTfLiteOk) {
@@ -124,6 +712,7 @@ void setup() {
 
   // Get information about the memory area to use for the model's input.
   input = interpreter->input(0);
+#endif  // CONFIG_TFLITE_AOT_MODEL
 
 #ifndef CLI_ONLY_INFERENCE
   // Initialize Camera
@@ -135,93 +724,249 @@ void setup() {
 #endif
 }
 
+// Runs the model on `frame`, or on the frame already in the input buffer if
+// nullptr, and returns its uint8 scores, or nullptr if the interpreter
+// evaluates a batch of frames.
+static const uint8_t* Invoke(void* frame) {
+#if CONFIG_TFLITE_AOT_MODEL
+  ModelAotInvoke(aot_arena, frame != nullptr ? (const uint8_t*) frame : aot_input,
+                 aot_output);
+  return aot_output;
+#else
+  // A batch would run batch_size inferences for the one frame, on stale
+  // frames in the other inputs, so single frames need a batch of 1.
+  if (interpreter->batch_size() > 1) {
+    MicroPrintf("Batch of %d, single frames need a batch of 1; score frames "
+                "with run_inference_batch()", interpreter->batch_size());
+    return nullptr;
+  }
+  // The model takes uint8 pixels as they are, so infer on the caller's
+  // buffer instead of copying it into the arena.
+  if (frame != nullptr) {
+    interpreter->SetInputBuffer(0, frame);
+  }
+  // Run the model on this input and make sure it succeeds.
+  if (kTfLiteOk != interpreter->Invoke()) {
+    MicroPrintf("Invoke failed.");
+  }
+  if (frame != nullptr) {
+    interpreter->SetInputBuffer(0, nullptr);
+  }
+  return interpreter->output(0)->data.uint8;
+#endif
+}
+
 #ifndef CLI_ONLY_INFERENCE
+// Runs the model on `frame`, or on the frame already in the input buffer if
+// nullptr, and reports the result.
+static void InvokeAndRespond(uint8_t* frame) {
+  const uint8_t* scores = Invoke(frame);
+  if (scores == nullptr) {
+    vTaskDelay(1); // to avoid watchdog trigger
+    return;
+  }
+  float gesture_scores[kCategoryCount];
+  DequantizeScores(scores, gesture_scores);
+
+  GestureResult result;
+  const int32_t time_ms = esp_timer_get_time() / 1000;
+  if (kTfLiteOk != recognizer.ProcessLatestResults(gesture_scores, time_ms, &result)) {
+    return;
+  }
+  RespondToGesture(result);
+
+  // While the scene stays blank, sleep between inferences instead of
+  // running flat out. A pipelined capture task keeps replacing its queued
+  // frame meanwhile, or waits with the blocking policy.
+  if (result.idle && idle_frame_interval_ms > 0) {
+    vTaskDelay(idle_frame_interval_ms / portTICK_PERIOD_MS);
+  } else {
+    vTaskDelay(1); // to avoid watchdog trigger
+  }
+}
+
 // The name of this function is important for Arduino compatibility.
 void loop() {
+  // Infer straight out of the camera's frame buffer when it is already in
+  // the model's input format.
+  uint8_t* frame = nullptr;
+  if (kTfLiteOk == AcquireImage(kNumCols, kNumRows, kNumChannels, &frame)) {
+    InvokeAndRespond(frame);
+    ReleaseImage();
+    return;
+  }
+
   // Get image from provider.
-  if (kTfLiteOk != GetImage(kNumCols, kNumRows, kNumChannels, input->data.uint8)) {
+#if CONFIG_TFLITE_AOT_MODEL
+  uint8_t* input_buffer = aot_input;
+#else
+  uint8_t* input_buffer = input->data.uint8;
+#endif
+  if (kTfLiteOk != GetImage(kNumCols, kNumRows, kNumChannels, input_buffer)) {
     MicroPrintf("Image capture failed.");
   }
 
-  //for (int i = 0; i < 96 * 96; i++) {
-      //printf("%.6f, ", input->data.f[i]);
-  //}
+  InvokeAndRespond(nullptr);
+}
 
-  // Run the model on this input and make sure it succeeds.
-  if (kTfLiteOk != interpreter->Invoke()) {
-    MicroPrintf("Invoke failed.");
+void loop_pipelined() {
+  // The capture task fills another slot while this one is inferred in place.
+  uint8_t* frame = nullptr;
+  if (kTfLiteOk != FramePipelineAcquire(&frame, portMAX_DELAY)) {
+    MicroPrintf("No frame from the capture pipeline.");
+    return;
   }
 
-  // Process the inference results.
-  //int8_t person_score = output->data.uint8[kPersonIndex];
-  //int8_t no_person_score = output->data.uint8[kNotAPersonIndex];
+  InvokeAndRespond(frame);
+  FramePipelineRelease();
+}
+#endif
 
-  //float person_score_f =
-  //    (person_score - output->params.zero_point) * output->params.scale;
-  //float no_person_score_f =
-  //    (no_person_score - output->params.zero_point) * output->params.scale;
+void model_input_dims(int *width, int *height, int *channels) {
+  *width = kNumCols;
+  *height = kNumRows;
+  *channels = kNumChannels;
+}
 
-  TfLiteTensor* output = interpreter->output(0);
-  float gesture_scores[kCategoryCount];
+void profile_print(int raw_events) {
+#if CONFIG_TFLITE_AOT_MODEL
+  printf("No per-node profile, the model is compiled ahead of time\n");
+#elif defined(COLLECT_CPU_STATS)
+  if (raw_events) {
+    profiler.LogEvents();
+  } else {
+    profiler.Log();
+  }
+#else
+  printf("Profiling disabled, define COLLECT_CPU_STATS in esp_main.h\n");
+#endif
+}
 
-  for (int i = 0; i < kCategoryCount; i++) {
-    gesture_scores[i] = output->data.uint8[i];
+void profile_print_ops(int json) {
+#if !CONFIG_TFLITE_AOT_MODEL && defined(COLLECT_CPU_STATS)
+  profiler.LogOps(json != 0);
+#else
+  if (json) {
+    printf("[]");
+  } else {
+    profile_print(0);
   }
+#endif
+}
 
-  // Respond to detection
-  RespondToDetection(gesture_scores);
-  vTaskDelay(1); // to avoid watchdog trigger
+void arena_set_internal_limit(size_t bytes) {
+#if CONFIG_TFLITE_SPLIT_ARENA && defined(TENSOR_ARENA_PERSISTENT_SIZE)
+  arena_internal_limit = bytes;
+#endif
+}
+
+void weight_tiling_set(size_t tile_bytes) {
+  weight_tile_size = tile_bytes;
+}
+
+void kernel_autotune_set(int enabled) {
+  kernel_autotune = enabled != 0;
+}
+
+void conv_winograd_set(int enabled) {
+  conv_winograd = enabled != 0;
+}
+
+void parallel_workers_set(int workers) {
+  parallel_workers = workers;
 }
+
+void parallel_min_macs_set(long macs) {
+  parallel_min_macs = macs;
+}
+
+void row_band_stages_set(int stages) {
+  row_band_stages = stages;
+}
+
+void idle_frame_interval_set(int interval_ms) {
+  idle_frame_interval_ms = interval_ms;
+}
+
+void batch_size_set(int size) {
+  batch_size = size;
+}
+
+int batch_size_get(void) {
+#if CONFIG_TFLITE_AOT_MODEL
+  return 1;
+#else
+  return interpreter != nullptr ? interpreter->batch_size() : batch_size;
 #endif
+}
 
-#if defined(COLLECT_CPU_STATS)
-  long long total_time = 0;
-  long long start_time = 0;
-  extern long long softmax_total_time;
-  extern long long dc_total_time;
-  extern long long conv_total_time;
-  extern long long fc_total_time;
-  extern long long pooling_total_time;
-  extern long long add_total_time;
-  extern long long mul_total_time;
+int run_inference_batch(const uint8_t *frames, int count, uint8_t *scores) {
+#if CONFIG_TFLITE_AOT_MODEL
+  for (int i = 0; i < count; i++) {
+    ModelAotInvoke(aot_arena, frames + i * kMaxImageSize, scores + i * kCategoryCount);
+  }
+  return 0;
+#else
+  if (interpreter == nullptr || count < 1 || count > interpreter->batch_size()) {
+    return -1;
+  }
+  // A full batch is inferred where it is, a partial one copied into the
+  // arena. The scores of the inputs past `count` are left over from the
+  // last batch.
+  const bool in_place = count == interpreter->batch_size();
+  if (in_place) {
+    interpreter->SetInputBuffer(0, const_cast<uint8_t *>(frames));
+  } else {
+    memcpy(input->data.uint8, frames, count * kMaxImageSize);
+  }
+  const TfLiteStatus status = interpreter->Invoke();
+  if (in_place) {
+    interpreter->SetInputBuffer(0, nullptr);
+  }
+  if (status != kTfLiteOk) {
+    MicroPrintf("Invoke failed.");
+    return -1;
+  }
+  memcpy(scores, interpreter->output(0)->data.uint8, count * kCategoryCount);
+  return 0;
 #endif
+}
 
-void run_inference(void *ptr) {
-  
-  // VER ESTO SI ES QUE PORCENTAJES ESTAN NOTABLEMENTE MALOS....
-  /* Convert from uint8 picture data to int8 */
-  for (int i = 0; i < kNumCols * kNumRows; i++) {
-    input->data.int8[i] = ((uint8_t *) ptr)[i];
+void arena_print(void) {
+#if CONFIG_TFLITE_SPLIT_ARENA && defined(TENSOR_ARENA_PERSISTENT_SIZE)
+  if (split_planner != nullptr) {
+    split_planner->PrintMemoryPlan();
+    return;
+  }
+#endif
+#if CONFIG_TFLITE_AOT_MODEL
+  if (aot_arena != nullptr) {
+    printf("Ahead-of-time model arena, %u bytes\n", (unsigned) ModelAotArenaSize());
+  }
+#endif
+  if (interpreter != nullptr) {
+    printf("Single arena, %u bytes used\n", (unsigned) interpreter->arena_used_bytes());
   }
+}
+
+void profile_reset(void) {
+#if defined(COLLECT_CPU_STATS)
+  profiler.Reset();
+#endif
+}
 
+void run_inference(void *ptr) {
 #if defined(COLLECT_CPU_STATS)
   long long start_time = esp_timer_get_time();
 #endif
-  // Run the model on this input and make sure it succeeds.
-  if (kTfLiteOk != interpreter->Invoke()) {
-    MicroPrintf("Invoke failed.");
+  const uint8_t* scores = Invoke(ptr);
+  if (scores == nullptr) {
+    return;
   }
 
 #if defined(COLLECT_CPU_STATS)
   long long total_time = (esp_timer_get_time() - start_time);
   printf("Total time = %lld\n", total_time / 1000);
-  //printf("Softmax time = %lld\n", softmax_total_time / 1000);
-  //printf("FC time = %lld\n", fc_total_time / 1000);
-  //printf("DC time = %lld\n", dc_total_time / 1000);
-  //printf("conv time = %lld\n", conv_total_time / 1000);
-  //printf("Pooling time = %lld\n", pooling_total_time / 1000);
-  //printf("add time = %lld\n", add_total_time / 1000);
-  //printf("mul time = %lld\n", mul_total_time / 1000);
-
-  /* Reset times */
-  total_time = 0;
-  //softmax_total_time = 0;
-  dc_total_time = 0;
-  conv_total_time = 0;
-  fc_total_time = 0;
-  pooling_total_time = 0;
-  add_total_time = 0;
-  mul_total_time = 0;
 #endif
 
   // Process the inference results.
@@ -236,16 +981,18 @@ void run_inference(void *ptr) {
   RespondToDetection(person_score_f, no_person_score_f);
   */
 
-  TfLiteTensor* output = interpreter->output(0);
   float gesture_scores[kCategoryCount];
 
+#if CONFIG_TFLITE_AOT_MODEL
+  printf("Input type: %s\n", "UINT8");
+  printf("Output type: %s\n", "UINT8");
+#else
   printf("Input type: %s\n", TfLiteTypeGetName(input->type));
-  printf("Output type: %s\n", TfLiteTypeGetName(output->type));
+  printf("Output type: %s\n", TfLiteTypeGetName(interpreter->output(0)->type));
+#endif
 
 
-  for (int i = 0; i < kCategoryCount; i++) {
-    gesture_scores[i] = output->data.uint8[i];
-  }
+  DequantizeScores(scores, gesture_scores);
 
   RespondToDetection(gesture_scores);
   vTaskDelay(8000 / portTICK_PERIOD_MS); // to avoid watchdog trigger
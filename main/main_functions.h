@@ -30,6 +30,10 @@ void setup();
 // compatibility.
 void loop();
 
+// Same as loop(), but takes the newest frame from the capture pipeline (see
+// frame_pipeline.h) instead of capturing it on the calling core.
+void loop_pipelined();
+
 #ifdef __cplusplus
 }
 #endif
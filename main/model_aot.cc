@@ -0,0 +1,941 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Generated by `model_aot_gen main/model_aot.cc` from
+// person_detect_model_data.cc, do not edit. See model_aot.h.
+
+#include "model_aot.h"
+
+#include <algorithm>
+
+#include "model_aot_ops.h"
+#include "person_detect_model_data.h"
+
+namespace {
+
+constexpr int kModelSize = 321072;
+constexpr uint32_t kModelHash = 0x4fe76f58;
+
+// Planned activations and scratch buffers, followed by the esp-nn
+// scratch buffer.
+constexpr size_t kActivationsSize = 107424;
+constexpr uintptr_t kAlignment = 16;
+
+template <typename T>
+const T* Weights(size_t offset) {
+  return reinterpret_cast<const T*>(g_person_detect_model_data + offset);
+}
+
+// CONV_2D + MAX_POOL_2D, operators 1-2
+namespace op1 {
+
+constexpr data_dims_t kInputDims = {96, 96, 1, 1};
+constexpr data_dims_t kFilterDims = {3, 3, 0, 0};
+constexpr data_dims_t kConvDims = {94, 94, 32, 1};
+constexpr conv_params_t kConvParams = {0, -128, {1, 1}, {0, 0}, {0, 0}, {-128, 127}};
+constexpr int32_t kBias[] = {
+    -20, 68, -67, -170, -55, 3,
+    -28, 103, -46, -115, -85, -76,
+    68, -73, 31, 24, 77, -76,
+    163, -78, 53, -11, -6, -268,
+    67, -24, 26, -45, 22, 61,
+    -108, 11,
+};
+constexpr int32_t kShift[] = {
+    -8, -8, -7, -8, -8, -8,
+    -8, -8, -8, -7, -8, -8,
+    -7, -8, -8, -8, -7, -8,
+    -8, -8, -7, -8, -8, -8,
+    -8, -7, -8, -8, -7, -8,
+    -8, -7,
+};
+constexpr int32_t kMultiplier[] = {
+    1795386296, 1902631644, 1204341921, 1574271079, 1735380800, 1621278822,
+    1934513042, 2109422412, 2104443447, 1215905436, 1898070834, 2049695626,
+    1157385438, 1335572207, 1513743830, 2034618750, 1148436243, 1596981926,
+    1822054827, 1969514739, 1168778770, 1548947346, 1658654306, 1719498262,
+    1567376094, 1113718633, 1855764958, 1764314501, 1155295560, 1851899580,
+    1439330900, 1226692416,
+};
+constexpr model_aot::PoolParams kPool = {2, 2, 2, 2, 0, 0, -128, 127};
+constexpr data_dims_t kOutputDims = {47, 47, 32, 1};
+
+}  // namespace op1
+
+// CONV_2D + MAX_POOL_2D, operators 3-4
+namespace op3 {
+
+constexpr data_dims_t kInputDims = {47, 47, 32, 1};
+constexpr data_dims_t kFilterDims = {3, 3, 0, 0};
+constexpr data_dims_t kConvDims = {45, 45, 64, 1};
+constexpr conv_params_t kConvParams = {0, -128, {1, 1}, {0, 0}, {0, 0}, {-128, 127}};
+constexpr int32_t kBias[] = {
+    -690617, -316086, -433317, -254826, -397424, -356603,
+    -383579, -128848, -433584, -199051, -490044, -302146,
+    -320511, -510119, -289061, -447149, -464452, -446011,
+    -332386, -462557, -168384, -556991, -266658, -312984,
+    -365491, -834481, -541698, -344284, -43299, -456250,
+    -336227, -144770, -373590, -320762, -124970, -103220,
+    -197153, -637287, -416737, -643670, -711042, -146885,
+    -478287, -344828, -327278, -400877, -277232, -307244,
+    -536432, -375824, -209371, -374539, -585610, -444696,
+    -179964, -552832, -194113, -498058, -218013, -326105,
+    6462, -495967, -15690, -301362,
+};
+constexpr int32_t kShift[] = {
+    -10, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -8, -9,
+};
+constexpr int32_t kMultiplier[] = {
+    1853193391, 2074644373, 1628750328, 1948483892, 1272065581, 1770518433,
+    1625673402, 1618576686, 1711075076, 1748222128, 1501838751, 1622007501,
+    1490411671, 1736008416, 1480936661, 1811255898, 1656996415, 1442046656,
+    1724555577, 1566903129, 1535073147, 1264712122, 2144641126, 1493907987,
+    1560786075, 1110113258, 1425156366, 1927020057, 1130060183, 1275278449,
+    1532533258, 1562724056, 1614410755, 1634218164, 1673341677, 1593242670,
+    1581967407, 1398210187, 1843241376, 1554728738, 1608671142, 1673184603,
+    1265334845, 1312374720, 1708740414, 1093815518, 1584444529, 1758252258,
+    1374528602, 1317851492, 1502473776, 1588562412, 1557307106, 1795957060,
+    1400777726, 1178431086, 1459386194, 1460014280, 2036588521, 1466135540,
+    1449821188, 1429483681, 1099121128, 1932781540,
+};
+constexpr model_aot::PoolParams kPool = {2, 2, 2, 2, 0, 0, -128, 127};
+constexpr data_dims_t kOutputDims = {22, 22, 64, 1};
+
+}  // namespace op3
+
+// CONV_2D + MAX_POOL_2D, operators 5-6
+namespace op5 {
+
+constexpr data_dims_t kInputDims = {22, 22, 64, 1};
+constexpr data_dims_t kFilterDims = {3, 3, 0, 0};
+constexpr data_dims_t kConvDims = {20, 20, 64, 1};
+constexpr conv_params_t kConvParams = {0, -128, {1, 1}, {0, 0}, {0, 0}, {-128, 127}};
+constexpr int32_t kBias[] = {
+    -437024, -840577, -405148, -414875, -854938, -1042254,
+    -503340, -1338517, -137052, -688035, -469664, -724573,
+    -817282, -580142, -721031, -420844, -520785, -456774,
+    -762276, -869874, -854482, -403897, -621884, -322789,
+    -638419, -836368, -290406, -126372, -1276804, -408916,
+    -284566, -404067, -750069, -458616, -1089151, -233690,
+    -612714, -1299924, -406369, -917600, -547620, -702674,
+    -317075, -623413, -246592, -322558, -1029086, -820106,
+    -848247, -454343, -801565, -645878, -747859, -431270,
+    -474975, -207800, -494294, -589115, -639889, -454738,
+    -463605, -547055, -638280, -1188180,
+};
+constexpr int32_t kShift[] = {
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -10, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -10, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -10,
+};
+constexpr int32_t kMultiplier[] = {
+    1577579486, 1333330288, 1455289199, 1325107347, 1272133899, 1395200644,
+    1318882600, 1097527704, 1508504909, 1271314556, 1154885868, 1295424495,
+    1503741701, 1830620936, 1455708117, 1469821379, 1328160163, 1322037416,
+    1329633702, 1281174413, 1333643960, 1221584448, 1449335534, 1350437646,
+    1297619214, 1700954199, 1377390992, 1435216763, 2119951231, 1437711580,
+    1522151156, 1190927827, 1181853280, 1707195765, 1187992355, 1456848705,
+    1360964486, 1815676035, 1495647612, 1093424495, 1509956907, 1243786882,
+    1207486923, 1503459997, 2025775534, 1721080733, 1292326728, 1668484793,
+    1650476158, 1213424752, 1404502798, 1108556970, 1302340324, 1876627310,
+    1412691116, 1554390988, 1559085835, 1469444658, 1426474183, 1416996554,
+    1470694919, 1615485968, 1543359558, 1622746845,
+};
+constexpr model_aot::PoolParams kPool = {2, 2, 2, 2, 0, 0, -128, 127};
+constexpr data_dims_t kOutputDims = {10, 10, 64, 1};
+
+}  // namespace op5
+
+// CONV_2D + MAX_POOL_2D, operators 7-8
+namespace op7 {
+
+constexpr data_dims_t kInputDims = {10, 10, 64, 1};
+constexpr data_dims_t kFilterDims = {3, 3, 0, 0};
+constexpr data_dims_t kConvDims = {8, 8, 96, 1};
+constexpr conv_params_t kConvParams = {0, -128, {1, 1}, {0, 0}, {0, 0}, {-128, 127}};
+constexpr int32_t kBias[] = {
+    -150161, -1129833, -745064, -478421, -207436, -497173,
+    -671988, -438083, -596124, -431708, -948792, -670849,
+    -841271, -517898, -505570, -697367, -451159, -531244,
+    -755211, -740765, -618926, -303217, -619559, -972164,
+    -372565, -387086, -420289, -160354, -228104, -131534,
+    -606369, -487031, -339504, -619175, -451214, -211756,
+    -623689, -510844, -349264, -481687, -624391, -395563,
+    -1014095, -240914, -443666, -679006, -464874, -727671,
+    -518049, -72390, -329895, -477241, -814736, -452246,
+    -388587, -512293, -491740, -487609, -490865, -623433,
+    -230845, -981123, -463098, -472219, -259411, -509432,
+    -283128, -327687, -391593, -571398, -228880, -362958,
+    -783115, -349551, -373941, -455422, -978966, -211770,
+    -924858, -309588, -551889, -571399, -238589, -66485,
+    -643137, -569171, -451586, -347998, -588537, -1004114,
+    -643528, -245650, -586093, -448169, -1104978, -131900,
+};
+constexpr int32_t kShift[] = {
+    -8, -8, -8, -8, -8, -8,
+    -8, -8, -8, -8, -9, -9,
+    -8, -8, -8, -9, -8, -8,
+    -8, -9, -8, -8, -9, -9,
+    -8, -8, -8, -8, -8, -8,
+    -9, -8, -8, -8, -8, -8,
+    -8, -8, -9, -8, -8, -8,
+    -9, -8, -8, -8, -9, -8,
+    -8, -8, -8, -8, -9, -8,
+    -8, -8, -8, -8, -9, -9,
+    -9, -9, -8, -8, -8, -8,
+    -8, -8, -8, -8, -8, -8,
+    -9, -8, -8, -8, -9, -8,
+    -9, -8, -8, -8, -8, -8,
+    -8, -8, -8, -8, -9, -8,
+    -9, -8, -8, -8, -9, -8,
+};
+constexpr int32_t kMultiplier[] = {
+    1360756886, 1092696405, 1263020961, 1108116784, 1128747325, 1101222002,
+    1215711579, 1090251971, 1343241034, 1256506470, 1529312455, 2052759269,
+    1277770404, 1404945109, 1504018308, 1890482456, 1334513331, 1143762554,
+    1421476733, 2014621220, 1283595825, 1094160359, 1731326292, 1366273613,
+    1266145527, 1199600768, 1089230370, 1148579826, 1084620653, 1087981293,
+    2036998357, 1147954606, 1207142990, 1325386778, 1252332722, 1259336304,
+    1370311915, 1128251253, 2146259212, 1337337375, 1430853834, 1256679376,
+    1801610875, 1535104589, 1190911290, 1365857396, 1725744948, 1136816777,
+    1092624638, 1120541745, 1103848622, 1315604101, 1701561962, 1485869575,
+    1424338151, 1284949276, 1449276866, 1112986413, 2081744970, 1970442276,
+    2124805772, 1882666872, 1381944795, 1088101076, 1170087837, 1188514785,
+    1144283911, 1575534770, 1394628731, 1190909332, 1277832040, 1402113232,
+    2020868818, 1367141633, 1189869598, 1503476519, 1694841363, 1146864303,
+    1470940586, 1141770603, 1176953503, 1277595540, 1594713617, 1157135985,
+    1121973773, 1092513539, 1115892185, 1109062956, 2077363496, 1098593679,
+    1939018185, 1149177122, 1169197427, 1214916263, 1324603806, 1309226164,
+};
+constexpr model_aot::PoolParams kPool = {2, 2, 2, 2, 0, 0, -128, 127};
+constexpr data_dims_t kOutputDims = {4, 4, 96, 1};
+
+}  // namespace op7
+
+// CONV_2D + MAX_POOL_2D, operators 9-10
+namespace op9 {
+
+constexpr data_dims_t kInputDims = {4, 4, 96, 1};
+constexpr data_dims_t kFilterDims = {3, 3, 0, 0};
+constexpr data_dims_t kConvDims = {2, 2, 96, 1};
+constexpr conv_params_t kConvParams = {0, -128, {1, 1}, {0, 0}, {0, 0}, {-128, 127}};
+constexpr int32_t kBias[] = {
+    -1385657, -927040, -769476, -1775040, -1024017, -1439484,
+    -756563, -1173186, -1104124, -1599353, -708575, -1312763,
+    -1267390, -954950, -441583, -663044, -404787, -1354183,
+    -936732, -1138228, -640892, -1568689, -827914, -999921,
+    -1051439, -1868419, -395106, -697431, -329248, -833328,
+    -311789, -1112513, -564513, -618731, -136869, -863272,
+    -1913204, -537916, -854384, -693181, -632465, -76168,
+    -686855, -1531735, -921086, -678711, -1285987, -839898,
+    -1683111, -880680, -399290, -1201353, -655211, -478277,
+    -1160475, -1499966, -1024131, -398169, -344592, -665202,
+    -807281, -668060, -569159, -1090155, -387608, -770011,
+    -1140446, -797865, -197606, -1332644, -207806, -286434,
+    -533486, -835494, -531609, -372688, -650421, -742621,
+    -729701, -716615, -1564101, -383305, -918908, -1588178,
+    -456810, -491980, -535087, -667569, -713124, -250783,
+    -1296952, -665722, -1296868, -220596, -1072339, -295972,
+};
+constexpr int32_t kShift[] = {
+    -9, -9, -9, -10, -9, -10,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -8, -10,
+    -9, -9, -9, -10, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -9, -9, -9, -9,
+    -10, -9, -9, -8, -8, -9,
+    -9, -10, -10, -9, -10, -9,
+    -9, -9, -9, -9, -8, -9,
+    -10, -10, -8, -9, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -10, -8, -9, -10,
+    -9, -9, -9, -9, -8, -9,
+    -10, -9, -10, -9, -9, -8,
+};
+constexpr int32_t kMultiplier[] = {
+    1101992643, 1439256496, 1659218451, 1571305166, 1659512310, 1880395467,
+    2018088978, 1360490630, 1443348047, 1149168540, 2138303645, 1329503657,
+    1188225661, 1333369441, 1498918229, 1775015617, 1355220019, 1943315174,
+    1280776632, 1730542979, 1637835172, 2087014361, 1208694994, 1681493770,
+    1862257047, 1170367564, 1654213931, 1971422170, 1662388241, 2090747588,
+    1320286052, 1552586565, 2011376843, 1838622529, 1890450135, 1577057169,
+    1540251914, 1883793674, 2008917699, 1083626643, 1097041424, 1829631248,
+    2012362928, 1892576351, 1843973372, 1601119916, 2123380503, 1843342260,
+    1652585851, 2055203021, 1789348531, 1163702801, 1086226228, 1515101640,
+    2143187608, 1797406889, 1141404599, 2061592694, 1140008423, 1761768974,
+    1890961805, 1478430338, 1772924982, 1266725157, 1891931426, 1214999132,
+    1225088404, 1409717605, 2065951312, 1226217372, 1128202257, 1470566072,
+    1710599688, 1888753543, 1947494631, 1907850700, 2054274563, 1645619764,
+    1308648094, 1791136657, 1807503138, 1092025114, 1944039495, 1869161320,
+    1788471282, 1787807241, 1894791311, 1813272443, 1152155470, 1963470556,
+    2109127960, 1713962593, 2009506392, 1974862097, 1752177000, 1144359576,
+};
+constexpr model_aot::PoolParams kPool = {2, 2, 2, 2, 0, 0, -128, 127};
+constexpr data_dims_t kOutputDims = {1, 1, 96, 1};
+
+}  // namespace op9
+
+// FULLY_CONNECTED, operator 12
+namespace op12 {
+
+constexpr int32_t kAccumDepth = 96;
+constexpr int32_t kChannels = 384;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = -128;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    -161824, -169570, -7010, -14180, -30726, -50305,
+    91573, -101920, -257649, -51550, -159529, -116001,
+    50705, -211787, -75313, 46959, -68636, -6757,
+    -8168, -132024, -39754, -111802, -44330, 19585,
+    -131875, -43459, 45664, 15794, -72645, -81302,
+    -11355, -144728, -56706, -55065, -83952, -126238,
+    -142481, -48515, -65529, 22978, -39276, 23686,
+    93100, 62783, 190, -73882, -168868, -21116,
+    -46036, 58717, -28807, 196084, -77196, 11160,
+    -318820, 126885, -126629, 55438, 3138, 60308,
+    212615, 29117, -10852, -69312, 61994, -1196,
+    138639, 62121, 34523, -95800, 10566, -105991,
+    45704, -64213, -8874, -23185, -82339, -60068,
+    -87267, 2188, -66088, -90488, -66571, -87380,
+    -45915, -13595, -47985, 185344, -132608, -4665,
+    -157323, -54049, -178161, -80303, -167355, -42293,
+    -48074, -86639, -59625, 1094, -2646, 2594,
+    -53322, -33127, -153032, 23648, -40893, -211104,
+    69579, 10450, -52302, 28469, -50700, 12218,
+    18240, -5595, -21023, -92151, -153376, -177086,
+    -122034, -7561, -17208, 67576, 11951, -57030,
+    -45225, -154489, -153749, -56103, -68131, -39147,
+    -6604, -302374, -25146, 7874, 5732, -117434,
+    41472, -76614, 53707, -23209, -2794, -105804,
+    -53930, -39600, 17507, -157151, -20042, 64312,
+    -68627, -153613, 68223, -29301, -46216, -85337,
+    34173, -70453, -7870, -80439, -147064, -101557,
+    -51420, 17795, -55973, -96275, -83196, -156823,
+    -91545, -33294, -55751, 17186, -1813, 8752,
+    -91215, 31638, -31929, -53959, 40455, 34108,
+    -24697, -86753, 62870, -175429, 31517, -7211,
+    -48188, 83756, 33826, -144203, -43094, -33956,
+    -105609, -27879, 56340, -80242, -11797, -55868,
+    -34502, 55362, 3275, -96311, -5319, 25458,
+    -98437, -4153, -88596, -79971, -72959, -74849,
+    -22437, -81402, 59360, -62157, -161858, 57848,
+    -106421, -24141, 69610, -27150, -121502, -31467,
+    -191348, -101564, -5973, -92187, -8228, -108618,
+    160100, -118401, 123247, -22262, -33818, -82892,
+    -9648, 51852, -59485, -94216, -135142, 132563,
+    -118114, -134252, -81379, 31004, -119990, -118452,
+    15952, -113132, 9543, -96325, -112237, -134347,
+    37045, -81254, -101517, -92723, -85663, -96833,
+    34734, 46274, -14950, 59536, 4376, 207613,
+    -113857, -27583, -64116, -37461, 25988, -64555,
+    -154976, -90141, -32416, 12834, 37495, -136174,
+    -77719, 741, -27781, 126789, -45600, -58016,
+    -60790, -157612, -118344, -18923, 8958, -166187,
+    -7325, -144788, -37205, -71127, -44049, -63960,
+    -86623, -127225, -37431, -72738, -35523, -141928,
+    1436, -67637, -113522, -13011, -91509, -72467,
+    -11177, -73167, 7638, -20025, -192752, -7931,
+    -147396, -52501, -88433, -86280, 36918, -557,
+    62361, -97330, -54871, 65061, -198684, -97402,
+    -25556, -36560, -24668, -31435, -50498, -160595,
+    -106364, -93343, -34964, -307062, -48464, -145300,
+    -5229, 30224, -189795, -104272, -3288, -106672,
+    8251, -87973, 83770, -72144, -63772, 16544,
+    -122842, -161116, -41797, -108222, 72997, 32747,
+    -46067, 50877, -131262, -35549, 101966, -39764,
+    67281, -45809, -115872, -6045, -283105, 54358,
+    -105504, -94795, -2521, -10654, -108108, -30306,
+    -3367, -65126, -53853, -72593, -82092, -116570,
+    -52758, -36996, 34220, -128296, -72144, -123385,
+};
+constexpr int32_t kShift[] = {
+    -8, -8, -9, -8, -8, -9,
+    -8, -8, -9, -9, -8, -9,
+    -8, -9, -9, -8, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -9, -9, -9, -9,
+    -8, -8, -9, -8, -8, -8,
+    -9, -8, -9, -8, -9, -8,
+    -9, -9, -9, -8, -8, -8,
+    -9, -8, -9, -9, -8, -9,
+    -9, -9, -8, -8, -8, -9,
+    -9, -8, -9, -9, -9, -8,
+    -9, -9, -8, -8, -9, -8,
+    -8, -9, -9, -8, -9, -8,
+    -8, -9, -9, -9, -9, -8,
+    -9, -8, -8, -9, -8, -9,
+    -9, -8, -9, -9, -8, -9,
+    -8, -9, -8, -8, -9, -9,
+    -9, -8, -8, -8, -9, -8,
+    -8, -9, -9, -8, -8, -9,
+    -8, -8, -9, -8, -9, -9,
+    -8, -9, -9, -9, -9, -8,
+    -9, -9, -9, -8, -9, -9,
+    -9, -8, -8, -8, -8, -9,
+    -8, -9, -8, -9, -9, -8,
+    -8, -8, -9, -8, -9, -8,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -8, -9, -9, -8,
+    -9, -9, -9, -8, -8, -9,
+    -9, -9, -8, -8, -9, -8,
+    -9, -9, -9, -8, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -8, -8, -8, -9,
+    -9, -9, -9, -8, -8, -9,
+    -9, -9, -8, -8, -9, -9,
+    -9, -8, -9, -9, -8, -9,
+    -8, -8, -8, -8, -8, -8,
+    -9, -9, -8, -8, -8, -8,
+    -9, -9, -9, -8, -9, -8,
+    -9, -9, -9, -9, -9, -8,
+    -8, -8, -9, -8, -9, -8,
+    -8, -9, -9, -9, -9, -9,
+    -8, -8, -8, -8, -9, -8,
+    -9, -8, -8, -8, -8, -8,
+    -9, -9, -9, -9, -8, -9,
+    -8, -8, -8, -9, -9, -9,
+    -8, -8, -8, -8, -9, -9,
+    -8, -8, -9, -9, -8, -8,
+    -8, -9, -9, -9, -8, -8,
+    -8, -8, -8, -8, -8, -8,
+    -9, -9, -9, -8, -9, -9,
+    -8, -9, -9, -9, -8, -8,
+    -9, -8, -8, -8, -9, -9,
+    -8, -8, -9, -8, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -8, -8, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -8, -9, -8, -8,
+    -9, -9, -9, -9, -9, -9,
+    -8, -8, -9, -8, -9, -9,
+    -8, -8, -8, -9, -8, -9,
+    -9, -8, -8, -8, -9, -9,
+    -9, -8, -9, -9, -9, -8,
+    -8, -8, -8, -9, -8, -9,
+    -8, -9, -9, -8, -9, -9,
+};
+constexpr int32_t kMultiplier[] = {
+    1301234476, 1121572924, 1965523552, 1131748771, 1143288711, 2040569873,
+    1389174700, 1144092881, 1745571173, 2145056357, 1169818521, 2016057760,
+    1249583971, 1986148325, 2044173572, 1479788390, 1150567452, 1789209158,
+    1649102143, 1811106680, 1628221609, 1768602913, 1990249521, 1552311377,
+    1451179063, 2063890277, 2076003906, 1615867975, 1962178905, 2139225953,
+    1374502584, 1107963251, 1759483795, 1248618067, 1179126734, 1331744961,
+    1831503743, 1075262598, 1966800457, 1255921916, 1535801134, 1149806400,
+    1939810033, 1887444625, 2137549907, 1150319309, 1089958351, 1177347742,
+    2071807124, 1536223133, 1950011942, 1422807490, 1354993415, 1855086835,
+    1621381144, 1508975042, 1076761152, 1560671348, 1214684666, 1580460955,
+    1746402702, 1409060931, 2034062747, 1790219738, 1707176222, 1311224432,
+    1484514012, 1650789272, 1112466099, 1171361232, 1915147961, 1213170873,
+    1481641409, 1562863767, 2040525197, 1445206406, 1870785462, 1191989121,
+    1166176640, 2014992980, 1862209036, 1605784510, 1785518531, 1357165661,
+    2147449126, 1236408418, 1457317178, 1743842831, 1142737273, 1775150213,
+    1599757739, 1113216069, 1811598809, 1975804250, 1413780320, 1779461456,
+    1103448454, 1958327583, 1099100846, 1407647141, 1723989327, 2068722741,
+    2131521231, 1108760234, 1406286598, 1299566222, 1688682049, 1160705290,
+    1333883266, 1917470253, 1824954885, 1103427501, 1213585080, 1671288328,
+    1179778693, 1124022923, 1468950280, 1093582223, 1917233019, 1986957689,
+    1161857517, 1497921517, 1742605753, 1602146006, 1968117883, 1196149020,
+    2124652541, 1712337004, 1465014281, 1195866937, 1984085432, 2015215668,
+    1712027908, 1076024256, 1603910019, 1492645062, 1399234181, 1940227357,
+    1120049001, 1580764510, 1173715298, 2037686706, 2138707156, 1211565391,
+    1113625427, 1315188917, 1706660023, 1199907787, 1951695088, 1095238182,
+    1658031129, 2135425368, 1833765600, 1908278578, 1082337093, 2121234819,
+    1735671781, 2131441576, 1173472697, 1786558722, 1734104654, 1179313577,
+    1885393334, 1588736423, 1679964149, 1568024030, 1138284036, 1943901533,
+    2128953741, 1978255374, 1425156968, 1097999356, 1533778588, 1285327967,
+    2028758413, 1703133209, 2048343687, 1350460003, 1944080410, 1881114645,
+    2076494824, 1741913793, 1985038522, 2061678290, 2070811955, 1733020133,
+    1098421354, 2045207702, 1176304348, 1478065416, 1129905189, 2023608021,
+    1842602636, 1498057277, 2038079787, 1078323517, 1109105262, 1942242456,
+    2146766344, 1987976408, 1079303447, 1315142509, 1651655607, 2132773028,
+    1581120014, 1101109020, 1991964529, 2095560609, 1461710328, 2142403151,
+    1085018784, 1107896410, 1105986767, 1259119461, 1095126665, 1106007719,
+    2144466564, 1941486599, 1158822919, 1488825775, 1410770918, 1136011529,
+    1877964634, 1850710309, 2026148671, 1252898314, 1835592645, 1148004291,
+    2101048149, 1797418304, 1777753202, 1918101432, 1622684370, 1079131843,
+    1285632561, 1242998576, 1723935127, 1124139202, 1425059736, 1178692527,
+    1221936826, 2140107873, 1610063545, 2146322700, 2127908355, 1786329974,
+    1300329438, 1381449025, 1336202354, 1166749290, 1606067805, 1183206891,
+    2028730361, 1355489354, 1118238840, 1227995372, 1086664614, 1190030213,
+    1608541095, 1729267687, 2043530963, 1872551380, 1191524611, 1565627278,
+    1181641323, 1175514724, 1690376624, 2126563570, 1664667608, 1613712267,
+    1145598535, 1106634830, 1248905085, 1135465892, 2073311392, 1903168014,
+    1148333041, 1370166492, 2132060808, 2037180550, 1365423899, 1188586725,
+    1094322842, 2101217676, 1623548627, 1635545199, 1131301231, 1252424886,
+    1323945951, 1262256052, 1128440229, 1138506897, 1125010213, 1545147616,
+    2066224343, 2036071094, 1831348069, 1096000793, 1724549856, 1897928616,
+    1124039200, 1824887178, 1994865878, 1731878814, 1092918748, 1130290131,
+    1839837393, 1091170493, 1299732891, 1164672631, 2119247599, 1829294007,
+    1388141348, 1229195913, 1923568194, 1259255827, 1362428955, 1827414494,
+    1944475396, 1931737166, 1713333039, 1798042211, 1687819177, 2100173849,
+    1228654085, 1794933413, 1136638986, 1125579833, 1234778174, 1998617285,
+    1757171374, 1879763626, 2041354995, 2051454044, 1938608974, 2097078557,
+    1966639935, 1478766207, 1267908444, 2094121103, 1502792770, 1117142111,
+    1830735245, 2007043751, 1670593944, 1855132031, 1663347412, 2015700178,
+    1094172363, 1137973900, 1643315550, 1189670466, 2016776734, 2145523378,
+    1080169696, 1194932116, 1170521390, 2000947542, 1220173419, 1786087372,
+    1742770951, 1268177973, 1243633825, 1085248832, 1846888944, 2056792145,
+    1736407897, 1413630188, 1940250734, 1698390269, 1994114004, 1323110006,
+    1229240675, 1167455017, 1148595296, 1843601268, 1203458584, 1851126420,
+    1095076015, 2093219616, 1626798727, 1099782417, 1975399740, 1616671625,
+};
+
+}  // namespace op12
+
+// FULLY_CONNECTED, operator 13
+namespace op13 {
+
+constexpr int32_t kAccumDepth = 384;
+constexpr int32_t kChannels = 64;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = -128;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    -159456, -89103, -148998, 73661, -300362, -275004,
+    -105256, -252200, -341815, 209014, -200185, -117751,
+    -72271, 117526, -193836, 113304, -353431, 367457,
+    -118078, -110077, 66672, -22891, 87278, -66772,
+    101697, -162442, -250620, -54142, 39883, -144279,
+    -26659, -255734, -90932, -140514, -117111, -110952,
+    -385343, -332737, -481317, 137157, 95606, -141547,
+    -24482, -439216, -445972, -384174, -530728, 196316,
+    963, -224942, -411102, -26127, -68153, 36893,
+    -3127, -649730, -190216, -97962, -195229, -449300,
+    304452, -80885, -191280, 9950,
+};
+constexpr int32_t kShift[] = {
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -9, -9, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10, -10, -10,
+    -10, -10, -10, -10,
+};
+constexpr int32_t kMultiplier[] = {
+    1624148195, 1728802806, 1989356169, 1699449284, 1614037264, 1372004209,
+    1841152814, 2023937554, 1295354767, 1255151424, 1818072541, 1685088101,
+    1875886565, 2085541412, 1078086518, 1078053512, 1294904728, 1659264935,
+    1687647490, 2093609108, 1592569180, 1347131356, 1820699705, 1711019417,
+    1875269007, 1870059307, 1653801778, 1492855656, 1887160996, 1513233309,
+    1600528933, 1590862333, 1561129661, 1930020773, 2106490228, 1569883625,
+    1583525120, 1340777462, 1284295080, 1803593450, 1683709026, 1413919693,
+    1786871223, 1988083480, 1275674800, 1763893287, 1211482075, 1620531692,
+    1439610421, 1619411161, 1177430649, 1578854097, 1445454077, 1574800218,
+    1765386429, 1158798454, 1489496348, 1855452761, 1616745801, 1482308387,
+    1290795632, 2005170846, 1695178273, 1689041095,
+};
+
+}  // namespace op13
+
+// FULLY_CONNECTED, operator 14
+namespace op14 {
+
+constexpr int32_t kAccumDepth = 64;
+constexpr int32_t kChannels = 192;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = -128;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    -50249, 16241, -48167, 40926, 51072, 88606,
+    -31217, -202257, 72330, 7212, 55116, 48335,
+    27946, 103856, 33523, 32183, -24, -3635,
+    -58035, -25219, -5616, 19401, -80871, -46990,
+    31512, 93647, -62302, -149262, -91611, 30870,
+    32380, -89365, -30957, 16979, -65652, 42541,
+    -81813, -180959, -116429, -143792, 72432, 51422,
+    82100, 68577, 35021, -11565, -67798, -50582,
+    72484, -61977, 28861, -7686, -46569, 79385,
+    27982, -97562, -112302, -69894, -173991, 65007,
+    -12415, -59101, -16132, 15912, 9646, -1667,
+    160472, 27153, 50346, 106584, -23276, -49011,
+    -22245, -30308, 74320, 21063, 41614, 13099,
+    -58346, -9161, 20715, -57932, -126386, 19818,
+    -308541, -122566, 6585, -63370, -32506, 73908,
+    -164618, 7608, -92796, 57739, -93839, -80785,
+    -134048, -147467, -7, -145940, 58871, 47134,
+    17069, 13060, 150066, -13931, -84214, 24421,
+    29992, 1311, -86555, -25316, -197165, -2938,
+    18950, -17067, 62173, -69317, -3291, -48258,
+    21504, -41012, -115573, -6854, -162828, -36652,
+    -25714, 25048, 61127, -63256, 25580, -64625,
+    69759, -31096, 52327, 60432, 1198, 42722,
+    54376, 53510, 41618, -59272, 30702, 158128,
+    61150, 8846, -75634, 32294, 36453, -12397,
+    -10456, -83251, -39298, -15511, 20242, -82931,
+    485, 8459, -87689, 45203, -69634, -16283,
+    76167, 63804, 73170, 22045, -32626, -48955,
+    -72952, -156844, -29842, -42929, -57848, 107658,
+    53670, -18769, 31361, -20790, 30909, 13551,
+    -12750, -9302, 83550, -24744, 3567, -30480,
+    14267, -29450, 101156, -100439, -20529, -116802,
+};
+constexpr int32_t kShift[] = {
+    -9, -9, -8, -9, -9, -9,
+    -9, -9, -9, -9, -9, -8,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -9, -9, -9, -9,
+    -9, -9, -9, -8, -9, -9,
+    -9, -9, -8, -9, -9, -9,
+    -9, -9, -8, -9, -9, -8,
+    -9, -9, -9, -9, -9, -9,
+    -8, -9, -9, -9, -9, -9,
+    -8, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -8, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -8, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -8, -8, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -8, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -8, -9, -9,
+    -9, -9, -9, -9, -8, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -8,
+    -9, -9, -9, -9, -9, -9,
+};
+constexpr int32_t kMultiplier[] = {
+    1667863112, 2139703621, 1184068936, 1989657598, 1498862496, 2111744938,
+    1605366364, 1550105977, 1739221508, 1742847499, 1683887932, 1191094094,
+    1918281489, 1701784544, 1766429727, 2026999354, 1544579286, 1876445560,
+    1986098030, 1638562549, 1751957498, 1470855840, 1632786647, 1609645644,
+    1376743051, 1683872310, 1817147601, 1357320295, 1604514789, 1698288079,
+    1435454637, 1547554449, 1577206319, 1091814286, 1743385654, 1691778688,
+    1736770477, 1470629262, 1110026903, 1751020802, 1795291403, 2105128162,
+    1983632976, 1418035537, 1075932892, 1720654632, 1438358948, 1173650146,
+    1447519503, 2102230862, 1777016175, 1218303913, 1800430007, 1889531257,
+    1285605671, 1597858528, 1399284027, 1930205265, 2110035637, 1653823989,
+    1197606069, 1744051120, 1669759752, 1662429783, 1923599437, 1474017358,
+    2076676222, 1769279792, 1636994706, 2076821616, 1688352337, 1910972185,
+    1660560697, 1659147104, 2040932199, 1416756759, 1119290414, 1615307150,
+    2084322564, 1471969174, 2143478696, 1935547692, 1834833749, 1325468450,
+    1425562316, 2049484854, 1369134964, 1828085848, 1652001153, 1417827409,
+    1947619815, 1571598567, 1714362471, 1553452989, 2038841577, 1518414533,
+    1562979611, 1613211854, 1777681272, 1662059410, 2136789592, 1507939283,
+    1675752023, 1531053962, 1664348319, 1582582572, 1115952012, 2070022544,
+    2115467120, 1623941359, 1202248833, 1902656933, 1739688073, 1404843930,
+    1791115325, 1683934920, 1667153609, 1734203081, 1698755997, 1694839095,
+    1477734620, 1563201392, 1405380362, 1181241381, 1637872604, 2107353107,
+    1735974131, 1834385635, 1236002607, 1741173624, 1304753385, 1688826281,
+    1772596176, 1933385849, 1537984774, 1601354132, 1453472781, 2093637122,
+    1569946095, 1420350277, 1131328956, 1290694827, 2043104251, 1947223118,
+    2036665712, 1672593826, 1555972658, 1848477405, 1538288109, 1703377358,
+    1729384294, 1798338770, 1519084058, 1977283370, 1983346616, 1457388330,
+    1717647979, 1900331860, 2047274793, 1205656488, 1923392909, 1878162856,
+    1223128850, 1631613532, 1679806816, 2114390812, 1250560695, 2106502146,
+    1731207376, 1609947379, 1721164741, 1742978133, 1816301561, 1762515285,
+    1690744571, 1719714738, 1799767739, 1544501792, 1510494624, 1662618722,
+    1808964334, 1751473590, 1769625810, 1614860513, 1716649657, 1132799747,
+    1571026955, 1486786560, 1722328876, 1587663856, 1747514250, 1539893346,
+};
+
+}  // namespace op14
+
+// FULLY_CONNECTED, operator 15
+namespace op15 {
+
+constexpr int32_t kAccumDepth = 192;
+constexpr int32_t kChannels = 64;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = -128;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    -319367, -13013, 61356, 21241, 6027, -216331,
+    -42161, 91246, -2388, -409497, 48001, 76220,
+    -302106, 6384, 19759, -347533, 223919, -72691,
+    -212489, -231337, -256283, -111581, 59782, 109600,
+    -369588, 243948, 354502, -113801, 172031, 70925,
+    112006, 30052, 281943, 105862, -46315, 2079,
+    144684, -254217, -126348, -187794, 172795, 55811,
+    13380, 148583, -142979, -130210, 186689, 139852,
+    28145, 29151, 22576, 38715, -11043, 207253,
+    172990, 152354, -244881, -58782, 29443, 88804,
+    -222883, -208277, 122860, 26608,
+};
+constexpr int32_t kShift[] = {
+    -10, -9, -9, -9, -9, -9,
+    -10, -9, -9, -10, -9, -9,
+    -10, -9, -10, -10, -9, -10,
+    -9, -10, -10, -9, -9, -9,
+    -10, -9, -9, -10, -9, -9,
+    -9, -10, -9, -9, -9, -9,
+    -9, -10, -10, -9, -10, -9,
+    -9, -9, -10, -9, -9, -10,
+    -9, -9, -9, -9, -9, -10,
+    -9, -9, -10, -9, -9, -9,
+    -9, -10, -9, -9,
+};
+constexpr int32_t kMultiplier[] = {
+    1770462658, 1109418790, 1130686652, 1320532812, 1348058069, 1247939597,
+    2015762686, 1281910445, 1394093133, 1741134037, 1377695908, 1074044961,
+    1973171669, 1082523698, 1842429365, 1798915721, 1181589154, 2128552233,
+    1409227287, 1890906944, 1910713028, 1146968491, 1410355094, 1492061399,
+    1968811241, 1082235501, 1083442592, 2046367021, 1160333249, 1238220334,
+    1124493385, 2049747092, 1186916839, 1663039944, 1352705323, 1233760363,
+    1082705115, 1710361841, 1734364148, 1330014222, 2108954985, 1329615285,
+    1439598414, 1304774435, 1876392444, 1356591719, 1591202560, 1854114903,
+    1335266507, 1431701479, 1254278181, 1326742149, 1165199164, 2061003685,
+    1835730458, 1370074223, 2037161471, 1155531920, 1202770267, 1482388214,
+    1170464092, 1783569532, 1316910852, 1264574143,
+};
+
+}  // namespace op15
+
+// FULLY_CONNECTED, operator 16
+namespace op16 {
+
+constexpr int32_t kAccumDepth = 64;
+constexpr int32_t kChannels = 32;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = -128;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    31752, 23056, -119944, 114208, -13450, 79396,
+    -53126, -137370, -108179, 62633, -124678, -178955,
+    -182673, 7881, -95880, -31998, -21402, 68866,
+    65393, 71194, -7393, -51207, 34876, -76933,
+    227137, -37509, 25709, 99466, -185986, 14117,
+    -30989, -56462,
+};
+constexpr int32_t kShift[] = {
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -8, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9,
+    -9, -9,
+};
+constexpr int32_t kMultiplier[] = {
+    1836995783, 1665089338, 1582257143, 1635122536, 1803848224, 1843797725,
+    1612175773, 1719092858, 1803205932, 1106795045, 1866530802, 1805484480,
+    1703886596, 1636511933, 1573081367, 1648170767, 2018312334, 1665885145,
+    1855358804, 1850474562, 2077880856, 1824764709, 1464313810, 1545764901,
+    2028032823, 1657669454, 1679367453, 1599155421, 1584121377, 1715972096,
+    1774951438, 1608589349,
+};
+
+}  // namespace op16
+
+// FULLY_CONNECTED + SOFTMAX, operators 17-18
+namespace op17 {
+
+constexpr int32_t kAccumDepth = 32;
+constexpr int32_t kChannels = 7;
+constexpr int32_t kInputOffset = 0;
+constexpr int32_t kFilterOffset = 0;
+constexpr int32_t kOutputOffset = 50;
+constexpr int32_t kActivationMin = -128;
+constexpr int32_t kActivationMax = 127;
+constexpr int32_t kBias[] = {
+    15990, -49690, -5385, 9831, -76045, -19097,
+    -58501,
+};
+constexpr int32_t kShift[] = {
+    -8, -8, -8, -8, -8, -8,
+    -8,
+};
+constexpr int32_t kMultiplier[] = {
+    1698438767, 1983440992, 1766582011, 1698441598, 1304365466, 1609848832,
+    1916605574,
+};
+constexpr int32_t kSoftmaxMultiplier = 2102345472;
+constexpr int32_t kSoftmaxShift = 27;
+constexpr int32_t kSoftmaxDiffMin = -15;
+
+}  // namespace op17
+
+}  // namespace
+
+size_t ModelAotArenaSize() {
+  int32_t scratch = 0;
+  scratch = std::max(scratch, model_aot::ConvScratchSize(
+      op1::kInputDims, op1::kFilterDims,
+      op1::kConvDims, op1::kConvParams));
+  scratch = std::max(scratch, model_aot::ConvScratchSize(
+      op3::kInputDims, op3::kFilterDims,
+      op3::kConvDims, op3::kConvParams));
+  scratch = std::max(scratch, model_aot::ConvScratchSize(
+      op5::kInputDims, op5::kFilterDims,
+      op5::kConvDims, op5::kConvParams));
+  scratch = std::max(scratch, model_aot::ConvScratchSize(
+      op7::kInputDims, op7::kFilterDims,
+      op7::kConvDims, op7::kConvParams));
+  scratch = std::max(scratch, model_aot::ConvScratchSize(
+      op9::kInputDims, op9::kFilterDims,
+      op9::kConvDims, op9::kConvParams));
+  scratch = std::max(scratch, esp_nn_get_softmax_scratch_size(7, 1));
+  return kAlignment - 1 + kActivationsSize + scratch;
+}
+
+bool ModelAotCheck() {
+  if (g_person_detect_model_data_len != kModelSize) {
+    return false;
+  }
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < kModelSize; i++) {
+    hash = (hash ^ g_person_detect_model_data[i]) * 16777619u;
+  }
+  return hash == kModelHash;
+}
+
+void ModelAotInvoke(uint8_t* arena, const uint8_t* input, uint8_t* output) {
+  int8_t* const activations = reinterpret_cast<int8_t*>(
+      (reinterpret_cast<uintptr_t>(arena) + kAlignment - 1) &
+      ~(kAlignment - 1));
+  esp_nn_set_conv_scratch_buf(activations + kActivationsSize);
+  esp_nn_set_softmax_scratch_buf(activations + kActivationsSize);
+
+  int8_t* const tensor26 = activations + 0;  // 1x47x47x32
+  int8_t* const tensor28 = activations + 70688;  // 1x22x22x64
+  int8_t* const tensor30 = activations + 0;  // 1x10x10x64
+  int8_t* const tensor32 = activations + 7936;  // 1x4x4x96
+  int8_t* const tensor34 = activations + 384;  // 1x1x1x96
+  int8_t* const tensor36 = activations + 0;  // 1x384
+  int8_t* const tensor37 = activations + 384;  // 1x64
+  int8_t* const tensor38 = activations + 0;  // 1x192
+  int8_t* const tensor39 = activations + 192;  // 1x64
+  int8_t* const tensor40 = activations + 0;  // 1x32
+  int8_t* const tensor42 = activations + 48;  // 1x7
+  int8_t* const band1 = activations + 70688;
+  int8_t* const band3 = activations + 101664;
+  int8_t* const band5 = activations + 6400;
+  int8_t* const band7 = activations + 6400;
+  int8_t* const band9 = activations + 0;
+  int8_t* const logits17 = activations + 32;
+
+  // CONV_2D + MAX_POOL_2D, operators 1-2
+  model_aot::ConvMaxPool(
+      op1::kInputDims, input, op1::kFilterDims,
+      Weights<int8_t>(760), op1::kBias, op1::kConvDims,
+      op1::kConvParams, model_aot::Quant(op1::kShift, op1::kMultiplier),
+      op1::kPool, op1::kOutputDims, band1, tensor26);
+
+  // CONV_2D + MAX_POOL_2D, operators 3-4
+  model_aot::ConvMaxPool(
+      op3::kInputDims, tensor26, op3::kFilterDims,
+      Weights<int8_t>(1200), op3::kBias, op3::kConvDims,
+      op3::kConvParams, model_aot::Quant(op3::kShift, op3::kMultiplier),
+      op3::kPool, op3::kOutputDims, band3, tensor28);
+
+  // CONV_2D + MAX_POOL_2D, operators 5-6
+  model_aot::ConvMaxPool(
+      op5::kInputDims, tensor28, op5::kFilterDims,
+      Weights<int8_t>(19912), op5::kBias, op5::kConvDims,
+      op5::kConvParams, model_aot::Quant(op5::kShift, op5::kMultiplier),
+      op5::kPool, op5::kOutputDims, band5, tensor30);
+
+  // CONV_2D + MAX_POOL_2D, operators 7-8
+  model_aot::ConvMaxPool(
+      op7::kInputDims, tensor30, op7::kFilterDims,
+      Weights<int8_t>(57056), op7::kBias, op7::kConvDims,
+      op7::kConvParams, model_aot::Quant(op7::kShift, op7::kMultiplier),
+      op7::kPool, op7::kOutputDims, band7, tensor32);
+
+  // CONV_2D + MAX_POOL_2D, operators 9-10
+  model_aot::ConvMaxPool(
+      op9::kInputDims, tensor32, op9::kFilterDims,
+      Weights<int8_t>(112760), op9::kBias, op9::kConvDims,
+      op9::kConvParams, model_aot::Quant(op9::kShift, op9::kMultiplier),
+      op9::kPool, op9::kOutputDims, band9, tensor34);
+
+  // FULLY_CONNECTED, operator 12
+  esp_nn_fully_connected_per_ch_s8(
+      tensor34, op12::kInputOffset, op12::kAccumDepth,
+      Weights<int8_t>(196112), op12::kFilterOffset,
+      op12::kBias, tensor36, op12::kChannels,
+      op12::kOutputOffset, op12::kShift, op12::kMultiplier,
+      op12::kActivationMin, op12::kActivationMax);
+
+  // FULLY_CONNECTED, operator 13
+  esp_nn_fully_connected_per_ch_s8(
+      tensor36, op13::kInputOffset, op13::kAccumDepth,
+      Weights<int8_t>(234536), op13::kFilterOffset,
+      op13::kBias, tensor37, op13::kChannels,
+      op13::kOutputOffset, op13::kShift, op13::kMultiplier,
+      op13::kActivationMin, op13::kActivationMax);
+
+  // FULLY_CONNECTED, operator 14
+  esp_nn_fully_connected_per_ch_s8(
+      tensor37, op14::kInputOffset, op14::kAccumDepth,
+      Weights<int8_t>(259392), op14::kFilterOffset,
+      op14::kBias, tensor38, op14::kChannels,
+      op14::kOutputOffset, op14::kShift, op14::kMultiplier,
+      op14::kActivationMin, op14::kActivationMax);
+
+  // FULLY_CONNECTED, operator 15
+  esp_nn_fully_connected_per_ch_s8(
+      tensor38, op15::kInputOffset, op15::kAccumDepth,
+      Weights<int8_t>(272472), op15::kFilterOffset,
+      op15::kBias, tensor39, op15::kChannels,
+      op15::kOutputOffset, op15::kShift, op15::kMultiplier,
+      op15::kActivationMin, op15::kActivationMax);
+
+  // FULLY_CONNECTED, operator 16
+  esp_nn_fully_connected_per_ch_s8(
+      tensor39, op16::kInputOffset, op16::kAccumDepth,
+      Weights<int8_t>(285040), op16::kFilterOffset,
+      op16::kBias, tensor40, op16::kChannels,
+      op16::kOutputOffset, op16::kShift, op16::kMultiplier,
+      op16::kActivationMin, op16::kActivationMax);
+
+  // FULLY_CONNECTED + SOFTMAX, operators 17-18
+  esp_nn_fully_connected_per_ch_s8(
+      tensor40, op17::kInputOffset, op17::kAccumDepth,
+      Weights<int8_t>(287240), op17::kFilterOffset,
+      op17::kBias, logits17, op17::kChannels,
+      op17::kOutputOffset, op17::kShift, op17::kMultiplier,
+      op17::kActivationMin, op17::kActivationMax);
+  esp_nn_softmax_s8(logits17, 1, op17::kChannels, op17::kSoftmaxMultiplier,
+                    op17::kSoftmaxShift, op17::kSoftmaxDiffMin, tensor42);
+
+  // QUANTIZE, operator 19
+  model_aot::Requantize(tensor42, 7, 128, 0, 255, output);
+}
@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// The model compiled ahead of time. model_aot.cc is generated from the
+// flatbuffer in person_detect_model_data.cc by host/src/model_aot_gen.cc:
+// every operator is a direct esp-nn call with its shapes and quantization
+// parameters baked in, the same operator pairs are fused as by
+// MicroInterpreterGraph::FuseOperators(), and every activation sits at an
+// offset planned offline in one arena. Running it needs no flatbuffer
+// parsing, op resolver, interpreter or AllocateTensors(); only the weights
+// are still read from g_person_detect_model_data.
+//
+// Regenerate model_aot.cc after changing the model:
+//
+//   ./build/host/model_aot_gen main/model_aot.cc
+
+#ifndef MODEL_AOT_H_
+#define MODEL_AOT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Bytes of arena ModelAotInvoke() needs, at any alignment. Includes the
+// esp-nn scratch buffers, whose size depends on the target.
+size_t ModelAotArenaSize();
+
+// False if g_person_detect_model_data is not the model model_aot.cc was
+// generated from.
+bool ModelAotCheck();
+
+// Runs the model on `input`, the model's uint8 input image, and writes its
+// uint8 output scores to `output`. `arena` must hold ModelAotArenaSize()
+// bytes; it only holds intermediate results, so it may be reused between
+// calls.
+void ModelAotInvoke(uint8_t* arena, const uint8_t* input, uint8_t* output);
+
+#endif  // MODEL_AOT_H_
@@ -0,0 +1,161 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Kernels the generated model_aot.cc calls besides plain esp-nn functions:
+// the pooling and fused conv + max pool kernels of
+// kernels/esp_nn/{pooling,conv}.cc written against esp-nn alone, so a
+// compiled model gives the same results as the interpreter.
+
+#ifndef MODEL_AOT_OPS_H_
+#define MODEL_AOT_OPS_H_
+
+#include "sdkconfig.h"
+
+#include <esp_nn.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace model_aot {
+
+struct PoolParams {
+  int32_t stride_width;
+  int32_t stride_height;
+  int32_t filter_width;
+  int32_t filter_height;
+  int32_t pad_width;
+  int32_t pad_height;
+  int32_t activation_min;
+  int32_t activation_max;
+};
+
+// esp-nn takes the per-channel parameters as non-const, but never writes
+// them.
+inline quant_data_t Quant(const int32_t* shift, const int32_t* mult) {
+  return {const_cast<int32_t*>(shift), const_cast<int32_t*>(mult)};
+}
+
+inline int32_t ConvScratchSize(const data_dims_t& input_dims,
+                               const data_dims_t& filter_dims,
+                               const data_dims_t& output_dims,
+                               const conv_params_t& params) {
+  return esp_nn_get_conv_scratch_size(&input_dims, &filter_dims, &output_dims,
+                                      &params);
+}
+
+inline void Conv(const data_dims_t& input_dims, const int8_t* input,
+                 const data_dims_t& filter_dims, const int8_t* filter,
+                 const int32_t* bias, const data_dims_t& output_dims,
+                 int8_t* output, const conv_params_t& params,
+                 const quant_data_t& quant) {
+  esp_nn_conv_s8(&input_dims, input, &filter_dims, filter, bias, &output_dims,
+                 output, &params, &quant);
+}
+
+// The model's uint8 input, read in place. params.in_offset is the uint8
+// zero point's.
+inline void Conv(const data_dims_t& input_dims, const uint8_t* input,
+                 const data_dims_t& filter_dims, const int8_t* filter,
+                 const int32_t* bias, const data_dims_t& output_dims,
+                 int8_t* output, const conv_params_t& params,
+                 const quant_data_t& quant) {
+  esp_nn_conv_u8_s8(&input_dims, input, &filter_dims, filter, bias,
+                    &output_dims, output, &params, &quant);
+}
+
+inline void MaxPool(const data_dims_t& input_dims, const int8_t* input,
+                    const PoolParams& pool, const data_dims_t& output_dims,
+                    int8_t* output) {
+  if (input_dims.channels % 4 == 0) {  // The S3 version needs multiples of 4
+    esp_nn_max_pool_s8(input, input_dims.width, input_dims.height, output,
+                       output_dims.width, output_dims.height,
+                       pool.stride_width, pool.stride_height,
+                       pool.filter_width, pool.filter_height, pool.pad_width,
+                       pool.pad_height, pool.activation_min,
+                       pool.activation_max, input_dims.channels);
+  } else {
+    esp_nn_max_pool_s8_ansi(input, input_dims.width, input_dims.height, output,
+                            output_dims.width, output_dims.height,
+                            pool.stride_width, pool.stride_height,
+                            pool.filter_width, pool.filter_height,
+                            pool.pad_width, pool.pad_height,
+                            pool.activation_min, pool.activation_max,
+                            input_dims.channels);
+  }
+}
+
+inline void AveragePool(const data_dims_t& input_dims, const int8_t* input,
+                        const PoolParams& pool, const data_dims_t& output_dims,
+                        int8_t* output) {
+  if (input_dims.channels % 4 == 0) {  // The S3 version needs multiples of 4
+    esp_nn_avg_pool_s8(input, input_dims.width, input_dims.height, output,
+                       output_dims.width, output_dims.height,
+                       pool.stride_width, pool.stride_height,
+                       pool.filter_width, pool.filter_height, pool.pad_width,
+                       pool.pad_height, pool.activation_min,
+                       pool.activation_max, input_dims.channels);
+  } else {
+    esp_nn_avg_pool_s8_ansi(input, input_dims.width, input_dims.height, output,
+                            output_dims.width, output_dims.height,
+                            pool.stride_width, pool.stride_height,
+                            pool.filter_width, pool.filter_height,
+                            pool.pad_width, pool.pad_height,
+                            pool.activation_min, pool.activation_max,
+                            input_dims.channels);
+  }
+}
+
+// A VALID conv followed by a max pool, computed one pooling window of conv
+// rows at a time into `band` (pool.filter_height conv rows), so the conv's
+// output never exists as a whole.
+template <typename InputT>
+void ConvMaxPool(const data_dims_t& input_dims, const InputT* input,
+                 const data_dims_t& filter_dims, const int8_t* filter,
+                 const int32_t* bias, const data_dims_t& conv_dims,
+                 const conv_params_t& params, const quant_data_t& quant,
+                 const PoolParams& pool, const data_dims_t& output_dims,
+                 int8_t* band, int8_t* output) {
+  const int input_row_size = input_dims.width * input_dims.channels;
+  const int output_row_size = output_dims.width * output_dims.channels;
+  for (int out_y = 0; out_y < output_dims.height; out_y++) {
+    const int32_t window_y = out_y * pool.stride_height - pool.pad_height;
+    const int32_t first_row = std::max<int32_t>(window_y, 0);
+    const int32_t rows =
+        std::min<int32_t>(window_y + pool.filter_height, conv_dims.height) -
+        first_row;
+    if (rows <= 0) {
+      continue;
+    }
+
+    const int32_t input_y = first_row * params.stride.height;
+    data_dims_t band_input_dims = input_dims;
+    band_input_dims.height -= input_y;
+    data_dims_t band_dims = conv_dims;
+    band_dims.height = rows;
+    Conv(band_input_dims, input + input_y * input_row_size, filter_dims,
+         filter, bias, band_dims, band, params, quant);
+
+    data_dims_t row_dims = output_dims;
+    row_dims.height = 1;
+    PoolParams row_pool = pool;
+    row_pool.pad_height = first_row - window_y;
+    MaxPool(band_dims, band, row_pool, row_dims,
+            output + out_y * output_row_size);
+  }
+}
+
+// Requantizes between two tensors of the same scale, which only moves the
+// zero point.
+template <typename InputT, typename OutputT>
+void Requantize(const InputT* input, int size, int32_t offset, int32_t min,
+                int32_t max, OutputT* output) {
+  for (int i = 0; i < size; i++) {
+    output[i] = static_cast<OutputT>(
+        std::min<int32_t>(std::max<int32_t>(input[i] + offset, min), max));
+  }
+}
+
+}  // namespace model_aot
+
+#endif  // MODEL_AOT_OPS_H_
@@ -0,0 +1,313 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node_profiler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "tensorflow/lite/schema/schema_utils.h"
+
+#include <esp_cpu.h>
+#include <esp_timer.h>
+
+namespace {
+
+uint32_t TensorBytes(const tflite::Tensor* tensor) {
+  if (tensor == nullptr || tensor->shape() == nullptr) {
+    return 0;
+  }
+  uint32_t elements = 1;
+  for (int32_t dim : *tensor->shape()) {
+    elements *= dim;
+  }
+  switch (tensor->type()) {
+    case tflite::TensorType_INT4:
+      return (elements + 1) / 2;
+    case tflite::TensorType_INT16:
+    case tflite::TensorType_FLOAT16:
+      return elements * 2;
+    case tflite::TensorType_INT32:
+    case tflite::TensorType_FLOAT32:
+      return elements * 4;
+    case tflite::TensorType_INT64:
+      return elements * 8;
+    default:
+      return elements;
+  }
+}
+
+uint64_t NumElements(const tflite::Tensor* tensor) {
+  if (tensor == nullptr || tensor->shape() == nullptr) {
+    return 0;
+  }
+  uint64_t elements = 1;
+  for (int32_t dim : *tensor->shape()) {
+    elements *= dim;
+  }
+  return elements;
+}
+
+int32_t Dim(const tflite::Tensor* tensor, int i) {
+  if (tensor == nullptr || tensor->shape() == nullptr ||
+      static_cast<int>(tensor->shape()->size()) <= i) {
+    return 0;
+  }
+  return tensor->shape()->Get(i);
+}
+
+// Multiply-accumulates (or, for pooling and elementwise ops, the equivalent
+// per-element operations) needed by one invocation of `op`.
+uint64_t NodeMacs(tflite::BuiltinOperator code, const tflite::Operator* op,
+                  const tflite::Tensor* filter, const tflite::Tensor* output) {
+  const uint64_t out_elements = NumElements(output);
+  switch (code) {
+    case tflite::BuiltinOperator_CONV_2D:
+      // Filter is [out_ch, h, w, in_ch].
+      return out_elements * Dim(filter, 1) * Dim(filter, 2) * Dim(filter, 3);
+    case tflite::BuiltinOperator_DEPTHWISE_CONV_2D:
+      // Filter is [1, h, w, out_ch].
+      return out_elements * Dim(filter, 1) * Dim(filter, 2);
+    case tflite::BuiltinOperator_FULLY_CONNECTED:
+      // Filter is [out_ch, in_depth].
+      return out_elements * Dim(filter, 1);
+    case tflite::BuiltinOperator_MAX_POOL_2D:
+    case tflite::BuiltinOperator_AVERAGE_POOL_2D: {
+      const tflite::Pool2DOptions* params = op->builtin_options_as_Pool2DOptions();
+      if (params == nullptr) {
+        return out_elements;
+      }
+      return out_elements * params->filter_height() * params->filter_width();
+    }
+    case tflite::BuiltinOperator_RESHAPE:
+      return 0;
+    default:
+      return out_elements;
+  }
+}
+
+}  // namespace
+
+void NodeProfiler::Init(const tflite::Model* model) {
+  num_nodes_ = 0;
+  if (model == nullptr || model->subgraphs() == nullptr ||
+      model->subgraphs()->size() == 0) {
+    return;
+  }
+  const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+  const auto* tensors = subgraph->tensors();
+  const auto* operators = subgraph->operators();
+  if (operators == nullptr) {
+    return;
+  }
+  auto tensor_at = [tensors](const flatbuffers::Vector<int32_t>* indices,
+                             int i) -> const tflite::Tensor* {
+    if (indices == nullptr || static_cast<int>(indices->size()) <= i ||
+        indices->Get(i) < 0) {
+      return nullptr;
+    }
+    return tensors->Get(indices->Get(i));
+  };
+
+  for (uint32_t i = 0; i < operators->size() && i < kMaxNodes; i++) {
+    const tflite::Operator* op = operators->Get(i);
+    const tflite::BuiltinOperator code =
+        tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index()));
+
+    uint32_t bytes = 0;
+    if (op->inputs() != nullptr) {
+      for (uint32_t j = 0; j < op->inputs()->size(); j++) {
+        bytes += TensorBytes(tensor_at(op->inputs(), j));
+      }
+    }
+    if (op->outputs() != nullptr) {
+      for (uint32_t j = 0; j < op->outputs()->size(); j++) {
+        bytes += TensorBytes(tensor_at(op->outputs(), j));
+      }
+    }
+
+    NodeStats& stats = nodes_[i];
+    stats.tag = tflite::EnumNameBuiltinOperator(code);
+    stats.macs = NodeMacs(code, op, tensor_at(op->inputs(), 1),
+                          tensor_at(op->outputs(), 0));
+    stats.bytes = bytes;
+    num_nodes_ = i + 1;
+  }
+  Reset();
+}
+
+uint32_t NodeProfiler::BeginEvent(const char* tag) {
+  return BeginNodeEvent(tag, -1, -1);
+}
+
+uint32_t NodeProfiler::BeginNodeEvent(const char* tag, int subgraph_idx,
+                                      int node_idx) {
+  const uint32_t seq = next_seq_++;
+  Event& event = events_[seq & (kNumEvents - 1)];
+  event.tag = tag;
+  event.seq = seq;
+  event.subgraph = subgraph_idx;
+  event.node = node_idx;
+  event.cycles = 0;
+  event.us = 0;
+  event.start_us = esp_timer_get_time();
+  event.start_cycles = esp_cpu_get_cycle_count();
+  return seq;
+}
+
+void NodeProfiler::EndEvent(uint32_t event_handle) {
+  const uint32_t end_cycles = esp_cpu_get_cycle_count();
+  const int64_t end_us = esp_timer_get_time();
+  Event& event = events_[event_handle & (kNumEvents - 1)];
+  if (event.seq != event_handle) {
+    // Overwritten by newer events while this one was still open.
+    return;
+  }
+  event.cycles = end_cycles - event.start_cycles;
+  event.us = static_cast<int32_t>(end_us - event.start_us);
+
+  if (event.subgraph != 0 || event.node < 0 || event.node >= kMaxNodes) {
+    return;
+  }
+  NodeStats& stats = nodes_[event.node];
+  if (stats.tag == nullptr) {
+    stats.tag = event.tag;
+  }
+  if (event.node >= num_nodes_) {
+    num_nodes_ = event.node + 1;
+  }
+  stats.count++;
+  stats.total_cycles += event.cycles;
+  stats.total_us += event.us;
+  if (event.cycles > stats.max_cycles) {
+    stats.max_cycles = event.cycles;
+  }
+}
+
+void NodeProfiler::Reset() {
+  for (int i = 0; i < kNumEvents; i++) {
+    events_[i] = {};
+  }
+  for (int i = 0; i < kMaxNodes; i++) {
+    nodes_[i].count = 0;
+    nodes_[i].total_cycles = 0;
+    nodes_[i].total_us = 0;
+    nodes_[i].max_cycles = 0;
+  }
+  next_seq_ = 0;
+}
+
+void NodeProfiler::Log() const {
+  uint64_t total_cycles = 0;
+  int64_t total_us = 0;
+  uint32_t invocations = 0;
+  for (int i = 0; i < num_nodes_; i++) {
+    if (nodes_[i].count == 0) {
+      continue;
+    }
+    total_cycles += nodes_[i].total_cycles / nodes_[i].count;
+    total_us += nodes_[i].total_us / nodes_[i].count;
+    if (nodes_[i].count > invocations) {
+      invocations = nodes_[i].count;
+    }
+  }
+  if (invocations == 0) {
+    printf("No inferences profiled yet\n");
+    return;
+  }
+
+  printf("Per-node profile, average over %" PRIu32 " invocation(s)\n",
+         invocations);
+  printf("%4s  %-20s %12s %12s %9s %12s %9s %10s %6s\n", "node", "op",
+         "cycles", "max_cycles", "us", "MACs", "MAC/cyc", "bytes", "%");
+  for (int i = 0; i < num_nodes_; i++) {
+    const NodeStats& stats = nodes_[i];
+    if (stats.count == 0) {
+      continue;
+    }
+    const uint64_t cycles = stats.total_cycles / stats.count;
+    const int64_t us = stats.total_us / stats.count;
+    printf("%4d  %-20s %12" PRIu64 " %12" PRIu32 " %9" PRId64 " %12" PRIu64
+           " %9.2f %10" PRIu32 " %5.1f%%\n",
+           i, stats.tag != nullptr ? stats.tag : "?", cycles,
+           stats.max_cycles, us, stats.macs,
+           cycles != 0 ? static_cast<double>(stats.macs) / cycles : 0.0,
+           stats.bytes,
+           total_cycles != 0 ? 100.0 * cycles / total_cycles : 0.0);
+  }
+  printf("total: %" PRIu64 " cycles, %" PRId64 " us\n", total_cycles,
+         total_us);
+}
+
+void NodeProfiler::LogOps(bool json) const {
+  struct OpStats {
+    const char* tag;
+    int nodes;
+    uint64_t cycles;
+    int64_t us;
+    uint64_t macs;
+  };
+  OpStats ops[kMaxNodes];
+  int num_ops = 0;
+  uint64_t total_cycles = 0;
+  for (int i = 0; i < num_nodes_; i++) {
+    const NodeStats& stats = nodes_[i];
+    if (stats.count == 0) {
+      continue;
+    }
+    const char* tag = stats.tag != nullptr ? stats.tag : "?";
+    int op = 0;
+    while (op < num_ops && strcmp(ops[op].tag, tag) != 0) {
+      op++;
+    }
+    if (op == num_ops) {
+      ops[num_ops++] = {tag, 0, 0, 0, 0};
+    }
+    ops[op].nodes++;
+    ops[op].cycles += stats.total_cycles / stats.count;
+    ops[op].us += stats.total_us / stats.count;
+    ops[op].macs += stats.macs;
+    total_cycles += stats.total_cycles / stats.count;
+  }
+  std::sort(ops, ops + num_ops, [](const OpStats& a, const OpStats& b) {
+    return a.cycles > b.cycles;
+  });
+
+  if (json) {
+    printf("[");
+    for (int i = 0; i < num_ops; i++) {
+      printf("%s{\"op\":\"%s\",\"nodes\":%d,\"cycles\":%" PRIu64
+             ",\"us\":%" PRId64 ",\"macs\":%" PRIu64 ",\"percent\":%.1f}",
+             i != 0 ? "," : "", ops[i].tag, ops[i].nodes, ops[i].cycles,
+             ops[i].us, ops[i].macs,
+             total_cycles != 0 ? 100.0 * ops[i].cycles / total_cycles : 0.0);
+    }
+    printf("]");
+    return;
+  }
+  if (num_ops == 0) {
+    printf("No inferences profiled yet\n");
+    return;
+  }
+  printf("%-20s %5s %12s %9s %12s %6s\n", "op", "nodes", "cycles", "us",
+         "MACs", "%");
+  for (int i = 0; i < num_ops; i++) {
+    printf("%-20s %5d %12" PRIu64 " %9" PRId64 " %12" PRIu64 " %5.1f%%\n",
+           ops[i].tag, ops[i].nodes, ops[i].cycles, ops[i].us, ops[i].macs,
+           total_cycles != 0 ? 100.0 * ops[i].cycles / total_cycles : 0.0);
+  }
+}
+
+void NodeProfiler::LogEvents() const {
+  printf("\"Event\",\"Subgraph\",\"Node\",\"Tag\",\"Cycles\",\"Us\"\n");
+  const uint32_t first = next_seq_ > kNumEvents ? next_seq_ - kNumEvents : 0;
+  for (uint32_t seq = first; seq != next_seq_; seq++) {
+    const Event& event = events_[seq & (kNumEvents - 1)];
+    printf("%" PRIu32 ",%d,%d,%s,%" PRIu32 ",%" PRId32 "\n", event.seq,
+           event.subgraph, event.node,
+           event.tag != nullptr ? event.tag : "?", event.cycles, event.us);
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Per-node profiler for the MicroInterpreter. Every operator invocation is
+// recorded in a fixed-size ring buffer (oldest events are overwritten instead
+// of aborting like tflite::MicroProfiler) and folded into per-node totals, so
+// the cost of each individual layer can be inspected at runtime.
+
+#ifndef NODE_PROFILER_H_
+#define NODE_PROFILER_H_
+
+#include <cstdint>
+
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+class NodeProfiler : public tflite::MicroProfilerInterface {
+ public:
+  // Nodes of subgraph 0 beyond this index are only kept in the ring buffer.
+  static constexpr int kMaxNodes = 64;
+  // Must be a power of two.
+  static constexpr int kNumEvents = 256;
+
+  // Computes the static cost (MACs and bytes touched) of every node of the
+  // first subgraph of `model`. Can be skipped, the costs then read as zero.
+  void Init(const tflite::Model* model);
+
+  uint32_t BeginEvent(const char* tag) override;
+  uint32_t BeginNodeEvent(const char* tag, int subgraph_idx,
+                          int node_idx) override;
+  void EndEvent(uint32_t event_handle) override;
+
+  // Drops all recorded events and per-node totals, keeps the static costs.
+  void Reset();
+
+  // Prints one row per node with its average cycles, time, MACs and bytes.
+  void Log() const;
+
+  // Prints the per-node averages summed by operator, most expensive first,
+  // as a table or as a JSON array of objects.
+  void LogOps(bool json) const;
+
+  // Prints the events still held in the ring buffer as CSV, oldest first.
+  void LogEvents() const;
+
+ private:
+  struct Event {
+    const char* tag;
+    uint32_t seq;
+    int16_t subgraph;
+    int16_t node;
+    uint32_t start_cycles;
+    uint32_t cycles;
+    int64_t start_us;
+    int32_t us;
+  };
+
+  struct NodeStats {
+    const char* tag;
+    uint64_t macs;
+    uint32_t bytes;
+    uint32_t count;
+    uint64_t total_cycles;
+    int64_t total_us;
+    uint32_t max_cycles;
+  };
+
+  Event events_[kNumEvents] = {};
+  NodeStats nodes_[kMaxNodes] = {};
+  int num_nodes_ = 0;
+  uint32_t next_seq_ = 0;
+};
+
+#endif  // NODE_PROFILER_H_
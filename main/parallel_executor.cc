@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "parallel_executor.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <esp_log.h>
+
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+
+namespace {
+
+const char* TAG = "parallel_executor";
+
+// Messages on a worker's start queue.
+constexpr int kRun = 1;
+constexpr int kExit = 0;
+
+QueueHandle_t start[kParallelMaxWorkers];  // One per worker task, depth one.
+QueueHandle_t done;  // Signalled by a worker task when it's done or exits.
+int started;         // Worker tasks running, worker 0 not included.
+
+// What the worker tasks run, set by Run() before it sends kRun.
+void (*current_task)(int worker, void* arg);
+void* current_arg;
+
+tflite::ParallelExecutor executor;
+
+void WorkerTask(void* arg) {
+  const int worker = (int) (intptr_t) arg;
+  int message;
+  while (xQueueReceive(start[worker], &message, portMAX_DELAY) == pdTRUE &&
+         message == kRun) {
+    current_task(worker, current_arg);
+    xQueueSend(done, &worker, portMAX_DELAY);
+  }
+  xQueueSend(done, &worker, portMAX_DELAY);
+  vTaskDelete(NULL);
+}
+
+void Run(void (*task)(int worker, void* arg), void* arg, void* user) {
+  current_task = task;
+  current_arg = arg;
+  for (int i = 1; i <= started; i++) {
+    xQueueSend(start[i], &kRun, portMAX_DELAY);
+  }
+  task(0, arg);
+  for (int i = 1; i <= started; i++) {
+    int worker;
+    xQueueReceive(done, &worker, portMAX_DELAY);
+  }
+}
+
+}  // namespace
+
+TfLiteStatus ParallelExecutorStart(int workers) {
+  ParallelExecutorStop();
+  if (workers < 1 || workers > kParallelMaxWorkers) {
+    ESP_LOGE(TAG, "Workers must be 1 to %d, not %d", kParallelMaxWorkers,
+             workers);
+    return kTfLiteError;
+  }
+  if (workers == 1) {
+    return kTfLiteOk;
+  }
+  done = xQueueCreate(kParallelMaxWorkers, sizeof(int));
+  if (done == NULL) {
+    ESP_LOGE(TAG, "Couldn't create done queue");
+    return kTfLiteError;
+  }
+  const BaseType_t core = xPortGetCoreID();
+  for (int i = 1; i < workers; i++) {
+    start[i] = xQueueCreate(1, sizeof(int));
+    if (start[i] == NULL ||
+        xTaskCreatePinnedToCore(&WorkerTask, "nn_worker", 4 * 1024,
+                                (void*) (intptr_t) i, 8, NULL,
+                                (core + i) % CONFIG_FREERTOS_NUMBER_OF_CORES) !=
+            pdPASS) {
+      ESP_LOGE(TAG, "Couldn't start worker %d", i);
+      if (start[i] != NULL) {
+        vQueueDelete(start[i]);
+        start[i] = NULL;
+      }
+      ParallelExecutorStop();
+      return kTfLiteError;
+    }
+    started = i;
+  }
+
+  executor.workers = workers;
+  executor.run = Run;
+  executor.user = NULL;
+  tflite::SetParallelExecutor(&executor);
+  ESP_LOGI(TAG, "%d workers", workers);
+  return kTfLiteOk;
+}
+
+void ParallelExecutorStop() {
+  tflite::SetParallelExecutor(nullptr);
+  for (int i = 1; i <= started; i++) {
+    xQueueSend(start[i], &kExit, portMAX_DELAY);
+    int worker;
+    xQueueReceive(done, &worker, portMAX_DELAY);
+  }
+  for (int i = 1; i <= started; i++) {
+    vQueueDelete(start[i]);
+    start[i] = NULL;
+  }
+  started = 0;
+  if (done != NULL) {
+    vQueueDelete(done);
+    done = NULL;
+  }
+}
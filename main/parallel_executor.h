@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Worker tasks for the intra-op parallelism of the esp_nn kernels (see
+// tensorflow/lite/micro/kernels/esp_nn/parallel.h). Worker 0 is the task
+// calling Invoke(); every other worker is a task of its own, pinned to the
+// next core round-robin, that sleeps on a queue until a layer is split.
+//
+// On a dual-core chip that is one extra task on the other core. On the host
+// FreeRTOS tasks are threads, so any number of workers can be tried there.
+
+#ifndef PARALLEL_EXECUTOR_H_
+#define PARALLEL_EXECUTOR_H_
+
+#include "tensorflow/lite/c/common.h"
+
+// Most workers ParallelExecutorStart() accepts.
+constexpr int kParallelMaxWorkers = 16;
+
+// Starts `workers` - 1 worker tasks and installs them as the esp_nn kernels'
+// executor. Must be called before AllocateTensors(), since the kernels size
+// their per-worker buffers at Prepare(). A single worker starts nothing.
+TfLiteStatus ParallelExecutorStart(int workers);
+
+// Uninstalls the executor and stops the worker tasks. No Invoke() may be
+// running.
+void ParallelExecutorStop();
+
+#endif  // PARALLEL_EXECUTOR_H_
@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Generated by `person_detection_host --arena-header`, do not edit
+// except to add the TENSOR_ARENA_*_<TARGET> lines a device prints
+// with CONFIG_TFLITE_ARENA_SIZING enabled. Sizes are exact for the
+// model and kernels they were measured with, plus alignment headroom;
+// rerun both after changing either.
+//
+// TENSOR_ARENA_SIZE is the size of a single arena,
+// TENSOR_ARENA_PERSISTENT_SIZE and TENSOR_ARENA_NON_PERSISTENT_SIZE
+// those of the two parts of a split one.
+
+#ifndef TENSOR_ARENA_SIZE_H_
+#define TENSOR_ARENA_SIZE_H_
+
+#include "sdkconfig.h"
+
+// Targets with the generic esp-nn kernels.
+#define TENSOR_ARENA_SIZE_GENERIC 126480
+#define TENSOR_ARENA_PERSISTENT_SIZE_GENERIC 18992
+#define TENSOR_ARENA_NON_PERSISTENT_SIZE_GENERIC 107440
+
+// The esp32s3 and esp32p4 kernels need scratch buffers the host can't
+// size, so those targets keep the old arena size until measured.
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#ifdef TENSOR_ARENA_SIZE_ESP32S3
+#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_ESP32S3
+#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_ESP32S3
+#define TENSOR_ARENA_NON_PERSISTENT_SIZE TENSOR_ARENA_NON_PERSISTENT_SIZE_ESP32S3
+#endif
+#elif defined(CONFIG_IDF_TARGET_ESP32P4)
+#ifdef TENSOR_ARENA_SIZE_ESP32P4
+#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_ESP32P4
+#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_ESP32P4
+#define TENSOR_ARENA_NON_PERSISTENT_SIZE TENSOR_ARENA_NON_PERSISTENT_SIZE_ESP32P4
+#endif
+#else
+#define TENSOR_ARENA_SIZE TENSOR_ARENA_SIZE_GENERIC
+#define TENSOR_ARENA_PERSISTENT_SIZE TENSOR_ARENA_PERSISTENT_SIZE_GENERIC
+#define TENSOR_ARENA_NON_PERSISTENT_SIZE TENSOR_ARENA_NON_PERSISTENT_SIZE_GENERIC
+#endif
+
+#endif  // TENSOR_ARENA_SIZE_H_
@@ -25,6 +25,9 @@
 #ifdef CONFIG_IDF_TARGET_ESP32
 #define ARCH_ESP32 1
 #endif
+#ifdef ESP_NN_HOST_SIMD
+#define ARCH_HOST_SIMD 1
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -39,6 +42,8 @@ extern "C" {
 #include "esp_nn_esp32p4.h"
 #elif defined(ARCH_ESP32_S3)
 #include "esp_nn_esp32s3.h"
+#elif defined(ARCH_HOST_SIMD)
+#include "esp_nn_host_simd.h"
 #else // for other platforms use generic optimisations
 #include "esp_nn_generic_opt.h"
 #endif // #if defined(ARCH_ESP32_S3)
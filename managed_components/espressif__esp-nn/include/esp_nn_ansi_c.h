@@ -26,8 +26,11 @@
 #define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_ansi
 
 #define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_ansi
+#define esp_nn_depthwise_conv_s8_s4 esp_nn_depthwise_conv_s8_s4_ansi
 
 #define esp_nn_conv_s8 esp_nn_conv_s8_ansi
+#define esp_nn_conv_u8_s8 esp_nn_conv_u8_s8_ansi
+#define esp_nn_conv_s8_s4 esp_nn_conv_s8_s4_ansi
 
 #define esp_nn_get_conv_scratch_size esp_nn_get_conv_scratch_size_ansi
 #define esp_nn_set_conv_scratch_buf esp_nn_set_conv_scratch_buf_ansi
@@ -41,6 +44,9 @@
 #define esp_nn_max_pool_s8 esp_nn_max_pool_s8_ansi
 
 #define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_ansi
+#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_s8_s4 esp_nn_fully_connected_s8_s4_ansi
+#define esp_nn_fully_connected_per_ch_s8_s4 esp_nn_fully_connected_per_ch_s8_s4_ansi
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_ansi
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_ansi
@@ -90,6 +90,23 @@ void esp_nn_depthwise_conv_s8_ansi(const data_dims_t *input_dims,
                                    const dw_conv_params_t *conv_params,
                                    const quant_data_t *quant_data);
 
+/**
+ * @brief       depthwise convolution per channel with int4 filter values
+ *
+ * @note        filter_data holds two values per byte, the even element in
+ *              the low nibble (TFLite's kTfLiteInt4 packing), and is read as
+ *              is, without unpacking. Needs no scratch buffer.
+ */
+void esp_nn_depthwise_conv_s8_s4_ansi(const data_dims_t *input_dims,
+                                      const int8_t *input_data,
+                                      const data_dims_t *filter_dims,
+                                      const int8_t *filter_data,
+                                      const int32_t *bias,
+                                      const data_dims_t *output_dims,
+                                      int8_t *out_data,
+                                      const dw_conv_params_t *conv_params,
+                                      const quant_data_t *quant_data);
+
 /**
  * @brief       2d-convolution channelwise
  *
@@ -97,6 +114,9 @@ void esp_nn_depthwise_conv_s8_ansi(const data_dims_t *input_dims,
  *
  *              inputs type: int8_t, output: int8_t
  *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *              With offset 0 each output is a plain dot product of input and
+ *              filter; callers can get there by folding offset * sum(filter)
+ *              into the bias when no output reads padding.
  */
 void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
                          const int8_t *input_data,
@@ -108,6 +128,43 @@ void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
                          const conv_params_t *conv_params,
                          const quant_data_t *quant_data);
 
+/**
+ * @brief       2d-convolution channelwise with uint8 activations
+ *
+ * @note        operation: result += (input + offset) * filter
+ *
+ *              input type: uint8_t, filter and output: int8_t
+ *              Lets a layer consume a uint8 image directly: the uint8 -> int8
+ *              zero point shift is folded into the input offset, which is
+ *              contained in [-255, 0] for that use.
+ *              Offset 0 takes the same dot product path as esp_nn_conv_s8_ansi.
+ */
+void esp_nn_conv_u8_s8_ansi(const data_dims_t *input_dims,
+                            const uint8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution channelwise with int4 filter values
+ *
+ * @note        filter_data is packed as for esp_nn_depthwise_conv_s8_s4_ansi;
+ *              a filter row needn't start on a byte. Needs no scratch buffer.
+ */
+void esp_nn_conv_s8_s4_ansi(const data_dims_t *input_dims,
+                            const int8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data);
+
 int esp_nn_get_conv_scratch_size_ansi(const data_dims_t *input_dims,
                                       const data_dims_t *filter_dims,
                                       const data_dims_t *output_dims,
@@ -184,6 +241,9 @@ void esp_nn_avg_pool_s8_ansi(const int8_t *input,
  *
  * @note        inputs type: int8_t, output: int8_t
  *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *              With both input and filter offsets 0 each output is a plain
+ *              dot product; fold input_offset * sum(filter row) into the bias
+ *              to get there.
  */
 void esp_nn_fully_connected_s8_ansi(const int8_t *input_data,
                                     const int32_t input_offset,
@@ -199,6 +259,61 @@ void esp_nn_fully_connected_s8_ansi(const int8_t *input_data,
                                     const int32_t activation_min,
                                     const int32_t activation_max);
 
+/**
+ * @brief       fully connected with per output channel requantization
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *              out_shift and out_mult hold `out_channels` elements each
+ *              Zero offsets take the same dot product path as above.
+ */
+void esp_nn_fully_connected_per_ch_s8_ansi(const int8_t *input_data,
+                                           const int32_t input_offset,
+                                           const uint16_t row_len,
+                                           const int8_t *filter_data,
+                                           const int32_t filter_offset,
+                                           const int32_t *bias,
+                                           int8_t *out_data,
+                                           const uint16_t out_channels,
+                                           const int32_t out_offset,
+                                           const int32_t *out_shift,
+                                           const int32_t *out_mult,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max);
+
+/**
+ * @brief       fully connected layers with int4 filter values
+ *
+ * @note        same as the two above, with filter_data packed as for
+ *              esp_nn_depthwise_conv_s8_s4_ansi
+ */
+void esp_nn_fully_connected_s8_s4_ansi(const int8_t *input_data,
+                                       const int32_t input_offset,
+                                       const uint16_t row_len,
+                                       const int8_t *filter_data,
+                                       const int32_t filter_offset,
+                                       const int32_t *bias,
+                                       int8_t *out_data,
+                                       const uint16_t out_channels,
+                                       const int32_t out_offset,
+                                       const int32_t out_shift,
+                                       const int32_t out_mult,
+                                       const int32_t activation_min,
+                                       const int32_t activation_max);
+void esp_nn_fully_connected_per_ch_s8_s4_ansi(const int8_t *input_data,
+                                              const int32_t input_offset,
+                                              const uint16_t row_len,
+                                              const int8_t *filter_data,
+                                              const int32_t filter_offset,
+                                              const int32_t *bias,
+                                              int8_t *out_data,
+                                              const uint16_t out_channels,
+                                              const int32_t out_offset,
+                                              const int32_t *out_shift,
+                                              const int32_t *out_mult,
+                                              const int32_t activation_min,
+                                              const int32_t activation_max);
+
 /**
  * @brief   Get scratch buffer size needed by softmax function
  *
@@ -257,6 +372,22 @@ void esp_nn_conv_s8_opt(const data_dims_t *input_dims,
                         const conv_params_t *conv_params,
                         const quant_data_t *quant_data);
 
+/**
+ * @brief       2d-convolution channelwise with uint8 activations, optimized
+ *              version
+ *
+ * @note        see esp_nn_conv_u8_s8_ansi
+ */
+void esp_nn_conv_u8_s8_opt(const data_dims_t *input_dims,
+                           const uint8_t *input_data,
+                           const data_dims_t *filter_dims,
+                           const int8_t *filter_data,
+                           const int32_t *bias,
+                           const data_dims_t *output_dims,
+                           int8_t *out_data,
+                           const conv_params_t *conv_params,
+                           const quant_data_t *quant_data);
+
 /**
  * @brief       depthwise convolution per channel optimized version
  *
@@ -291,6 +422,146 @@ int esp_nn_get_depthwise_conv_scratch_size_opt(const data_dims_t *input_dims,
                                                const dw_conv_params_t *conv_params);
 void esp_nn_set_depthwise_conv_scratch_buf_opt(const void *buf);
 
+/******************************* im2col + GEMM ********************************/
+
+/**
+ * Bytes of a GEMM tile, which should fit in the data cache with room to
+ * spare. esp_nn_conv_s8_gemm's scratch buffer holds one tile of up to this
+ * size, if the filter has at most ESP_NN_GEMM_TILE_BYTES / 4 bytes per
+ * output channel, and the bias.
+ */
+#ifndef ESP_NN_GEMM_TILE_BYTES
+#define ESP_NN_GEMM_TILE_BYTES (16 * 1024)
+#endif
+
+/**
+ * @brief       int8 matrix product with per column requantization
+ *
+ * @note        out[r * out_stride + c] = requantized
+ *              sum(lhs[r * depth + k] * rhs[c * depth + k]) + bias[c]
+ *              for `rows` rows of lhs and `cols` rows of rhs, e.g. the inputs
+ *              of a batch and the filter rows of a fully connected layer.
+ *              Offsets must be folded into the bias. Bit-exact with the
+ *              _ansi kernels. Needs no scratch buffer.
+ */
+void esp_nn_gemm_s8(const int8_t *lhs,
+                    const int32_t rows,
+                    const int8_t *rhs,
+                    const int32_t cols,
+                    const int32_t depth,
+                    const int32_t *bias,
+                    int8_t *out_data,
+                    const int32_t out_stride,
+                    const int32_t out_offset,
+                    const int32_t *out_shift,
+                    const int32_t *out_mult,
+                    const int32_t activation_min,
+                    const int32_t activation_max);
+
+/**
+ * @brief       2d-convolution as im2col + esp_nn_gemm_s8
+ *
+ * @note        Bit-exact with esp_nn_conv_s8_ansi. Unrolls tiles of output
+ *              pixels into the scratch buffer, which must be set; without
+ *              one it runs esp_nn_conv_s8_ansi.
+ */
+void esp_nn_conv_s8_gemm(const data_dims_t *input_dims,
+                         const int8_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int32_t *bias,
+                         const data_dims_t *output_dims,
+                         int8_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data);
+
+/**
+ * @brief       esp_nn_conv_s8_gemm with uint8 activations
+ *
+ * @note        see esp_nn_conv_u8_s8_ansi
+ */
+void esp_nn_conv_u8_s8_gemm(const data_dims_t *input_dims,
+                            const uint8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data);
+
+int esp_nn_get_conv_scratch_size_gemm(const data_dims_t *input_dims,
+                                      const data_dims_t *filter_dims,
+                                      const data_dims_t *output_dims,
+                                      const conv_params_t *conv_params);
+void esp_nn_set_conv_scratch_buf_gemm(const void *buf);
+
+/************************** Winograd F(2x2, 3x3) ******************************/
+
+/**
+ * @brief       whether esp_nn_conv_s8_winograd can run a layer
+ *
+ * @return      1 for 3x3 filters with stride 1, no padding and no dilation,
+ *              and few enough input channels for int32 sums at the offset
+ *              in conv_params; 0 otherwise
+ */
+int esp_nn_conv_winograd_supported(const data_dims_t *input_dims,
+                                   const data_dims_t *filter_dims,
+                                   const conv_params_t *conv_params);
+
+/**
+ * @brief       bytes of the transformed filter of a layer
+ */
+int esp_nn_get_conv_winograd_filter_size(const data_dims_t *input_dims,
+                                         const data_dims_t *output_dims);
+
+/**
+ * @brief       transforms a 3x3 filter for esp_nn_conv_s8_winograd
+ *
+ * @note        filter_data is [out_channels][3][3][in_channels], as for the
+ *              other conv kernels. Done once, e.g. when preparing the layer.
+ */
+void esp_nn_conv_winograd_filter_s8(const int8_t *filter_data,
+                                    const int32_t in_channels,
+                                    const int32_t out_channels,
+                                    int16_t *transformed);
+
+/**
+ * @brief       2d-convolution as Winograd F(2x2, 3x3)
+ *
+ * @note        Bit-exact with esp_nn_conv_s8_ansi, for the layers
+ *              esp_nn_conv_winograd_supported accepts. filter_data is the
+ *              transformed filter. The scratch buffer must be set.
+ */
+void esp_nn_conv_s8_winograd(const data_dims_t *input_dims,
+                             const int8_t *input_data,
+                             const int16_t *filter_data,
+                             const int32_t *bias,
+                             const data_dims_t *output_dims,
+                             int8_t *out_data,
+                             const conv_params_t *conv_params,
+                             const quant_data_t *quant_data);
+
+/**
+ * @brief       esp_nn_conv_s8_winograd with uint8 activations
+ *
+ * @note        see esp_nn_conv_u8_s8_ansi
+ */
+void esp_nn_conv_u8_s8_winograd(const data_dims_t *input_dims,
+                                const uint8_t *input_data,
+                                const int16_t *filter_data,
+                                const int32_t *bias,
+                                const data_dims_t *output_dims,
+                                int8_t *out_data,
+                                const conv_params_t *conv_params,
+                                const quant_data_t *quant_data);
+
+int esp_nn_get_conv_scratch_size_winograd(const data_dims_t *input_dims,
+                                          const data_dims_t *filter_dims,
+                                          const data_dims_t *output_dims,
+                                          const conv_params_t *conv_params);
+void esp_nn_set_conv_scratch_buf_winograd(const void *buf);
+
 /* ANSI C function to be hooked up when optimised version needed */
 void esp_nn_set_softmax_scratch_buf_opt(void *buffer);
 
@@ -210,6 +210,7 @@ void esp_nn_relu6_s8_esp32s3(int8_t *data, uint16_t size);
 #define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_esp32s3
 
 #define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_esp32s3
+#define esp_nn_depthwise_conv_s8_s4 esp_nn_depthwise_conv_s8_s4_ansi
 
 #define esp_nn_get_conv_scratch_size esp_nn_get_conv_scratch_size_esp32s3
 #define esp_nn_set_conv_scratch_buf esp_nn_set_conv_scratch_buf_esp32s3
@@ -218,6 +219,8 @@ void esp_nn_relu6_s8_esp32s3(int8_t *data, uint16_t size);
 #define esp_nn_set_depthwise_conv_scratch_buf esp_nn_set_depthwise_conv_scratch_buf_esp32s3
 
 #define esp_nn_conv_s8 esp_nn_conv_s8_esp32s3
+#define esp_nn_conv_u8_s8 esp_nn_conv_u8_s8_ansi
+#define esp_nn_conv_s8_s4 esp_nn_conv_s8_s4_ansi
 
 #define esp_nn_relu6_s8 esp_nn_relu6_s8_esp32s3
 
@@ -225,6 +228,9 @@ void esp_nn_relu6_s8_esp32s3(int8_t *data, uint16_t size);
 #define esp_nn_max_pool_s8 esp_nn_max_pool_s8_esp32s3
 
 #define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_esp32s3
+#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_s8_s4 esp_nn_fully_connected_s8_s4_ansi
+#define esp_nn_fully_connected_per_ch_s8_s4 esp_nn_fully_connected_per_ch_s8_s4_ansi
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
@@ -0,0 +1,235 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file        Header definitions to include for esp_nn optimized functions on
+ *              a host: x86 (SSE4.1, AVX2) or ARM (NEON)
+ *
+ *              Selected by defining ESP_NN_HOST_SIMD along with
+ *              CONFIG_NN_OPTIMIZED. The instruction set is the one the
+ *              `_simd` sources are compiled for, plain C if none of them.
+ *              Unlike the `_opt` versions, the `_simd` ones requantize
+ *              exactly like the `_ansi` ones, so their output is bit-exact
+ *              with the reference kernels.
+ */
+
+#pragma once
+
+#include "esp_nn_defs.h"
+#include "esp_nn_ansi_headers.h"
+
+/************************** Basic math functions *****************************/
+
+/**
+ * @brief       elementwise addition
+ *
+ * @note        see esp_nn_add_elementwise_s8_ansi
+ */
+void esp_nn_add_elementwise_s8_simd(const int8_t *input1_data,
+                                    const int8_t *input2_data,
+                                    const int32_t input1_offset,
+                                    const int32_t input2_offset,
+                                    const int32_t input1_mult,
+                                    const int32_t input2_mult,
+                                    const int32_t input1_shift,
+                                    const int32_t input2_shift,
+                                    const int32_t left_shift,
+                                    int8_t *output,
+                                    const int32_t out_offset,
+                                    const int32_t out_mult,
+                                    const int32_t out_shift,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const int32_t size);
+
+/**
+ * @brief       elementwise multiplication
+ *
+ * @note        see esp_nn_mul_elementwise_s8_ansi
+ */
+void esp_nn_mul_elementwise_s8_simd(const int8_t *input1_data,
+                                    const int8_t *input2_data,
+                                    const int32_t input1_offset,
+                                    const int32_t input2_offset,
+                                    int8_t *output,
+                                    const int32_t out_offset,
+                                    const int32_t out_mult,
+                                    const int32_t out_shift,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const int32_t size);
+
+/************************** Convolution functions *****************************/
+
+/**
+ * @brief       depthwise convolution per channel
+ *
+ * @note        see esp_nn_depthwise_conv_s8_ansi
+ */
+void esp_nn_depthwise_conv_s8_simd(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int32_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const dw_conv_params_t *conv_params,
+                                   const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution channelwise
+ *
+ * @note        see esp_nn_conv_s8_ansi
+ *              Each output pixel gathers its receptive field, with the
+ *              offset applied and zeros for the padding, into a stack buffer
+ *              every output channel then reads in one dot product.
+ */
+void esp_nn_conv_s8_simd(const data_dims_t *input_dims,
+                         const int8_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int32_t *bias,
+                         const data_dims_t *output_dims,
+                         int8_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution channelwise with uint8 activations
+ *
+ * @note        see esp_nn_conv_u8_s8_ansi
+ */
+void esp_nn_conv_u8_s8_simd(const data_dims_t *input_dims,
+                            const uint8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data);
+
+/************************** Activation functions *****************************/
+
+void esp_nn_relu6_s8_simd(int8_t *data, uint16_t size);
+
+/************************** Pooling functions *****************************/
+
+void esp_nn_avg_pool_s8_simd(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels);
+
+void esp_nn_max_pool_s8_simd(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels);
+
+/************************** Fully connected functions *****************************/
+
+/**
+ * @brief       fully connected
+ *
+ * @note        see esp_nn_fully_connected_s8_ansi
+ *              Non-zero offsets are applied to the dot product afterwards,
+ *              from the sums of the input and of each filter row.
+ */
+void esp_nn_fully_connected_s8_simd(const int8_t *input_data,
+                                    const int32_t input_offset,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int32_t filter_offset,
+                                    const int32_t *bias,
+                                    int8_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_offset,
+                                    const int32_t out_shift,
+                                    const int32_t out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max);
+
+/**
+ * @brief       fully connected with per output channel requantization
+ *
+ * @note        see esp_nn_fully_connected_per_ch_s8_ansi
+ */
+void esp_nn_fully_connected_per_ch_s8_simd(const int8_t *input_data,
+                                           const int32_t input_offset,
+                                           const uint16_t row_len,
+                                           const int8_t *filter_data,
+                                           const int32_t filter_offset,
+                                           const int32_t *bias,
+                                           int8_t *out_data,
+                                           const uint16_t out_channels,
+                                           const int32_t out_offset,
+                                           const int32_t *out_shift,
+                                           const int32_t *out_mult,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max);
+
+/********************** function defines ***************************/
+
+#define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_simd
+#define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_simd
+
+#define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_simd
+#define esp_nn_depthwise_conv_s8_s4 esp_nn_depthwise_conv_s8_s4_ansi
+
+#define esp_nn_conv_s8 esp_nn_conv_s8_simd
+#define esp_nn_conv_u8_s8 esp_nn_conv_u8_s8_simd
+#define esp_nn_conv_s8_s4 esp_nn_conv_s8_s4_ansi
+
+/* the _simd kernels need no scratch buffers */
+#define esp_nn_get_conv_scratch_size esp_nn_get_conv_scratch_size_ansi
+#define esp_nn_set_conv_scratch_buf esp_nn_set_conv_scratch_buf_ansi
+
+#define esp_nn_get_depthwise_conv_scratch_size esp_nn_get_depthwise_conv_scratch_size_ansi
+#define esp_nn_set_depthwise_conv_scratch_buf esp_nn_set_depthwise_conv_scratch_buf_ansi
+
+#define esp_nn_relu6_s8 esp_nn_relu6_s8_simd
+
+#define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_simd
+#define esp_nn_max_pool_s8 esp_nn_max_pool_s8_simd
+
+#define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_simd
+#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_simd
+#define esp_nn_fully_connected_s8_s4 esp_nn_fully_connected_s8_s4_ansi
+#define esp_nn_fully_connected_per_ch_s8_s4 esp_nn_fully_connected_per_ch_s8_s4_ansi
+
+/* softmax is bound by its per element fixed point exp(), kept from _opt */
+#define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
+#define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
+#define esp_nn_softmax_s8 esp_nn_softmax_s8_opt
@@ -0,0 +1,61 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <simd_functions.h>
+
+void esp_nn_mul_elementwise_s8_simd(const int8_t *input1_data,
+                                    const int8_t *input2_data,
+                                    const int32_t input1_offset,
+                                    const int32_t input2_offset,
+                                    int8_t *output,
+                                    const int32_t out_offset,
+                                    const int32_t out_mult,
+                                    const int32_t out_shift,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const int32_t size)
+{
+    const esp_nn_v32_t offset1 = esp_nn_v32_set1(input1_offset);
+    const esp_nn_v32_t offset2 = esp_nn_v32_set1(input2_offset);
+    const esp_nn_v32_t offset_out = esp_nn_v32_set1(out_offset);
+    const esp_nn_v32_t act_min = esp_nn_v32_set1(activation_min);
+    const esp_nn_v32_t act_max = esp_nn_v32_set1(activation_max);
+
+    int i = 0;
+    for (; i + ESP_NN_SIMD_LANES <= size; i += ESP_NN_SIMD_LANES) {
+        esp_nn_v32_t tmp1 = esp_nn_v32_add(esp_nn_v32_load_s8(input1_data + i), offset1);
+        esp_nn_v32_t tmp2 = esp_nn_v32_add(esp_nn_v32_load_s8(input2_data + i), offset2);
+
+        esp_nn_v32_t out = esp_nn_v32_mul(tmp1, tmp2);
+        out = esp_nn_v32_multiply_by_quantized_mult(out, out_mult, out_shift);
+        out = esp_nn_v32_add(out, offset_out);
+
+        out = esp_nn_v32_max(act_min, esp_nn_v32_min(out, act_max));
+        esp_nn_v32_store_s8(output + i, out);
+    }
+
+    for (; i < size; i++) {
+        int32_t tmp1 = input1_data[i] + input1_offset;
+        int32_t tmp2 = input2_data[i] + input2_offset;
+
+        int32_t out = tmp1 * tmp2;
+        out = esp_nn_multiply_by_quantized_mult(out, out_mult, out_shift);
+        out = out + out_offset;
+
+        out = max(activation_min, min(out, activation_max));
+        output[i] = (int8_t) out;
+    }
+}
@@ -24,6 +24,13 @@
  */
 #define __NN_FORCE_INLINE__ __attribute((always_inline)) static inline
 
+/**
+ * Scratch buffer pointers set by esp_nn_set_*_scratch_buf() are per thread,
+ * so that parts of one layer can run on several cores at once, each with a
+ * scratch buffer of its own.
+ */
+#define __NN_SCRATCH_BUF__ static __thread
+
 /* min/max macros */
 #ifndef max
 #define max(a, b) ({            \
@@ -253,3 +260,88 @@ __NN_FORCE_INLINE__ void esp_nn_s8_to_s16(const int8_t *src, int16_t *dst, const
         dst[i] = src[i];
     }
 }
+
+/**
+ * @brief       dot product of `len` int8 inputs and filter values
+ *
+ * @note        The kernels take this path, without an input offset add per
+ *              multiply, when called with an in_offset of 0. A caller with a
+ *              constant filter gets there by folding in_offset * sum(filter)
+ *              into the bias beforehand.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_dot_s8(const int8_t *input, const int8_t *filter,
+                                          const int32_t len)
+{
+    int32_t sum = 0;
+    int32_t i = 0;
+    for (; i < len - 3; i += 4) {
+        sum += input[i + 0] * filter[i + 0];
+        sum += input[i + 1] * filter[i + 1];
+        sum += input[i + 2] * filter[i + 2];
+        sum += input[i + 3] * filter[i + 3];
+    }
+    for (; i < len; i++) {
+        sum += input[i] * filter[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief       element `index` of packed int4 values
+ *
+ * @note        Two values per byte, the even element in the low nibble, as
+ *              TFLite packs kTfLiteInt4 tensors.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_s4_get(const int8_t *packed, const int32_t index)
+{
+    const int8_t byte = packed[index >> 1];
+    return (index & 1) ? (byte >> 4) : ((int8_t) (byte << 4) >> 4);
+}
+
+/**
+ * @brief       dot product of `len` int8 inputs plus input_offset and the
+ *              packed int4 filter values from element `start` on
+ *
+ * @note        Reads each filter byte once for two products.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_dot_s8_s4(const int8_t *input, const int32_t input_offset,
+                                             const int8_t *filter, const int32_t start,
+                                             const int32_t len)
+{
+    int32_t sum = 0;
+    int32_t i = 0;
+    if ((start & 1) && len > 0) {
+        sum += (input[0] + input_offset) * esp_nn_s4_get(filter, start);
+        i = 1;
+    }
+    const int8_t *bytes = filter + ((start + i) >> 1);
+    for (; i < len - 1; i += 2) {
+        const int8_t byte = *bytes++;
+        sum += (input[i + 0] + input_offset) * ((int8_t) (byte << 4) >> 4);
+        sum += (input[i + 1] + input_offset) * (byte >> 4);
+    }
+    if (i < len) {
+        sum += (input[i] + input_offset) * esp_nn_s4_get(filter, start + i);
+    }
+    return sum;
+}
+
+/**
+ * @brief       esp_nn_dot_s8 for uint8 inputs
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_dot_u8_s8(const uint8_t *input, const int8_t *filter,
+                                             const int32_t len)
+{
+    int32_t sum = 0;
+    int32_t i = 0;
+    for (; i < len - 3; i += 4) {
+        sum += input[i + 0] * filter[i + 0];
+        sum += input[i + 1] * filter[i + 1];
+        sum += input[i + 2] * filter[i + 2];
+        sum += input[i + 3] * filter[i + 3];
+    }
+    for (; i < len; i++) {
+        sum += input[i] * filter[i];
+    }
+    return sum;
+}
@@ -0,0 +1,542 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file        Vector helpers of the host `_simd` kernels (esp_nn_host_simd.h)
+ *
+ *              The instruction set is the one the kernels are compiled for:
+ *              AVX2, SSE4.1 or NEON, else one lane of plain C. Everything here
+ *              is integer arithmetic giving exactly what the scalar helpers of
+ *              common_functions.h give, so the kernels stay bit-exact with the
+ *              _ansi ones whatever the lane count.
+ */
+
+#pragma once
+
+#include <common_functions.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ESP_NN_SIMD_LANES 8
+typedef __m256i esp_nn_v32_t;
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define ESP_NN_SIMD_LANES 4
+typedef __m128i esp_nn_v32_t;
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ESP_NN_SIMD_LANES 4
+typedef int32x4_t esp_nn_v32_t;
+#else
+#define ESP_NN_SIMD_LANES 1
+typedef int32_t esp_nn_v32_t;
+#endif
+
+/************************** int32 lanes ***************************/
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_set1(int32_t val)
+{
+#if defined(__AVX2__)
+    return _mm256_set1_epi32(val);
+#elif defined(__SSE4_1__)
+    return _mm_set1_epi32(val);
+#elif defined(__ARM_NEON)
+    return vdupq_n_s32(val);
+#else
+    return val;
+#endif
+}
+
+/* ESP_NN_SIMD_LANES int8 values, sign extended */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_load_s8(const int8_t *src)
+{
+#if defined(__AVX2__)
+    int64_t val;
+    memcpy(&val, src, sizeof(val));
+    return _mm256_cvtepi8_epi32(_mm_cvtsi64_si128(val));
+#elif defined(__SSE4_1__)
+    int32_t val;
+    memcpy(&val, src, sizeof(val));
+    return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(val));
+#elif defined(__ARM_NEON)
+    int32_t val;
+    memcpy(&val, src, sizeof(val));
+    int16x8_t val16 = vmovl_s8(vreinterpret_s8_s32(vdup_n_s32(val)));
+    return vmovl_s16(vget_low_s16(val16));
+#else
+    return *src;
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_load_s32(const int32_t *src)
+{
+#if defined(__AVX2__)
+    return _mm256_loadu_si256((const __m256i *) src);
+#elif defined(__SSE4_1__)
+    return _mm_loadu_si128((const __m128i *) src);
+#elif defined(__ARM_NEON)
+    return vld1q_s32(src);
+#else
+    return *src;
+#endif
+}
+
+__NN_FORCE_INLINE__ void esp_nn_v32_store_s32(int32_t *dst, esp_nn_v32_t val)
+{
+#if defined(__AVX2__)
+    _mm256_storeu_si256((__m256i *) dst, val);
+#elif defined(__SSE4_1__)
+    _mm_storeu_si128((__m128i *) dst, val);
+#elif defined(__ARM_NEON)
+    vst1q_s32(dst, val);
+#else
+    *dst = val;
+#endif
+}
+
+/* Saturating store of ESP_NN_SIMD_LANES values to int8 */
+__NN_FORCE_INLINE__ void esp_nn_v32_store_s8(int8_t *dst, esp_nn_v32_t val)
+{
+#if defined(__AVX2__)
+    __m128i val16 = _mm_packs_epi32(_mm256_castsi256_si128(val),
+                                    _mm256_extracti128_si256(val, 1));
+    int64_t val8 = _mm_cvtsi128_si64(_mm_packs_epi16(val16, val16));
+    memcpy(dst, &val8, sizeof(val8));
+#elif defined(__SSE4_1__)
+    __m128i val16 = _mm_packs_epi32(val, val);
+    int32_t val8 = _mm_cvtsi128_si32(_mm_packs_epi16(val16, val16));
+    memcpy(dst, &val8, sizeof(val8));
+#elif defined(__ARM_NEON)
+    int16x4_t val16 = vqmovn_s32(val);
+    int8x8_t val8 = vqmovn_s16(vcombine_s16(val16, val16));
+    int32_t out = vget_lane_s32(vreinterpret_s32_s8(val8), 0);
+    memcpy(dst, &out, sizeof(out));
+#else
+    *dst = (int8_t) esp_nn_saturate8(val);
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_add(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_add_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_add_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vaddq_s32(a, b);
+#else
+    return a + b;
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_sub(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_sub_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_sub_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vsubq_s32(a, b);
+#else
+    return a - b;
+#endif
+}
+
+/* Low 32 bits of the product */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_mul(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_mullo_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_mullo_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vmulq_s32(a, b);
+#else
+    return (int32_t) ((uint32_t) a * (uint32_t) b);
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_and(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_and_si256(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_and_si128(a, b);
+#elif defined(__ARM_NEON)
+    return vandq_s32(a, b);
+#else
+    return a & b;
+#endif
+}
+
+/* -1 in the lanes where a > b, 0 elsewhere */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_cmpgt(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_cmpgt_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_cmpgt_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vreinterpretq_s32_u32(vcgtq_s32(a, b));
+#else
+    return a > b ? -1 : 0;
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_min(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_min_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_min_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vminq_s32(a, b);
+#else
+    return min(a, b);
+#endif
+}
+
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_max(esp_nn_v32_t a, esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    return _mm256_max_epi32(a, b);
+#elif defined(__SSE4_1__)
+    return _mm_max_epi32(a, b);
+#elif defined(__ARM_NEON)
+    return vmaxq_s32(a, b);
+#else
+    return max(a, b);
+#endif
+}
+
+/* Shifts every lane left by `shift`, in [0, 31] */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_shift_left(esp_nn_v32_t val, int32_t shift)
+{
+#if defined(__AVX2__)
+    return _mm256_sll_epi32(val, _mm_cvtsi32_si128(shift));
+#elif defined(__SSE4_1__)
+    return _mm_sll_epi32(val, _mm_cvtsi32_si128(shift));
+#elif defined(__ARM_NEON)
+    return vshlq_s32(val, vdupq_n_s32(shift));
+#else
+    return (int32_t) ((uint32_t) val << shift);
+#endif
+}
+
+/* Arithmetic right shift of every lane by `shift`, in [0, 31] */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_shift_right(esp_nn_v32_t val, int32_t shift)
+{
+#if defined(__AVX2__)
+    return _mm256_sra_epi32(val, _mm_cvtsi32_si128(shift));
+#elif defined(__SSE4_1__)
+    return _mm_sra_epi32(val, _mm_cvtsi32_si128(shift));
+#elif defined(__ARM_NEON)
+    return vshlq_s32(val, vdupq_n_s32(-shift));
+#else
+    return val >> shift;
+#endif
+}
+
+/**
+ * esp_nn_sat_round_doubling_high_mul() of every lane.
+ *
+ * x86 has no rounding high multiply: the 64 bit products of the even and the
+ * odd lanes get the same nudge and round towards zero as the scalar version.
+ * NEON's vqrdmulh is the same operation.
+ */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_sat_round_doubling_high_mul(esp_nn_v32_t a,
+                                                                        esp_nn_v32_t b)
+{
+#if defined(__AVX2__)
+    const __m256i nudge = _mm256_set1_epi64x(1 << 30);
+    /* 1 - (1 << 30) when the signs differ */
+    const __m256i nudge_neg = _mm256_set1_epi64x(1 - (1ll << 31));
+    const __m256i round_to_zero = _mm256_set1_epi64x((1ll << 31) - 1);
+    const __m256i differ = _mm256_srai_epi32(_mm256_xor_si256(a, b), 31);
+    const __m256i overflow = _mm256_and_si256(_mm256_cmpeq_epi32(a, b),
+                                              _mm256_cmpeq_epi32(a, _mm256_set1_epi32(INT32_MIN)));
+
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    even = _mm256_add_epi64(even, _mm256_add_epi64(nudge,
+            _mm256_and_si256(_mm256_shuffle_epi32(differ, _MM_SHUFFLE(2, 2, 0, 0)), nudge_neg)));
+    odd = _mm256_add_epi64(odd, _mm256_add_epi64(nudge,
+            _mm256_and_si256(_mm256_shuffle_epi32(differ, _MM_SHUFFLE(3, 3, 1, 1)), nudge_neg)));
+
+    /* (val + (val < 0 ? (1 << 31) - 1 : 0)) >> 31, only the low 32 bits are kept */
+    const __m256i even_neg = _mm256_shuffle_epi32(_mm256_srai_epi32(even, 31), _MM_SHUFFLE(3, 3, 1, 1));
+    const __m256i odd_neg = _mm256_shuffle_epi32(_mm256_srai_epi32(odd, 31), _MM_SHUFFLE(3, 3, 1, 1));
+    even = _mm256_srli_epi64(_mm256_add_epi64(even, _mm256_and_si256(even_neg, round_to_zero)), 31);
+    odd = _mm256_slli_epi64(_mm256_add_epi64(odd, _mm256_and_si256(odd_neg, round_to_zero)), 1);
+    const __m256i result = _mm256_blend_epi32(even, odd, 0xaa);
+
+    /* INT32_MIN * INT32_MIN came out as INT32_MIN, saturate it */
+    return _mm256_xor_si256(result, overflow);
+#elif defined(__SSE4_1__)
+    const __m128i nudge = _mm_set1_epi64x(1 << 30);
+    const __m128i nudge_neg = _mm_set1_epi64x(1 - (1ll << 31));
+    const __m128i round_to_zero = _mm_set1_epi64x((1ll << 31) - 1);
+    const __m128i differ = _mm_srai_epi32(_mm_xor_si128(a, b), 31);
+    const __m128i overflow = _mm_and_si128(_mm_cmpeq_epi32(a, b),
+                                           _mm_cmpeq_epi32(a, _mm_set1_epi32(INT32_MIN)));
+
+    __m128i even = _mm_mul_epi32(a, b);
+    __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    even = _mm_add_epi64(even, _mm_add_epi64(nudge,
+            _mm_and_si128(_mm_shuffle_epi32(differ, _MM_SHUFFLE(2, 2, 0, 0)), nudge_neg)));
+    odd = _mm_add_epi64(odd, _mm_add_epi64(nudge,
+            _mm_and_si128(_mm_shuffle_epi32(differ, _MM_SHUFFLE(3, 3, 1, 1)), nudge_neg)));
+
+    const __m128i even_neg = _mm_shuffle_epi32(_mm_srai_epi32(even, 31), _MM_SHUFFLE(3, 3, 1, 1));
+    const __m128i odd_neg = _mm_shuffle_epi32(_mm_srai_epi32(odd, 31), _MM_SHUFFLE(3, 3, 1, 1));
+    even = _mm_srli_epi64(_mm_add_epi64(even, _mm_and_si128(even_neg, round_to_zero)), 31);
+    odd = _mm_slli_epi64(_mm_add_epi64(odd, _mm_and_si128(odd_neg, round_to_zero)), 1);
+    const __m128i result = _mm_blend_epi16(even, odd, 0xcc);
+
+    return _mm_xor_si128(result, overflow);
+#elif defined(__ARM_NEON)
+    return vqrdmulhq_s32(a, b);
+#else
+    return esp_nn_sat_round_doubling_high_mul(a, b);
+#endif
+}
+
+/* esp_nn_div_by_power_of_two() of every lane, `exponent` in [0, 31] */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_div_by_power_of_two(esp_nn_v32_t val, int32_t exponent)
+{
+    const int32_t mask = (int32_t) ((1u << exponent) - 1);
+    const esp_nn_v32_t remainder = esp_nn_v32_and(val, esp_nn_v32_set1(mask));
+    esp_nn_v32_t result = esp_nn_v32_shift_right(val, exponent);
+    /* (mask >> 1) + 1 for the negative results */
+    const esp_nn_v32_t threshold = esp_nn_v32_sub(esp_nn_v32_set1(mask >> 1),
+                                                  esp_nn_v32_shift_right(result, 31));
+    /* the compare gives -1 where the result is rounded up */
+    return esp_nn_v32_sub(result, esp_nn_v32_cmpgt(remainder, threshold));
+}
+
+/* esp_nn_multiply_by_quantized_mult() of every lane */
+__NN_FORCE_INLINE__ esp_nn_v32_t esp_nn_v32_multiply_by_quantized_mult(esp_nn_v32_t val,
+                                                                       int32_t mult,
+                                                                       int32_t shift)
+{
+    const int32_t left_shift = shift > 0 ? shift : 0;
+    const int32_t right_shift = shift > 0 ? 0 : -shift;
+    esp_nn_v32_t result = esp_nn_v32_sat_round_doubling_high_mul(esp_nn_v32_shift_left(val, left_shift),
+                                                                 esp_nn_v32_set1(mult));
+    return esp_nn_v32_div_by_power_of_two(result, right_shift);
+}
+
+/************************** dot products ***************************/
+
+#if defined(__AVX2__)
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_hsum_s32(__m256i acc)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+#elif defined(__SSE4_1__)
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_hsum_s32(__m128i sum)
+{
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+#elif defined(__ARM_NEON)
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_hsum_s32(int32x4_t acc)
+{
+#if defined(__aarch64__)
+    return vaddvq_s32(acc);
+#else
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#endif
+}
+#endif
+
+/* sum(a[i] * b[i]) */
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_dot_s8(const int8_t *a, const int8_t *b, const int32_t len)
+{
+    int32_t i = 0;
+    int32_t result = 0;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= len; i += 16) {
+        __m256i a16 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *) (a + i)));
+        __m256i b16 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *) (b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a16, b16));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__SSE4_1__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= len; i += 8) {
+        __m128i a16 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *) (a + i)));
+        __m128i b16 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *) (b + i)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a16, b16));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__ARM_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 16 <= len; i += 16) {
+        int8x16_t a8 = vld1q_s8(a + i);
+        int8x16_t b8 = vld1q_s8(b + i);
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(a8), vget_low_s8(b8)));
+        acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(a8), vget_high_s8(b8)));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#endif
+    for (; i < len; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+/**
+ * sum(a[i] * b[i]) of int16 values in [-255, 255], the activations with
+ * their offset, and int8 filter values.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_dot_s16_s8(const int16_t *a, const int8_t *b, const int32_t len)
+{
+    int32_t i = 0;
+    int32_t result = 0;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= len; i += 16) {
+        __m256i a16 = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i b16 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *) (b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a16, b16));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__SSE4_1__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= len; i += 8) {
+        __m128i a16 = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i b16 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *) (b + i)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a16, b16));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__ARM_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 8 <= len; i += 8) {
+        int16x8_t a16 = vld1q_s16(a + i);
+        int16x8_t b16 = vmovl_s8(vld1_s8(b + i));
+        acc = vmlal_s16(acc, vget_low_s16(a16), vget_low_s16(b16));
+        acc = vmlal_s16(acc, vget_high_s16(a16), vget_high_s16(b16));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#endif
+    for (; i < len; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+/* sum(a[i]) */
+__NN_FORCE_INLINE__ int32_t esp_nn_simd_sum_s8(const int8_t *a, const int32_t len)
+{
+    int32_t i = 0;
+    int32_t result = 0;
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= len; i += 16) {
+        __m256i a16 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *) (a + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a16, ones));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__SSE4_1__)
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 8 <= len; i += 8) {
+        __m128i a16 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *) (a + i)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a16, ones));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#elif defined(__ARM_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 16 <= len; i += 16) {
+        acc = vpadalq_s16(acc, vpaddlq_s8(vld1q_s8(a + i)));
+    }
+    result = esp_nn_simd_hsum_s32(acc);
+#endif
+    for (; i < len; i++) {
+        result += a[i];
+    }
+    return result;
+}
+
+/************************** int8 lanes ***************************/
+
+/* dst[i] = max(dst[i], src[i]) */
+__NN_FORCE_INLINE__ void esp_nn_simd_max_s8(int8_t *dst, const int8_t *src, const int32_t len)
+{
+    int32_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= len; i += 32) {
+        __m256i val = _mm256_max_epi8(_mm256_loadu_si256((const __m256i *) (dst + i)),
+                                      _mm256_loadu_si256((const __m256i *) (src + i)));
+        _mm256_storeu_si256((__m256i *) (dst + i), val);
+    }
+#endif
+#if defined(__SSE4_1__)
+    for (; i + 16 <= len; i += 16) {
+        __m128i val = _mm_max_epi8(_mm_loadu_si128((const __m128i *) (dst + i)),
+                                   _mm_loadu_si128((const __m128i *) (src + i)));
+        _mm_storeu_si128((__m128i *) (dst + i), val);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= len; i += 16) {
+        vst1q_s8(dst + i, vmaxq_s8(vld1q_s8(dst + i), vld1q_s8(src + i)));
+    }
+#endif
+    for (; i < len; i++) {
+        dst[i] = max(dst[i], src[i]);
+    }
+}
+
+/* dst[i] = min(max(src[i], act_min), act_max) */
+__NN_FORCE_INLINE__ void esp_nn_simd_clamp_s8(int8_t *dst, const int8_t *src, const int32_t len,
+                                              const int32_t act_min, const int32_t act_max)
+{
+    int32_t i = 0;
+#if defined(__AVX2__)
+    const __m256i min32 = _mm256_set1_epi8((int8_t) esp_nn_saturate8(act_min));
+    const __m256i max32 = _mm256_set1_epi8((int8_t) esp_nn_saturate8(act_max));
+    for (; i + 32 <= len; i += 32) {
+        __m256i val = _mm256_loadu_si256((const __m256i *) (src + i));
+        val = _mm256_min_epi8(_mm256_max_epi8(val, min32), max32);
+        _mm256_storeu_si256((__m256i *) (dst + i), val);
+    }
+#endif
+#if defined(__SSE4_1__)
+    const __m128i min16 = _mm_set1_epi8((int8_t) esp_nn_saturate8(act_min));
+    const __m128i max16 = _mm_set1_epi8((int8_t) esp_nn_saturate8(act_max));
+    for (; i + 16 <= len; i += 16) {
+        __m128i val = _mm_loadu_si128((const __m128i *) (src + i));
+        val = _mm_min_epi8(_mm_max_epi8(val, min16), max16);
+        _mm_storeu_si128((__m128i *) (dst + i), val);
+    }
+#elif defined(__ARM_NEON)
+    const int8x16_t min16 = vdupq_n_s8((int8_t) esp_nn_saturate8(act_min));
+    const int8x16_t max16 = vdupq_n_s8((int8_t) esp_nn_saturate8(act_max));
+    for (; i + 16 <= len; i += 16) {
+        vst1q_s8(dst + i, vminq_s8(vmaxq_s8(vld1q_s8(src + i), min16), max16));
+    }
+#endif
+    for (; i < len; i++) {
+        int32_t val = max(src[i], act_min);
+        dst[i] = (int8_t) min(val, act_max);
+    }
+}
@@ -0,0 +1,315 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * im2col + int8 GEMM convolution.
+ *
+ * The direct kernels loop over the filter taps of every output pixel, which
+ * for a layer with few input channels is a handful of MACs per loop. Here a
+ * tile of output pixels is first unrolled into rows of filter_ht * filter_wd
+ * * in_channels bytes (im2col), and the filter is multiplied with the tile
+ * in register blocks of 4 pixels x 4 output channels: every input byte
+ * loaded feeds 4 MACs, and so does every filter byte. Tiles are sized to
+ * ESP_NN_GEMM_TILE_BYTES so that one stays in the data cache while all the
+ * filter rows pass over it.
+ *
+ * The input offset is applied as in TFLite's GEMM kernels: padding is
+ * filled with -input_offset, so that it adds nothing, and
+ * input_offset * sum(filter row) goes into the bias of every call.
+ */
+
+#include <esp_nn_defs.h>
+#include <esp_nn_ansi_headers.h>
+
+#include <common_functions.h>
+
+/* Rows and columns of a register block */
+#define GEMM_BLOCK 4
+
+__NN_SCRATCH_BUF__ int8_t *scratch_buffer = NULL;
+
+/* Rows of `depth` bytes that fit in a tile, a multiple of GEMM_BLOCK */
+static int32_t gemm_tile_rows(int32_t depth)
+{
+    int32_t rows = ESP_NN_GEMM_TILE_BYTES / max(depth, 1);
+    return max(GEMM_BLOCK, rows / GEMM_BLOCK * GEMM_BLOCK);
+}
+
+__NN_FORCE_INLINE__ void gemm_block_4x4(const int8_t *lhs,
+                                        const int8_t *rhs,
+                                        const int32_t depth,
+                                        int32_t acc[GEMM_BLOCK][GEMM_BLOCK])
+{
+    const int8_t *l0 = lhs;
+    const int8_t *l1 = l0 + depth;
+    const int8_t *l2 = l1 + depth;
+    const int8_t *l3 = l2 + depth;
+    const int8_t *r0 = rhs;
+    const int8_t *r1 = r0 + depth;
+    const int8_t *r2 = r1 + depth;
+    const int8_t *r3 = r2 + depth;
+    int32_t a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    int32_t a10 = 0, a11 = 0, a12 = 0, a13 = 0;
+    int32_t a20 = 0, a21 = 0, a22 = 0, a23 = 0;
+    int32_t a30 = 0, a31 = 0, a32 = 0, a33 = 0;
+
+    for (int32_t k = 0; k < depth; k++) {
+        const int32_t x0 = l0[k], x1 = l1[k], x2 = l2[k], x3 = l3[k];
+        const int32_t w0 = r0[k], w1 = r1[k], w2 = r2[k], w3 = r3[k];
+        a00 += x0 * w0; a01 += x0 * w1; a02 += x0 * w2; a03 += x0 * w3;
+        a10 += x1 * w0; a11 += x1 * w1; a12 += x1 * w2; a13 += x1 * w3;
+        a20 += x2 * w0; a21 += x2 * w1; a22 += x2 * w2; a23 += x2 * w3;
+        a30 += x3 * w0; a31 += x3 * w1; a32 += x3 * w2; a33 += x3 * w3;
+    }
+    acc[0][0] = a00; acc[0][1] = a01; acc[0][2] = a02; acc[0][3] = a03;
+    acc[1][0] = a10; acc[1][1] = a11; acc[1][2] = a12; acc[1][3] = a13;
+    acc[2][0] = a20; acc[2][1] = a21; acc[2][2] = a22; acc[2][3] = a23;
+    acc[3][0] = a30; acc[3][1] = a31; acc[3][2] = a32; acc[3][3] = a33;
+}
+
+/* A block at the bottom or right edge, with fewer rows or columns */
+static void gemm_block_edge(const int8_t *lhs, const int8_t *rhs,
+                            const int32_t depth, const int32_t rows,
+                            const int32_t cols,
+                            int32_t acc[GEMM_BLOCK][GEMM_BLOCK])
+{
+    for (int32_t r = 0; r < rows; r++) {
+        for (int32_t c = 0; c < cols; c++) {
+            acc[r][c] = esp_nn_dot_s8(lhs + r * depth, rhs + c * depth, depth);
+        }
+    }
+}
+
+void esp_nn_gemm_s8(const int8_t *lhs,
+                    const int32_t rows,
+                    const int8_t *rhs,
+                    const int32_t cols,
+                    const int32_t depth,
+                    const int32_t *bias,
+                    int8_t *out_data,
+                    const int32_t out_stride,
+                    const int32_t out_offset,
+                    const int32_t *out_shift,
+                    const int32_t *out_mult,
+                    const int32_t activation_min,
+                    const int32_t activation_max)
+{
+    const int32_t tile_rows = gemm_tile_rows(depth);
+    int32_t acc[GEMM_BLOCK][GEMM_BLOCK];
+
+    for (int32_t tile = 0; tile < rows; tile += tile_rows) {
+        const int32_t tile_end = min(rows, tile + tile_rows);
+        for (int32_t col = 0; col < cols; col += GEMM_BLOCK) {
+            const int32_t block_cols = min(GEMM_BLOCK, cols - col);
+            const int8_t *rhs_block = rhs + col * depth;
+            for (int32_t row = tile; row < tile_end; row += GEMM_BLOCK) {
+                const int32_t block_rows = min(GEMM_BLOCK, tile_end - row);
+                const int8_t *lhs_block = lhs + row * depth;
+                if (block_rows == GEMM_BLOCK && block_cols == GEMM_BLOCK) {
+                    gemm_block_4x4(lhs_block, rhs_block, depth, acc);
+                } else {
+                    gemm_block_edge(lhs_block, rhs_block, depth,
+                                    block_rows, block_cols, acc);
+                }
+                for (int32_t r = 0; r < block_rows; r++) {
+                    int8_t *out = out_data + (row + r) * out_stride + col;
+                    for (int32_t c = 0; c < block_cols; c++) {
+                        int32_t result = acc[r][c];
+                        if (bias) {
+                            result += bias[col + c];
+                        }
+                        result = esp_nn_multiply_by_quantized_mult(result,
+                                        out_mult[col + c], out_shift[col + c]);
+                        result += out_offset;
+                        result = max(result, activation_min);
+                        result = min(result, activation_max);
+                        out[c] = (int8_t) result;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Output pixels per im2col tile */
+static int32_t conv_tile_pixels(const data_dims_t *filter_dims,
+                                const data_dims_t *input_dims,
+                                const data_dims_t *output_dims)
+{
+    const int32_t depth = filter_dims->width * filter_dims->height *
+                          input_dims->channels;
+    return min(gemm_tile_rows(depth),
+               (int32_t) output_dims->width * output_dims->height);
+}
+
+int esp_nn_get_conv_scratch_size_gemm(const data_dims_t *input_dims,
+                                      const data_dims_t *filter_dims,
+                                      const data_dims_t *output_dims,
+                                      const conv_params_t *conv_params)
+{
+    const int32_t depth = filter_dims->width * filter_dims->height *
+                          input_dims->channels;
+    /* The bias with the input offset, then the im2col tile */
+    return output_dims->channels * sizeof(int32_t) +
+           conv_tile_pixels(filter_dims, input_dims, output_dims) * depth;
+}
+
+void esp_nn_set_conv_scratch_buf_gemm(const void *buf)
+{
+    scratch_buffer = (int8_t *) buf;
+}
+
+/**
+ * Unrolls output pixels [first, first + count) into rows of `depth` bytes.
+ * `flip` is xor-ed into every input byte, 0x80 turns uint8 into int8.
+ */
+static void im2col_s8(const uint8_t *input_data,
+                      const data_dims_t *input_dims,
+                      const data_dims_t *filter_dims,
+                      const data_dims_t *output_dims,
+                      const conv_params_t *conv_params,
+                      const uint8_t flip, const int8_t pad_value,
+                      const int32_t first, const int32_t count,
+                      int8_t *col_data)
+{
+    const int32_t input_wd = input_dims->width;
+    const int32_t input_ht = input_dims->height;
+    const int32_t in_channels = input_dims->channels;
+    const int32_t filter_wd = filter_dims->width;
+    const int32_t filter_ht = filter_dims->height;
+    const int32_t out_wd = output_dims->width;
+    const int32_t row_len = filter_wd * in_channels;
+
+    for (int32_t pixel = first; pixel < first + count; pixel++) {
+        const int32_t base_y = (pixel / out_wd) * conv_params->stride.height -
+                               conv_params->padding.height;
+        const int32_t base_x = (pixel % out_wd) * conv_params->stride.width -
+                               conv_params->padding.width;
+        const bool row_inside = base_x >= 0 && base_x + filter_wd <= input_wd;
+        for (int32_t filter_y = 0; filter_y < filter_ht; filter_y++) {
+            const int32_t in_y = base_y + filter_y;
+            if (in_y < 0 || in_y >= input_ht) {
+                memset(col_data, pad_value, row_len);
+                col_data += row_len;
+                continue;
+            }
+            const uint8_t *src = input_data + (in_y * input_wd + base_x) * in_channels;
+            if (row_inside && flip == 0) {
+                memcpy(col_data, src, row_len);
+                col_data += row_len;
+                continue;
+            }
+            for (int32_t filter_x = 0; filter_x < filter_wd; filter_x++) {
+                const int32_t in_x = base_x + filter_x;
+                if (in_x < 0 || in_x >= input_wd) {
+                    memset(col_data, pad_value, in_channels);
+                } else {
+                    for (int32_t ch = 0; ch < in_channels; ch++) {
+                        col_data[ch] = (int8_t) (src[filter_x * in_channels + ch] ^ flip);
+                    }
+                }
+                col_data += in_channels;
+            }
+        }
+    }
+}
+
+/**
+ * Returns false, computing nothing, if the scratch buffer isn't set or the
+ * padding value doesn't fit in int8.
+ */
+static bool esp_nn_conv_gemm(const data_dims_t *input_dims,
+                             const uint8_t *input_data,
+                             const uint8_t flip,
+                             const data_dims_t *filter_dims,
+                             const int8_t *filter_data,
+                             const int32_t *bias,
+                             const data_dims_t *output_dims,
+                             int8_t *out_data,
+                             const conv_params_t *conv_params,
+                             const quant_data_t *quant_data)
+{
+    /* The offset to the int8 values in the im2col rows */
+    const int32_t input_offset = conv_params->in_offset + (flip ? 128 : 0);
+    if (scratch_buffer == NULL || input_offset < -INT8_MAX || input_offset > -INT8_MIN) {
+        return false;
+    }
+    const int32_t out_channels = output_dims->channels;
+    const int32_t depth = filter_dims->width * filter_dims->height *
+                          input_dims->channels;
+    const int32_t pixels = output_dims->width * output_dims->height;
+    const int32_t tile_pixels = conv_tile_pixels(filter_dims, input_dims, output_dims);
+
+    const int32_t *gemm_bias = bias;
+    if (input_offset != 0) {
+        int32_t *offset_bias = (int32_t *) scratch_buffer;
+        for (int32_t ch = 0; ch < out_channels; ch++) {
+            const int8_t *row = filter_data + ch * depth;
+            int32_t sum = 0;
+            for (int32_t k = 0; k < depth; k++) {
+                sum += row[k];
+            }
+            offset_bias[ch] = (bias ? bias[ch] : 0) + input_offset * sum;
+        }
+        gemm_bias = offset_bias;
+    }
+    int8_t *col_data = scratch_buffer + out_channels * sizeof(int32_t);
+
+    for (int32_t first = 0; first < pixels; first += tile_pixels) {
+        const int32_t count = min(tile_pixels, pixels - first);
+        im2col_s8(input_data, input_dims, filter_dims, output_dims, conv_params,
+                  flip, (int8_t) -input_offset, first, count, col_data);
+        esp_nn_gemm_s8(col_data, count, filter_data, out_channels, depth,
+                       gemm_bias, out_data + first * out_channels, out_channels,
+                       conv_params->out_offset, quant_data->shift, quant_data->mult,
+                       conv_params->activation.min, conv_params->activation.max);
+    }
+    return true;
+}
+
+void esp_nn_conv_s8_gemm(const data_dims_t *input_dims,
+                         const int8_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int32_t *bias,
+                         const data_dims_t *output_dims,
+                         int8_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data)
+{
+    if (!esp_nn_conv_gemm(input_dims, (const uint8_t *) input_data, 0,
+                          filter_dims, filter_data, bias, output_dims,
+                          out_data, conv_params, quant_data)) {
+        esp_nn_conv_s8_ansi(input_dims, input_data, filter_dims, filter_data,
+                            bias, output_dims, out_data, conv_params, quant_data);
+    }
+}
+
+void esp_nn_conv_u8_s8_gemm(const data_dims_t *input_dims,
+                            const uint8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data)
+{
+    if (!esp_nn_conv_gemm(input_dims, input_data, 0x80,
+                          filter_dims, filter_data, bias, output_dims,
+                          out_data, conv_params, quant_data)) {
+        esp_nn_conv_u8_s8_ansi(input_dims, input_data, filter_dims, filter_data,
+                               bias, output_dims, out_data, conv_params, quant_data);
+    }
+}
@@ -63,15 +63,20 @@ static void esp_nn_conv_s8_1x1(const data_dims_t *input_dims,
 
                 const int8_t *input_ptr = input_base_ptr;
 
-                int32_t in_ch_idx = 0;
-                for (; in_ch_idx < in_channels - 3; in_ch_idx += 4) {
-                    conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
-                    conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
-                    conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
-                    conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
-                }
-                for (; in_ch_idx < in_channels; in_ch_idx ++) {
-                    conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                if (input_offset == 0) {
+                    conv_out = esp_nn_dot_s8(input_ptr, filter_ptr, in_channels);
+                    filter_ptr += in_channels;
+                } else {
+                    int32_t in_ch_idx = 0;
+                    for (; in_ch_idx < in_channels - 3; in_ch_idx += 4) {
+                        conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                    }
+                    for (; in_ch_idx < in_channels; in_ch_idx ++) {
+                        conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                    }
                 }
                 if (bias) {
                     conv_out += bias[out_ch_idx];
@@ -153,6 +158,101 @@ void esp_nn_conv_s8_opt(const data_dims_t *input_dims,
                         const int8_t *filter_ptr = filter_data +
                                         out_ch_idx * in_channels * filter_ht * filter_wd +
                                         (filter_y_idx * filter_wd + filter_x_idx) * in_channels;
+                        if (input_offset == 0) {
+                            conv_out += esp_nn_dot_s8(input_ptr, filter_ptr, in_channels);
+                            continue;
+                        }
+                        int32_t in_ch_idx = 0;
+                        for (; in_ch_idx < in_channels - 3; in_ch_idx += 4) {
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        }
+                        for (; in_ch_idx < in_channels; in_ch_idx ++) {
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        }
+                    }
+                }
+                if (bias) {
+                    conv_out += bias[out_ch_idx];
+                }
+                conv_out = esp_nn_multiply_by_quantized_mult_fast(conv_out, *out_mult++, *out_shift++);
+                conv_out += out_offset;
+                conv_out = max(conv_out, activation_min);
+                conv_out = min(conv_out, activation_max);
+                *out_data++ = (int8_t) conv_out;
+            }
+        }
+    }
+}
+
+/**
+ * Assumption 1: i/p channels == o/p channels
+ * Assumption 2: Pointers are valid
+ * Assumption 3: dialation width = 1
+ *
+ * uint8 activations, see esp_nn_conv_u8_s8_ansi.
+ */
+void esp_nn_conv_u8_s8_opt(const data_dims_t *input_dims,
+                           const uint8_t *input_data,
+                           const data_dims_t *filter_dims,
+                           const int8_t *filter_data,
+                           const int32_t *bias,
+                           const data_dims_t *output_dims,
+                           int8_t *out_data,
+                           const conv_params_t *conv_params,
+                           const quant_data_t *quant_data)
+{
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    int32_t out_ch_idx, out_y, out_x, filter_y_idx, filter_x_idx;
+
+    for (out_y = 0; out_y < out_ht; out_y++) {
+        for (out_x = 0; out_x < out_wd; out_x++) {
+            const int32_t *out_shift = quant_data->shift;
+            const int32_t *out_mult = quant_data->mult;
+            for (out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                int32_t conv_out = 0;
+
+                const int32_t base_y = stride_ht * out_y - pad_ht;
+                const int32_t base_x = stride_wd * out_x - pad_wd;
+
+                const int32_t filter_y_start = max(0, -base_y);
+                const int32_t filter_x_start = max(0, -base_x);
+
+                const int32_t filter_y_end = min(filter_ht, input_ht - base_y);
+                const int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+
+                for (filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    for (filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t in_row = base_y + filter_y_idx;
+                        const int32_t in_col = base_x + filter_x_idx;
+
+                        const uint8_t *input_ptr = input_data +
+                                        (in_row * input_wd + in_col) * in_channels;
+                        const int8_t *filter_ptr = filter_data +
+                                        out_ch_idx * in_channels * filter_ht * filter_wd +
+                                        (filter_y_idx * filter_wd + filter_x_idx) * in_channels;
+                        if (input_offset == 0) {
+                            conv_out += esp_nn_dot_u8_s8(input_ptr, filter_ptr, in_channels);
+                            continue;
+                        }
                         int32_t in_ch_idx = 0;
                         for (; in_ch_idx < in_channels - 3; in_ch_idx += 4) {
                             conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
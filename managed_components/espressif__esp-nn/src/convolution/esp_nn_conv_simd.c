@@ -0,0 +1,172 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_nn_defs.h>
+#include <esp_nn_ansi_headers.h>
+
+#include <simd_functions.h>
+
+/* receptive field values gathered on the stack, bigger filters take _ansi */
+#define CONV_SIMD_MAX_PATCH 4096
+
+/**
+ * Requantizes the dot products of `patch` with every output channel's
+ * filter into `out_data`, exactly like esp_nn_conv_s8_ansi.
+ */
+static void esp_nn_conv_patch_s8(const int16_t *patch,
+                                 const int32_t patch_size,
+                                 const int8_t *filter_data,
+                                 const int32_t *bias,
+                                 int8_t *out_data,
+                                 const uint16_t out_channels,
+                                 const conv_params_t *conv_params,
+                                 const quant_data_t *quant_data)
+{
+    for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+        int32_t conv_out = esp_nn_simd_dot_s16_s8(patch, filter_data + out_ch_idx * patch_size,
+                                                  patch_size);
+        if (bias) {
+            conv_out += bias[out_ch_idx];
+        }
+        conv_out = esp_nn_multiply_by_quantized_mult(conv_out, quant_data->mult[out_ch_idx],
+                                                     quant_data->shift[out_ch_idx]);
+        conv_out += conv_params->out_offset;
+        conv_out = max(conv_out, conv_params->activation.min);
+        conv_out = min(conv_out, conv_params->activation.max);
+        *out_data++ = (int8_t) conv_out;
+    }
+}
+
+void esp_nn_conv_s8_simd(const data_dims_t *input_dims,
+                         const int8_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int32_t *bias,
+                         const data_dims_t *output_dims,
+                         int8_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t patch_size = filter_ht * filter_wd * in_channels;
+
+    if (patch_size > CONV_SIMD_MAX_PATCH) {
+        esp_nn_conv_s8_ansi(input_dims, input_data, filter_dims, filter_data, bias,
+                            output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+
+    int16_t patch[CONV_SIMD_MAX_PATCH];
+
+    for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+        for (int32_t out_x = 0; out_x < out_wd; out_x++) {
+            const int32_t base_y = stride_ht * out_y - pad_ht;
+            const int32_t base_x = stride_wd * out_x - pad_wd;
+            int16_t *dst = patch;
+
+            /* taps outside of the input contribute 0, as they are skipped by _ansi */
+            for (int32_t filter_y_idx = 0; filter_y_idx < filter_ht; filter_y_idx++) {
+                const int32_t in_row = base_y + filter_y_idx;
+                for (int32_t filter_x_idx = 0; filter_x_idx < filter_wd; filter_x_idx++) {
+                    const int32_t in_col = base_x + filter_x_idx;
+                    if (in_row < 0 || in_row >= input_ht || in_col < 0 || in_col >= input_wd) {
+                        memset(dst, 0, in_channels * sizeof(int16_t));
+                    } else {
+                        const int8_t *src = input_data + (in_row * input_wd + in_col) * in_channels;
+                        for (int32_t in_ch_idx = 0; in_ch_idx < in_channels; in_ch_idx++) {
+                            dst[in_ch_idx] = src[in_ch_idx] + input_offset;
+                        }
+                    }
+                    dst += in_channels;
+                }
+            }
+            esp_nn_conv_patch_s8(patch, patch_size, filter_data, bias, out_data,
+                                 out_channels, conv_params, quant_data);
+            out_data += out_channels;
+        }
+    }
+}
+
+void esp_nn_conv_u8_s8_simd(const data_dims_t *input_dims,
+                            const uint8_t *input_data,
+                            const data_dims_t *filter_dims,
+                            const int8_t *filter_data,
+                            const int32_t *bias,
+                            const data_dims_t *output_dims,
+                            int8_t *out_data,
+                            const conv_params_t *conv_params,
+                            const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t patch_size = filter_ht * filter_wd * in_channels;
+
+    if (patch_size > CONV_SIMD_MAX_PATCH) {
+        esp_nn_conv_u8_s8_ansi(input_dims, input_data, filter_dims, filter_data, bias,
+                               output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+
+    int16_t patch[CONV_SIMD_MAX_PATCH];
+
+    for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+        for (int32_t out_x = 0; out_x < out_wd; out_x++) {
+            const int32_t base_y = stride_ht * out_y - pad_ht;
+            const int32_t base_x = stride_wd * out_x - pad_wd;
+            int16_t *dst = patch;
+
+            for (int32_t filter_y_idx = 0; filter_y_idx < filter_ht; filter_y_idx++) {
+                const int32_t in_row = base_y + filter_y_idx;
+                for (int32_t filter_x_idx = 0; filter_x_idx < filter_wd; filter_x_idx++) {
+                    const int32_t in_col = base_x + filter_x_idx;
+                    if (in_row < 0 || in_row >= input_ht || in_col < 0 || in_col >= input_wd) {
+                        memset(dst, 0, in_channels * sizeof(int16_t));
+                    } else {
+                        const uint8_t *src = input_data + (in_row * input_wd + in_col) * in_channels;
+                        for (int32_t in_ch_idx = 0; in_ch_idx < in_channels; in_ch_idx++) {
+                            dst[in_ch_idx] = src[in_ch_idx] + input_offset;
+                        }
+                    }
+                    dst += in_channels;
+                }
+            }
+            esp_nn_conv_patch_s8(patch, patch_size, filter_data, bias, out_data,
+                                 out_channels, conv_params, quant_data);
+            out_data += out_channels;
+        }
+    }
+}
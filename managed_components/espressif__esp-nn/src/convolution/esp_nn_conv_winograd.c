@@ -0,0 +1,269 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * Winograd F(2x2, 3x3) convolution, for 3x3 stride 1 layers without
+ * padding.
+ *
+ * Every 2x2 block of outputs is computed from the 4x4 block of inputs under
+ * it as Y = A^T [U . V] A, with U = G g G^T the transformed filter and
+ * V = B^T d B the transformed input, summed over the input channels: 16
+ * multiplications per input channel instead of 36.
+ *
+ * G has halves in it, so the filter is transformed with 2G instead, into
+ * integers, and the result is 4 Y. Everything is exact integer arithmetic:
+ * dividing by 4 at the end gives the same accumulator as the direct
+ * convolution, so the output is bit-exact with esp_nn_conv_s8_ansi.
+ *
+ *   2G = | 2  0  0 |   B^T = | 1  0 -1  0 |   A^T = | 1  1  1  0 |
+ *        | 1  1  1 |         | 0  1  1  0 |         | 0  1 -1 -1 |
+ *        | 1 -1  1 |         | 0 -1  1  0 |
+ *        | 0  0  2 |         | 0  1  0 -1 |
+ */
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+/* Elements of a transformed 4x4 tile */
+#define WINOGRAD_TILE 16
+
+__NN_SCRATCH_BUF__ int16_t *scratch_buffer = NULL;
+
+int esp_nn_conv_winograd_supported(const data_dims_t *input_dims,
+                                    const data_dims_t *filter_dims,
+                                    const conv_params_t *conv_params)
+{
+    if (filter_dims->width != 3 || filter_dims->height != 3 ||
+        conv_params->stride.width != 1 || conv_params->stride.height != 1 ||
+        conv_params->padding.width != 0 || conv_params->padding.height != 0) {
+        return 0;
+    }
+    /**
+     * |input + offset| <= 255 + |offset| for int8 and uint8 inputs alike, so
+     * a transformed input is at most 4 times that and a transformed filter
+     * tap 9 * 128. The output transform adds up 9 channel sums of their
+     * products, which must fit in int32.
+     */
+    const int64_t max_input = 255 + (conv_params->in_offset < 0 ? -conv_params->in_offset
+                                                                : conv_params->in_offset);
+    const int64_t max_product = 4 * max_input * 9 * 128;
+    return 4 * max_input <= INT16_MAX &&
+           9 * max_product * input_dims->channels <= INT32_MAX;
+}
+
+int esp_nn_get_conv_winograd_filter_size(const data_dims_t *input_dims,
+                                         const data_dims_t *output_dims)
+{
+    return WINOGRAD_TILE * input_dims->channels * output_dims->channels *
+           sizeof(int16_t);
+}
+
+void esp_nn_conv_winograd_filter_s8(const int8_t *filter_data,
+                                    const int32_t in_channels,
+                                    const int32_t out_channels,
+                                    int16_t *transformed)
+{
+    for (int32_t out_ch = 0; out_ch < out_channels; out_ch++) {
+        for (int32_t in_ch = 0; in_ch < in_channels; in_ch++) {
+            int32_t g[3][3];
+            for (int32_t y = 0; y < 3; y++) {
+                for (int32_t x = 0; x < 3; x++) {
+                    g[y][x] = filter_data[((out_ch * 3 + y) * 3 + x) * in_channels + in_ch];
+                }
+            }
+            /* t = 2G g, then u = t (2G)^T */
+            int32_t t[4][3];
+            for (int32_t x = 0; x < 3; x++) {
+                t[0][x] = 2 * g[0][x];
+                t[1][x] = g[0][x] + g[1][x] + g[2][x];
+                t[2][x] = g[0][x] - g[1][x] + g[2][x];
+                t[3][x] = 2 * g[2][x];
+            }
+            for (int32_t y = 0; y < 4; y++) {
+                const int32_t u[4] = {
+                    2 * t[y][0],
+                    t[y][0] + t[y][1] + t[y][2],
+                    t[y][0] - t[y][1] + t[y][2],
+                    2 * t[y][2],
+                };
+                for (int32_t x = 0; x < 4; x++) {
+                    /* [tile element][out channel][in channel] */
+                    transformed[((y * 4 + x) * out_channels + out_ch) * in_channels + in_ch] =
+                        (int16_t) u[x];
+                }
+            }
+        }
+    }
+}
+
+int esp_nn_get_conv_scratch_size_winograd(const data_dims_t *input_dims,
+                                          const data_dims_t *filter_dims,
+                                          const data_dims_t *output_dims,
+                                          const conv_params_t *conv_params)
+{
+    /* The transformed input tile of every input channel */
+    return WINOGRAD_TILE * input_dims->channels * sizeof(int16_t);
+}
+
+void esp_nn_set_conv_scratch_buf_winograd(const void *buf)
+{
+    scratch_buffer = (int16_t *) buf;
+}
+
+__NN_FORCE_INLINE__ int32_t esp_nn_dot_s16(const int16_t *a, const int16_t *b,
+                                           const int32_t len)
+{
+    int32_t sum = 0;
+    for (int32_t i = 0; i < len; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/**
+ * Transforms the 4x4 input tile at (in_y, in_x) of every input channel into
+ * `v`, [tile element][in channel]. Inputs past the edge read as 0: only the
+ * outputs of the tile that are past the edge too depend on them.
+ */
+__NN_FORCE_INLINE__ void winograd_input_tile(const void *input_data,
+                                             const int32_t is_u8,
+                                             const int32_t input_wd,
+                                             const int32_t input_ht,
+                                             const int32_t in_channels,
+                                             const int32_t input_offset,
+                                             const int32_t in_y,
+                                             const int32_t in_x,
+                                             int16_t *v)
+{
+    for (int32_t ch = 0; ch < in_channels; ch++) {
+        int32_t d[4][4];
+        for (int32_t y = 0; y < 4; y++) {
+            for (int32_t x = 0; x < 4; x++) {
+                if (in_y + y >= input_ht || in_x + x >= input_wd) {
+                    d[y][x] = 0;
+                    continue;
+                }
+                const int32_t index = ((in_y + y) * input_wd + in_x + x) * in_channels + ch;
+                d[y][x] = (is_u8 ? ((const uint8_t *) input_data)[index]
+                                 : ((const int8_t *) input_data)[index]) + input_offset;
+            }
+        }
+        /* t = B^T d, then v = t B */
+        int32_t t[4][4];
+        for (int32_t x = 0; x < 4; x++) {
+            t[0][x] = d[0][x] - d[2][x];
+            t[1][x] = d[1][x] + d[2][x];
+            t[2][x] = d[2][x] - d[1][x];
+            t[3][x] = d[1][x] - d[3][x];
+        }
+        for (int32_t y = 0; y < 4; y++) {
+            v[(y * 4 + 0) * in_channels + ch] = (int16_t) (t[y][0] - t[y][2]);
+            v[(y * 4 + 1) * in_channels + ch] = (int16_t) (t[y][1] + t[y][2]);
+            v[(y * 4 + 2) * in_channels + ch] = (int16_t) (t[y][2] - t[y][1]);
+            v[(y * 4 + 3) * in_channels + ch] = (int16_t) (t[y][1] - t[y][3]);
+        }
+    }
+}
+
+static void esp_nn_conv_winograd(const data_dims_t *input_dims,
+                                 const void *input_data,
+                                 const int32_t is_u8,
+                                 const int16_t *filter_data,
+                                 const int32_t *bias,
+                                 const data_dims_t *output_dims,
+                                 int8_t *out_data,
+                                 const conv_params_t *conv_params,
+                                 const quant_data_t *quant_data)
+{
+    const int32_t input_wd = input_dims->width;
+    const int32_t input_ht = input_dims->height;
+    const int32_t in_channels = input_dims->channels;
+    const int32_t out_wd = output_dims->width;
+    const int32_t out_ht = output_dims->height;
+    const int32_t out_channels = output_dims->channels;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    int16_t *v = scratch_buffer;
+
+    for (int32_t tile_y = 0; tile_y < out_ht; tile_y += 2) {
+        for (int32_t tile_x = 0; tile_x < out_wd; tile_x += 2) {
+            winograd_input_tile(input_data, is_u8, input_wd, input_ht, in_channels,
+                                conv_params->in_offset, tile_y, tile_x, v);
+            const int32_t rows = min(2, out_ht - tile_y);
+            const int32_t cols = min(2, out_wd - tile_x);
+            for (int32_t out_ch = 0; out_ch < out_channels; out_ch++) {
+                int32_t m[4][4];
+                for (int32_t i = 0; i < WINOGRAD_TILE; i++) {
+                    m[i / 4][i % 4] = esp_nn_dot_s16(
+                        filter_data + (i * out_channels + out_ch) * in_channels,
+                        v + i * in_channels, in_channels);
+                }
+                /* s = A^T m, then y = s A */
+                int32_t s[2][4];
+                for (int32_t x = 0; x < 4; x++) {
+                    s[0][x] = m[0][x] + m[1][x] + m[2][x];
+                    s[1][x] = m[1][x] - m[2][x] - m[3][x];
+                }
+                int32_t y[2][2];
+                for (int32_t i = 0; i < 2; i++) {
+                    y[i][0] = s[i][0] + s[i][1] + s[i][2];
+                    y[i][1] = s[i][1] - s[i][2] - s[i][3];
+                }
+                for (int32_t i = 0; i < rows; i++) {
+                    for (int32_t j = 0; j < cols; j++) {
+                        /* The filter was transformed with 2G, y is 4 times the sum */
+                        int32_t result = y[i][j] / 4;
+                        if (bias) {
+                            result += bias[out_ch];
+                        }
+                        result = esp_nn_multiply_by_quantized_mult(result,
+                                        quant_data->mult[out_ch], quant_data->shift[out_ch]);
+                        result += conv_params->out_offset;
+                        result = max(result, activation_min);
+                        result = min(result, activation_max);
+                        out_data[((tile_y + i) * out_wd + tile_x + j) * out_channels + out_ch] =
+                            (int8_t) result;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void esp_nn_conv_s8_winograd(const data_dims_t *input_dims,
+                             const int8_t *input_data,
+                             const int16_t *filter_data,
+                             const int32_t *bias,
+                             const data_dims_t *output_dims,
+                             int8_t *out_data,
+                             const conv_params_t *conv_params,
+                             const quant_data_t *quant_data)
+{
+    esp_nn_conv_winograd(input_dims, input_data, 0, filter_data, bias,
+                         output_dims, out_data, conv_params, quant_data);
+}
+
+void esp_nn_conv_u8_s8_winograd(const data_dims_t *input_dims,
+                                const uint8_t *input_data,
+                                const int16_t *filter_data,
+                                const int32_t *bias,
+                                const data_dims_t *output_dims,
+                                int8_t *out_data,
+                                const conv_params_t *conv_params,
+                                const quant_data_t *quant_data)
+{
+    esp_nn_conv_winograd(input_dims, input_data, 1, filter_data, bias,
+                         output_dims, out_data, conv_params, quant_data);
+}
@@ -0,0 +1,130 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_nn_defs.h>
+#include <esp_nn_ansi_headers.h>
+
+#include <simd_functions.h>
+
+/* accumulators kept on the stack, wider layers take _ansi */
+#define DEPTHWISE_SIMD_MAX_CHANNELS 1024
+
+/**
+ * acc[i] += (input[i] + input_offset) * filter[i] for the `size` output
+ * channels of one filter tap. With a channel multiplier, `input` holds the
+ * input values already repeated ch_mult times, with their offset.
+ */
+static inline void esp_nn_depthwise_tap_s8(int32_t *acc,
+                                           const int8_t *input,
+                                           const int32_t *input_expanded,
+                                           const int32_t input_offset,
+                                           const int8_t *filter,
+                                           const int32_t size)
+{
+    const esp_nn_v32_t offset = esp_nn_v32_set1(input_offset);
+    int32_t i = 0;
+    for (; i + ESP_NN_SIMD_LANES <= size; i += ESP_NN_SIMD_LANES) {
+        esp_nn_v32_t in = input_expanded ? esp_nn_v32_load_s32(input_expanded + i) :
+                          esp_nn_v32_add(esp_nn_v32_load_s8(input + i), offset);
+        esp_nn_v32_t prod = esp_nn_v32_mul(in, esp_nn_v32_load_s8(filter + i));
+        esp_nn_v32_store_s32(acc + i, esp_nn_v32_add(esp_nn_v32_load_s32(acc + i), prod));
+    }
+    for (; i < size; i++) {
+        const int32_t in = input_expanded ? input_expanded[i] : input[i] + input_offset;
+        acc[i] += in * filter[i];
+    }
+}
+
+void esp_nn_depthwise_conv_s8_simd(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int32_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const dw_conv_params_t *conv_params,
+                                   const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const int32_t *out_shift = quant_data->shift;
+    const int32_t *out_mult = quant_data->mult;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const uint16_t ch_mult = conv_params->ch_mult;
+    const int32_t out_channels = channels * ch_mult;
+
+    if (out_channels > DEPTHWISE_SIMD_MAX_CHANNELS) {
+        esp_nn_depthwise_conv_s8_ansi(input_dims, input_data, filter_dims, filter_data, bias,
+                                      output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+
+    int32_t acc[DEPTHWISE_SIMD_MAX_CHANNELS];
+    int32_t input_expanded[DEPTHWISE_SIMD_MAX_CHANNELS];
+
+    for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+        const int32_t base_y = (out_y * stride_ht) - pad_ht;
+        for (int32_t out_x = 0; out_x < out_wd; out_x++) {
+            const int32_t base_x = (out_x * stride_wd) - pad_wd;
+
+            /* Select filter so as the point doesn't lie outside block */
+            const int32_t filter_y_start = max(0, -base_y);
+            const int32_t filter_x_start = max(0, -base_x);
+            const int32_t filter_y_end = min(filter_ht, input_ht - base_y);
+            const int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+
+            memset(acc, 0, out_channels * sizeof(int32_t));
+            for (int32_t filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                const int32_t idx_y = base_y + filter_y_idx;
+                for (int32_t filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                    const int32_t idx_x = base_x + filter_x_idx;
+                    const int8_t *input = input_data + (idx_y * input_wd + idx_x) * channels;
+                    const int8_t *filter = filter_data + (filter_y_idx * filter_wd + filter_x_idx) * out_channels;
+                    if (ch_mult == 1) {
+                        esp_nn_depthwise_tap_s8(acc, input, NULL, input_offset, filter, out_channels);
+                        continue;
+                    }
+                    for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                        input_expanded[out_ch_idx] = input[out_ch_idx / ch_mult] + input_offset;
+                    }
+                    esp_nn_depthwise_tap_s8(acc, input, input_expanded, input_offset, filter, out_channels);
+                }
+            }
+
+            for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                int32_t result = acc[out_ch_idx];
+                if (bias) {
+                    result += bias[out_ch_idx];
+                }
+                result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_ch_idx], out_shift[out_ch_idx]);
+                result += out_offset;
+                result = max(result, activation_min);
+                result = min(result, activation_max);
+                *out_data++ = (int8_t) result;
+            }
+        }
+    }
+}
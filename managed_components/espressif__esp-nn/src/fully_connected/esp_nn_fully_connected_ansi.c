@@ -30,13 +30,18 @@ void esp_nn_fully_connected_s8_ansi(const int8_t *input_data,
                                     const int32_t activation_min,
                                     const int32_t activation_max)
 {
+    const bool no_offsets = input_offset == 0 && filter_offset == 0;
     for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
         int32_t result = 0;
-        for (int32_t data_idx = 0; data_idx < row_len; data_idx++) {
-            int32_t filter_index = row_len * out_c + data_idx;
-            int32_t input_val = input_data[data_idx];
-            int32_t filter_val = filter_data[filter_index];
-            result += (filter_val + filter_offset) * (input_val + input_offset);
+        if (no_offsets) {
+            result = esp_nn_dot_s8(input_data, filter_data + row_len * out_c, row_len);
+        } else {
+            for (int32_t data_idx = 0; data_idx < row_len; data_idx++) {
+                int32_t filter_index = row_len * out_c + data_idx;
+                int32_t input_val = input_data[data_idx];
+                int32_t filter_val = filter_data[filter_index];
+                result += (filter_val + filter_offset) * (input_val + input_offset);
+            }
         }
         if (bias) {
             result += bias[out_c];
@@ -48,3 +53,117 @@ void esp_nn_fully_connected_s8_ansi(const int8_t *input_data,
         out_data[out_c] = (int8_t) result;
     }
 }
+
+void esp_nn_fully_connected_per_ch_s8_ansi(const int8_t *input_data,
+                                           const int32_t input_offset,
+                                           const uint16_t row_len,
+                                           const int8_t *filter_data,
+                                           const int32_t filter_offset,
+                                           const int32_t *bias,
+                                           int8_t *out_data,
+                                           const uint16_t out_channels,
+                                           const int32_t out_offset,
+                                           const int32_t *out_shift,
+                                           const int32_t *out_mult,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max)
+{
+    const bool no_offsets = input_offset == 0 && filter_offset == 0;
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        int32_t result = 0;
+        if (no_offsets) {
+            result = esp_nn_dot_s8(input_data, filter_data + row_len * out_c, row_len);
+        } else {
+            for (int32_t data_idx = 0; data_idx < row_len; data_idx++) {
+                int32_t filter_index = row_len * out_c + data_idx;
+                int32_t input_val = input_data[data_idx];
+                int32_t filter_val = filter_data[filter_index];
+                result += (filter_val + filter_offset) * (input_val + input_offset);
+            }
+        }
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_c], out_shift[out_c]);
+        result += out_offset;
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int8_t) result;
+    }
+}
+
+/* sum(input + input_offset), what a filter offset multiplies */
+__NN_FORCE_INLINE__ int32_t esp_nn_fully_connected_s4_input_sum(const int8_t *input_data,
+                                                                const int32_t input_offset,
+                                                                const uint16_t row_len)
+{
+    int32_t sum = 0;
+    for (int32_t i = 0; i < row_len; i++) {
+        sum += input_data[i] + input_offset;
+    }
+    return sum;
+}
+
+void esp_nn_fully_connected_s8_s4_ansi(const int8_t *input_data,
+                                       const int32_t input_offset,
+                                       const uint16_t row_len,
+                                       const int8_t *filter_data,
+                                       const int32_t filter_offset,
+                                       const int32_t *bias,
+                                       int8_t *out_data,
+                                       const uint16_t out_channels,
+                                       const int32_t out_offset,
+                                       const int32_t out_shift,
+                                       const int32_t out_mult,
+                                       const int32_t activation_min,
+                                       const int32_t activation_max)
+{
+    const int32_t input_sum = filter_offset == 0 ? 0 :
+        esp_nn_fully_connected_s4_input_sum(input_data, input_offset, row_len);
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        /* (input + input_offset) * (filter + filter_offset), summed */
+        int32_t result = esp_nn_dot_s8_s4(input_data, input_offset, filter_data,
+                                          row_len * out_c, row_len) +
+                         filter_offset * input_sum;
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+        result += out_offset;
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int8_t) result;
+    }
+}
+
+void esp_nn_fully_connected_per_ch_s8_s4_ansi(const int8_t *input_data,
+                                              const int32_t input_offset,
+                                              const uint16_t row_len,
+                                              const int8_t *filter_data,
+                                              const int32_t filter_offset,
+                                              const int32_t *bias,
+                                              int8_t *out_data,
+                                              const uint16_t out_channels,
+                                              const int32_t out_offset,
+                                              const int32_t *out_shift,
+                                              const int32_t *out_mult,
+                                              const int32_t activation_min,
+                                              const int32_t activation_max)
+{
+    const int32_t input_sum = filter_offset == 0 ? 0 :
+        esp_nn_fully_connected_s4_input_sum(input_data, input_offset, row_len);
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        /* (input + input_offset) * (filter + filter_offset), summed */
+        int32_t result = esp_nn_dot_s8_s4(input_data, input_offset, filter_data,
+                                          row_len * out_c, row_len) +
+                         filter_offset * input_sum;
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_c], out_shift[out_c]);
+        result += out_offset;
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int8_t) result;
+    }
+}
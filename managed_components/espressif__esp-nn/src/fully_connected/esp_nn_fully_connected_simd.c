@@ -0,0 +1,97 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <simd_functions.h>
+
+/**
+ * sum((filter[i] + filter_offset) * (input[i] + input_offset)), expanded so
+ * that the loop over the row is a plain dot product. `input_sum` is
+ * sum(input[i]), the same for every row.
+ */
+static inline int32_t esp_nn_fc_row_s8(const int8_t *input_data,
+                                       const int32_t input_offset,
+                                       const int32_t input_sum,
+                                       const uint16_t row_len,
+                                       const int8_t *filter_row,
+                                       const int32_t filter_offset)
+{
+    int32_t result = esp_nn_simd_dot_s8(input_data, filter_row, row_len);
+    if (input_offset) {
+        result += input_offset * (esp_nn_simd_sum_s8(filter_row, row_len) + filter_offset * row_len);
+    }
+    if (filter_offset) {
+        result += filter_offset * input_sum;
+    }
+    return result;
+}
+
+void esp_nn_fully_connected_s8_simd(const int8_t *input_data,
+                                    const int32_t input_offset,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int32_t filter_offset,
+                                    const int32_t *bias,
+                                    int8_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_offset,
+                                    const int32_t out_shift,
+                                    const int32_t out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max)
+{
+    const int32_t input_sum = filter_offset ? esp_nn_simd_sum_s8(input_data, row_len) : 0;
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        int32_t result = esp_nn_fc_row_s8(input_data, input_offset, input_sum, row_len,
+                                          filter_data + row_len * out_c, filter_offset);
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+        result += out_offset;
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int8_t) result;
+    }
+}
+
+void esp_nn_fully_connected_per_ch_s8_simd(const int8_t *input_data,
+                                           const int32_t input_offset,
+                                           const uint16_t row_len,
+                                           const int8_t *filter_data,
+                                           const int32_t filter_offset,
+                                           const int32_t *bias,
+                                           int8_t *out_data,
+                                           const uint16_t out_channels,
+                                           const int32_t out_offset,
+                                           const int32_t *out_shift,
+                                           const int32_t *out_mult,
+                                           const int32_t activation_min,
+                                           const int32_t activation_max)
+{
+    const int32_t input_sum = filter_offset ? esp_nn_simd_sum_s8(input_data, row_len) : 0;
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        int32_t result = esp_nn_fc_row_s8(input_data, input_offset, input_sum, row_len,
+                                          filter_data + row_len * out_c, filter_offset);
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_c], out_shift[out_c]);
+        result += out_offset;
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int8_t) result;
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <simd_functions.h>
+
+/* channels summed per pass over the filter window */
+#define AVG_POOL_SIMD_CHANNELS 256
+
+void esp_nn_avg_pool_s8_simd(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels)
+{
+    int32_t sums[AVG_POOL_SIMD_CHANNELS];
+
+    int32_t base_y = -pad_ht;
+    for (int32_t out_y = 0; out_y < output_ht; out_y++, base_y += stride_ht) {
+        int32_t base_x = -pad_wd;
+        for (int32_t out_x = 0; out_x < output_wd; out_x++, base_x += stride_wd) {
+            /* Make sure filter does not cross the input box */
+            int32_t filter_y_start = max(0, -base_y);
+            int32_t filter_x_start = max(0, -base_x);
+            int32_t filter_y_end = min(filter_ht, input_ht - base_y);
+            int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+            int32_t filter_cnt = (filter_y_end - filter_y_start) * (filter_x_end - filter_x_start);
+
+            for (int32_t ch_start = 0; ch_start < channels; ch_start += AVG_POOL_SIMD_CHANNELS) {
+                const int32_t ch_cnt = min(channels - ch_start, AVG_POOL_SIMD_CHANNELS);
+
+                memset(sums, 0, ch_cnt * sizeof(int32_t));
+                for (int32_t filter_y = filter_y_start; filter_y < filter_y_end; filter_y++) {
+                    for (int32_t filter_x = filter_x_start; filter_x < filter_x_end; filter_x++) {
+                        int32_t in_x_idx = base_x + filter_x;
+                        int32_t in_y_idx = base_y + filter_y;
+                        const int8_t *src = input + (in_y_idx * input_wd + in_x_idx) * channels + ch_start;
+                        int32_t ch_idx = 0;
+                        for (; ch_idx + ESP_NN_SIMD_LANES <= ch_cnt; ch_idx += ESP_NN_SIMD_LANES) {
+                            esp_nn_v32_t sum = esp_nn_v32_add(esp_nn_v32_load_s32(sums + ch_idx),
+                                                              esp_nn_v32_load_s8(src + ch_idx));
+                            esp_nn_v32_store_s32(sums + ch_idx, sum);
+                        }
+                        for (; ch_idx < ch_cnt; ch_idx++) {
+                            sums[ch_idx] += src[ch_idx];
+                        }
+                    }
+                }
+
+                for (int32_t ch_idx = 0; ch_idx < ch_cnt; ch_idx++) {
+                    int32_t result = sums[ch_idx];
+
+                    /* Rounded average */
+                    result = result > 0 ? (result + filter_cnt / 2) / filter_cnt
+                                        : (result - filter_cnt / 2) / filter_cnt;
+
+                    /* Activation function */
+                    result = max(result, activation_min);
+                    result = min(result, activation_max);
+                    output[ch_start + ch_idx] = (int8_t) result;
+                }
+            }
+            output += channels;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <simd_functions.h>
+
+void esp_nn_max_pool_s8_simd(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels)
+{
+    int32_t base_y = -pad_ht;
+    for (int32_t out_y = 0; out_y < output_ht; out_y++, base_y += stride_ht) {
+        int32_t base_x = -pad_wd;
+        for (int32_t out_x = 0; out_x < output_wd; out_x++, base_x += stride_wd) {
+            /* Make sure filter does not cross the input box */
+            int32_t filter_y_start = max(0, -base_y);
+            int32_t filter_x_start = max(0, -base_x);
+            int32_t filter_y_end = min(filter_ht, input_ht - base_y);
+            int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+
+            /* all the channels of the output pixel at once */
+            memset(output, INT8_MIN, channels);
+            for (int32_t filter_y = filter_y_start; filter_y < filter_y_end; filter_y++) {
+                for (int32_t filter_x = filter_x_start; filter_x < filter_x_end; filter_x++) {
+                    int32_t in_x_idx = base_x + filter_x;
+                    int32_t in_y_idx = base_y + filter_y;
+                    esp_nn_simd_max_s8(output, input + (in_y_idx * input_wd + in_x_idx) * channels,
+                                       channels);
+                }
+            }
+
+            /* Activation function */
+            esp_nn_simd_clamp_s8(output, output, channels, activation_min, activation_max);
+            output += channels;
+        }
+    }
+}
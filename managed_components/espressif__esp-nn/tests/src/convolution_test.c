@@ -223,9 +223,9 @@ void esp_nn_depthwise_conv_s8_test()
             goto dc_s8_cleanup;
         }
 
-        input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
-        out_data_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
-        out_data_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+        input = (int8_t *) (((uintptr_t) input_orig + 15) & ~15);
+        out_data_c = (int8_t *) (((uintptr_t) out_c_orig + 15) & ~15);
+        out_data_opt = (int8_t *) (((uintptr_t) out_opt_orig + 15) & ~15);
 
         /* Generate input data */
         for (int i = 0; i < in_size; ++i) {
@@ -266,7 +266,7 @@ void esp_nn_depthwise_conv_s8_test()
                        itr, scratch_buf_size);
                 goto dc_s8_cleanup;
             }
-            int align_sz = 16 - (((int32_t) scratch_buf) & 0xf);
+            int align_sz = 16 - (((uintptr_t) scratch_buf) & 0xf);
             esp_nn_set_depthwise_conv_scratch_buf(scratch_buf + align_sz);
         }
 
@@ -537,9 +537,9 @@ void esp_nn_conv_s8_test()
             goto conv_s8_cleanup;
         }
 
-        int8_t *input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
-        int8_t *out_data_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
-        int8_t *out_data_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+        int8_t *input = (int8_t *) (((uintptr_t) input_orig + 15) & ~15);
+        int8_t *out_data_c = (int8_t *) (((uintptr_t) out_c_orig + 15) & ~15);
+        int8_t *out_data_opt = (int8_t *) (((uintptr_t) out_opt_orig + 15) & ~15);
 
         /* Generate input data between -128 -> +127 */
         for (int i = 0; i < in_size; ++i) {
@@ -582,7 +582,7 @@ void esp_nn_conv_s8_test()
                 printf(ANSI_COLOR_RED"scratch_buf alloc failed size %d\n"ANSI_COLOR_RESET, scratch_buf_size);
                 goto conv_s8_cleanup;
             }
-            int align_sz = 16 - (((int32_t) scratch_buf) & 0xf);
+            int align_sz = 16 - (((uintptr_t) scratch_buf) & 0xf);
             esp_nn_set_conv_scratch_buf(scratch_buf + align_sz);
         }
 
@@ -656,3 +656,194 @@ void esp_nn_conv_s8_test()
         }
     }
 }
+
+/*
+ * uint8 activations with the zero point shift folded into in_offset must give
+ * the same result as shifting the input to int8 first.
+ */
+void esp_nn_conv_u8_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t input_offset = 128; /* int8 input with zero point -128 */
+    const int32_t activation_min = -128;
+    const int32_t activation_max = 127;
+    const int32_t out_offset = -128;
+
+    uint8_t *input_u8 = NULL;
+    int8_t *input_s8 = NULL;
+    int8_t *filter_data = NULL;
+    int32_t *bias = NULL, *out_shift = NULL, *out_mult = NULL;
+    int8_t *out_ref = NULL, *out_c = NULL, *out_opt = NULL;
+
+    int in_wd, in_ht, in_channels, out_channels;
+    uint16_t filter_ht, filter_wd, out_wd, out_ht;
+    uint16_t pad_wd, pad_ht, stride_wd, stride_ht;
+
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 4; itr++) {
+        switch (itr) {
+        case 0: // first layer of a grayscale model
+            in_wd = 96;
+            in_ht = 96;
+            in_channels = 1;
+            out_channels = 32;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        case 1: // rgb, padded, stride 2
+            in_wd = 32;
+            in_ht = 32;
+            in_channels = 3;
+            out_channels = 16;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 2: // 1x1
+            in_wd = 8;
+            in_ht = 8;
+            in_channels = 16;
+            out_channels = 8;
+            filter_ht = 1;
+            filter_wd = 1;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        default: // odd channel count
+            in_wd = 10;
+            in_ht = 10;
+            in_channels = 5;
+            out_channels = 7;
+            filter_ht = 5;
+            filter_wd = 5;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        }
+
+        if (pad_wd) {
+            out_wd = (in_wd + stride_wd - 1) / stride_wd;
+        } else {
+            out_wd = (in_wd + stride_wd - filter_wd) / stride_wd;
+        }
+        if (pad_ht) {
+            out_ht = (in_ht + stride_ht - 1) / stride_ht;
+        } else {
+            out_ht = (in_ht + stride_ht - filter_ht) / stride_ht;
+        }
+
+        int in_size = in_wd * in_ht * in_channels;
+        int filter_size = filter_wd * filter_ht * in_channels * out_channels;
+        int out_size = out_wd * out_ht * out_channels;
+
+        input_u8 = malloc(in_size);
+        input_s8 = malloc(in_size);
+        filter_data = malloc(filter_size);
+        bias = malloc(sizeof (int32_t) * out_channels);
+        out_shift = malloc(sizeof (int32_t) * out_channels);
+        out_mult = malloc(sizeof (int32_t) * out_channels);
+        out_ref = malloc(out_size);
+        out_c = malloc(out_size);
+        out_opt = malloc(out_size);
+
+        if (input_u8 == NULL || input_s8 == NULL || filter_data == NULL || bias == NULL ||
+                out_shift == NULL || out_mult == NULL || out_ref == NULL ||
+                out_c == NULL || out_opt == NULL) {
+            printf(ANSI_COLOR_RED"allocations failed\n"ANSI_COLOR_RESET);
+            goto conv_u8_s8_cleanup;
+        }
+
+        for (int i = 0; i < in_size; ++i) {
+            input_u8[i] = rand() % 256;
+            input_s8[i] = (int8_t) (input_u8[i] - 128);
+        }
+        for (int i = 0; i < filter_size; ++i) {
+            filter_data[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (int32_t)rand() % UINT16_MAX - INT16_MAX;
+            out_shift[i] = -10 + rand() % 2;
+            out_mult[i] = 0x7f67f4f8 + rand() % 50;
+        }
+
+        data_dims_t input_dims = {.width = in_wd, .height = in_ht, .channels = in_channels, 1};
+        data_dims_t output_dims = {.width = out_wd, .height = out_ht, .channels = out_channels, 1};
+        data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
+        conv_params_t conv_params = {.in_offset = input_offset, .out_offset = out_offset,
+                                    .stride = {stride_wd, stride_ht}, .padding = {pad_wd, pad_ht},
+                                    .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+        conv_params_t conv_params_u8 = conv_params;
+        conv_params_u8.in_offset = input_offset - 128;
+        quant_data_t quant_data = {.shift = out_shift, .mult = out_mult};
+
+        esp_nn_conv_s8_ansi(&input_dims, input_s8, &filter_dims, filter_data,
+                            bias, &output_dims, out_ref, &conv_params, &quant_data);
+
+        profile_c_start();
+        esp_nn_conv_u8_s8_ansi(&input_dims, input_u8, &filter_dims, filter_data,
+                               bias, &output_dims, out_c, &conv_params_u8, &quant_data);
+        total_c = profile_c_end();
+
+        profile_opt_start();
+        esp_nn_conv_u8_s8_opt(&input_dims, input_u8, &filter_dims, filter_data,
+                              bias, &output_dims, out_opt, &conv_params_u8, &quant_data);
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(out_ref, out_c, out_size);
+#if defined(ESP_NN_HOST_SIMD)
+        if (ret == true) {
+            /* the host _simd variant requantizes like _ansi */
+            esp_nn_conv_u8_s8(&input_dims, input_u8, &filter_dims, filter_data,
+                              bias, &output_dims, out_opt, &conv_params_u8, &quant_data);
+            ret = CHECK_EQUAL(out_ref, out_opt, out_size);
+            esp_nn_conv_u8_s8_opt(&input_dims, input_u8, &filter_dims, filter_data,
+                                  bias, &output_dims, out_opt, &conv_params_u8, &quant_data);
+        }
+#endif
+        if (ret == true) {
+            /* opt variants round with the _fast multiplier, compare against s8 opt */
+            esp_nn_conv_s8_opt(&input_dims, input_s8, &filter_dims, filter_data,
+                               bias, &output_dims, out_ref, &conv_params, &quant_data);
+            ret = CHECK_EQUAL(out_ref, out_opt, out_size);
+        }
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed [pad: (%d, %d), stride: (%d, %d)"
+                   " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]\n"ANSI_COLOR_RESET,
+                   itr, pad_wd, pad_ht, stride_wd, stride_ht, out_wd, out_ht,
+                   out_channels, filter_wd, filter_ht, in_channels);
+            goto conv_u8_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [pad: (%d, %d), stride: (%d, %d)"
+               " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]"ANSI_COLOR_RESET,
+               itr, pad_wd, pad_ht, stride_wd, stride_ht, out_wd, out_ht,
+               out_channels, filter_wd, filter_ht, in_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+
+    conv_u8_s8_cleanup:
+        free(input_u8);
+        free(input_s8);
+        free(filter_data);
+        free(bias);
+        free(out_shift);
+        free(out_mult);
+        free(out_ref);
+        free(out_c);
+        free(out_opt);
+        input_u8 = NULL;
+        input_s8 = NULL;
+        filter_data = NULL;
+        bias = out_shift = out_mult = NULL;
+        out_ref = out_c = out_opt = NULL;
+    }
+}
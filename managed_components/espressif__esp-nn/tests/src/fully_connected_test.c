@@ -22,7 +22,7 @@ void esp_nn_fully_connected_s8_test()
     uint16_t out_channels = 3;
     int8_t input[row_len];
     int8_t filter_data[row_len * out_channels];
-    int8_t output_c[out_channels], output_opt[out_channels];
+    int8_t output_c[16], output_opt[16]; /* out_channels goes up to 16 */
     int32_t activation_min = -128;
     int32_t activation_max = 127;
     int32_t input_offset = 0;
@@ -80,6 +80,10 @@ void esp_nn_fully_connected_s8_test()
         if (itr == 0) {
             out_shift = SHIFT_MAX;
         }
+        if (itr >= 12) { /* asymmetric quantization */
+            input_offset = rand() % 256 - 128;
+            filter_offset = rand() % 256 - 128;
+        }
         /* Generate input and filter data */
         for (int i = 0; i < row_len; ++i) {
             input[i] = rand() % 256 - 128;
@@ -109,7 +113,8 @@ void esp_nn_fully_connected_s8_test()
 
         bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
         if (ret == false) {
-            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            printf(ANSI_COLOR_RED"[%3d] failed [offsets %"PRId32", %"PRId32"]\n"ANSI_COLOR_RESET,
+                   itr, input_offset, filter_offset);
 #if 0
             printf("Output: \n");
             PRINT_ARRAY_HEX(output_opt, out_channels, 1);
@@ -129,3 +134,84 @@ void esp_nn_fully_connected_s8_test()
         printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
     }
 }
+
+void esp_nn_fully_connected_per_ch_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    uint16_t out_channels = 7;
+    int8_t input[row_len];
+    int8_t filter_data[row_len * out_channels];
+    int32_t bias[out_channels];
+    int32_t out_shift[out_channels];
+    int32_t out_mult[out_channels];
+    int8_t output_c[out_channels], output_opt[out_channels];
+    int32_t activation_min = -128;
+    int32_t activation_max = 127;
+    int32_t input_offset = 0;
+    int32_t filter_offset = 0;
+    int32_t out_offset = -3;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 10; itr++) {
+        switch (itr) {
+        case 0:
+            break;
+        case 1:
+            row_len = 16;
+            break;
+        case 2:
+            row_len = 1;
+            break;
+        case 3: /* input offset only, as with the first layer of a folded model */
+            row_len = 200;
+            input_offset = 128;
+            break;
+        default:
+            row_len = rand() % 64 + 1;
+            input_offset = rand() % 256 - 128;
+            filter_offset = rand() % 256 - 128;
+            break;
+        }
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = rand() % UINT16_MAX - INT16_MAX;
+            out_shift[i] = -10 + rand() % 5;
+            out_mult[i] = INT32_MAX / row_len + rand() % INT16_MAX;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_per_ch_s8_ansi(input, input_offset, row_len, filter_data, filter_offset,
+                                              bias, output_c, out_channels, out_offset, out_shift,
+                                              out_mult, activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_per_ch_s8(input, input_offset, row_len, filter_data, filter_offset,
+                                         bias, output_opt, out_channels, out_offset, out_shift,
+                                         out_mult, activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed [offsets %"PRId32", %"PRId32"]\n"ANSI_COLOR_RESET,
+                   itr, input_offset, filter_offset);
+            return;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+}
@@ -14,12 +14,11 @@
 #include "test_utils.h"
 
 
-void esp_nn_avg_pool_s8_test()
+static void esp_nn_avg_pool_s8_test_channels(const uint16_t channels)
 {
     /* prepare data */
     const uint16_t input_wd = 16;
     const uint16_t input_ht = 16;
-    const uint16_t channels = 16; /* With TFLite example, I have seen it 256 */
     const int size = input_wd * input_ht * channels;
     int8_t *input = NULL, *output_c = NULL, *output_opt = NULL;
     const int32_t activation_min = -128;
@@ -42,9 +41,9 @@ void esp_nn_avg_pool_s8_test()
         goto avg_pool_s8_cleanup;
     }
 
-    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
-    output_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
-    output_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+    input = (int8_t *) (((uintptr_t) input_orig + 15) & ~15);
+    output_c = (int8_t *) (((uintptr_t) out_c_orig + 15) & ~15);
+    output_opt = (int8_t *) (((uintptr_t) out_opt_orig + 15) & ~15);
 
     /**
      * width/height, channels etc look suspicious but it it true.
@@ -78,7 +77,7 @@ void esp_nn_avg_pool_s8_test()
 
     bool ret = CHECK_EQUAL(output_c, output_opt, out_size);
     if (ret == false) {
-        printf(ANSI_COLOR_RED"%s failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        printf(ANSI_COLOR_RED"%s failed [channels %d]\n"ANSI_COLOR_RESET, __FUNCTION__, channels);
         printf("Output: \n");
         PRINT_ARRAY_HEX(output_opt, out_wd * channels, out_ht);
         printf("Expected: \n");
@@ -87,7 +86,7 @@ void esp_nn_avg_pool_s8_test()
         PRINT_ARRAY_HEX(input, input_wd * channels, input_ht);
         goto avg_pool_s8_cleanup;
     }
-    printf(ANSI_COLOR_GREEN"%s passed\n"ANSI_COLOR_RESET, __FUNCTION__);
+    printf(ANSI_COLOR_GREEN"%s passed [channels %d]\n"ANSI_COLOR_RESET, __FUNCTION__, channels);
 
 avg_pool_s8_cleanup:
     if (input_orig) {
@@ -101,12 +100,18 @@ avg_pool_s8_cleanup:
     }
 }
 
-void esp_nn_max_pool_s8_test()
+void esp_nn_avg_pool_s8_test()
+{
+    /* a multiple of the vector width, and one with a left-over */
+    esp_nn_avg_pool_s8_test_channels(16); /* With TFLite example, I have seen it 256 */
+    esp_nn_avg_pool_s8_test_channels(36);
+}
+
+static void esp_nn_max_pool_s8_test_channels(const uint16_t channels)
 {
     /* prepare data */
     const uint16_t input_wd = 16;
     const uint16_t input_ht = 16;
-    const uint16_t channels = 16; /* With TFLite example, I have seen it 256 */
     int8_t *input = NULL, *output_c = NULL, *output_opt = NULL;
     const int size = input_wd * input_ht * channels;
     const int32_t activation_min = -128;
@@ -129,9 +134,9 @@ void esp_nn_max_pool_s8_test()
         goto max_pool_s8_cleanup;
     }
 
-    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
-    output_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
-    output_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+    input = (int8_t *) (((uintptr_t) input_orig + 15) & ~15);
+    output_c = (int8_t *) (((uintptr_t) out_c_orig + 15) & ~15);
+    output_opt = (int8_t *) (((uintptr_t) out_opt_orig + 15) & ~15);
 
     for (int i = 0; i < size; ++i) {
         input[i] = rand() % 256 - 128;
@@ -159,7 +164,7 @@ void esp_nn_max_pool_s8_test()
 
     bool ret = CHECK_EQUAL(output_c, output_opt, out_wd * out_ht * channels);
     if (ret == false) {
-        printf(ANSI_COLOR_RED"%s failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        printf(ANSI_COLOR_RED"%s failed [channels %d]\n"ANSI_COLOR_RESET, __FUNCTION__, channels);
         printf("Output: \n");
         PRINT_ARRAY_HEX(output_opt, out_wd * out_ht * channels, 1);
         printf("Expected: \n");
@@ -168,7 +173,7 @@ void esp_nn_max_pool_s8_test()
         PRINT_ARRAY_HEX(input, 8, size / 8);
         goto max_pool_s8_cleanup;
     }
-    printf(ANSI_COLOR_GREEN"%s passed\n"ANSI_COLOR_RESET, __FUNCTION__);
+    printf(ANSI_COLOR_GREEN"%s passed [channels %d]\n"ANSI_COLOR_RESET, __FUNCTION__, channels);
 
 max_pool_s8_cleanup:
     if (input_orig) {
@@ -181,3 +186,10 @@ max_pool_s8_cleanup:
         free(out_opt_orig);
     }
 }
+
+void esp_nn_max_pool_s8_test()
+{
+    /* a multiple of the vector width, and one with a left-over */
+    esp_nn_max_pool_s8_test_channels(16);
+    esp_nn_max_pool_s8_test_channels(36);
+}
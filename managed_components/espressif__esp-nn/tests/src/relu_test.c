@@ -26,9 +26,9 @@ void esp_nn_relu6_s8_test()
         printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
         goto relu6_s8_cleanup;
     }
-    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
-    inout_ansi = (int8_t *) (((uint32_t) inout_c_orig + 15) & ~15);
-    inout_opt = (int8_t *) (((uint32_t) inout_opt_orig + 15) & ~15);
+    input = (int8_t *) (((uintptr_t) input_orig + 15) & ~15);
+    inout_ansi = (int8_t *) (((uintptr_t) inout_c_orig + 15) & ~15);
+    inout_opt = (int8_t *) (((uintptr_t) inout_opt_orig + 15) & ~15);
 
     /* Generate filter data between -128 -> +127 */
     for (int i = 0; i < size; ++i) {
@@ -0,0 +1,207 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+
+#include <esp_cpu.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+namespace {
+
+// Runs of every implementation, the fastest counts.
+constexpr int kRepeats = 3;
+
+// The esp_nn.h kernels first, then the generic C ones every target builds.
+// Where esp_nn.h already picks the generic ones, they are tried twice.
+const ConvImpl kConvImpls[] = {
+    {"esp_nn", esp_nn_conv_s8, esp_nn_conv_u8_s8,
+     esp_nn_get_conv_scratch_size, esp_nn_set_conv_scratch_buf},
+    {"opt", esp_nn_conv_s8_opt, esp_nn_conv_u8_s8_opt,
+     esp_nn_get_conv_scratch_size_opt, esp_nn_set_conv_scratch_buf_opt},
+    {"ansi", esp_nn_conv_s8_ansi, esp_nn_conv_u8_s8_ansi,
+     esp_nn_get_conv_scratch_size_ansi, esp_nn_set_conv_scratch_buf_ansi},
+    {"gemm", esp_nn_conv_s8_gemm, esp_nn_conv_u8_s8_gemm,
+     esp_nn_get_conv_scratch_size_gemm, esp_nn_set_conv_scratch_buf_gemm},
+};
+
+const DepthwiseConvImpl kDepthwiseConvImpls[] = {
+    {"esp_nn", esp_nn_depthwise_conv_s8,
+     esp_nn_get_depthwise_conv_scratch_size,
+     esp_nn_set_depthwise_conv_scratch_buf},
+    {"opt", esp_nn_depthwise_conv_s8_opt,
+     esp_nn_get_depthwise_conv_scratch_size_opt,
+     esp_nn_set_depthwise_conv_scratch_buf_opt},
+    {"ansi", esp_nn_depthwise_conv_s8_ansi,
+     esp_nn_get_depthwise_conv_scratch_size_ansi,
+     esp_nn_set_depthwise_conv_scratch_buf_ansi},
+};
+
+bool autotune = false;
+const AutotuneCache* autotune_cache = nullptr;
+
+uint32_t Fnv1a(uint32_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// The cache key of a layer, which also covers the list of implementations
+// so that a firmware with other ones doesn't reuse stale choices.
+uint32_t Key(const char* op, const AutotuneShape& shape, int count,
+             const char* (*name)(int index)) {
+  const int32_t values[] = {
+      shape.input_dims.width,  shape.input_dims.height,
+      shape.input_dims.channels, shape.filter_dims.width,
+      shape.filter_dims.height, shape.output_dims.width,
+      shape.output_dims.height, shape.output_dims.channels,
+      shape.stride.width,      shape.stride.height,
+      shape.padding.width,     shape.padding.height,
+      shape.ch_mult,           shape.in_offset,
+      shape.out_offset,        shape.activation.min,
+      shape.activation.max,    shape.filter_size,
+      shape.bias_data != nullptr,
+  };
+  const size_t channel_bytes = shape.output_dims.channels * sizeof(int32_t);
+  uint32_t hash = Fnv1a(2166136261u, op, strlen(op) + 1);
+  hash = Fnv1a(hash, values, sizeof(values));
+  hash = Fnv1a(hash, shape.filter_data, shape.filter_size);
+  if (shape.bias_data != nullptr) {
+    hash = Fnv1a(hash, shape.bias_data, channel_bytes);
+  }
+  hash = Fnv1a(hash, shape.output_multiplier, channel_bytes);
+  hash = Fnv1a(hash, shape.output_shift, channel_bytes);
+  for (int i = 0; i < count; i++) {
+    hash = Fnv1a(hash, name(i), strlen(name(i)) + 1);
+  }
+  return hash;
+}
+
+}  // namespace
+
+void SetKernelAutotune(bool enabled) { autotune = enabled; }
+
+bool GetKernelAutotune() { return autotune; }
+
+void SetAutotuneCache(const AutotuneCache* cache) { autotune_cache = cache; }
+
+int ConvImplCount() {
+  return sizeof(kConvImpls) / sizeof(kConvImpls[0]);
+}
+
+const ConvImpl& GetConvImpl(int index) { return kConvImpls[index]; }
+
+int DepthwiseConvImplCount() {
+  return sizeof(kDepthwiseConvImpls) / sizeof(kDepthwiseConvImpls[0]);
+}
+
+const DepthwiseConvImpl& GetDepthwiseConvImpl(int index) {
+  return kDepthwiseConvImpls[index];
+}
+
+int AutotuneBandCount(const AutotuneShape& shape) {
+  return shape.output_dims.height > kAutotuneRows ? kAutotuneBands : 1;
+}
+
+AutotuneBand GetAutotuneBand(const AutotuneShape& shape, int band) {
+  AutotuneBand result;
+  result.output_dims = shape.output_dims;
+  result.output_dims.height =
+      std::min<int32_t>(shape.output_dims.height, kAutotuneRows);
+  const int32_t first_row =
+      band == 0 ? 0 : shape.output_dims.height - result.output_dims.height;
+  // Input rows of the band's first output row and one past its last.
+  const int32_t begin = first_row * shape.stride.height - shape.padding.height;
+  const int32_t end = begin +
+                      (result.output_dims.height - 1) * shape.stride.height +
+                      shape.filter_dims.height;
+  result.input_row = std::max<int32_t>(begin, 0);
+  result.padding_height = result.input_row - begin;
+  result.input_dims = shape.input_dims;
+  result.input_dims.height =
+      std::min<int32_t>(end, shape.input_dims.height) - result.input_row;
+  return result;
+}
+
+int Autotune(const char* op, const AutotuneShape& shape, int count,
+             const char* (*name)(int index), int8_t* buffer, int output_size,
+             void (*run)(int index, int band, int8_t* output, void* user),
+             void* user) {
+  char log[192];
+  int length = snprintf(log, sizeof(log), "autotune %s %dx%dx%d -> %dx%dx%d:",
+                        op, static_cast<int>(shape.input_dims.height),
+                        static_cast<int>(shape.input_dims.width),
+                        static_cast<int>(shape.input_dims.channels),
+                        static_cast<int>(shape.output_dims.height),
+                        static_cast<int>(shape.output_dims.width),
+                        static_cast<int>(shape.output_dims.channels));
+
+  const uint32_t key = Key(op, shape, count, name);
+  uint8_t cached;
+  if (autotune_cache != nullptr &&
+      autotune_cache->load(key, &cached, autotune_cache->user) &&
+      cached < count) {
+    MicroPrintf("%s %s (cached)", log, name(cached));
+    return cached;
+  }
+
+  // Implementation 0's output of every band, then the one compared.
+  const int bands = AutotuneBandCount(shape);
+  int8_t* output = buffer + bands * output_size;
+  int best = 0;
+  uint32_t best_cycles = UINT32_MAX;
+  for (int i = 0; i < count; i++) {
+    int8_t* out = i == 0 ? buffer : output;
+    uint32_t cycles = UINT32_MAX;
+    for (int repeat = 0; repeat < kRepeats; repeat++) {
+      const uint32_t start = esp_cpu_get_cycle_count();
+      run(i, 0, out, user);
+      const uint32_t elapsed = esp_cpu_get_cycle_count() - start;
+      cycles = elapsed < cycles ? elapsed : cycles;
+    }
+    bool same = i == 0 || memcmp(out, buffer, output_size) == 0;
+    for (int band = 1; band < bands && same; band++) {
+      int8_t* reference = buffer + band * output_size;
+      out = i == 0 ? reference : output;
+      run(i, band, out, user);
+      same = i == 0 || memcmp(out, reference, output_size) == 0;
+    }
+    if (length < static_cast<int>(sizeof(log))) {
+      length += same ? snprintf(log + length, sizeof(log) - length, " %s %lu",
+                                name(i), static_cast<unsigned long>(cycles))
+                     : snprintf(log + length, sizeof(log) - length,
+                                " %s differs", name(i));
+    }
+    if (same && cycles < best_cycles) {
+      best = i;
+      best_cycles = cycles;
+    }
+  }
+  if (autotune_cache != nullptr) {
+    autotune_cache->store(key, static_cast<uint8_t>(best),
+                          autotune_cache->user);
+  }
+  MicroPrintf("%s -> %s", log, name(best));
+  return best;
+}
+
+}  // namespace tflite
@@ -0,0 +1,160 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_AUTOTUNE_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_AUTOTUNE_H_
+
+#include <esp_nn.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tflite {
+
+// Kernel autotuning for the esp_nn int8 CONV_2D and DEPTHWISE_CONV_2D
+// kernels.
+//
+// esp_nn.h binds every kernel to one implementation per chip, which picks
+// its inner loop by fixed shape rules. With autotuning on, Prepare() instead
+// runs every implementation the chip has on a band of a few output rows of
+// the layer, with its real weights and quantization, and the node keeps the
+// fastest one. An implementation only qualifies if its output is the same as
+// the default one's on the top and the bottom band of the layer, which
+// between them cover every border; the rows in between are not compared.
+//
+// Tuning takes a few kernel runs per layer at AllocateTensors(). An
+// AutotuneCache, e.g. in NVS, remembers the choices so that the next boot
+// skips them. Its key covers the weights and quantization the outputs were
+// compared with, so a choice is never reused for other ones.
+struct AutotuneCache {
+  // Looks up the implementation stored for `key`, false if there is none.
+  bool (*load)(uint32_t key, uint8_t* choice, void* user);
+  void (*store)(uint32_t key, uint8_t choice, void* user);
+  void* user;
+};
+
+// Off by default. Only affects kernels prepared afterwards, so set it
+// before AllocateTensors().
+void SetKernelAutotune(bool enabled);
+bool GetKernelAutotune();
+
+// Installs `cache`, which must outlive every interpreter using it, or none
+// if nullptr.
+void SetAutotuneCache(const AutotuneCache* cache);
+
+// One implementation of esp_nn_conv_s8() and esp_nn_conv_u8_s8(), with the
+// scratch buffer functions that go with it.
+struct ConvImpl {
+  const char* name;
+  void (*conv_s8)(const data_dims_t* input_dims, const int8_t* input_data,
+                  const data_dims_t* filter_dims, const int8_t* filter_data,
+                  const int32_t* bias, const data_dims_t* output_dims,
+                  int8_t* out_data, const conv_params_t* conv_params,
+                  const quant_data_t* quant_data);
+  void (*conv_u8_s8)(const data_dims_t* input_dims, const uint8_t* input_data,
+                     const data_dims_t* filter_dims,
+                     const int8_t* filter_data, const int32_t* bias,
+                     const data_dims_t* output_dims, int8_t* out_data,
+                     const conv_params_t* conv_params,
+                     const quant_data_t* quant_data);
+  int (*get_scratch_size)(const data_dims_t* input_dims,
+                          const data_dims_t* filter_dims,
+                          const data_dims_t* output_dims,
+                          const conv_params_t* conv_params);
+  void (*set_scratch_buf)(const void* buf);
+};
+
+struct DepthwiseConvImpl {
+  const char* name;
+  void (*depthwise_conv_s8)(const data_dims_t* input_dims,
+                            const int8_t* input_data,
+                            const data_dims_t* filter_dims,
+                            const int8_t* filter_data, const int32_t* bias,
+                            const data_dims_t* output_dims, int8_t* out_data,
+                            const dw_conv_params_t* conv_params,
+                            const quant_data_t* quant_data);
+  int (*get_scratch_size)(const data_dims_t* input_dims,
+                          const data_dims_t* filter_dims,
+                          const data_dims_t* output_dims,
+                          const dw_conv_params_t* conv_params);
+  void (*set_scratch_buf)(const void* buf);
+};
+
+// The implementations, the default (the esp_nn.h one) first.
+int ConvImplCount();
+const ConvImpl& GetConvImpl(int index);
+int DepthwiseConvImplCount();
+const DepthwiseConvImpl& GetDepthwiseConvImpl(int index);
+
+// The layer a choice is made for: its dims and conv params, and the weights
+// and quantization its outputs are compared with. `filter_data` holds
+// `filter_size` bytes; `bias_data`, if not nullptr, and the per-channel
+// multipliers and shifts one value per output channel.
+struct AutotuneShape {
+  data_dims_t input_dims;
+  data_dims_t filter_dims;
+  data_dims_t output_dims;
+  data_2d_t stride;
+  data_2d_t padding;
+  int32_t ch_mult;
+  int32_t in_offset;
+  int32_t out_offset;
+  act_params_t activation;
+  const int8_t* filter_data;
+  int32_t filter_size;
+  const int32_t* bias_data;
+  const int32_t* output_multiplier;
+  const int32_t* output_shift;
+};
+
+// Output rows of a band.
+constexpr int kAutotuneRows = 4;
+
+// The bands compared: the top one, then the bottom one if the layer has
+// more than kAutotuneRows output rows.
+constexpr int kAutotuneBands = 2;
+
+// Band `band` of the layer `shape` describes, a conv of its own over the
+// input rows from `input_row` on, with `padding_height` rows of padding
+// above them.
+struct AutotuneBand {
+  data_dims_t input_dims;
+  data_dims_t output_dims;
+  int32_t input_row;
+  int32_t padding_height;
+};
+
+int AutotuneBandCount(const AutotuneShape& shape);
+AutotuneBand GetAutotuneBand(const AutotuneShape& shape, int band);
+
+// Runs `run(index, band, output)` for implementation `index` of `count` on
+// every band of the layer `shape` describes, each of which writes
+// `output_size` bytes, and returns the fastest implementation on band 0
+// whose outputs match implementation 0's, or the cached one. `buffer` holds
+// (kAutotuneBands + 1) * output_size bytes. `op` names the operator in the
+// cache key and the log.
+int Autotune(const char* op, const AutotuneShape& shape, int count,
+             const char* (*name)(int index), int8_t* buffer, int output_size,
+             void (*run)(int index, int band, int8_t* output, void* user),
+             void* user);
+
+// What tuning can add to the tensor arena: the scratch buffer of the
+// largest candidate, an im2col tile of esp_nn_conv_s8_gemm() with its bias.
+// Arena sizes measured without tuning need this much more.
+constexpr size_t kAutotuneArenaHeadroom = ESP_NN_GEMM_TILE_BYTES + 4096;
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_AUTOTUNE_H_
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/kernels/conv.h"
 
+#include <cstring>
+
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/kernels/internal/portable_tensor_utils.h"
 #include "tensorflow/lite/kernels/internal/reference/conv.h"
@@ -24,14 +26,21 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
 
-#include <esp_timer.h>
-
 #if ESP_NN
 #include <esp_nn.h>
-#endif
 
+#include <algorithm>
 
-long long conv_total_time = 0;
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/folded_bias.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/fusion.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/weight_stream.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/winograd.h"
+#include "tensorflow/lite/micro/kernels/pooling.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#endif
 
 namespace tflite {
 namespace {
@@ -39,15 +48,156 @@ namespace {
 struct NodeData {
   OpDataConv op_data;
 #if ESP_NN
+  // Workers the output rows are split across (see parallel.h), each with
+  // the scratch buffer `scratch_stride` bytes after the previous one's.
+  int workers;
   int buffer_idx;
+  int scratch_stride;
+  // GetConvImpl() index, 0 unless autotuned (see autotune.h).
+  int conv_impl;
+  // Arena copy of the filter, -1 to read it in place (see weight_stream.h).
+  int weight_tile_idx;
+  // Bias with the input offset folded in (see folded_bias.h), or null when
+  // the conv has padding and keeps its input offset.
+  int32_t* folded_bias;
+  // Winograd transformed filter (see winograd.h), or null.
+  int16_t* winograd_filter;
+  // Fused MAX_POOL_2D (see fusion.h): its op data and the scratch buffer
+  // for the conv rows under one pooling window, one per worker.
+  OpDataPooling pool;
+  int band_buffer_idx;
+  int band_stride;
+  // A stage of a row band stack (see fusion.h): runs on one worker and
+  // requests no scratch or band buffer, the stack has one for all stages.
+  bool row_band;
 #endif
 };
 
 static void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context, sizeof(OpDataConv));
+  void* data = context->AllocatePersistentBuffer(context, sizeof(NodeData));
+  if (data != nullptr) {
+    memset(data, 0, sizeof(NodeData));
+  }
+  return data;
 }
 
+#if ESP_NN
+// A layer's top and bottom output rows, what AutotuneConv() runs every
+// implementation on (see autotune.h).
+struct ConvBands {
+  AutotuneBand bands[kAutotuneBands];
+  data_dims_t filter_dims;
+  conv_params_t conv_params;
+  quant_data_t quant_data;
+  const int8_t* input_data;
+  const int8_t* filter_data;
+  const int32_t* bias_data;
+  void* scratch_buf;
+};
+
+void RunConvBand(int index, int band, int8_t* output, void* user) {
+  const ConvBands& bands = *static_cast<const ConvBands*>(user);
+  const AutotuneBand& rows = bands.bands[band];
+  conv_params_t conv_params = bands.conv_params;
+  conv_params.padding.height = rows.padding_height;
+  const ConvImpl& impl = GetConvImpl(index);
+  impl.set_scratch_buf(bands.scratch_buf);
+  impl.conv_s8(&rows.input_dims, bands.input_data, &bands.filter_dims,
+               bands.filter_data, bands.bias_data, &rows.output_dims, output,
+               &conv_params, &bands.quant_data);
+}
+
+const char* ConvImplName(int index) { return GetConvImpl(index).name; }
+
+// Sets data->conv_impl to the fastest implementation for the int8 layer
+// (see autotune.h), or leaves the default one if the arena has no room for
+// the bands. A uint8 input folded in later (see FoldInputQuantize) runs the
+// uint8 kernel of the same implementation.
+TfLiteStatus AutotuneConv(TfLiteContext* context,
+                          const data_dims_t& input_dims,
+                          const data_dims_t& filter_dims,
+                          const data_dims_t& output_dims,
+                          const conv_params_t& conv_params,
+                          const int8_t* filter_data, const int32_t* bias_data,
+                          NodeData* data) {
+  AutotuneShape shape;
+  shape.input_dims = input_dims;
+  shape.filter_dims = filter_dims;
+  shape.output_dims = output_dims;
+  shape.stride = conv_params.stride;
+  shape.padding = conv_params.padding;
+  shape.ch_mult = 1;
+  shape.in_offset = conv_params.in_offset;
+  shape.out_offset = conv_params.out_offset;
+  shape.activation = conv_params.activation;
+  shape.filter_data = filter_data;
+  shape.filter_size = output_dims.channels * filter_dims.width *
+                      filter_dims.height * input_dims.channels;
+  shape.bias_data = bias_data;
+  shape.output_multiplier = data->op_data.per_channel_output_multiplier;
+  shape.output_shift = data->op_data.per_channel_output_shift;
+
+  ConvBands bands;
+  bands.filter_dims = filter_dims;
+  bands.conv_params = conv_params;
+  bands.quant_data = {.shift = data->op_data.per_channel_output_shift,
+                      .mult = data->op_data.per_channel_output_multiplier};
+  bands.filter_data = filter_data;
+  bands.bias_data = bias_data;
+
+  // Every band reads its input rows from the same buffer.
+  int scratch_size = 0;
+  int input_size = 0;
+  for (int band = 0; band < AutotuneBandCount(shape); band++) {
+    AutotuneBand& rows = bands.bands[band];
+    rows = GetAutotuneBand(shape, band);
+    conv_params_t band_params = conv_params;
+    band_params.padding.height = rows.padding_height;
+    for (int i = 0; i < ConvImplCount(); i++) {
+      scratch_size = std::max(scratch_size, GetConvImpl(i).get_scratch_size(
+          &rows.input_dims, &filter_dims, &rows.output_dims, &band_params));
+    }
+    input_size = std::max<int>(input_size, rows.input_dims.width *
+                                               rows.input_dims.height *
+                                               rows.input_dims.channels);
+  }
+  const data_dims_t& band_output = bands.bands[0].output_dims;
+  const int output_size =
+      band_output.width * band_output.height * band_output.channels;
+  const int alignment = MicroArenaBufferAlignment();
+  const int input_bytes = (input_size + alignment - 1) / alignment * alignment;
+  const int outputs_bytes =
+      ((kAutotuneBands + 1) * output_size + alignment - 1) / alignment *
+      alignment;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  uint8_t* buffer = micro_context->AllocateTempBuffer(
+      input_bytes + outputs_bytes + scratch_size, alignment);
+  if (buffer == nullptr) {
+    MicroPrintf("autotune CONV_2D: no arena left for the bands, not tuned");
+    return kTfLiteOk;
+  }
+  // Any input will do, the time doesn't depend on it.
+  int8_t* input = reinterpret_cast<int8_t*>(buffer);
+  uint32_t state = 1;
+  for (int i = 0; i < input_size; i++) {
+    state = state * 1664525u + 1013904223u;
+    input[i] = static_cast<int8_t>(state >> 24);
+  }
+  bands.input_data = input;
+  bands.scratch_buf =
+      scratch_size > 0 ? buffer + input_bytes + outputs_bytes : nullptr;
+
+  data->conv_impl = Autotune(
+      "CONV_2D", shape, ConvImplCount(), ConvImplName,
+      reinterpret_cast<int8_t*>(buffer + input_bytes), output_size,
+      RunConvBand, &bands);
+  micro_context->DeallocateTempBuffer(buffer);
+  return kTfLiteOk;
+}
+#endif
+
 static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   TFLITE_DCHECK(node->builtin_data != nullptr);
@@ -120,7 +270,16 @@ static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
       context, node, params, input_width, input_height, filter_width,
       filter_height, output_width, output_height, input->type, &data->op_data));
 
-  if (filter->type == kTfLiteInt4) {
+#if ESP_NN
+  // esp-nn reads int4 filters packed (esp_nn_conv_s8_s4()); only dilated
+  // convs, left to the reference kernel, unpack them first.
+  const bool unpack_int4 = filter->type == kTfLiteInt4 &&
+                           (params.dilation_width_factor != 1 ||
+                            params.dilation_height_factor != 1);
+#else
+  const bool unpack_int4 = filter->type == kTfLiteInt4;
+#endif
+  if (unpack_int4) {
     int filter_size =
         RuntimeShape(filter->dims->size,
                      reinterpret_cast<const int32_t*>(filter->dims->data))
@@ -147,11 +306,119 @@ static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                   .dilation = {0, 0}, .activation = {-128, 127}
                                 };
 
-    int scratch_buf_size = esp_nn_get_conv_scratch_size(
-        &input_dims, &filter_dims, &output_dims, &conv_params);
-    if (scratch_buf_size > 0) {
+    // The offset is still unfolded here, which only makes the overflow
+    // check stricter.
+    data->winograd_filter = nullptr;
+    conv_params_t winograd_params = conv_params;
+    winograd_params.in_offset = -data->op_data.input_zero_point;
+    if (GetConvWinograd() && filter->type == kTfLiteInt8 &&
+        input_channels == filter_input_channels &&
+        params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 &&
+        data->op_data.padding.width_offset == 0 &&
+        data->op_data.padding.height_offset == 0 &&
+        esp_nn_conv_winograd_supported(&input_dims, &filter_dims,
+                                       &winograd_params)) {
+      data->winograd_filter = static_cast<int16_t*>(
+          context->AllocatePersistentBuffer(
+              context, esp_nn_get_conv_winograd_filter_size(&input_dims,
+                                                            &output_dims)));
+      TF_LITE_ENSURE(context, data->winograd_filter != nullptr);
+      esp_nn_conv_winograd_filter_s8(GetTensorData<int8_t>(filter),
+                                     input_channels, num_channels,
+                                     data->winograd_filter);
+    }
+
+    // The filter is read once per output pixel; copy it to the arena first
+    // when it fits in the two weight tiles.
+    const size_t filter_bytes = NumElements(filter);
+    data->weight_tile_idx = -1;
+    if (GetWeightTileSize() > 0 && data->winograd_filter == nullptr &&
+        filter->type == kTfLiteInt8 &&
+        params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 &&
+        filter_bytes <= 2 * GetWeightTileSize()) {
       TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
-        context, scratch_buf_size, &data->buffer_idx));
+        context, filter_bytes, &data->weight_tile_idx));
+    }
+
+    data->folded_bias = nullptr;
+    if (filter->type == kTfLiteInt8 && params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 &&
+        data->op_data.padding.width == 0 &&
+        data->op_data.padding.height == 0 &&
+        data->op_data.padding.width_offset == 0 &&
+        data->op_data.padding.height_offset == 0) {
+      TfLiteTensor* bias =
+          micro_context->AllocateTempInputTensor(node, kConvBiasTensor);
+      data->folded_bias = static_cast<int32_t*>(
+          context->AllocatePersistentBuffer(context,
+                                            num_channels * sizeof(int32_t)));
+      TF_LITE_ENSURE(context, data->folded_bias != nullptr);
+      FoldInputOffset(GetTensorData<int8_t>(filter),
+                      bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr,
+                      -data->op_data.input_zero_point, num_channels,
+                      filter_bytes / num_channels, data->folded_bias);
+      if (bias != nullptr) {
+        micro_context->DeallocateTempTfLiteTensor(bias);
+      }
+    }
+
+    data->conv_impl = 0;
+    if (GetKernelAutotune() && data->winograd_filter == nullptr &&
+        filter->type == kTfLiteInt8 &&
+        params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1) {
+      TfLiteTensor* bias =
+          micro_context->AllocateTempInputTensor(node, kConvBiasTensor);
+      conv_params_t tuned_params = conv_params;
+      tuned_params.in_offset = data->folded_bias != nullptr
+                                   ? 0
+                                   : -data->op_data.input_zero_point;
+      tuned_params.out_offset = data->op_data.output_zero_point;
+      tuned_params.activation = {data->op_data.output_activation_min,
+                                 data->op_data.output_activation_max};
+      const TfLiteStatus status = AutotuneConv(
+          context, input_dims, filter_dims, output_dims, tuned_params,
+          GetTensorData<int8_t>(filter),
+          data->folded_bias != nullptr
+              ? data->folded_bias
+              : (bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr),
+          data);
+      if (bias != nullptr) {
+        micro_context->DeallocateTempTfLiteTensor(bias);
+      }
+      TF_LITE_ENSURE_STATUS(status);
+    }
+
+    // esp_nn_conv_s8_s4() needs none.
+    int scratch_buf_size = 0;
+    if (data->winograd_filter != nullptr) {
+      scratch_buf_size = esp_nn_get_conv_scratch_size_winograd(
+          &input_dims, &filter_dims, &output_dims, &conv_params);
+    } else if (filter->type == kTfLiteInt8) {
+      scratch_buf_size = GetConvImpl(data->conv_impl).get_scratch_size(
+          &input_dims, &filter_dims, &output_dims, &conv_params);
+    }
+
+    // A band of output rows is a conv of its own over the input rows from
+    // the band's first on, as long as no padding goes above them.
+    data->workers = 1;
+    if (!data->row_band && params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 &&
+        data->op_data.padding.height == 0) {
+      data->workers = ParallelWorkers(
+          static_cast<int64_t>(output_height) * output_width *
+              num_channels * filter_height * filter_width *
+              filter_input_channels,
+          output_height);
+    }
+    const int alignment = MicroArenaBufferAlignment();
+    data->scratch_stride =
+        (scratch_buf_size + alignment - 1) / alignment * alignment;
+    if (scratch_buf_size > 0 && !data->row_band) {
+      TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, data->workers * data->scratch_stride, &data->buffer_idx));
     } else {
       data->buffer_idx = -1;
     }
@@ -166,7 +433,182 @@ static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 }
 
 #if ESP_NN
+// esp-nn arguments of a dilation-free conv, with the scratch buffer and the
+// arena copy of the filter (see weight_stream.h) set up.
+struct ConvArgs {
+  const ConvImpl* impl;
+  data_dims_t input_dims;
+  data_dims_t filter_dims;
+  data_dims_t output_dims;
+  conv_params_t conv_params;
+  quant_data_t quant_data;
+  const int8_t *filter_data;
+  const int32_t *bias_data;
+  // Set to run esp_nn_conv_s8_winograd() instead of impl.
+  const int16_t *winograd_filter;
+  // filter_data is packed int4, for esp_nn_conv_s8_s4().
+  bool int4_filter;
+  // The first worker's scratch buffer, or null.
+  int8_t *scratch_buf;
+  int scratch_stride;
+};
+
+// Sets the scratch buffer of worker `worker` for the kernels the calling
+// thread runs; esp-nn keeps one per thread.
+inline void SetConvScratch(const ConvArgs& args, int worker) {
+  void *scratch_buf = args.scratch_buf != nullptr
+                          ? args.scratch_buf + worker * args.scratch_stride
+                          : nullptr;
+  if (args.winograd_filter != nullptr) {
+    esp_nn_set_conv_scratch_buf_winograd(scratch_buf);
+  } else {
+    args.impl->set_scratch_buf(scratch_buf);
+  }
+}
+
+// Runs the conv of `args` over `input_dims`/`output_dims`, which may be a
+// band of the layer's.
+inline void ConvKernel(const ConvArgs& args, const data_dims_t *input_dims,
+                       const int8_t *input_data,
+                       const data_dims_t *output_dims, int8_t *output_data) {
+  if (args.int4_filter) {
+    esp_nn_conv_s8_s4(input_dims, input_data, &args.filter_dims,
+                      args.filter_data, args.bias_data, output_dims,
+                      output_data, &args.conv_params, &args.quant_data);
+    return;
+  }
+  if (args.winograd_filter != nullptr) {
+    esp_nn_conv_s8_winograd(input_dims, input_data, args.winograd_filter,
+                            args.bias_data, output_dims, output_data,
+                            &args.conv_params, &args.quant_data);
+    return;
+  }
+  args.impl->conv_s8(input_dims, input_data, &args.filter_dims,
+                     args.filter_data, args.bias_data, output_dims,
+                     output_data, &args.conv_params, &args.quant_data);
+}
+
+// uint8 input is the raw model input aliased by a folded QUANTIZE node (see
+// MicroInterpreterGraph::FoldInputQuantize), the -128 shift goes into
+// in_offset.
+inline void ConvKernel(const ConvArgs& args, const data_dims_t *input_dims,
+                       const uint8_t *input_data,
+                       const data_dims_t *output_dims, int8_t *output_data) {
+  conv_params_t params_u8 = args.conv_params;
+  params_u8.in_offset -= 128;
+  if (args.winograd_filter != nullptr) {
+    esp_nn_conv_u8_s8_winograd(input_dims, input_data, args.winograd_filter,
+                               args.bias_data, output_dims, output_data,
+                               &params_u8, &args.quant_data);
+    return;
+  }
+  args.impl->conv_u8_s8(input_dims, input_data, &args.filter_dims,
+                        args.filter_data, args.bias_data, output_dims,
+                        output_data, &params_u8, &args.quant_data);
+}
+
+inline void PrepareConvArgs(TfLiteContext* context,
+                            const TfLiteConvParams& params,
+                            const NodeData& data,
+                            const RuntimeShape& input_shape,
+                            const TfLiteEvalTensor* filter,
+                            const TfLiteEvalTensor* bias,
+                            const RuntimeShape& output_shape, ConvArgs* args) {
+  RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
+  RuntimeShape bias_shape = tflite::micro::GetTensorShape(bias);
+
+  // A folded bias already holds the input offset's share of every output.
+  const int32_t input_offset =
+      data.folded_bias != nullptr ? 0 : -data.op_data.input_zero_point;
+  const int32_t output_offset = data.op_data.output_zero_point;
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int pad_width = data.op_data.padding.width;
+  const int pad_height = data.op_data.padding.height;
+
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+
+  // Set min and max value of the output.
+  const int32_t activation_min = data.op_data.output_activation_min;
+  const int32_t activation_max = data.op_data.output_activation_max;
+
+  // Consistency check.
+  TFLITE_DCHECK_LE(activation_min, activation_max);
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
+  const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
+
+  if (tflite::micro::GetTensorData<int8_t>(bias)) {
+    TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
+  }
+
+  args->scratch_buf = nullptr;
+  if (data.buffer_idx > -1) {
+    args->scratch_buf = static_cast<int8_t*>(
+        context->GetScratchBuffer(context, data.buffer_idx));
+  }
+  args->scratch_stride = data.scratch_stride;
+  args->impl = &GetConvImpl(data.conv_impl);
+  args->winograd_filter = data.winograd_filter;
+  args->int4_filter = filter->type == kTfLiteInt4;
+
+  const int8_t *filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+  const WeightMemory& memory = GetWeightMemory();
+  if (data.weight_tile_idx > -1) {
+    int8_t *filter_copy = static_cast<int8_t*>(
+        context->GetScratchBuffer(context, data.weight_tile_idx));
+    memory.copy_start(filter_copy, filter_data, filter_shape.FlatSize(),
+                      memory.user);
+    memory.copy_wait(memory.user);
+    filter_data = filter_copy;
+  } else if (memory.read_in_place != nullptr &&
+             data.winograd_filter == nullptr) {
+    // A Winograd layer reads its transformed filter from the arena instead,
+    // an int4 one half a byte per value.
+    memory.read_in_place(filter_data,
+                         filter->type == kTfLiteInt4
+                             ? (filter_shape.FlatSize() + 1) / 2
+                             : filter_shape.FlatSize(),
+                         memory.user);
+  }
+
+  args->input_dims =  {
+                        .width = input_width, .height = input_height,
+                        .channels = input_depth, 1
+                      };
+  args->output_dims = {
+                        .width = output_width, .height = output_height,
+                        .channels = output_depth, 1
+                      };
+  args->filter_dims = {.width = filter_width, .height = filter_height, 0, 0};
+  args->conv_params = {
+                        .in_offset = input_offset, .out_offset = output_offset,
+                        .stride = {stride_width, stride_height},
+                        .padding = {pad_width, pad_height},
+                        .dilation = {0, 0},
+                        .activation = {activation_min, activation_max}
+                      };
+  args->quant_data = {
+                       .shift = data.op_data.per_channel_output_shift,
+                       .mult = data.op_data.per_channel_output_multiplier
+                     };
+  args->filter_data = filter_data;
+  args->bias_data = data.folded_bias != nullptr
+                        ? data.folded_bias
+                        : tflite::micro::GetTensorData<int32_t>(bias);
+}
+
 // Fixed-point per-channel-quantization convolution Int8 function wrapper.
+// InputT is int8_t, or uint8_t for a folded input quantize (dilation 1 only).
+// An int4 filter must have dilation 1 too.
+template <typename InputT>
 inline void EvalQuantizedPerChannel(
     TfLiteContext* context, TfLiteNode* node, const TfLiteConvParams& params,
     const NodeData& data, const TfLiteEvalTensor* input,
@@ -176,82 +618,35 @@ inline void EvalQuantizedPerChannel(
   const int dilation_height_factor = params.dilation_height_factor;
 
   if (dilation_width_factor == 1 && dilation_height_factor == 1) {
-    // Get parameters.
-    RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
     RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
     RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
-    RuntimeShape bias_shape = tflite::micro::GetTensorShape(bias);
+    ConvArgs args;
+    PrepareConvArgs(context, params, data, input_shape, filter, bias,
+                    output_shape, &args);
 
-    const int8_t *input_data = tflite::micro::GetTensorData<int8_t>(input);
+    const InputT *input_data = tflite::micro::GetTensorData<InputT>(input);
     int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
-
-    const int32_t input_offset = -data.op_data.input_zero_point;
-    const int32_t output_offset = data.op_data.output_zero_point;
-    const int stride_width = params.stride_width;
-    const int stride_height = params.stride_height;
-    const int pad_width = data.op_data.padding.width;
-    const int pad_height = data.op_data.padding.height;
-
-    const int input_height = input_shape.Dims(1);
-    const int input_width = input_shape.Dims(2);
-    const int filter_height = filter_shape.Dims(1);
-    const int filter_width = filter_shape.Dims(2);
-    const int output_height = output_shape.Dims(1);
-    const int output_width = output_shape.Dims(2);
-
-    // Set min and max value of the output.
-    const int32_t activation_min = data.op_data.output_activation_min;
-    const int32_t activation_max = data.op_data.output_activation_max;
-
-    // Consistency check.
-    TFLITE_DCHECK_LE(activation_min, activation_max);
-    TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
-    TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
-    TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
     const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
-    const int input_depth = MatchingDim(input_shape, 3, filter_shape, 3);
-    const int output_depth = MatchingDim(filter_shape, 0, output_shape, 3);
-
-    if (tflite::micro::GetTensorData<int8_t>(bias)) {
-      TFLITE_DCHECK_EQ(bias_shape.FlatSize(), output_depth);
-    }
-
-    void *scratch_buf = NULL;
-    if (data.buffer_idx > -1) {
-      scratch_buf = context->GetScratchBuffer(context, data.buffer_idx);
-    }
-    esp_nn_set_conv_scratch_buf(scratch_buf);
-
-    const int input_size = input_width * input_height * input_depth;
-    const int output_size = output_width * output_height * output_depth;
-
-    data_dims_t input_dims =  {
-                                .width = input_width, .height = input_height,
-                                .channels = input_depth, 1
-                              };
-    data_dims_t output_dims = {
-                                .width = output_width, .height = output_height,
-                                .channels = output_depth, 1
-                              };
-    data_dims_t filter_dims = {.width = filter_width, .height = filter_height, 0, 0};
-    conv_params_t conv_params = {
-                                  .in_offset = input_offset, .out_offset = output_offset,
-                                  .stride = {stride_width, stride_height},
-                                  .padding = {pad_width, pad_height},
-                                  .dilation = {0, 0},
-                                  .activation = {activation_min, activation_max}
-                                };
-    quant_data_t quant_data = {
-                                .shift = data.op_data.per_channel_output_shift,
-                                .mult = data.op_data.per_channel_output_multiplier
-                              };
+    const int input_size = input_shape.FlatSize() / batch_size;
+    const int output_size = output_shape.FlatSize() / batch_size;
+    const int input_row_size = args.input_dims.width * args.input_dims.channels;
+    const int output_row_size =
+        args.output_dims.width * args.output_dims.channels;
 
     for (int i_batch = 0; i_batch < batch_size; i_batch++) {
-      esp_nn_conv_s8(&input_dims, input_data + i_batch * input_size,
-                     &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
-                     tflite::micro::GetTensorData<int32_t>(bias),
-                     &output_dims, output_data + i_batch * output_size,
-                     &conv_params, &quant_data);
+      const InputT *batch_input = input_data + i_batch * input_size;
+      int8_t *batch_output = output_data + i_batch * output_size;
+      auto conv_rows = [&](int worker, int begin, int end) {
+        SetConvScratch(args, worker);
+        const int input_y = begin * params.stride_height;
+        data_dims_t input_dims = args.input_dims;
+        input_dims.height -= input_y;
+        data_dims_t output_dims = args.output_dims;
+        output_dims.height = end - begin;
+        ConvKernel(args, &input_dims, batch_input + input_y * input_row_size,
+                   &output_dims, batch_output + begin * output_row_size);
+      };
+      ParallelFor(data.workers, args.output_dims.height, conv_rows);
     }
   } else {
     reference_integer_ops::ConvPerChannel(
@@ -268,6 +663,103 @@ inline void EvalQuantizedPerChannel(
         tflite::micro::GetTensorData<int8_t>(output));
   }
 }
+
+// Computes output row `out_y` of a conv fused with a MAX_POOL_2D into
+// `output_row`: the conv rows under its pooling window into `band`, from
+// the input rows they need, then the pool of those. `input` is input row
+// `input_y` on, of which there are `input_height`; the conv has no vertical
+// padding, so a band is a conv of its own over a slice of the input rows.
+template <typename InputT>
+inline void ConvMaxPoolRow(const ConvArgs& args,
+                           const FusedConvMaxPoolParams& params,
+                           const NodeData& data, const InputT *input,
+                           int input_y, int input_height, int output_width,
+                           int out_y, int8_t *band, int8_t *output_row) {
+  const TfLitePoolParams& pool = params.pool;
+  const int conv_height = args.output_dims.height;
+  const int conv_width = args.output_dims.width;
+  const int depth = args.output_dims.channels;
+  const int window_y = out_y * pool.stride_height - data.pool.padding.height;
+  const int first_row = std::max(window_y, 0);
+  const int rows =
+      std::min(window_y + pool.filter_height, conv_height) - first_row;
+  if (rows <= 0) {
+    return;
+  }
+
+  const int skip = first_row * params.conv.stride_height - input_y;
+  data_dims_t input_dims = args.input_dims;
+  input_dims.height = input_height - skip;
+  data_dims_t band_dims = args.output_dims;
+  band_dims.height = rows;
+  ConvKernel(args, &input_dims,
+             input + skip * input_dims.width * input_dims.channels,
+             &band_dims, band);
+
+  if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
+    esp_nn_max_pool_s8(band, conv_width, rows, output_row, output_width, 1,
+                       pool.stride_width, pool.stride_height,
+                       pool.filter_width, pool.filter_height,
+                       data.pool.padding.width, first_row - window_y,
+                       data.pool.activation_min, data.pool.activation_max,
+                       depth);
+  } else {
+    esp_nn_max_pool_s8_ansi(band, conv_width, rows, output_row, output_width,
+                            1, pool.stride_width, pool.stride_height,
+                            pool.filter_width, pool.filter_height,
+                            data.pool.padding.width, first_row - window_y,
+                            data.pool.activation_min,
+                            data.pool.activation_max, depth);
+  }
+}
+
+// Conv fused with the MAX_POOL_2D after it (see fusion.h), one
+// ConvMaxPoolRow() per output row, so the conv's output never exists as a
+// whole. Every worker computes a part of the output rows, in a band buffer
+// of its own.
+template <typename InputT>
+inline void EvalConvMaxPool(TfLiteContext* context,
+                            const FusedConvMaxPoolParams& params,
+                            const NodeData& data, const TfLiteEvalTensor* input,
+                            const TfLiteEvalTensor* filter,
+                            const TfLiteEvalTensor* bias,
+                            const TfLiteEvalTensor* conv_output,
+                            TfLiteEvalTensor* output) {
+  RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+  RuntimeShape conv_shape = tflite::micro::GetTensorShape(conv_output);
+  RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+  ConvArgs args;
+  PrepareConvArgs(context, params.conv, data, input_shape, filter, bias,
+                  conv_shape, &args);
+
+  const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
+  const int depth = MatchingDim(conv_shape, 3, output_shape, 3);
+  const int input_size = input_shape.FlatSize() / batch_size;
+  const int output_size = output_shape.FlatSize() / batch_size;
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_row_size = output_width * depth;
+
+  int8_t *bands = static_cast<int8_t*>(
+      context->GetScratchBuffer(context, data.band_buffer_idx));
+
+  const InputT *input_data = tflite::micro::GetTensorData<InputT>(input);
+  int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
+  for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+    const InputT *batch_input = input_data + i_batch * input_size;
+    int8_t *batch_output = output_data + i_batch * output_size;
+    auto pool_rows = [&](int worker, int begin, int end) {
+      SetConvScratch(args, worker);
+      int8_t *band = bands + worker * data.band_stride;
+      for (int out_y = begin; out_y < end; out_y++) {
+        ConvMaxPoolRow(args, params, data, batch_input, 0,
+                       args.input_dims.height, output_width, out_y, band,
+                       batch_output + out_y * output_row_size);
+      }
+    };
+    ParallelFor(data.workers, output_height, pool_rows);
+  }
+}
 #endif
 
 static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
@@ -288,7 +780,6 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   const auto& data = *(static_cast<const NodeData*>(node->user_data));
 
-  long long start_time = esp_timer_get_time();
   switch (input->type) {  // Already know in/out types are same.
     case kTfLiteFloat32: {
       tflite::reference_ops::Conv(
@@ -341,6 +832,14 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt8: {
       switch (filter->type) {
         case kTfLiteInt4: {
+#if ESP_NN
+          if (params.dilation_width_factor == 1 &&
+              params.dilation_height_factor == 1) {
+            EvalQuantizedPerChannel<int8_t>(context, node, params, data,
+                                            input, filter, bias, output);
+            break;
+          }
+#endif
           int8_t* unpacked_filter_data = static_cast<int8_t*>(
               context->GetScratchBuffer(context, data.op_data.filter_buffer_index));
           tflite::tensor_utils::UnpackDenseInt4IntoInt8(
@@ -362,8 +861,8 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
         }
         case kTfLiteInt8: {
 #if ESP_NN
-          EvalQuantizedPerChannel(context, node, params, data, input, filter,
-                                  bias, output);
+          EvalQuantizedPerChannel<int8_t>(context, node, params, data, input,
+                                          filter, bias, output);
 #else
           reference_integer_ops::ConvPerChannel(
               ConvParamsQuantized(params, data.op_data),
@@ -387,16 +886,332 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       }
       break;
     }
+#if ESP_NN
+    case kTfLiteUInt8: {
+      TF_LITE_ENSURE_TYPES_EQ(context, filter->type, kTfLiteInt8);
+      TF_LITE_ENSURE(context, params.dilation_width_factor == 1 &&
+                                  params.dilation_height_factor == 1);
+      EvalQuantizedPerChannel<uint8_t>(context, node, params, data, input,
+                                       filter, bias, output);
+      break;
+    }
+#endif
+    default:
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+#if ESP_NN
+TfLiteStatus ConvMaxPoolPrepare(TfLiteContext* context, TfLiteNode* node) {
+  // Prepare the conv on its own output, the node's intermediate.
+  TfLiteIntArray* outputs = node->outputs;
+  node->outputs = node->intermediates;
+  const TfLiteStatus conv_status = Prepare(context, node);
+  node->outputs = outputs;
+  TF_LITE_ENSURE_STATUS(conv_status);
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  const auto& params =
+      *(static_cast<const FusedConvMaxPoolParams*>(node->builtin_data));
+  TF_LITE_ENSURE_EQ(context, data->op_data.padding.height, 0);
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* conv_output =
+      micro_context->AllocateTempIntermediateTensor(node, 0);
+  TF_LITE_ENSURE(context, conv_output != nullptr);
+  TfLiteTensor* output = micro_context->AllocateTempOutputTensor(node, 0);
+  TF_LITE_ENSURE(context, output != nullptr);
+  TF_LITE_ENSURE_TYPES_EQ(context, conv_output->type, kTfLiteInt8);
+  TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt8);
+
+  TF_LITE_ENSURE_STATUS(CalculateOpDataPooling(
+      context, &params.pool, conv_output, output, &data->pool));
+  TF_LITE_ENSURE_STATUS(CalculateActivationRangeQuantized(
+      context, params.pool.activation, output, &data->pool.activation_min,
+      &data->pool.activation_max));
+  const int band_size = params.pool.filter_height *
+                        conv_output->dims->data[2] *
+                        conv_output->dims->data[3];
+  // Prepare() split the conv rows; the pool rows are split instead, fewer.
+  data->workers = std::min(data->workers, output->dims->data[1]);
+  const int alignment = MicroArenaBufferAlignment();
+  data->band_stride = (band_size + alignment - 1) / alignment * alignment;
+  if (!data->row_band) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, data->workers * data->band_stride, &data->band_buffer_idx));
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(conv_output);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus ConvMaxPoolEval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kConvInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 3)
+          ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
+          : nullptr;
+  const TfLiteEvalTensor* conv_output =
+      context->GetEvalTensor(context, node->intermediates->data[0]);
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+
+  const auto& params =
+      *(static_cast<const FusedConvMaxPoolParams*>(node->builtin_data));
+  const auto& data = *(static_cast<const NodeData*>(node->user_data));
+
+  switch (input->type) {
+    case kTfLiteInt8:
+      EvalConvMaxPool<int8_t>(context, params, data, input, filter, bias,
+                              conv_output, output);
+      break;
+    case kTfLiteUInt8:
+      EvalConvMaxPool<uint8_t>(context, params, data, input, filter, bias,
+                               conv_output, output);
+      break;
+    default:
+      MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
+                  input->type);
+      return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+int row_band_stages = 0;
+
+struct RowBandData {
+  // The buffers all stages share: esp-nn scratch (-1 if no stage has one),
+  // conv rows under one pooling window, and the input windows.
+  int scratch_buffer_idx;
+  int band_buffer_idx;
+  int window_buffer_idx;
+  // Where in the window buffer the input window of every stage but the
+  // first, which reads its input in place, is, and how many rows it holds.
+  int window_offset[kMaxRowBandStages];
+  int window_rows[kMaxRowBandStages];
+};
+
+void* RowBandInit(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(RowBandData));
+}
+
+TfLiteStatus RowBandPrepare(TfLiteContext* context, TfLiteNode* node) {
+  auto& params = *(static_cast<RowBandParams*>(node->builtin_data));
+  RowBandData* data = static_cast<RowBandData*>(node->user_data);
+  MicroContext* micro_context = GetMicroContext(context);
+  const int alignment = MicroArenaBufferAlignment();
+
+  int scratch_size = 0;
+  int band_size = 0;
+  int window_size = 0;
+  for (int i = 0; i < params.num_stages; i++) {
+    TfLiteNode& stage = params.stages[i];
+    stage.user_data = Init(context, nullptr, 0);
+    TF_LITE_ENSURE(context, stage.user_data != nullptr);
+    NodeData* stage_data = static_cast<NodeData*>(stage.user_data);
+    stage_data->row_band = true;
+    TF_LITE_ENSURE_STATUS(ConvMaxPoolPrepare(context, &stage));
+    TF_LITE_ENSURE_EQ(context, stage_data->pool.padding.height, 0);
+    scratch_size = std::max(scratch_size, stage_data->scratch_stride);
+    band_size = std::max(band_size, stage_data->band_stride);
+    if (i == 0) {
+      continue;
+    }
+
+    // The input rows of the conv rows under one pooling window.
+    const auto& stage_params =
+        *(static_cast<const FusedConvMaxPoolParams*>(stage.builtin_data));
+    TfLiteTensor* input =
+        micro_context->AllocateTempInputTensor(&stage, kConvInputTensor);
+    TF_LITE_ENSURE(context, input != nullptr);
+    TfLiteTensor* filter =
+        micro_context->AllocateTempInputTensor(&stage, kConvWeightsTensor);
+    TF_LITE_ENSURE(context, filter != nullptr);
+    const int rows = std::min(
+        input->dims->data[1],
+        (stage_params.pool.filter_height - 1) *
+                stage_params.conv.stride_height +
+            filter->dims->data[1]);
+    const int row_size = input->dims->data[2] * input->dims->data[3];
+    data->window_offset[i] = window_size;
+    data->window_rows[i] = rows;
+    window_size +=
+        (rows * row_size + alignment - 1) / alignment * alignment;
+    micro_context->DeallocateTempTfLiteTensor(input);
+    micro_context->DeallocateTempTfLiteTensor(filter);
+  }
+
+  data->scratch_buffer_idx = -1;
+  if (scratch_size > 0) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, scratch_size, &data->scratch_buffer_idx));
+  }
+  TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+      context, band_size, &data->band_buffer_idx));
+  data->window_buffer_idx = -1;
+  if (window_size > 0) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, window_size, &data->window_buffer_idx));
+  }
+  return kTfLiteOk;
+}
+
+// A stage of a row band stack, at Eval.
+struct RowBandStage {
+  ConvArgs args;
+  const FusedConvMaxPoolParams* params;
+  const NodeData* data;
+  int output_width;
+  // Input rows from one output row to the next.
+  int step;
+  int8_t* band;
+  // Input rows [first_row, first_row + rows) of the `window_rows` the
+  // window holds, the first stage's input being read in place.
+  int8_t* window;
+  int window_rows;
+  int first_row;
+  int rows;
+};
+
+// Computes output row `out_y` of stage `stage_idx` into `output_row`, after
+// sliding the stage's window down to the input rows under it and filling in
+// those it doesn't hold yet, output rows of the stage before.
+template <typename InputT>
+void RowBandRow(RowBandStage* stages, int stage_idx, const InputT* input,
+                int out_y, int8_t* output_row) {
+  RowBandStage& stage = stages[stage_idx];
+  const int input_y = out_y * stage.step;
+  const int row_size =
+      stage.args.input_dims.width * stage.args.input_dims.channels;
+  if (stage_idx == 0) {
+    SetConvScratch(stage.args, 0);
+    ConvMaxPoolRow(stage.args, *stage.params, *stage.data,
+                   input + input_y * row_size, input_y,
+                   stage.args.input_dims.height - input_y, stage.output_width,
+                   out_y, stage.band, output_row);
+    return;
+  }
+
+  const int kept = std::max(stage.first_row + stage.rows - input_y, 0);
+  if (kept > 0 && kept < stage.rows) {
+    memmove(stage.window, stage.window + (stage.rows - kept) * row_size,
+            kept * row_size);
+  }
+  stage.first_row = input_y;
+  stage.rows = kept;
+  const int rows =
+      std::min(stage.window_rows, stage.args.input_dims.height - input_y);
+  for (; stage.rows < rows; stage.rows++) {
+    RowBandRow(stages, stage_idx - 1, input, input_y + stage.rows,
+               stage.window + stage.rows * row_size);
+  }
+  SetConvScratch(stage.args, 0);
+  ConvMaxPoolRow<int8_t>(stage.args, *stage.params, *stage.data, stage.window,
+                         input_y, stage.rows, stage.output_width, out_y,
+                         stage.band, output_row);
+}
+
+template <typename InputT>
+void EvalRowBands(RowBandStage* stages, int num_stages,
+                  const TfLiteEvalTensor* input, TfLiteEvalTensor* output) {
+  RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+  RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+  const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_size = input_shape.FlatSize() / batch_size;
+  const int output_size = output_shape.FlatSize() / batch_size;
+  const int output_height = output_shape.Dims(1);
+  const int output_row_size = output_shape.Dims(2) * output_shape.Dims(3);
+
+  const InputT *input_data = tflite::micro::GetTensorData<InputT>(input);
+  int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
+  for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+    for (int i = 0; i < num_stages; i++) {
+      stages[i].first_row = 0;
+      stages[i].rows = 0;
+    }
+    int8_t *batch_output = output_data + i_batch * output_size;
+    for (int out_y = 0; out_y < output_height; out_y++) {
+      RowBandRow(stages, num_stages - 1, input_data + i_batch * input_size,
+                 out_y, batch_output + out_y * output_row_size);
+    }
+  }
+}
+
+TfLiteStatus RowBandEval(TfLiteContext* context, TfLiteNode* node) {
+  const auto& params = *(static_cast<const RowBandParams*>(node->builtin_data));
+  const auto& data = *(static_cast<const RowBandData*>(node->user_data));
+  int8_t* scratch_buf =
+      data.scratch_buffer_idx > -1
+          ? static_cast<int8_t*>(
+                context->GetScratchBuffer(context, data.scratch_buffer_idx))
+          : nullptr;
+  int8_t* band = static_cast<int8_t*>(
+      context->GetScratchBuffer(context, data.band_buffer_idx));
+  int8_t* windows =
+      data.window_buffer_idx > -1
+          ? static_cast<int8_t*>(
+                context->GetScratchBuffer(context, data.window_buffer_idx))
+          : nullptr;
+
+  RowBandStage stages[kMaxRowBandStages];
+  for (int i = 0; i < params.num_stages; i++) {
+    const TfLiteNode* stage_node = &params.stages[i];
+    const TfLiteEvalTensor* input =
+        tflite::micro::GetEvalInput(context, stage_node, kConvInputTensor);
+    const TfLiteEvalTensor* filter =
+        tflite::micro::GetEvalInput(context, stage_node, kConvWeightsTensor);
+    const TfLiteEvalTensor* bias =
+        (NumInputs(stage_node) == 3)
+            ? tflite::micro::GetEvalInput(context, stage_node, kConvBiasTensor)
+            : nullptr;
+    const TfLiteEvalTensor* conv_output =
+        context->GetEvalTensor(context, stage_node->intermediates->data[0]);
+    const TfLiteEvalTensor* output =
+        tflite::micro::GetEvalOutput(context, stage_node, 0);
+
+    RowBandStage& stage = stages[i];
+    stage.params =
+        static_cast<const FusedConvMaxPoolParams*>(stage_node->builtin_data);
+    stage.data = static_cast<const NodeData*>(stage_node->user_data);
+    PrepareConvArgs(context, stage.params->conv, *stage.data,
+                    tflite::micro::GetTensorShape(input), filter, bias,
+                    tflite::micro::GetTensorShape(conv_output), &stage.args);
+    stage.args.scratch_buf = scratch_buf;
+    stage.args.scratch_stride = 0;
+    stage.output_width = output->dims->data[2];
+    stage.step =
+        stage.params->pool.stride_height * stage.params->conv.stride_height;
+    stage.band = band;
+    stage.window = i > 0 ? windows + data.window_offset[i] : nullptr;
+    stage.window_rows = i > 0 ? data.window_rows[i] : 0;
+  }
+
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, &params.stages[0], kConvInputTensor);
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(
+      context, &params.stages[params.num_stages - 1], 0);
+  switch (input->type) {
+    case kTfLiteInt8:
+      EvalRowBands<int8_t>(stages, params.num_stages, input, output);
+      break;
+    case kTfLiteUInt8:
+      EvalRowBands<uint8_t>(stages, params.num_stages, input, output);
+      break;
     default:
       MicroPrintf("Type %s (%d) not supported.", TfLiteTypeGetName(input->type),
                   input->type);
       return kTfLiteError;
   }
-  long long time_this_instance = esp_timer_get_time() - start_time;
-  conv_total_time += time_this_instance;
-  // printf("time this conv instance: %llu\n", time_this_instance / 1000);
   return kTfLiteOk;
 }
+#endif
 
 }  // namespace
 
@@ -404,4 +1219,30 @@ TFLMRegistration Register_CONV_2D() {
   return tflite::micro::RegisterOp(Init, Prepare, Eval);
 }
 
+#if ESP_NN
+TFLMRegistration Register_CONV_2D_MAX_POOL_2D() {
+  return tflite::micro::RegisterOp(Init, ConvMaxPoolPrepare, ConvMaxPoolEval);
+}
+
+TFLMRegistration Register_ROW_BAND_STACK() {
+  return tflite::micro::RegisterOp(RowBandInit, RowBandPrepare, RowBandEval);
+}
+
+void SetRowBandStages(int stages) {
+  row_band_stages = std::min(std::max(stages, 0), kMaxRowBandStages);
+}
+
+int GetRowBandStages() { return row_band_stages; }
+
+size_t RowBandPersistentBytes(int stages) {
+  const size_t alignment = MicroArenaBufferAlignment();
+  auto aligned = [alignment](size_t bytes) {
+    return (bytes + alignment - 1) / alignment * alignment;
+  };
+  return aligned(sizeof(RowBandParams)) + aligned(sizeof(RowBandData)) +
+         stages * aligned(sizeof(NodeData)) +
+         aligned(3 * sizeof(ScratchBufferHandle));
+}
+#endif
+
 }  // namespace tflite
@@ -24,13 +24,15 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
 
-#include <esp_timer.h>
-
 #if ESP_NN
 #include <esp_nn.h>
-#endif
 
-long long dc_total_time = 0;
+#include <algorithm>
+
+#include "tensorflow/lite/micro/kernels/esp_nn/autotune.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#endif
 
 namespace tflite {
 namespace {
@@ -38,7 +40,13 @@ namespace {
 struct NodeData {
   OpDataConv op_data;
 #if ESP_NN
+  // Workers the output rows are split across (see parallel.h), each with
+  // the scratch buffer `scratch_stride` bytes after the previous one's.
+  int workers;
   int buffer_idx;
+  int scratch_stride;
+  // GetDepthwiseConvImpl() index, 0 unless autotuned (see autotune.h).
+  int depthwise_impl;
 #endif
 };
 
@@ -49,6 +57,129 @@ void* Init(TfLiteContext* context, const char* buffer,
 }
 
 #if ESP_NN
+// A layer's top and bottom output rows, what AutotuneDepthwiseConv() runs
+// every implementation on (see autotune.h).
+struct DepthwiseConvBands {
+  AutotuneBand bands[kAutotuneBands];
+  data_dims_t filter_dims;
+  dw_conv_params_t conv_params;
+  quant_data_t quant_data;
+  const int8_t* input_data;
+  const int8_t* filter_data;
+  const int32_t* bias_data;
+  void* scratch_buf;
+};
+
+void RunDepthwiseConvBand(int index, int band, int8_t* output, void* user) {
+  const DepthwiseConvBands& bands =
+      *static_cast<const DepthwiseConvBands*>(user);
+  const AutotuneBand& rows = bands.bands[band];
+  dw_conv_params_t conv_params = bands.conv_params;
+  conv_params.padding.height = rows.padding_height;
+  const DepthwiseConvImpl& impl = GetDepthwiseConvImpl(index);
+  impl.set_scratch_buf(bands.scratch_buf);
+  impl.depthwise_conv_s8(&rows.input_dims, bands.input_data,
+                         &bands.filter_dims, bands.filter_data,
+                         bands.bias_data, &rows.output_dims, output,
+                         &conv_params, &bands.quant_data);
+}
+
+const char* DepthwiseConvImplName(int index) {
+  return GetDepthwiseConvImpl(index).name;
+}
+
+// Sets data->depthwise_impl to the fastest implementation for the layer
+// (see autotune.h), or leaves the default one if the arena has no room for
+// the bands.
+TfLiteStatus AutotuneDepthwiseConv(TfLiteContext* context,
+                                   const data_dims_t& input_dims,
+                                   const data_dims_t& filter_dims,
+                                   const data_dims_t& output_dims,
+                                   const dw_conv_params_t& conv_params,
+                                   const int8_t* filter_data,
+                                   const int32_t* bias_data, NodeData* data) {
+  AutotuneShape shape;
+  shape.input_dims = input_dims;
+  shape.filter_dims = filter_dims;
+  shape.output_dims = output_dims;
+  shape.stride = conv_params.stride;
+  shape.padding = conv_params.padding;
+  shape.ch_mult = conv_params.ch_mult;
+  shape.in_offset = conv_params.in_offset;
+  shape.out_offset = conv_params.out_offset;
+  shape.activation = conv_params.activation;
+  shape.filter_data = filter_data;
+  shape.filter_size =
+      filter_dims.width * filter_dims.height * output_dims.channels;
+  shape.bias_data = bias_data;
+  shape.output_multiplier = data->op_data.per_channel_output_multiplier;
+  shape.output_shift = data->op_data.per_channel_output_shift;
+
+  DepthwiseConvBands bands;
+  bands.filter_dims = filter_dims;
+  bands.conv_params = conv_params;
+  bands.quant_data = {.shift = data->op_data.per_channel_output_shift,
+                      .mult = data->op_data.per_channel_output_multiplier};
+  bands.filter_data = filter_data;
+  bands.bias_data = bias_data;
+
+  // Every band reads its input rows from the same buffer.
+  int scratch_size = 0;
+  int input_size = 0;
+  for (int band = 0; band < AutotuneBandCount(shape); band++) {
+    AutotuneBand& rows = bands.bands[band];
+    rows = GetAutotuneBand(shape, band);
+    dw_conv_params_t band_params = conv_params;
+    band_params.padding.height = rows.padding_height;
+    for (int i = 0; i < DepthwiseConvImplCount(); i++) {
+      scratch_size = std::max(scratch_size,
+                              GetDepthwiseConvImpl(i).get_scratch_size(
+                                  &rows.input_dims, &filter_dims,
+                                  &rows.output_dims, &band_params));
+    }
+    input_size = std::max<int>(input_size, rows.input_dims.width *
+                                               rows.input_dims.height *
+                                               rows.input_dims.channels);
+  }
+  const data_dims_t& band_output = bands.bands[0].output_dims;
+  const int output_size =
+      band_output.width * band_output.height * band_output.channels;
+  const int alignment = MicroArenaBufferAlignment();
+  const int input_bytes = (input_size + alignment - 1) / alignment * alignment;
+  const int outputs_bytes =
+      ((kAutotuneBands + 1) * output_size + alignment - 1) / alignment *
+      alignment;
+
+  MicroContext* micro_context = GetMicroContext(context);
+  uint8_t* buffer = micro_context->AllocateTempBuffer(
+      input_bytes + outputs_bytes + scratch_size, alignment);
+  if (buffer == nullptr) {
+    MicroPrintf(
+        "autotune DEPTHWISE_CONV_2D: no arena left for the bands, not tuned");
+    return kTfLiteOk;
+  }
+  // Any input will do, the time doesn't depend on it.
+  int8_t* input = reinterpret_cast<int8_t*>(buffer);
+  uint32_t state = 1;
+  for (int i = 0; i < input_size; i++) {
+    state = state * 1664525u + 1013904223u;
+    input[i] = static_cast<int8_t>(state >> 24);
+  }
+  bands.input_data = input;
+  bands.scratch_buf =
+      scratch_size > 0 ? buffer + input_bytes + outputs_bytes : nullptr;
+
+  data->depthwise_impl = Autotune(
+      "DEPTHWISE_CONV_2D", shape, DepthwiseConvImplCount(),
+      DepthwiseConvImplName, reinterpret_cast<int8_t*>(buffer + input_bytes),
+      output_size, RunDepthwiseConvBand, &bands);
+  micro_context->DeallocateTempBuffer(buffer);
+  return kTfLiteOk;
+}
+#endif
+
+#if ESP_NN
+// An int4 filter must have dilation 1.
 inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                                     const TfLiteDepthwiseConvParams& params,
                                     const NodeData& data,
@@ -105,12 +236,13 @@ inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
 
     const int input_size = input_width * input_height * input_depth;
     const int output_size = output_width * output_height * output_depth;
-    void *scratch_buf = NULL;
+    int8_t *scratch_buf = nullptr;
     if (data.buffer_idx > -1) {
-      scratch_buf = context->GetScratchBuffer(context, data.buffer_idx);
+      scratch_buf = static_cast<int8_t*>(
+          context->GetScratchBuffer(context, data.buffer_idx));
     }
 
-    esp_nn_set_depthwise_conv_scratch_buf(scratch_buf);
+    const DepthwiseConvImpl& impl = GetDepthwiseConvImpl(data.depthwise_impl);
 
     data_dims_t input_dims =  {
                                 .width = input_width, .height = input_height,
@@ -134,11 +266,36 @@ inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                               };
 
     for (int i_batch = 0; i_batch < batch_size; i_batch++) {
-      esp_nn_depthwise_conv_s8(&input_dims, input_data + i_batch * input_size,
+      // Every worker computes a band of output rows, a depthwise conv of its
+      // own over the input rows from the band's first on.
+      auto conv_rows = [&](int worker, int begin, int end) {
+        impl.set_scratch_buf(scratch_buf != nullptr
+                                 ? scratch_buf + worker * data.scratch_stride
+                                 : nullptr);
+        const int input_y = begin * stride_height;
+        data_dims_t band_input_dims = input_dims;
+        band_input_dims.height -= input_y;
+        data_dims_t band_output_dims = output_dims;
+        band_output_dims.height = end - begin;
+        const int8_t *band_input = input_data + i_batch * input_size +
+                                   input_y * input_width * input_depth;
+        int8_t *band_output = output_data + i_batch * output_size +
+                              begin * output_width * output_depth;
+        if (filter->type == kTfLiteInt4) {
+          esp_nn_depthwise_conv_s8_s4(&band_input_dims, band_input,
+                                      &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
+                                      tflite::micro::GetTensorData<int32_t>(bias),
+                                      &band_output_dims, band_output,
+                                      &conv_params, &quant_data);
+          return;
+        }
+        impl.depthwise_conv_s8(&band_input_dims, band_input,
                                &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
                                tflite::micro::GetTensorData<int32_t>(bias),
-                               &output_dims, output_data + i_batch * output_size,
+                               &band_output_dims, band_output,
                                &conv_params, &quant_data);
+      };
+      ParallelFor(data.workers, output_height, conv_rows);
     }
   } else {
     reference_integer_ops::DepthwiseConvPerChannel(
@@ -237,7 +394,16 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
           (input->type == kTfLiteInt16 && filter->type == kTfLiteInt8),
       "Hybrid models are not supported on TFLite Micro.");
 
-  if (filter->type == kTfLiteInt4) {
+#if ESP_NN
+  // esp-nn reads int4 filters packed (esp_nn_depthwise_conv_s8_s4()); only
+  // dilated convs, left to the reference kernel, unpack them first.
+  const bool unpack_int4 = filter->type == kTfLiteInt4 &&
+                           (params.dilation_width_factor != 1 ||
+                            params.dilation_height_factor != 1);
+#else
+  const bool unpack_int4 = filter->type == kTfLiteInt4;
+#endif
+  if (unpack_int4) {
     int filter_size =
         RuntimeShape(filter->dims->size,
                      reinterpret_cast<const int32_t*>(filter->dims->data))
@@ -269,11 +435,50 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                       .dilation = {0, 0}, .activation = {-128, 127}
                                     };
 
-    int scratch_buf_size = esp_nn_get_depthwise_conv_scratch_size(
-        &input_dims, &filter_dims, &output_dims, &conv_params);
+    data->depthwise_impl = 0;
+    if (GetKernelAutotune() && filter->type == kTfLiteInt8 &&
+        params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1) {
+      TfLiteTensor* bias = micro_context->AllocateTempInputTensor(
+          node, kDepthwiseConvBiasTensor);
+      dw_conv_params_t tuned_params = conv_params;
+      tuned_params.in_offset = -data->op_data.input_zero_point;
+      tuned_params.out_offset = data->op_data.output_zero_point;
+      tuned_params.activation = {data->op_data.output_activation_min,
+                                 data->op_data.output_activation_max};
+      const TfLiteStatus status = AutotuneDepthwiseConv(
+          context, input_dims, filter_dims, output_dims, tuned_params,
+          GetTensorData<int8_t>(filter),
+          bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr, data);
+      if (bias != nullptr) {
+        micro_context->DeallocateTempTfLiteTensor(bias);
+      }
+      TF_LITE_ENSURE_STATUS(status);
+    }
+
+    // esp_nn_depthwise_conv_s8_s4() needs none.
+    int scratch_buf_size =
+        filter->type != kTfLiteInt8
+            ? 0
+            : GetDepthwiseConvImpl(data->depthwise_impl).get_scratch_size(
+                  &input_dims, &filter_dims, &output_dims, &conv_params);
+
+    // Split by output rows, as long as no padding goes above a band's.
+    data->workers = 1;
+    if (params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 &&
+        data->op_data.padding.height == 0) {
+      data->workers = ParallelWorkers(
+          static_cast<int64_t>(output_height) * output_width *
+              output->dims->data[3] * filter_height * filter_width,
+          output_height);
+    }
+    const int alignment = MicroArenaBufferAlignment();
+    data->scratch_stride =
+        (scratch_buf_size + alignment - 1) / alignment * alignment;
     if (scratch_buf_size > 0) {
       TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
-        context, scratch_buf_size, &data->buffer_idx));
+        context, data->workers * data->scratch_stride, &data->buffer_idx));
     } else {
       data->buffer_idx = -1;
     }
@@ -306,7 +511,6 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
           ? tflite::micro::GetEvalInput(context, node, kDepthwiseConvBiasTensor)
           : nullptr;
 
-  long long start_time = esp_timer_get_time();
   switch (input->type) {  // Already know in/out types are same.
     case kTfLiteFloat32: {
       tflite::reference_ops::DepthwiseConv(
@@ -324,6 +528,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt8: {
       switch (filter->type) {
         case kTfLiteInt4: {
+#if ESP_NN
+          if (params.dilation_width_factor == 1 &&
+              params.dilation_height_factor == 1) {
+            EvalQuantizedPerChannel(context, node, params, data, input, filter,
+                                    bias, output);
+            break;
+          }
+#endif
           int8_t* unpacked_filter_data = static_cast<int8_t*>(
               context->GetScratchBuffer(context, data.op_data.filter_buffer_index));
           tflite::tensor_utils::UnpackDenseInt4IntoInt8(
@@ -401,10 +613,6 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
                   TfLiteTypeGetName(input->type), input->type);
       return kTfLiteError;
   }
-  long long time_this_instance = esp_timer_get_time() - start_time;
-  dc_total_time += time_this_instance;
-  // printf("time this dc instance: %llu\n", time_this_instance / 1000);
-
   return kTfLiteOk;
 }
 
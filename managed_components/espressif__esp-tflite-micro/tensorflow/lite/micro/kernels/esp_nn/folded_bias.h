@@ -0,0 +1,50 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FOLDED_BIAS_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FOLDED_BIAS_H_
+
+#include <cstdint>
+
+namespace tflite {
+
+// sum((input + input_offset) * filter) over a filter row is
+// sum(input * filter) + input_offset * sum(filter), and the second term is a
+// constant per output channel. Adding it to the bias once at Prepare lets
+// the esp-nn conv and fully connected kernels run with a zero input offset,
+// where they take a plain int8 dot product.
+//
+// Only exact when every output reads its whole filter row from the input:
+// a conv output over padding would add the offset for taps that read
+// nothing.
+//
+// `filter` holds `channels` rows of `row_size` values, `bias` is null or
+// holds `channels` values.
+inline void FoldInputOffset(const int8_t* filter, const int32_t* bias,
+                            int32_t input_offset, int channels, int row_size,
+                            int32_t* folded_bias) {
+  for (int c = 0; c < channels; c++) {
+    int32_t filter_sum = 0;
+    for (int i = 0; i < row_size; i++) {
+      filter_sum += filter[c * row_size + i];
+    }
+    folded_bias[c] =
+        (bias != nullptr ? bias[c] : 0) + input_offset * filter_sum;
+  }
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FOLDED_BIAS_H_
@@ -25,20 +25,41 @@ limitations under the License.
 
 #if ESP_NN
 #include <esp_nn.h>
-#endif
 
-#include <esp_timer.h>
+#include <algorithm>
 
-long long fc_total_time = 0;
+#include "tensorflow/lite/micro/kernels/esp_nn/folded_bias.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/fusion.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/weight_stream.h"
+#include "tensorflow/lite/micro/kernels/softmax.h"
+#endif
 
 namespace tflite {
 namespace {
 
+struct NodeData {
+  OpDataFullyConnected op_data;
+#if ESP_NN
+  // Filter rows per weight tile, 0 to read the filter in place (see
+  // weight_stream.h), and the scratch buffer holding two tiles.
+  int tile_rows;
+  int tile_buffer_idx;
+  // Bias with the input offset folded in (see folded_bias.h), or null when
+  // the filter has a zero point of its own.
+  int32_t* folded_bias;
+  // Only used by FULLY_CONNECTED_SOFTMAX: the softmax, the scratch buffer
+  // holding the logits and esp-nn's softmax scratch buffer, or -1.
+  SoftmaxParams softmax;
+  int logits_buffer_idx;
+  int softmax_buffer_idx;
+#endif
+};
+
 void* FullyConnectedInit(TfLiteContext* context, const char* buffer,
                          size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context,
-                                           sizeof(OpDataFullyConnected));
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
 }
 
 TfLiteStatus FullyConnectedPrepare(TfLiteContext* context, TfLiteNode* node) {
@@ -47,7 +68,8 @@ TfLiteStatus FullyConnectedPrepare(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   TFLITE_DCHECK(node->builtin_data != nullptr);
 
-  auto* data = static_cast<OpDataFullyConnected*>(node->user_data);
+  auto* node_data = static_cast<NodeData*>(node->user_data);
+  OpDataFullyConnected* data = &node_data->op_data;
   const auto params =
       static_cast<const TfLiteFullyConnectedParams*>(node->builtin_data);
 
@@ -74,6 +96,8 @@ TfLiteStatus FullyConnectedPrepare(TfLiteContext* context, TfLiteNode* node) {
     return kTfLiteError;
   }
 
+#if !ESP_NN
+  // esp-nn reads int4 filters packed (esp_nn_fully_connected_s8_s4()).
   if (filter->type == kTfLiteInt4) {
     int filter_size =
         RuntimeShape(filter->dims->size,
@@ -82,11 +106,45 @@ TfLiteStatus FullyConnectedPrepare(TfLiteContext* context, TfLiteNode* node) {
     context->RequestScratchBufferInArena(context, filter_size,
                                          &data->filter_buffer_index);
   }
+#endif
 
   TF_LITE_ENSURE_OK(context, CalculateOpDataFullyConnected(
                                  context, params->activation, input->type,
                                  input, filter, bias, output, data));
 
+#if ESP_NN
+  // Tile the filter by output channels when it is larger than one tile.
+  node_data->tile_rows = 0;
+  node_data->tile_buffer_idx = -1;
+  node_data->folded_bias = nullptr;
+  if (input->type == kTfLiteInt8 && filter->type == kTfLiteInt8) {
+    const int accum_depth = filter->dims->data[filter->dims->size - 1];
+    const int output_depth = output->dims->data[output->dims->size - 1];
+    const int tile_rows =
+        accum_depth > 0 ? static_cast<int>(GetWeightTileSize() / accum_depth)
+                        : 0;
+    if (tile_rows > 0 && tile_rows < output_depth) {
+      TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+          context, 2 * tile_rows * accum_depth, &node_data->tile_buffer_idx));
+      node_data->tile_rows = tile_rows;
+    }
+
+    // The input offset times a filter row's sum is the same for every
+    // input; with no filter zero point, nothing else depends on it.
+    if (data->filter_zero_point == 0) {
+      const int channels = filter->dims->data[0];
+      node_data->folded_bias = static_cast<int32_t*>(
+          context->AllocatePersistentBuffer(context,
+                                            channels * sizeof(int32_t)));
+      TF_LITE_ENSURE(context, node_data->folded_bias != nullptr);
+      FoldInputOffset(GetTensorData<int8_t>(filter),
+                      bias != nullptr ? GetTensorData<int32_t>(bias) : nullptr,
+                      -data->input_zero_point, channels, accum_depth,
+                      node_data->folded_bias);
+    }
+  }
+#endif
+
   micro_context->DeallocateTempTfLiteTensor(input);
   micro_context->DeallocateTempTfLiteTensor(filter);
   if (bias != nullptr) {
@@ -96,6 +154,204 @@ TfLiteStatus FullyConnectedPrepare(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+#if ESP_NN
+// Computes `output_depth` output channels of one batch from the matching
+// filter rows, bias and per-channel quantization, all starting at `channel`.
+inline void FullyConnectedKernel(const OpDataFullyConnected& data,
+                                 const int8_t* input_data,
+                                 int32_t input_offset,
+                                 const int8_t* filter_rows,
+                                 const int32_t* bias_data, int channel,
+                                 int8_t* output_data, int accum_depth,
+                                 int output_depth) {
+  if (bias_data != nullptr) {
+    bias_data += channel;
+  }
+  if (data.is_per_channel) {
+    esp_nn_fully_connected_per_ch_s8(input_data, input_offset,
+                                     accum_depth,
+                                     filter_rows, -data.filter_zero_point,
+                                     bias_data, output_data + channel,
+                                     output_depth, data.output_zero_point,
+                                     data.per_channel_output_shift + channel,
+                                     data.per_channel_output_multiplier + channel,
+                                     data.output_activation_min,
+                                     data.output_activation_max);
+  } else {
+    esp_nn_fully_connected_s8(input_data, input_offset,
+                              accum_depth,
+                              filter_rows, -data.filter_zero_point,
+                              bias_data, output_data + channel, output_depth,
+                              data.output_zero_point,
+                              data.output_shift, data.output_multiplier,
+                              data.output_activation_min,
+                              data.output_activation_max);
+  }
+}
+
+// FullyConnectedKernel() for every batch. With more than one, a per-channel
+// layer whose offsets are folded into the bias is a single GEMM, which
+// reads every filter row once for all the batches instead of once per
+// batch.
+inline void FullyConnectedBatches(const OpDataFullyConnected& data,
+                                  const int8_t* input_data,
+                                  int32_t input_offset,
+                                  const int8_t* filter_rows,
+                                  const int32_t* bias_data, int channel,
+                                  int8_t* output_data, int batches,
+                                  int accum_depth, int output_depth,
+                                  int rows) {
+  if (batches > 1 && data.is_per_channel && input_offset == 0 &&
+      data.filter_zero_point == 0) {
+    esp_nn_gemm_s8(input_data, batches, filter_rows, rows, accum_depth,
+                   bias_data != nullptr ? bias_data + channel : nullptr,
+                   output_data + channel, output_depth,
+                   data.output_zero_point,
+                   data.per_channel_output_shift + channel,
+                   data.per_channel_output_multiplier + channel,
+                   data.output_activation_min, data.output_activation_max);
+    return;
+  }
+  for (int b = 0; b < batches; ++b) {
+    FullyConnectedKernel(data, input_data + b * accum_depth, input_offset,
+                         filter_rows, bias_data, channel,
+                         output_data + b * output_depth, accum_depth, rows);
+  }
+}
+
+// FullyConnectedBatches() split by output channels across the workers (see
+// parallel.h), each computing its channels of every batch.
+inline void FullyConnectedRows(const OpDataFullyConnected& data,
+                               const int8_t* input_data, int32_t input_offset,
+                               const int8_t* filter_rows,
+                               const int32_t* bias_data, int channel,
+                               int8_t* output_data, int batches,
+                               int accum_depth, int output_depth, int rows) {
+  auto channels = [&](int worker, int begin, int end) {
+    FullyConnectedBatches(data, input_data, input_offset,
+                          filter_rows + begin * accum_depth, bias_data,
+                          channel + begin, output_data, batches, accum_depth,
+                          output_depth, end - begin);
+  };
+  ParallelFor(ParallelWorkers(static_cast<int64_t>(batches) * rows *
+                                  accum_depth,
+                              rows),
+              rows, channels);
+}
+
+// Int8 input and filter, through the weight tiles if the node has them.
+// Writes `output_shape` int8 values to `output_data`, which need not be the
+// node's output tensor.
+void EvalQuantizedInt8(TfLiteContext* context, const NodeData& node_data,
+                       const TfLiteEvalTensor* input,
+                       const TfLiteEvalTensor* filter,
+                       const TfLiteEvalTensor* bias,
+                       const RuntimeShape& output_shape, int8_t* output_data) {
+  const OpDataFullyConnected& data = node_data.op_data;
+  const RuntimeShape& filter_shape = tflite::micro::GetTensorShape(filter);
+
+  TFLITE_DCHECK_GE(filter_shape.DimensionsCount(), 2);
+  TFLITE_DCHECK_GE(output_shape.DimensionsCount(), 1);
+  const int filter_dim_count = filter_shape.DimensionsCount();
+  const int batches = output_shape.Dims(0);
+  const int output_depth = output_shape.Dims(1);
+  TFLITE_DCHECK_LE(output_depth, filter_shape.Dims(filter_dim_count - 2));
+  const int accum_depth = filter_shape.Dims(filter_dim_count - 1);
+
+  // A folded bias already holds the input offset's share of every output.
+  const int32_t* bias_data =
+      node_data.folded_bias != nullptr
+          ? node_data.folded_bias
+          : tflite::micro::GetOptionalTensorData<int32_t>(bias);
+  const int32_t input_offset =
+      node_data.folded_bias != nullptr ? 0 : -data.input_zero_point;
+
+  const int8_t *input_data = tflite::micro::GetTensorData<int8_t>(input);
+  const int8_t *filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+
+  const WeightMemory& memory = GetWeightMemory();
+  const int tile_rows = node_data.tile_rows;
+  if (tile_rows == 0) {
+    if (memory.read_in_place != nullptr) {
+      memory.read_in_place(filter_data, output_depth * accum_depth,
+                           memory.user);
+    }
+    FullyConnectedRows(data, input_data, input_offset, filter_data,
+                       bias_data, 0, output_data, batches, accum_depth,
+                       output_depth, output_depth);
+    return;
+  }
+
+  // Double buffered: copy the next tile while computing this one.
+  int8_t* tiles[2];
+  tiles[0] = static_cast<int8_t*>(
+      context->GetScratchBuffer(context, node_data.tile_buffer_idx));
+  tiles[1] = tiles[0] + tile_rows * accum_depth;
+  memory.copy_start(tiles[0], filter_data,
+                    std::min(tile_rows, output_depth) * accum_depth,
+                    memory.user);
+  for (int channel = 0, t = 0; channel < output_depth;
+       channel += tile_rows, t ^= 1) {
+    const int rows = std::min(tile_rows, output_depth - channel);
+    memory.copy_wait(memory.user);
+    const int next = channel + rows;
+    if (next < output_depth) {
+      memory.copy_start(
+          tiles[t ^ 1], filter_data + next * accum_depth,
+          std::min(tile_rows, output_depth - next) * accum_depth,
+          memory.user);
+    }
+    FullyConnectedRows(data, input_data, input_offset, tiles[t], bias_data,
+                       channel, output_data, batches, accum_depth,
+                       output_depth, rows);
+  }
+}
+
+// Int8 input with a packed int4 filter, read in place.
+void EvalQuantizedInt4(const OpDataFullyConnected& data,
+                       const TfLiteEvalTensor* input,
+                       const TfLiteEvalTensor* filter,
+                       const TfLiteEvalTensor* bias, TfLiteEvalTensor* output) {
+  const RuntimeShape& filter_shape = tflite::micro::GetTensorShape(filter);
+  const RuntimeShape& output_shape = tflite::micro::GetTensorShape(output);
+  const int filter_dim_count = filter_shape.DimensionsCount();
+  const int batches = output_shape.Dims(0);
+  const int output_depth = output_shape.Dims(1);
+  TFLITE_DCHECK_LE(output_depth, filter_shape.Dims(filter_dim_count - 2));
+  const int accum_depth = filter_shape.Dims(filter_dim_count - 1);
+
+  const int8_t *input_data = tflite::micro::GetTensorData<int8_t>(input);
+  const int8_t *filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+  const int32_t *bias_data =
+      tflite::micro::GetOptionalTensorData<int32_t>(bias);
+  int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
+
+  const WeightMemory& memory = GetWeightMemory();
+  if (memory.read_in_place != nullptr) {
+    memory.read_in_place(filter_data, (output_depth * accum_depth + 1) / 2,
+                         memory.user);
+  }
+  for (int b = 0; b < batches; ++b) {
+    if (data.is_per_channel) {
+      esp_nn_fully_connected_per_ch_s8_s4(
+          input_data + b * accum_depth, -data.input_zero_point, accum_depth,
+          filter_data, -data.filter_zero_point, bias_data,
+          output_data + b * output_depth, output_depth,
+          data.output_zero_point, data.per_channel_output_shift,
+          data.per_channel_output_multiplier, data.output_activation_min,
+          data.output_activation_max);
+    } else {
+      esp_nn_fully_connected_s8_s4(
+          input_data + b * accum_depth, -data.input_zero_point, accum_depth,
+          filter_data, -data.filter_zero_point, bias_data,
+          output_data + b * output_depth, output_depth,
+          data.output_zero_point, data.output_shift, data.output_multiplier,
+          data.output_activation_min, data.output_activation_max);
+    }
+  }
+}
+#endif
+
 TfLiteStatus FullyConnectedEval(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->builtin_data != nullptr);
   const auto* params =
@@ -112,10 +368,9 @@ TfLiteStatus FullyConnectedEval(TfLiteContext* context, TfLiteNode* node) {
 
   TFLITE_DCHECK(node->user_data != nullptr);
 
-  const auto& data =
-      *(static_cast<const OpDataFullyConnected*>(node->user_data));
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const OpDataFullyConnected& data = node_data.op_data;
 
-  long long start_time = esp_timer_get_time();
   // Checks in Prepare ensure input, output and filter types are all the same.
   switch (input->type) {
     case kTfLiteFloat32: {
@@ -135,12 +390,29 @@ TfLiteStatus FullyConnectedEval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt8: {
       switch (filter->type) {
         case kTfLiteInt4: {
+#if ESP_NN
+          EvalQuantizedInt4(data, input, filter, bias, output);
+#else
           int8_t* unpacked_filter_data = static_cast<int8_t*>(
               context->GetScratchBuffer(context, data.filter_buffer_index));
           tflite::tensor_utils::UnpackDenseInt4IntoInt8(
               tflite::micro::GetTensorData<int8_t>(filter),
               tflite::micro::GetTensorShape(filter).FlatSize(),
               unpacked_filter_data);
+          if (data.is_per_channel) {
+            tflite::reference_integer_ops::FullyConnectedPerChannel(
+                FullyConnectedParamsQuantized(data),
+                data.per_channel_output_multiplier,
+                reinterpret_cast<const int*>(data.per_channel_output_shift),
+                tflite::micro::GetTensorShape(input),
+                tflite::micro::GetTensorData<int8_t>(input),
+                tflite::micro::GetTensorShape(filter), unpacked_filter_data,
+                tflite::micro::GetTensorShape(bias),
+                tflite::micro::GetOptionalTensorData<int32_t>(bias),
+                tflite::micro::GetTensorShape(output),
+                tflite::micro::GetTensorData<int8_t>(output));
+            break;
+          }
           tflite::reference_integer_ops::FullyConnected(
               FullyConnectedParamsQuantized(data),
               tflite::micro::GetTensorShape(input),
@@ -150,41 +422,30 @@ TfLiteStatus FullyConnectedEval(TfLiteContext* context, TfLiteNode* node) {
               tflite::micro::GetOptionalTensorData<int32_t>(bias),
               tflite::micro::GetTensorShape(output),
               tflite::micro::GetTensorData<int8_t>(output));
+#endif
           break;
         }
         case kTfLiteInt8: {
 #if ESP_NN
-          const RuntimeShape& filter_shape = tflite::micro::GetTensorShape(filter);
-          const RuntimeShape& output_shape = tflite::micro::GetTensorShape(output);
-
-          TFLITE_DCHECK_GE(filter_shape.DimensionsCount(), 2);
-          TFLITE_DCHECK_GE(output_shape.DimensionsCount(), 1);
-          const int filter_dim_count = filter_shape.DimensionsCount();
-          const int batches = output_shape.Dims(0);
-          const int output_depth = output_shape.Dims(1);
-          TFLITE_DCHECK_LE(output_depth, filter_shape.Dims(filter_dim_count - 2));
-          const int accum_depth = filter_shape.Dims(filter_dim_count - 1);
-
-          const int32_t* bias_data =
-              tflite::micro::GetOptionalTensorData<int32_t>(bias);
-
-          const int8_t *input_data = tflite::micro::GetTensorData<int8_t>(input);
-          int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
-          const int8_t *filter_data = tflite::micro::GetTensorData<int8_t>(filter);
-
-          for (int b = 0; b < batches; ++b) {
-            esp_nn_fully_connected_s8(input_data, -data.input_zero_point,
-                                      accum_depth,
-                                      filter_data, -data.filter_zero_point,
-                                      bias_data, output_data, output_depth,
-                                      data.output_zero_point,
-                                      data.output_shift, data.output_multiplier,
-                                      data.output_activation_min,
-                                      data.output_activation_max);
-            input_data += accum_depth;
-            output_data += output_depth;
-          }
+          EvalQuantizedInt8(context, node_data, input, filter, bias,
+                            tflite::micro::GetTensorShape(output),
+                            tflite::micro::GetTensorData<int8_t>(output));
 #else
+          if (data.is_per_channel) {
+            tflite::reference_integer_ops::FullyConnectedPerChannel(
+                FullyConnectedParamsQuantized(data),
+                data.per_channel_output_multiplier,
+                reinterpret_cast<const int*>(data.per_channel_output_shift),
+                tflite::micro::GetTensorShape(input),
+                tflite::micro::GetTensorData<int8_t>(input),
+                tflite::micro::GetTensorShape(filter),
+                tflite::micro::GetTensorData<int8_t>(filter),
+                tflite::micro::GetTensorShape(bias),
+                tflite::micro::GetOptionalTensorData<int32_t>(bias),
+                tflite::micro::GetTensorShape(output),
+                tflite::micro::GetTensorData<int8_t>(output));
+            break;
+          }
           tflite::reference_integer_ops::FullyConnected(
               FullyConnectedParamsQuantized(data),
               tflite::micro::GetTensorShape(input),
@@ -237,10 +498,91 @@ TfLiteStatus FullyConnectedEval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteError;
     }
   }
-  fc_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
+#if ESP_NN
+TfLiteStatus FullyConnectedSoftmaxPrepare(TfLiteContext* context,
+                                          TfLiteNode* node) {
+  // Prepare the fully connected on its own output, the node's intermediate.
+  TfLiteIntArray* outputs = node->outputs;
+  node->outputs = node->intermediates;
+  const TfLiteStatus fc_status = FullyConnectedPrepare(context, node);
+  node->outputs = outputs;
+  TF_LITE_ENSURE_STATUS(fc_status);
+
+  auto* node_data = static_cast<NodeData*>(node->user_data);
+  const auto& params = *(
+      static_cast<const FusedFullyConnectedSoftmaxParams*>(node->builtin_data));
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* logits = micro_context->AllocateTempIntermediateTensor(node, 0);
+  TF_LITE_ENSURE(context, logits != nullptr);
+  TfLiteTensor* output = micro_context->AllocateTempOutputTensor(node, 0);
+  TF_LITE_ENSURE(context, output != nullptr);
+  TF_LITE_ENSURE_TYPES_EQ(context, logits->type, kTfLiteInt8);
+  TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt8);
+
+  TF_LITE_ENSURE_STATUS(CalculateSoftmaxParams(
+      context, logits, output, &params.softmax, &node_data->softmax));
+  const int logits_size =
+      RuntimeShape(logits->dims->size,
+                   reinterpret_cast<const int32_t*>(logits->dims->data))
+          .FlatSize();
+  TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+      context, logits_size, &node_data->logits_buffer_idx));
+  const int32_t scratch_size = esp_nn_get_softmax_scratch_size(
+      logits->dims->data[logits->dims->size - 1], 1);
+  node_data->softmax_buffer_idx = -1;
+  if (scratch_size > 0) {
+    TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+        context, scratch_size, &node_data->softmax_buffer_idx));
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(logits);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus FullyConnectedSoftmaxEval(TfLiteContext* context,
+                                       TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kFullyConnectedInputTensor);
+  const TfLiteEvalTensor* filter =
+      tflite::micro::GetEvalInput(context, node, kFullyConnectedWeightsTensor);
+  const TfLiteEvalTensor* bias =
+      tflite::micro::GetEvalInput(context, node, kFullyConnectedBiasTensor);
+  const TfLiteEvalTensor* logits =
+      context->GetEvalTensor(context, node->intermediates->data[0]);
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+
+  const RuntimeShape logits_shape = tflite::micro::GetTensorShape(logits);
+  int8_t* logits_data = static_cast<int8_t*>(
+      context->GetScratchBuffer(context, node_data.logits_buffer_idx));
+  EvalQuantizedInt8(context, node_data, input, filter, bias, logits_shape,
+                    logits_data);
+
+  const int trailing_dim = logits_shape.DimensionsCount() - 1;
+  const int depth = logits_shape.Dims(trailing_dim);
+  const int outer_size = logits_shape.FlatSize() / depth;
+  void* scratch_buf = nullptr;
+  if (node_data.softmax_buffer_idx > -1) {
+    scratch_buf =
+        context->GetScratchBuffer(context, node_data.softmax_buffer_idx);
+  }
+  esp_nn_set_softmax_scratch_buf(scratch_buf);
+  esp_nn_softmax_s8(logits_data, outer_size, depth,
+                    node_data.softmax.input_multiplier,
+                    node_data.softmax.input_left_shift,
+                    node_data.softmax.diff_min,
+                    tflite::micro::GetTensorData<int8_t>(output));
+  return kTfLiteOk;
+}
+#endif
+
 }  // namespace
 
 TFLMRegistration Register_FULLY_CONNECTED() {
@@ -252,4 +594,12 @@ TFLMInferenceRegistration RegisterInference_FULLY_CONNECTED() {
   return tflite::micro::RegisterOp(FullyConnectedEval);
 }
 
+#if ESP_NN
+TFLMRegistration Register_FULLY_CONNECTED_SOFTMAX() {
+  return tflite::micro::RegisterOp(FullyConnectedInit,
+                                   FullyConnectedSoftmaxPrepare,
+                                   FullyConnectedSoftmaxEval);
+}
+#endif
+
 }  // namespace tflite
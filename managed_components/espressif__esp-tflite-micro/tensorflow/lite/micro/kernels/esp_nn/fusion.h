@@ -0,0 +1,95 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FUSION_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FUSION_H_
+
+#include <cstddef>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/micro/micro_common.h"
+
+namespace tflite {
+
+// Kernels for the pairs of ops MicroInterpreterGraph::FuseOperators()
+// replaces with a single node. A fused node has the inputs of the first op,
+// the outputs of the second and the tensor between the two as its only
+// intermediate, which is never allocated: the kernels only read its shape
+// and quantization.
+//
+// The builtin data of a fused node holds the builtin data of both ops, the
+// first op's first, so it still reads as the first op's.
+
+struct FusedConvMaxPoolParams {
+  TfLiteConvParams conv;
+  TfLitePoolParams pool;
+};
+
+struct FusedFullyConnectedSoftmaxParams {
+  TfLiteFullyConnectedParams fully_connected;
+  TfLiteSoftmaxParams softmax;
+};
+
+// int8 CONV_2D without vertical padding or dilation followed by an int8
+// MAX_POOL_2D. Computes the conv rows under one pooling window at a time
+// into a scratch buffer and pools them into the output, so the conv's
+// output never exists as a whole.
+TFLMRegistration Register_CONV_2D_MAX_POOL_2D();
+
+// Most stages of a row band stack.
+constexpr int kMaxRowBandStages = 8;
+
+// A chain of fused CONV_2D + MAX_POOL_2D nodes, each feeding the next,
+// which MicroInterpreterGraph::BandOperators() replaces with a single node.
+// `stages` are the fused nodes as they were, the builtin data of each a
+// FusedConvMaxPoolParams; the stack node has the first's inputs and the
+// last's outputs, and the tensors between the stages are never allocated.
+struct RowBandParams {
+  // The first stage's builtin data, so the node still reads as a CONV_2D.
+  FusedConvMaxPoolParams first;
+  int num_stages;
+  TfLiteNode stages[kMaxRowBandStages];
+};
+
+// Runs the stages of a RowBandParams one output row at a time, MCUNetV2
+// style: an output row of the last stage pulls the rows of the previous
+// stage's output under it, and so on up to the input, and each stage keeps
+// only a window of the input rows its next output row needs, which slides
+// down the tensor. The stages' outputs never exist as a whole; the stack
+// needs the windows, one band and one esp-nn scratch buffer for all stages.
+// The output is the same as running the stages one after the other. Every
+// stage runs on one worker (see parallel.h).
+TFLMRegistration Register_ROW_BAND_STACK();
+
+// Fused CONV_2D + MAX_POOL_2D stages from the start of the graph that
+// AllocateTensors() turns into a row band stack, up to kMaxRowBandStages;
+// 0 or 1 (a fused node already bands its own conv output) leave the graph
+// as it is. 0 by default. Set it before AllocateTensors().
+void SetRowBandStages(int stages);
+int GetRowBandStages();
+
+// Persistent arena a row band stack of `stages` stages takes on top of the
+// stages' own allocations: its RowBandParams, its RowBandData, the NodeData
+// RowBandPrepare() sets up for every stage and the handles of its three
+// scratch buffers.
+size_t RowBandPersistentBytes(int stages);
+
+// int8 FULLY_CONNECTED followed by an int8 SOFTMAX. The logits go to a
+// scratch buffer the softmax reads back while still in cache.
+TFLMRegistration Register_FULLY_CONNECTED_SOFTMAX();
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_FUSION_H_
@@ -30,10 +30,6 @@ limitations under the License.
 #include <esp_nn.h>
 #endif
 
-#include <esp_timer.h>
-
-long long mul_total_time = 0;
-
 namespace tflite {
 #if ESP_NN
 void MulEvalQuantized(TfLiteContext* context, TfLiteNode* node,
@@ -92,7 +88,6 @@ TfLiteStatus MulEval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteEvalTensor* output =
       tflite::micro::GetEvalOutput(context, node, kMulOutputTensor);
 
-  long long start_time = esp_timer_get_time();
   switch (input1->type) {
     case kTfLiteInt8:
 #if ESP_NN
@@ -114,7 +109,6 @@ TfLiteStatus MulEval(TfLiteContext* context, TfLiteNode* node) {
                   TfLiteTypeGetName(input1->type), input1->type);
       return kTfLiteError;
   }
-  mul_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
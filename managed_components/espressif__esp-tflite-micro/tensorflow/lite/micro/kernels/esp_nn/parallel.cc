@@ -0,0 +1,54 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+
+#include <algorithm>
+
+namespace tflite {
+namespace {
+
+void RunOnCaller(void (*task)(int worker, void* arg), void* arg, void* user) {
+  task(0, arg);
+}
+
+const ParallelExecutor kSingleWorker = {1, RunOnCaller, nullptr};
+
+const ParallelExecutor* parallel_executor = &kSingleWorker;
+
+// About what it costs to wake up a task on the other core of an ESP32-S3
+// and wait for it, in MACs of the optimized kernels.
+int64_t parallel_min_macs = 100000;
+
+}  // namespace
+
+void SetParallelExecutor(const ParallelExecutor* executor) {
+  parallel_executor = executor != nullptr ? executor : &kSingleWorker;
+}
+
+const ParallelExecutor& GetParallelExecutor() { return *parallel_executor; }
+
+void SetParallelMinMacs(int64_t macs) { parallel_min_macs = macs; }
+
+int64_t GetParallelMinMacs() { return parallel_min_macs; }
+
+int ParallelWorkers(int64_t macs, int units) {
+  if (macs < parallel_min_macs) {
+    return 1;
+  }
+  return std::max(1, std::min(parallel_executor->workers, units));
+}
+
+}  // namespace tflite
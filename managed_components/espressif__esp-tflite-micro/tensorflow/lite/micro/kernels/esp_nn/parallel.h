@@ -0,0 +1,100 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
+
+#include <cstdint>
+
+namespace tflite {
+
+// Intra-op parallelism for the esp_nn int8 kernels.
+//
+// With a ParallelExecutor of more than one worker installed, every CONV_2D
+// (fused with a MAX_POOL_2D or not), DEPTHWISE_CONV_2D, MAX_POOL_2D,
+// AVERAGE_POOL_2D and FULLY_CONNECTED layer of at least GetParallelMinMacs()
+// multiply-accumulates is split across the workers: convs and pools by
+// output rows, fully connected layers by output channels. Every worker of a
+// conv or depthwise conv gets its own esp-nn scratch buffer, and of a fused
+// conv its own band buffer, from the arena. The parts don't overlap, so the
+// output is the same as with one worker.
+//
+// Convs with vertical padding, whose row bands the optimized kernels would
+// pad differently, stay on one worker.
+//
+// The executor is the application's: on a dual-core chip a task pinned to
+// the other core, on the host any number of threads.
+struct ParallelExecutor {
+  // Workers, the calling thread included.
+  int workers;
+  // Runs task(worker, arg) once for every worker in [0, workers), worker 0
+  // on the calling thread, and returns once all of them have returned.
+  void (*run)(void (*task)(int worker, void* arg), void* arg, void* user);
+  void* user;
+};
+
+// Installs `executor`, which must outlive every interpreter using it, or the
+// default single worker if nullptr. Convs and depthwise convs size their
+// buffers for the workers there are at Prepare(), so set it before
+// AllocateTensors().
+void SetParallelExecutor(const ParallelExecutor* executor);
+const ParallelExecutor& GetParallelExecutor();
+
+// Layers of fewer MACs run on one worker, since waking the others up costs
+// more than they save. Set it before AllocateTensors().
+void SetParallelMinMacs(int64_t macs);
+int64_t GetParallelMinMacs();
+
+// Workers to split a layer of `macs` MACs and `units` output rows or
+// channels across: 1 for a small layer, at most one per unit.
+int ParallelWorkers(int64_t macs, int units);
+
+// Calls fn(worker, begin, end) for `workers` contiguous parts of the units
+// [0, units), on the workers of the executor, and returns once every part is
+// done. `workers` is what ParallelWorkers() returned, at most the executor's.
+template <typename Fn>
+void ParallelFor(int workers, int units, const Fn& fn) {
+  const ParallelExecutor& executor = GetParallelExecutor();
+  if (workers > executor.workers) {
+    workers = executor.workers;
+  }
+  if (workers <= 1) {
+    fn(0, 0, units);
+    return;
+  }
+  struct Parts {
+    const Fn* fn;
+    int workers;
+    int units;
+  };
+  Parts parts = {&fn, workers, units};
+  executor.run(
+      [](int worker, void* arg) {
+        const Parts& parts = *static_cast<const Parts*>(arg);
+        if (worker >= parts.workers) {
+          return;
+        }
+        const int begin = parts.units * worker / parts.workers;
+        const int end = parts.units * (worker + 1) / parts.workers;
+        if (begin < end) {
+          (*parts.fn)(worker, begin, end);
+        }
+      },
+      &parts, executor.user);
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
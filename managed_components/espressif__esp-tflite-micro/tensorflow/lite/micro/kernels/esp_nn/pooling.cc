@@ -22,21 +22,32 @@ limitations under the License.
 
 #if ESP_NN
 #include <esp_nn.h>
-#endif
 
-#include <esp_timer.h>
+#include <algorithm>
 
-long long pooling_total_time = 0;
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+#endif
 
 namespace tflite {
 
 namespace {
 #if ESP_NN
-void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
-                          const TfLitePoolParams* params, const OpDataPooling* data,
-                          const TfLiteEvalTensor* input,
-                          TfLiteEvalTensor* output) {
-
+// An esp-nn int8 pooling kernel, esp_nn_avg_pool_s8() or esp_nn_max_pool_s8().
+typedef void (*PoolKernel)(const int8_t* input, uint16_t input_wd,
+                           uint16_t input_ht, int8_t* output,
+                           uint16_t output_wd, uint16_t output_ht,
+                           uint16_t stride_wd, uint16_t stride_ht,
+                           uint16_t filter_wd, uint16_t filter_ht,
+                           uint16_t pad_wd, uint16_t pad_ht,
+                           int32_t activation_min, int32_t activation_max,
+                           uint16_t channels);
+
+// Runs `pool` on every batch, split by output rows across the workers (see
+// parallel.h). A band of output rows pools the input rows from the first
+// one under its windows on, with what is left of the padding above them.
+void EvalQuantized(PoolKernel pool, const TfLitePoolParams* params,
+                   const OpDataPooling* data, const TfLiteEvalTensor* input,
+                   TfLiteEvalTensor* output) {
   const int stride_height = params->stride_height;
   const int stride_width = params->stride_width;
   const int filter_height = params->filter_height;
@@ -63,85 +74,42 @@ void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
 
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
-
-  if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_avg_pool_s8(input_data, input_width, input_height,
-                         output_data, output_width, output_height,
-                         stride_width, stride_height,
-                         filter_width, filter_height,
-                         pad_width, pad_height,
-                         activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
-  } else {
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_avg_pool_s8_ansi(input_data, input_width, input_height,
-                              output_data, output_width, output_height,
-                              stride_width, stride_height,
-                              filter_width, filter_height,
-                              pad_width, pad_height,
-                              activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
+  const int workers = ParallelWorkers(
+      static_cast<int64_t>(output_size) * filter_height * filter_width,
+      output_height);
+  for (int batch = 0; batch < batches; ++batch) {
+    auto pool_rows = [&](int worker, int begin, int end) {
+      const int window_y = begin * stride_height - pad_height;
+      const int input_y = std::max(window_y, 0);
+      pool(input_data + input_y * input_width * depth, input_width,
+           input_height - input_y, output_data + begin * output_width * depth,
+           output_width, end - begin, stride_width, stride_height,
+           filter_width, filter_height, pad_width, input_y - window_y,
+           activation_min, activation_max, depth);
+    };
+    ParallelFor(workers, output_height, pool_rows);
+    input_data += input_size;
+    output_data += output_size;
   }
 }
 
+void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
+                          const TfLitePoolParams* params, const OpDataPooling* data,
+                          const TfLiteEvalTensor* input,
+                          TfLiteEvalTensor* output) {
+  const int depth = tflite::micro::GetTensorShape(input).Dims(3);
+  // S3 version only supports channels multiple of 4
+  EvalQuantized(depth % 4 == 0 ? esp_nn_avg_pool_s8 : esp_nn_avg_pool_s8_ansi,
+                params, data, input, output);
+}
+
 void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
                       TfLitePoolParams* params, const OpDataPooling* data,
                       const TfLiteEvalTensor* input, TfLiteEvalTensor* output) {
-
-  const int stride_height = params->stride_height;
-  const int stride_width = params->stride_width;
-  const int filter_height = params->filter_height;
-  const int filter_width = params->filter_width;
-  const int activation_min = data->activation_min;
-  const int activation_max = data->activation_max;
-  const int pad_height = data->padding.height;
-  const int pad_width = data->padding.width;
-
-  const RuntimeShape& input_shape = tflite::micro::GetTensorShape(input);
-  const RuntimeShape& output_shape = tflite::micro::GetTensorShape(output);
-  TFLITE_DCHECK_LE(activation_min, activation_max);
-  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
-  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
-  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
-  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
-  const int input_height = input_shape.Dims(1);
-  const int input_width = input_shape.Dims(2);
-  const int output_height = output_shape.Dims(1);
-  const int output_width = output_shape.Dims(2);
-
-  const int8_t *input_data = tflite::micro::GetTensorData<int8_t>(input);
-  int8_t *output_data = tflite::micro::GetTensorData<int8_t>(output);
-
-  const int input_size = input_width * input_height * depth;
-  const int output_size = output_width * output_height * depth;
-  if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_max_pool_s8(input_data, input_width, input_height,
-                         output_data, output_width, output_height,
-                         stride_width, stride_height,
-                         filter_width, filter_height,
-                         pad_width, pad_height,
-                         activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
-  } else {
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_max_pool_s8_ansi(input_data, input_width, input_height,
-                              output_data, output_width, output_height,
-                              stride_width, stride_height,
-                              filter_width, filter_height,
-                              pad_width, pad_height,
-                              activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
-  }
+  const int depth = tflite::micro::GetTensorShape(input).Dims(3);
+  // S3 version only supports channels multiple of 4
+  EvalQuantized(depth % 4 == 0 ? esp_nn_max_pool_s8 : esp_nn_max_pool_s8_ansi,
+                params, data, input, output);
 }
 #endif
 
@@ -158,7 +126,6 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteEvalTensor* output =
       micro::GetEvalOutput(context, node, kPoolingOutputTensor);
 
-  long long start_time = esp_timer_get_time();
   // Inputs and outputs share the same type, guaranteed by the converter.
   switch (input->type) {
     case kTfLiteFloat32:
@@ -181,7 +148,6 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
                          TfLiteTypeGetName(input->type));
       return kTfLiteError;
   }
-  pooling_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
@@ -198,7 +164,6 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteEvalTensor* output =
       micro::GetEvalOutput(context, node, kPoolingOutputTensor);
 
-  long long start_time = esp_timer_get_time();
   switch (input->type) {
     case kTfLiteFloat32:
       MaxPoolingEvalFloat(context, node, params, data, input, output);
@@ -220,7 +185,6 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
                   TfLiteTypeGetName(input->type));
       return kTfLiteError;
   }
-  pooling_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
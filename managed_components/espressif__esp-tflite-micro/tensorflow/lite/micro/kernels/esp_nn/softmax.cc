@@ -26,14 +26,10 @@ limitations under the License.
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
 
-#include <esp_timer.h>
-
 #if ESP_NN
 #include <esp_nn.h>
 #endif
 
-long long softmax_total_time = 0;
-
 namespace tflite {
 namespace {
 // Softmax parameter data that persists in user_data
@@ -105,7 +101,6 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   NodeData data = *static_cast<NodeData*>(node->user_data);
 
-  long long start_time = esp_timer_get_time();
   switch (input->type) {
     case kTfLiteFloat32: {
       tflite::reference_ops::Softmax(
@@ -125,7 +120,6 @@ static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
                          TfLiteTypeGetName(input->type), input->type);
       return kTfLiteError;
   }
-  softmax_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
@@ -0,0 +1,47 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/esp_nn/weight_stream.h"
+
+#include <cstring>
+
+namespace tflite {
+namespace {
+
+void MemcpyStart(void* dst, const void* src, size_t bytes, void* user) {
+  std::memcpy(dst, src, bytes);
+}
+
+void MemcpyWait(void* user) {}
+
+const WeightMemory kMemcpyWeightMemory = {MemcpyStart, MemcpyWait, nullptr,
+                                          nullptr};
+
+size_t weight_tile_size = 0;
+const WeightMemory* weight_memory = &kMemcpyWeightMemory;
+
+}  // namespace
+
+void SetWeightTileSize(size_t bytes) { weight_tile_size = bytes; }
+
+size_t GetWeightTileSize() { return weight_tile_size; }
+
+void SetWeightMemory(const WeightMemory* memory) {
+  weight_memory = memory != nullptr ? memory : &kMemcpyWeightMemory;
+}
+
+const WeightMemory& GetWeightMemory() { return *weight_memory; }
+
+}  // namespace tflite
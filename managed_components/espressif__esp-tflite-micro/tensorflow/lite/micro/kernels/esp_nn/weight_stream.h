@@ -0,0 +1,63 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WEIGHT_STREAM_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WEIGHT_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tflite {
+
+// Weight tiling for the esp_nn int8 FULLY_CONNECTED and CONV_2D kernels.
+//
+// With a tile size set, a fully connected layer whose filter is larger than
+// one tile asks for two tile buffers in the arena and walks its output
+// channels a tile of filter rows at a time: the rows of tile i + 1 are copied
+// into one buffer while tile i is computed from the other, so the kernel only
+// ever reads weights from arena (SRAM) memory. A convolution reuses its
+// filter for every output pixel, so one whose filter fits in the two buffers
+// copies it there whole before computing.
+//
+// The copies go through a WeightMemory. The default one is a synchronous
+// memcpy(); a target with a DMA engine, or a simulation of slow weight
+// memory, can install its own.
+struct WeightMemory {
+  // Starts copying `bytes` of weights from `src` to `dst`. May return before
+  // the copy is done.
+  void (*copy_start)(void* dst, const void* src, size_t bytes, void* user);
+  // Returns once every copy started so far is done.
+  void (*copy_wait)(void* user);
+  // Called before a kernel reads `bytes` of weights where they are, without
+  // copying them. May be nullptr; a simulated slow memory charges its
+  // latency here.
+  void (*read_in_place)(const void* src, size_t bytes, void* user);
+  void* user;
+};
+
+// Largest tile in bytes, 0 (the default) to read weights in place. Only
+// affects kernels prepared afterwards, so set it before AllocateTensors().
+// The arena needs up to 2 * bytes more, plus alignment.
+void SetWeightTileSize(size_t bytes);
+size_t GetWeightTileSize();
+
+// Installs `memory`, which must outlive every interpreter using it, or the
+// default memcpy() one if nullptr.
+void SetWeightMemory(const WeightMemory* memory);
+const WeightMemory& GetWeightMemory();
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WEIGHT_STREAM_H_
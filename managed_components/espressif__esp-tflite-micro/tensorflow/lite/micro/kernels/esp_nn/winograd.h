@@ -0,0 +1,40 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WINOGRAD_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WINOGRAD_H_
+
+namespace tflite {
+
+// Winograd F(2x2, 3x3) for the esp_nn int8 CONV_2D kernel.
+//
+// With it on, Prepare() runs every layer esp_nn_conv_winograd_supported()
+// accepts (3x3, stride 1, no padding) with esp_nn_conv_s8_winograd(): 16
+// multiplies per input channel for each 2x2 block of outputs instead of 36.
+// The output is bit-exact with the other kernels.
+//
+// The transformed filter is int16 and 4x4 instead of 3x3, 32 bytes per
+// input/output channel pair against 9, and is computed once at Prepare()
+// into a persistent arena buffer. The weight tiles and autotuning don't
+// apply to these layers.
+//
+// Off by default. Only affects kernels prepared afterwards, so set it
+// before AllocateTensors().
+void SetConvWinograd(bool enabled);
+bool GetConvWinograd();
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_WINOGRAD_H_
@@ -39,6 +39,12 @@ struct OpDataFullyConnected {
   int32_t filter_zero_point;
   int32_t output_zero_point;
 
+  // Per output channel multipliers and shifts, set when the filter has one
+  // scale per output channel instead of a single per-tensor scale.
+  bool is_per_channel;
+  int32_t* per_channel_output_multiplier;
+  int32_t* per_channel_output_shift;
+
 // TODO(b/258710417): enable by default once optimized fully-connected works for
 // all targets.
 #if !defined(HEXAGON)
@@ -57,30 +57,57 @@ TfLiteStatus CalculateOpDataFullyConnected(
     TfLiteType data_type, const TfLiteTensor* input, const TfLiteTensor* filter,
     const TfLiteTensor* bias, TfLiteTensor* output,
     OpDataFullyConnected* data) {
-  // TODO(b/324385802): Support per-channel quantization for FullyConnected.
-  // If you have hit this failure message, you will need to disable this
-  // behavior. This can be done by setting the following flag to true:
-  // TfLiteConverter._experimental_disable_per_channel_quantization_for_dense_layers
-  // https://github.com/tensorflow/tensorflow/blob/377f47694fa790e98db6665b9adecde00b5e0d68/tensorflow/lite/python/lite.py#L674
+  data->is_per_channel = false;
   if (filter->quantization.type == kTfLiteAffineQuantization &&
       filter->quantization.params != nullptr) {
     TfLiteAffineQuantization* affine_quantization =
         reinterpret_cast<TfLiteAffineQuantization*>(
             filter->quantization.params);
     TF_LITE_ENSURE(context, affine_quantization->scale);
-    TF_LITE_ENSURE_MSG(
-        context, affine_quantization->scale->size == 1,
-        "FullyConnected per-channel quantization not yet supported. Please set "
-        "converter._experimental_disable_per_channel_quantization_for_dense_"
-        "layers = True.");
+    data->is_per_channel = affine_quantization->scale->size > 1;
+  }
+
+  if (data->is_per_channel) {
+    // Only int8 activations are supported with per-channel weights, the same
+    // restriction the per-channel convolutions have.
+    TF_LITE_ENSURE_TYPES_EQ(context, data_type, kTfLiteInt8);
+    const auto* affine_quantization =
+        reinterpret_cast<TfLiteAffineQuantization*>(
+            filter->quantization.params);
+    const int num_channels = affine_quantization->scale->size;
+    TF_LITE_ENSURE_EQ(context, num_channels,
+                      filter->dims->data[affine_quantization->quantized_dimension]);
+
+    data->per_channel_output_multiplier =
+        static_cast<int32_t*>(context->AllocatePersistentBuffer(
+            context, num_channels * sizeof(int32_t)));
+    data->per_channel_output_shift =
+        static_cast<int32_t*>(context->AllocatePersistentBuffer(
+            context, num_channels * sizeof(int32_t)));
+    TF_LITE_ENSURE(context, data->per_channel_output_multiplier != nullptr &&
+                                data->per_channel_output_shift != nullptr);
+
+    const double input_scale = static_cast<double>(input->params.scale);
+    const double output_scale = static_cast<double>(output->params.scale);
+    for (int i = 0; i < num_channels; ++i) {
+      const double filter_scale =
+          static_cast<double>(affine_quantization->scale->data[i]);
+      int channel_shift;
+      QuantizeMultiplier(input_scale * filter_scale / output_scale,
+                         &data->per_channel_output_multiplier[i],
+                         &channel_shift);
+      data->per_channel_output_shift[i] = channel_shift;
+    }
   }
 
   if (data_type != kTfLiteFloat32) {
-    double real_multiplier = 0.0;
-    TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipler(
-        context, input, filter, bias, output, &real_multiplier));
-    QuantizeMultiplier(real_multiplier, &data->output_multiplier,
-                       &data->output_shift);
+    if (!data->is_per_channel) {
+      double real_multiplier = 0.0;
+      TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipler(
+          context, input, filter, bias, output, &real_multiplier));
+      QuantizeMultiplier(real_multiplier, &data->output_multiplier,
+                         &data->output_shift);
+    }
 
     // Filter weights will always be symmetric quantized since we only support
     // int8 quantization. See
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_MICRO_MEMORY_PLANNER_MEMORY_PLANNER_H_
 #define TENSORFLOW_LITE_MICRO_MICRO_MEMORY_PLANNER_MEMORY_PLANNER_H_
 
+#include <cstdint>
+
 #include "tensorflow/lite/c/common.h"
 
 namespace tflite {
@@ -71,6 +73,18 @@ class MicroMemoryPlanner {
   // Calculated layout offset for the N-th buffer added to the planner.
   virtual TfLiteStatus GetOffsetForBuffer(int buffer_index, int* offset) = 0;
 
+  // Address of the N-th buffer, given the start of the arena the allocator
+  // reserved GetMaximumMemorySize() bytes of. Planners that place buffers
+  // outside of that arena override this; by default it is `arena` plus the
+  // buffer's offset.
+  virtual TfLiteStatus GetAddressForBuffer(int buffer_index, uint8_t* arena,
+                                           uint8_t** address) {
+    int offset = -1;
+    TF_LITE_ENSURE_STATUS(GetOffsetForBuffer(buffer_index, &offset));
+    *address = arena + offset;
+    return kTfLiteOk;
+  }
+
   // Provides the scratch buffer in case that the memory planner needs it.
   // The lifetime of scratch buffers lifetime lasts until the static memory plan
   // is committed.
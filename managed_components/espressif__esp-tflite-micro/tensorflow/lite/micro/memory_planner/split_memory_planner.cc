@@ -0,0 +1,186 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/memory_planner/split_memory_planner.h"
+
+#include "tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+
+SplitMemoryPlanner::SplitMemoryPlanner(size_t fast_size, uint8_t* slow,
+                                       size_t slow_size)
+    : fast_size_(fast_size), slow_(slow), slow_size_(slow_size) {}
+
+SplitMemoryPlanner::~SplitMemoryPlanner() {
+  // We don't own the scratch buffer or the slow region.
+}
+
+TfLiteStatus SplitMemoryPlanner::Init(unsigned char* scratch_buffer,
+                                      int scratch_buffer_size) {
+  scratch_buffer_ = scratch_buffer;
+  scratch_buffer_size_ = scratch_buffer_size;
+  buffer_count_ = 0;
+  need_to_calculate_placement_ = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus SplitMemoryPlanner::AddBuffer(int size, int first_time_used,
+                                           int last_time_used) {
+  if (buffer_count_ >= kMaxBufferCount) {
+    MicroPrintf("Too many buffers (max is %d)", kMaxBufferCount);
+    return kTfLiteError;
+  }
+  BufferPlacement* current = &buffers_[buffer_count_];
+  current->size = size;
+  current->first_time_used = first_time_used;
+  current->last_time_used = last_time_used;
+  current->region = kFastRegion;
+  current->placed = false;
+  current->offset = 0;
+  ++buffer_count_;
+  need_to_calculate_placement_ = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus SplitMemoryPlanner::PlanRegion(Region region, bool store_offsets,
+                                            size_t* size) {
+  TF_LITE_ENSURE_STATUS(greedy_.Init(scratch_buffer_, scratch_buffer_size_));
+  for (int i = 0; i < buffer_count_; ++i) {
+    const BufferPlacement& buffer = buffers_[i];
+    if (buffer.placed && buffer.region == region) {
+      TF_LITE_ENSURE_STATUS(greedy_.AddBuffer(
+          buffer.size, buffer.first_time_used, buffer.last_time_used));
+    }
+  }
+  *size = greedy_.GetMaximumMemorySize();
+  if (store_offsets) {
+    int greedy_index = 0;
+    for (int i = 0; i < buffer_count_; ++i) {
+      BufferPlacement& buffer = buffers_[i];
+      if (buffer.placed && buffer.region == region) {
+        TF_LITE_ENSURE_STATUS(
+            greedy_.GetOffsetForBuffer(greedy_index++, &buffer.offset));
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus SplitMemoryPlanner::CalculatePlacementIfNeeded() {
+  if (!need_to_calculate_placement_) {
+    return placement_status_;
+  }
+  need_to_calculate_placement_ = false;
+  placement_status_ = kTfLiteError;
+
+  // Offer the buffers to the fast region largest first.
+  for (int step = 0; step < buffer_count_; ++step) {
+    int largest = -1;
+    for (int i = 0; i < buffer_count_; ++i) {
+      if (!buffers_[i].placed &&
+          (largest < 0 || buffers_[i].size > buffers_[largest].size)) {
+        largest = i;
+      }
+    }
+    BufferPlacement& buffer = buffers_[largest];
+    buffer.placed = true;
+    buffer.region = kFastRegion;
+    size_t fast_size = 0;
+    TF_LITE_ENSURE_STATUS(PlanRegion(kFastRegion, false, &fast_size));
+    if (fast_size > fast_size_) {
+      buffer.region = kSlowRegion;
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(PlanRegion(kFastRegion, true, &fast_used_));
+  TF_LITE_ENSURE_STATUS(PlanRegion(kSlowRegion, true, &slow_used_));
+  if (slow_used_ > slow_size_) {
+    MicroPrintf("Split plan needs %d bytes of slow memory, only %d provided",
+                static_cast<int>(slow_used_), static_cast<int>(slow_size_));
+    return kTfLiteError;
+  }
+  placement_status_ = kTfLiteOk;
+  return kTfLiteOk;
+}
+
+size_t SplitMemoryPlanner::GetMaximumMemorySize() {
+  if (CalculatePlacementIfNeeded() != kTfLiteOk) {
+    return 0;
+  }
+  return fast_used_;
+}
+
+size_t SplitMemoryPlanner::GetSlowMemorySize() {
+  if (CalculatePlacementIfNeeded() != kTfLiteOk) {
+    return 0;
+  }
+  return slow_used_;
+}
+
+int SplitMemoryPlanner::GetBufferCount() { return buffer_count_; }
+
+TfLiteStatus SplitMemoryPlanner::GetOffsetForBuffer(int buffer_index,
+                                                    int* offset) {
+  TF_LITE_ENSURE_STATUS(CalculatePlacementIfNeeded());
+  if ((buffer_index < 0) || (buffer_index >= buffer_count_)) {
+    MicroPrintf("buffer index %d is outside range 0 to %d", buffer_index,
+                buffer_count_);
+    return kTfLiteError;
+  }
+  *offset = buffers_[buffer_index].offset;
+  return kTfLiteOk;
+}
+
+TfLiteStatus SplitMemoryPlanner::GetAddressForBuffer(int buffer_index,
+                                                     uint8_t* arena,
+                                                     uint8_t** address) {
+  int offset = 0;
+  TF_LITE_ENSURE_STATUS(GetOffsetForBuffer(buffer_index, &offset));
+  uint8_t* base =
+      buffers_[buffer_index].region == kFastRegion ? arena : slow_;
+  *address = base + offset;
+  return kTfLiteOk;
+}
+
+TfLiteStatus SplitMemoryPlanner::GetRegionForBuffer(int buffer_index,
+                                                    Region* region) {
+  TF_LITE_ENSURE_STATUS(CalculatePlacementIfNeeded());
+  if ((buffer_index < 0) || (buffer_index >= buffer_count_)) {
+    MicroPrintf("buffer index %d is outside range 0 to %d", buffer_index,
+                buffer_count_);
+    return kTfLiteError;
+  }
+  *region = buffers_[buffer_index].region;
+  return kTfLiteOk;
+}
+
+void SplitMemoryPlanner::PrintMemoryPlan() {
+  if (CalculatePlacementIfNeeded() != kTfLiteOk) {
+    MicroPrintf("No valid split plan");
+    return;
+  }
+  MicroPrintf("Split plan: %d bytes fast (limit %d), %d bytes slow (limit %d)",
+              static_cast<int>(fast_used_), static_cast<int>(fast_size_),
+              static_cast<int>(slow_used_), static_cast<int>(slow_size_));
+  for (int i = 0; i < buffer_count_; ++i) {
+    const BufferPlacement& buffer = buffers_[i];
+    MicroPrintf("buffer %d: size=%d, first_used=%d last_used=%d, %s offset=%d",
+                i, buffer.size, buffer.first_time_used, buffer.last_time_used,
+                buffer.region == kFastRegion ? "fast" : "slow",
+                buffer.offset);
+  }
+}
+
+}  // namespace tflite
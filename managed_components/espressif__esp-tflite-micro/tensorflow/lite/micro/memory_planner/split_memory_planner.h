@@ -0,0 +1,113 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_MEMORY_PLANNER_SPLIT_MEMORY_PLANNER_H_
+#define TENSORFLOW_LITE_MICRO_MEMORY_PLANNER_SPLIT_MEMORY_PLANNER_H_
+
+#include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/memory_planner/micro_memory_planner.h"
+
+namespace tflite {
+
+// A memory planner that spreads the non-persistent buffers over two memory
+// regions: the allocator's head, which is meant to live in fast memory (e.g.
+// internal SRAM) and is limited to `fast_size` bytes, and a caller-provided
+// `slow` region (e.g. PSRAM) for whatever doesn't fit.
+//
+// Buffers are offered to the fast region largest first, and each one is kept
+// there if the greedy plan of the fast region still fits in `fast_size` with
+// it. Activations are each written once and read by the next op, so memory
+// traffic grows with buffer size and this keeps as many bytes of traffic in
+// fast memory as the greedy packing allows. Both regions are then laid out
+// with the GreedyMemoryPlanner, so buffers of either region still share
+// memory when their lifetimes don't overlap.
+//
+// The placement is kept in the planner, so it can be reported after the plan
+// is committed. Offline planned buffers are not supported.
+class SplitMemoryPlanner : public MicroMemoryPlanner {
+ public:
+  enum Region { kFastRegion = 0, kSlowRegion = 1 };
+
+  SplitMemoryPlanner(size_t fast_size, uint8_t* slow, size_t slow_size);
+  ~SplitMemoryPlanner() override;
+
+  TfLiteStatus Init(unsigned char* scratch_buffer,
+                    int scratch_buffer_size) override;
+
+  TfLiteStatus AddBuffer(int size, int first_time_used,
+                         int last_time_used) override;
+
+  // Size of the fast region's plan, which is what the allocator reserves in
+  // its head.
+  size_t GetMaximumMemorySize() override;
+  int GetBufferCount() override;
+
+  // Offset of a buffer within its region.
+  TfLiteStatus GetOffsetForBuffer(int buffer_index, int* offset) override;
+  TfLiteStatus GetAddressForBuffer(int buffer_index, uint8_t* arena,
+                                   uint8_t** address) override;
+
+  // Region a buffer was placed in.
+  TfLiteStatus GetRegionForBuffer(int buffer_index, Region* region);
+
+  // Bytes of the slow region the plan uses.
+  size_t GetSlowMemorySize();
+
+  bool preserves_all_tensors() const override { return false; }
+
+  // Prints one line per buffer with its size, lifetime, region and offset.
+  void PrintMemoryPlan() override;
+
+ private:
+  static constexpr int kMaxBufferCount = 256;
+
+  struct BufferPlacement {
+    int size;
+    int first_time_used;
+    int last_time_used;
+    Region region;
+    bool placed;
+    int offset;
+  };
+
+  // Lays out the placed buffers of `region` with `greedy_` and returns the
+  // size of the plan, storing the buffers' offsets if `store_offsets`.
+  TfLiteStatus PlanRegion(Region region, bool store_offsets, size_t* size);
+
+  // If there isn't an up to date plan, calculate a new one.
+  TfLiteStatus CalculatePlacementIfNeeded();
+
+  const size_t fast_size_;
+  uint8_t* const slow_;
+  const size_t slow_size_;
+
+  unsigned char* scratch_buffer_ = nullptr;
+  int scratch_buffer_size_ = 0;
+  GreedyMemoryPlanner greedy_;
+
+  BufferPlacement buffers_[kMaxBufferCount];
+  int buffer_count_ = 0;
+  size_t fast_used_ = 0;
+  size_t slow_used_ = 0;
+  bool need_to_calculate_placement_ = true;
+  TfLiteStatus placement_status_ = kTfLiteOk;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_MEMORY_PLANNER_SPLIT_MEMORY_PLANNER_H_
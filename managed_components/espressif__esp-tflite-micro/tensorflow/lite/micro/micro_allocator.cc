@@ -125,10 +125,10 @@ TfLiteStatus CommitPlan(MicroMemoryPlanner* planner, uint8_t* starting_point,
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
     if (current->needs_allocating) {
-      int offset = -1;
-      TF_LITE_ENSURE_STATUS(
-          planner->GetOffsetForBuffer(planner_index, &offset));
-      *current->output_ptr = reinterpret_cast<void*>(starting_point + offset);
+      uint8_t* address = nullptr;
+      TF_LITE_ENSURE_STATUS(planner->GetAddressForBuffer(
+          planner_index, starting_point, &address));
+      *current->output_ptr = reinterpret_cast<void*>(address);
       ++planner_index;
     }
   }
@@ -469,6 +469,33 @@ MicroAllocator* MicroAllocator::Create(uint8_t* persistent_tensor_arena,
   return allocator;
 }
 
+MicroAllocator* MicroAllocator::Create(uint8_t* persistent_tensor_arena,
+                                       size_t persistent_arena_size,
+                                       uint8_t* non_persistent_tensor_arena,
+                                       size_t non_persistent_arena_size,
+                                       MicroMemoryPlanner* memory_planner) {
+  TFLITE_DCHECK(persistent_tensor_arena != nullptr);
+  TFLITE_DCHECK(non_persistent_tensor_arena != nullptr);
+  TFLITE_DCHECK(persistent_tensor_arena != non_persistent_tensor_arena);
+  TFLITE_DCHECK(memory_planner != nullptr);
+
+  IPersistentBufferAllocator* persistent_buffer_allocator =
+      CreatePersistentArenaAllocator(persistent_tensor_arena,
+                                     persistent_arena_size);
+  INonPersistentBufferAllocator* non_persistent_buffer_allocator =
+      CreateNonPersistentArenaAllocator(non_persistent_tensor_arena,
+                                        non_persistent_arena_size,
+                                        persistent_buffer_allocator);
+
+  uint8_t* micro_allocator_buffer =
+      persistent_buffer_allocator->AllocatePersistentBuffer(
+          sizeof(MicroAllocator), alignof(MicroAllocator));
+  MicroAllocator* allocator = new (micro_allocator_buffer)
+      MicroAllocator(persistent_buffer_allocator,
+                     non_persistent_buffer_allocator, memory_planner);
+  return allocator;
+}
+
 SubgraphAllocations* MicroAllocator::StartModelAllocation(const Model* model) {
   TFLITE_DCHECK(model != nullptr);
 
@@ -611,6 +638,14 @@ size_t MicroAllocator::used_bytes() const {
          persistent_buffer_allocator_->GetPersistentUsedBytes();
 }
 
+size_t MicroAllocator::persistent_used_bytes() const {
+  return persistent_buffer_allocator_->GetPersistentUsedBytes();
+}
+
+size_t MicroAllocator::non_persistent_used_bytes() const {
+  return non_persistent_buffer_allocator_->GetNonPersistentUsedBytes();
+}
+
 TfLiteStatus MicroAllocator::AllocateNodeAndRegistrations(
     const Model* model, SubgraphAllocations* subgraph_allocations) {
   TFLITE_DCHECK(subgraph_allocations != nullptr);
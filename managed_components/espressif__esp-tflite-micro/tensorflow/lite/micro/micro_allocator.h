@@ -151,6 +151,15 @@ class MicroAllocator {
       uint8_t* non_persistent_tensor_arena, size_t non_persistent_arena_size,
       MemoryPlannerType memory_planner_type = MemoryPlannerType::kGreedy);
 
+  // Creates a MicroAllocator instance with separate persistent and
+  // non-persistent arenas that plans the non-persistent arena with the given
+  // MemoryPlanner, which is not placed in either arena.
+  static MicroAllocator* Create(uint8_t* persistent_tensor_arena,
+                                size_t persistent_arena_size,
+                                uint8_t* non_persistent_tensor_arena,
+                                size_t non_persistent_arena_size,
+                                MicroMemoryPlanner* memory_planner);
+
   // Returns the fixed amount of memory overhead of MicroAllocator.
   static size_t GetDefaultTailUsage(bool is_memory_planner_given);
 
@@ -235,8 +244,9 @@ class MicroAllocator {
   // This method only requests a buffer with a given size to be used after a
   // model has finished allocation via FinishModelAllocation(). All requested
   // buffers will be accessible by the out-param in that method.
-  TfLiteStatus RequestScratchBufferInArena(size_t bytes, int subgraph_idx,
-                                           int* buffer_idx);
+  virtual TfLiteStatus RequestScratchBufferInArena(size_t bytes,
+                                                   int subgraph_idx,
+                                                   int* buffer_idx);
 
   // Finish allocating a specific NodeAndRegistration prepare block (kernel
   // entry for a model) with a given node ID. This call ensures that any scratch
@@ -248,6 +258,10 @@ class MicroAllocator {
   // `FinishModelAllocation`. Otherwise, it will return 0.
   size_t used_bytes() const;
 
+  // The persistent (tail) and non-persistent (head) parts of used_bytes().
+  size_t persistent_used_bytes() const;
+  size_t non_persistent_used_bytes() const;
+
   TfLiteBridgeBuiltinDataAllocator* GetBuiltinDataAllocator();
 
  protected:
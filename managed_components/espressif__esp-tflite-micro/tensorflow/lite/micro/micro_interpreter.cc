@@ -59,6 +59,7 @@ MicroInterpreter::MicroInterpreter(const Model* model,
       tensors_allocated_(false),
       initialization_status_(kTfLiteError),
       input_tensors_(nullptr),
+      input_arena_data_(nullptr),
       output_tensors_(nullptr),
       micro_context_(&allocator_, model_, &graph_) {
   Init(profiler);
@@ -76,6 +77,7 @@ MicroInterpreter::MicroInterpreter(const Model* model,
       tensors_allocated_(false),
       initialization_status_(kTfLiteError),
       input_tensors_(nullptr),
+      input_arena_data_(nullptr),
       output_tensors_(nullptr),
       micro_context_(&allocator_, model_, &graph_) {
   Init(profiler);
@@ -207,8 +209,11 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
   }
 
   graph_.SetSubgraphAllocations(allocations);
+  TF_LITE_ENSURE_STATUS(BatchActivations(allocations));
 
   TF_LITE_ENSURE_STATUS(PrepareNodeAndRegistrationDataFromFlatbuffer());
+  TF_LITE_ENSURE_STATUS(graph_.FuseOperators());
+  TF_LITE_ENSURE_STATUS(graph_.BandOperators());
 
   micro_context_.SetInterpreterState(
       MicroInterpreterContext::InterpreterState::kInit);
@@ -228,6 +233,8 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
 
   micro_context_.SetScratchBufferHandles(scratch_buffer_handles_);
 
+  TF_LITE_ENSURE_STATUS(graph_.FoldInputQuantize());
+
   // TODO(b/162311891): Drop these allocations when the interpreter supports
   // handling buffers from TfLiteEvalTensor.
   input_tensors_ =
@@ -241,6 +248,16 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
     return kTfLiteError;
   }
 
+  input_arena_data_ = reinterpret_cast<void**>(
+      allocator_.AllocatePersistentBuffer(sizeof(void*) * inputs_size()));
+  if (input_arena_data_ == nullptr) {
+    MicroPrintf(
+        "Failed to allocate memory for context->input_arena_data_, "
+        "%d bytes required",
+        sizeof(void*) * inputs_size());
+    return kTfLiteError;
+  }
+
   for (size_t i = 0; i < inputs_size(); ++i) {
     input_tensors_[i] = allocator_.AllocatePersistentTfLiteTensor(
         model_, graph_.GetAllocations(), inputs().Get(i), 0);
@@ -248,6 +265,7 @@ TfLiteStatus MicroInterpreter::AllocateTensors() {
       MicroPrintf("Failed to initialize input tensor %d", i);
       return kTfLiteError;
     }
+    input_arena_data_[i] = input_tensors_[i]->data.data;
   }
 
   // TODO(b/162311891): Drop these allocations when the interpreter supports
@@ -303,6 +321,67 @@ TfLiteTensor* MicroInterpreter::input(size_t index) {
   return input_tensors_[index];
 }
 
+TfLiteStatus MicroInterpreter::SetBatchSize(int batch_size) {
+  if (tensors_allocated_) {
+    MicroPrintf("SetBatchSize() called after AllocateTensors()");
+    return kTfLiteError;
+  }
+  if (batch_size < 1) {
+    MicroPrintf("Batch size %d is less than 1", batch_size);
+    return kTfLiteError;
+  }
+  batch_size_ = batch_size;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::BatchActivations(
+    SubgraphAllocations* allocations) {
+  if (batch_size_ == 1) {
+    return kTfLiteOk;
+  }
+  for (size_t subgraph_idx = 0; subgraph_idx < model_->subgraphs()->size();
+       ++subgraph_idx) {
+    const size_t tensors_size =
+        model_->subgraphs()->Get(subgraph_idx)->tensors()->size();
+    for (size_t i = 0; i < tensors_size; ++i) {
+      // Constant tensors already point at their flatbuffer data.
+      TfLiteEvalTensor& tensor = allocations[subgraph_idx].tensors[i];
+      if (tensor.data.data != nullptr || tensor.dims->size == 0 ||
+          tensor.dims->data[0] != 1) {
+        continue;
+      }
+      // The dims point into the flatbuffer, which is read-only.
+      TfLiteIntArray* dims =
+          static_cast<TfLiteIntArray*>(allocator_.AllocatePersistentBuffer(
+              TfLiteIntArrayGetSizeInBytes(tensor.dims->size)));
+      TF_LITE_ENSURE(&context_, dims != nullptr);
+      dims->size = tensor.dims->size;
+      for (int d = 0; d < dims->size; ++d) {
+        dims->data[d] = tensor.dims->data[d];
+      }
+      dims->data[0] = batch_size_;
+      tensor.dims = dims;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::SetInputBuffer(size_t index, void* buffer) {
+  if (!tensors_allocated_) {
+    MicroPrintf("SetInputBuffer() called before AllocateTensors()");
+    return kTfLiteError;
+  }
+  const size_t length = inputs_size();
+  if (index >= length) {
+    MicroPrintf("Input index %d out of range (length is %d)", index, length);
+    return kTfLiteError;
+  }
+  void* data = buffer != nullptr ? buffer : input_arena_data_[index];
+  TF_LITE_ENSURE_STATUS(graph_.SetSubgraphInputData(0, index, data));
+  input_tensors_[index]->data.data = data;
+  return kTfLiteOk;
+}
+
 TfLiteTensor* MicroInterpreter::output(size_t index) {
   const size_t length = outputs_size();
   if (index >= length) {
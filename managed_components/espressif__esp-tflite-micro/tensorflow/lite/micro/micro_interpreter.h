@@ -69,6 +69,16 @@ class MicroInterpreter {
   // intermediate tensors.
   TfLiteStatus AllocateTensors();
 
+  // Makes every Invoke() evaluate `batch_size` inputs at once: the leading
+  // dimension of every activation tensor of 1 becomes `batch_size`, inputs
+  // and outputs included, so input(0) holds the inputs back to back and
+  // output(0) their results. The kernels loop over the batch inside each
+  // weight tile, reading every weight once per Invoke() rather than once
+  // per input. Activations take `batch_size` times the arena, scratch
+  // buffers don't. Must be called before AllocateTensors().
+  TfLiteStatus SetBatchSize(int batch_size);
+  int batch_size() const { return batch_size_; }
+
   // In order to support partial graph runs for strided models, this can return
   // values other than kTfLiteOk and kTfLiteError.
   // TODO(b/149795762): Add this to the TfLiteStatus enum.
@@ -81,6 +91,13 @@ class MicroInterpreter {
   TfLiteStatus SetMicroExternalContext(void* external_context_payload);
 
   TfLiteTensor* input(size_t index);
+
+  // Points input `index` at a caller-owned buffer instead of its arena
+  // allocation, so e.g. a camera frame can be inferred on without copying it.
+  // The buffer must match the tensor's size and stay valid and unmodified
+  // for the duration of Invoke(). Passing nullptr restores the arena buffer.
+  // Only valid after AllocateTensors().
+  TfLiteStatus SetInputBuffer(size_t index, void* buffer);
   size_t inputs_size() const {
     return model_->subgraphs()->Get(0)->inputs()->size();
   }
@@ -155,6 +172,9 @@ class MicroInterpreter {
   // error reporting during initialization.
   void Init(MicroProfilerInterface* profiler);
 
+  // Sets the leading dimension of the activations, see SetBatchSize.
+  TfLiteStatus BatchActivations(SubgraphAllocations* allocations);
+
   // Gets the current subgraph index used from within context methods.
   int get_subgraph_index() { return graph_.GetCurrentSubgraphIndex(); }
 
@@ -164,6 +184,7 @@ class MicroInterpreter {
   MicroAllocator& allocator_;
   MicroInterpreterGraph graph_;
   bool tensors_allocated_;
+  int batch_size_ = 1;
 
   TfLiteStatus initialization_status_;
 
@@ -172,6 +193,7 @@ class MicroInterpreter {
   // TODO(b/162311891): Clean these pointers up when this class supports buffers
   // from TfLiteEvalTensor.
   TfLiteTensor** input_tensors_;
+  void** input_arena_data_;
   TfLiteTensor** output_tensors_;
 
   MicroInterpreterContext micro_context_;
@@ -15,10 +15,16 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/micro_interpreter_graph.h"
 
+#include <cstring>
+
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 #include "tensorflow/lite/micro/flatbuffer_utils.h"
+#if ESP_NN
+#include "tensorflow/lite/micro/kernels/esp_nn/fusion.h"
+#endif
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/micro_log.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
@@ -35,6 +41,65 @@ const char* OpNameFromRegistration(const TFLMRegistration* registration) {
   }
 }
 
+#if ESP_NN
+// Invoke of a folded input QUANTIZE: the consumer reads the uint8 input as
+// is, so the node only has to move it when the input sits in the arena.
+TfLiteStatus FoldedQuantizeEval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      context->GetEvalTensor(context, node->inputs->data[0]);
+  TfLiteEvalTensor* output =
+      context->GetEvalTensor(context, node->outputs->data[0]);
+  if (output->data.data != input->data.data) {
+    size_t bytes;
+    TF_LITE_ENSURE_STATUS(TfLiteEvalTensorByteLength(input, &bytes));
+    memcpy(output->data.data, input->data.data, bytes);
+  }
+  return kTfLiteOk;
+}
+
+bool SingleZeroPoint(const Tensor* tensor, float* scale, int64_t* zero_point) {
+  const QuantizationParameters* quantization = tensor->quantization();
+  if (quantization == nullptr || quantization->scale() == nullptr ||
+      quantization->zero_point() == nullptr ||
+      quantization->scale()->size() != 1 ||
+      quantization->zero_point()->size() != 1) {
+    return false;
+  }
+  *scale = quantization->scale()->Get(0);
+  *zero_point = quantization->zero_point()->Get(0);
+  return true;
+}
+
+// Invoke of a node fused into the one before it.
+TfLiteStatus ElidedEval(TfLiteContext* context, TfLiteNode* node) {
+  return kTfLiteOk;
+}
+
+bool Contains(const TfLiteIntArray* indices, int32_t index) {
+  if (indices == nullptr) {
+    return false;
+  }
+  for (int i = 0; i < indices->size; ++i) {
+    if (indices->data[i] == index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Contains(const flatbuffers::Vector<int32_t>* indices, int32_t index) {
+  if (indices == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < indices->size(); ++i) {
+    if (indices->Get(i) == index) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
 }  // namespace
 
 MicroInterpreterGraph::MicroInterpreterGraph(
@@ -186,7 +251,7 @@ TfLiteStatus MicroInterpreterGraph::InvokeSubgraph(int subgraph_idx) {
 // only defined for builds with the error strings.
 #if !defined(TF_LITE_STRIP_ERROR_STRINGS)
     ScopedMicroProfiler scoped_profiler(
-        OpNameFromRegistration(registration),
+        OpNameFromRegistration(registration), subgraph_idx, i,
         reinterpret_cast<MicroProfilerInterface*>(context_->profiler));
 #endif
 
@@ -242,6 +307,307 @@ int MicroInterpreterGraph::NumSubgraphs() {
   return model_->subgraphs()->size();
 }
 
+TfLiteStatus MicroInterpreterGraph::SetSubgraphInputData(int subgraph_idx,
+                                                         int input_idx,
+                                                         void* data) {
+  TfLiteEvalTensor* input = GetSubgraphInput(subgraph_idx, input_idx);
+  input->data.data = data;
+  if (input == folded_input_) {
+    folded_output_->data.data =
+        data == folded_input_arena_data_ ? folded_output_arena_data_ : data;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::FoldInputQuantize() {
+#if ESP_NN
+  if (folded_input_ != nullptr || subgraphs_ == nullptr ||
+      subgraphs_->size() == 0) {
+    return kTfLiteOk;
+  }
+  const SubGraph* subgraph = subgraphs_->Get(0);
+  const uint32_t operators_size = NumSubgraphOperators(subgraph);
+  for (size_t i = 0; i < operators_size; ++i) {
+    const Operator* op = subgraph->operators()->Get(i);
+    NodeAndRegistration& quantize =
+        subgraph_allocations_[0].node_and_registrations[i];
+    if (quantize.registration->builtin_code != BuiltinOperator_QUANTIZE ||
+        op->inputs()->size() != 1 || op->outputs()->size() != 1) {
+      continue;
+    }
+    const int32_t input_idx = op->inputs()->Get(0);
+    const int32_t output_idx = op->outputs()->Get(0);
+    if (!Contains(subgraph->inputs(), input_idx) ||
+        Contains(subgraph->outputs(), output_idx)) {
+      continue;
+    }
+    const Tensor* input = subgraph->tensors()->Get(input_idx);
+    const Tensor* output = subgraph->tensors()->Get(output_idx);
+    float input_scale, output_scale;
+    int64_t input_zero_point, output_zero_point;
+    if (input->type() != TensorType_UINT8 ||
+        output->type() != TensorType_INT8 ||
+        !SingleZeroPoint(input, &input_scale, &input_zero_point) ||
+        !SingleZeroPoint(output, &output_scale, &output_zero_point) ||
+        input_scale != output_scale ||
+        output_zero_point != input_zero_point - 128) {
+      continue;
+    }
+
+    // The quantized tensor must feed exactly one dilation-free CONV_2D with
+    // int8 weights, the only consumer that knows how to read uint8.
+    int consumer = -1;
+    int num_consumers = 0;
+    for (size_t j = 0; j < operators_size; ++j) {
+      if (Contains(subgraph->operators()->Get(j)->inputs(), output_idx)) {
+        consumer = j;
+        num_consumers++;
+      }
+    }
+    if (num_consumers != 1) {
+      continue;
+    }
+    const Operator* conv_op = subgraph->operators()->Get(consumer);
+    const NodeAndRegistration& conv =
+        subgraph_allocations_[0].node_and_registrations[consumer];
+    const TfLiteConvParams* params =
+        static_cast<const TfLiteConvParams*>(conv.node.builtin_data);
+    if (conv.registration->builtin_code != BuiltinOperator_CONV_2D ||
+        conv_op->inputs()->Get(0) != output_idx || params == nullptr ||
+        params->dilation_width_factor != 1 ||
+        params->dilation_height_factor != 1 ||
+        subgraph->tensors()->Get(conv_op->inputs()->Get(1))->type() !=
+            TensorType_INT8) {
+      continue;
+    }
+
+    folded_quantize_registration_ = *quantize.registration;
+    folded_quantize_registration_.invoke = FoldedQuantizeEval;
+    quantize.registration = &folded_quantize_registration_;
+
+    folded_input_ = &subgraph_allocations_[0].tensors[input_idx];
+    folded_output_ = &subgraph_allocations_[0].tensors[output_idx];
+    folded_input_arena_data_ = folded_input_->data.data;
+    folded_output_arena_data_ = folded_output_->data.data;
+    folded_output_->type = kTfLiteUInt8;
+    return kTfLiteOk;
+  }
+#endif
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::FuseOperators() {
+#if ESP_NN
+  if (subgraphs_ == nullptr || subgraphs_->size() == 0) {
+    return kTfLiteOk;
+  }
+  const SubGraph* subgraph = subgraphs_->Get(0);
+  const auto* tensors = subgraph->tensors();
+  const uint32_t operators_size = NumSubgraphOperators(subgraph);
+  for (size_t i = 0; i < operators_size; ++i) {
+    NodeAndRegistration& first =
+        subgraph_allocations_[0].node_and_registrations[i];
+    if (first.node.inputs == nullptr || first.node.inputs->size < 2 ||
+        first.node.outputs == nullptr || first.node.outputs->size != 1) {
+      continue;
+    }
+    const int32_t tensor_idx = first.node.outputs->data[0];
+    if (Contains(subgraph->outputs(), tensor_idx) ||
+        tensors->Get(tensor_idx)->type() != TensorType_INT8) {
+      continue;
+    }
+
+    // The tensor must be the only input of its only consumer.
+    int consumer = -1;
+    int num_consumers = 0;
+    for (size_t j = 0; j < operators_size; ++j) {
+      const TfLiteNode& node =
+          subgraph_allocations_[0].node_and_registrations[j].node;
+      if (Contains(node.inputs, tensor_idx)) {
+        consumer = j;
+        num_consumers++;
+      }
+    }
+    if (num_consumers != 1) {
+      continue;
+    }
+    NodeAndRegistration& second =
+        subgraph_allocations_[0].node_and_registrations[consumer];
+    if (second.node.inputs->size != 1 || second.node.outputs == nullptr ||
+        second.node.outputs->size != 1 ||
+        tensors->Get(second.node.outputs->data[0])->type() !=
+            TensorType_INT8) {
+      continue;
+    }
+
+    const TensorType input_type =
+        tensors->Get(first.node.inputs->data[0])->type();
+    const TensorType filter_type =
+        tensors->Get(first.node.inputs->data[1])->type();
+    if (input_type != TensorType_INT8 || filter_type != TensorType_INT8) {
+      continue;
+    }
+
+    void* params = nullptr;
+    TFLMRegistration* fused_registration = nullptr;
+    TFLMRegistration* elided_registration = nullptr;
+    TFLMRegistration fused_kernel = {};
+    const int32_t first_code = first.registration->builtin_code;
+    const int32_t second_code = second.registration->builtin_code;
+    if (first_code == BuiltinOperator_CONV_2D &&
+        second_code == BuiltinOperator_MAX_POOL_2D) {
+      // The fused kernel computes whole pooling windows of conv rows, which
+      // rules out vertical padding.
+      const auto* conv =
+          static_cast<const TfLiteConvParams*>(first.node.builtin_data);
+      if (conv == nullptr || conv->padding != kTfLitePaddingValid ||
+          conv->dilation_width_factor != 1 ||
+          conv->dilation_height_factor != 1) {
+        continue;
+      }
+      auto* fused = static_cast<FusedConvMaxPoolParams*>(
+          allocator_->AllocatePersistentBuffer(sizeof(FusedConvMaxPoolParams)));
+      TF_LITE_ENSURE(context_, fused != nullptr);
+      fused->conv = *conv;
+      fused->pool = *static_cast<const TfLitePoolParams*>(
+          second.node.builtin_data);
+      params = fused;
+      fused_registration = &fused_conv_registration_;
+      elided_registration = &elided_max_pool_registration_;
+      fused_kernel = Register_CONV_2D_MAX_POOL_2D();
+    } else if (first_code == BuiltinOperator_FULLY_CONNECTED &&
+               second_code == BuiltinOperator_SOFTMAX) {
+      auto* fused = static_cast<FusedFullyConnectedSoftmaxParams*>(
+          allocator_->AllocatePersistentBuffer(
+              sizeof(FusedFullyConnectedSoftmaxParams)));
+      TF_LITE_ENSURE(context_, fused != nullptr);
+      fused->fully_connected = *static_cast<const TfLiteFullyConnectedParams*>(
+          first.node.builtin_data);
+      fused->softmax =
+          *static_cast<const TfLiteSoftmaxParams*>(second.node.builtin_data);
+      params = fused;
+      fused_registration = &fused_fully_connected_registration_;
+      elided_registration = &elided_softmax_registration_;
+      fused_kernel = Register_FULLY_CONNECTED_SOFTMAX();
+    } else {
+      continue;
+    }
+
+    // The fused node keeps the first op's name, for the profiler and for
+    // passes such as FoldInputQuantize.
+    if (fused_registration->invoke == nullptr) {
+      *fused_registration = fused_kernel;
+      fused_registration->builtin_code = first_code;
+    }
+    if (elided_registration->invoke == nullptr) {
+      *elided_registration = {};
+      elided_registration->builtin_code = second_code;
+      elided_registration->invoke = ElidedEval;
+    }
+
+    TfLiteIntArray* intermediates = static_cast<TfLiteIntArray*>(
+        allocator_->AllocatePersistentBuffer(TfLiteIntArrayGetSizeInBytes(1)));
+    TfLiteIntArray* none = static_cast<TfLiteIntArray*>(
+        allocator_->AllocatePersistentBuffer(TfLiteIntArrayGetSizeInBytes(0)));
+    TF_LITE_ENSURE(context_, intermediates != nullptr && none != nullptr);
+    intermediates->size = 1;
+    intermediates->data[0] = tensor_idx;
+    none->size = 0;
+
+    first.node.builtin_data = params;
+    first.node.outputs = second.node.outputs;
+    first.node.intermediates = intermediates;
+    first.registration = fused_registration;
+    second.node.inputs = none;
+    second.node.outputs = none;
+    second.registration = elided_registration;
+  }
+#endif
+  return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreterGraph::BandOperators() {
+#if ESP_NN
+  const int max_stages = GetRowBandStages();
+  if (max_stages < 2 || subgraphs_ == nullptr || subgraphs_->size() == 0) {
+    return kTfLiteOk;
+  }
+  const SubGraph* subgraph = subgraphs_->Get(0);
+  const uint32_t operators_size = NumSubgraphOperators(subgraph);
+  NodeAndRegistration* nodes = subgraph_allocations_[0].node_and_registrations;
+
+  // The chain starts at the first fused conv; what comes before it (here a
+  // QUANTIZE) only produces its input.
+  int chain[kMaxRowBandStages];
+  int num_stages = 0;
+  for (size_t i = 0; i < operators_size && num_stages < max_stages; ++i) {
+    const NodeAndRegistration& node = nodes[i];
+    if (node.registration == &elided_max_pool_registration_ ||
+        (num_stages == 0 &&
+         node.registration != &fused_conv_registration_)) {
+      continue;
+    }
+    if (node.registration != &fused_conv_registration_ ||
+        static_cast<const FusedConvMaxPoolParams*>(node.node.builtin_data)
+                ->pool.padding != kTfLitePaddingValid) {
+      break;
+    }
+    if (num_stages > 0) {
+      // The previous stage's output must be the only input this stage
+      // reads of its only consumer.
+      const int32_t tensor_idx =
+          nodes[chain[num_stages - 1]].node.outputs->data[0];
+      int num_consumers = 0;
+      for (size_t j = 0; j < operators_size; ++j) {
+        if (Contains(nodes[j].node.inputs, tensor_idx)) {
+          num_consumers++;
+        }
+      }
+      if (node.node.inputs->data[0] != tensor_idx || num_consumers != 1 ||
+          Contains(subgraph->outputs(), tensor_idx)) {
+        break;
+      }
+    }
+    chain[num_stages++] = i;
+  }
+  if (num_stages < 2) {
+    return kTfLiteOk;
+  }
+
+  auto* params = static_cast<RowBandParams*>(
+      allocator_->AllocatePersistentBuffer(sizeof(RowBandParams)));
+  TfLiteIntArray* none = static_cast<TfLiteIntArray*>(
+      allocator_->AllocatePersistentBuffer(TfLiteIntArrayGetSizeInBytes(0)));
+  TF_LITE_ENSURE(context_, params != nullptr && none != nullptr);
+  none->size = 0;
+  params->first =
+      *static_cast<const FusedConvMaxPoolParams*>(
+          nodes[chain[0]].node.builtin_data);
+  params->num_stages = num_stages;
+  for (int i = 0; i < num_stages; ++i) {
+    params->stages[i] = nodes[chain[i]].node;
+  }
+
+  if (row_band_registration_.invoke == nullptr) {
+    row_band_registration_ = Register_ROW_BAND_STACK();
+    row_band_registration_.builtin_code = BuiltinOperator_CONV_2D;
+    elided_conv_registration_ = {};
+    elided_conv_registration_.builtin_code = BuiltinOperator_CONV_2D;
+    elided_conv_registration_.invoke = ElidedEval;
+  }
+  NodeAndRegistration& first = nodes[chain[0]];
+  first.node.builtin_data = params;
+  first.node.outputs = nodes[chain[num_stages - 1]].node.outputs;
+  first.registration = &row_band_registration_;
+  for (int i = 1; i < num_stages; ++i) {
+    nodes[chain[i]].node.inputs = none;
+    nodes[chain[i]].node.outputs = none;
+    nodes[chain[i]].registration = &elided_conv_registration_;
+  }
+#endif
+  return kTfLiteOk;
+}
+
 void MicroInterpreterGraph::SetSubgraphAllocations(
     SubgraphAllocations* subgraph_allocations) {
   subgraph_allocations_ = subgraph_allocations;
@@ -77,6 +77,33 @@ class MicroInterpreterGraph : public MicroGraph {
   // Number of subgraphs in the model.
   virtual int NumSubgraphs();
 
+  // Points the specified input tensor of a specified subgraph at `data`,
+  // keeping a folded input quantize (see FoldInputQuantize) in step with it.
+  virtual TfLiteStatus SetSubgraphInputData(int subgraph_idx, int input_idx,
+                                            void* data);
+
+  // Folds a leading uint8->int8 QUANTIZE that only shifts the zero point by
+  // -128 into the CONV_2D consuming it: the conv reads the uint8 input
+  // directly and the QUANTIZE becomes a plain copy, or nothing at all once
+  // the input lives outside the arena. Must run after the memory plan is
+  // final. Leaves the graph untouched if the pattern does not match.
+  virtual TfLiteStatus FoldInputQuantize();
+
+  // Replaces each int8 CONV_2D (VALID padding, no dilation) feeding only a
+  // MAX_POOL_2D, and each int8 FULLY_CONNECTED feeding only a SOFTMAX, with
+  // one node running a fused esp-nn kernel (see kernels/esp_nn/fusion.h). The
+  // second node of a pair is left in place but does nothing, and the tensor
+  // between the two is not allocated. Must run before InitSubgraphs.
+  virtual TfLiteStatus FuseOperators();
+
+  // Replaces the chain of fused CONV_2D + MAX_POOL_2D nodes the graph starts
+  // with, each feeding only the next with VALID pooling, with one node
+  // running them row band by row band (see kernels/esp_nn/fusion.h), up to
+  // GetRowBandStages() of them. The other nodes of the chain are left in
+  // place but do nothing, and the tensors between the stages are not
+  // allocated. Must run after FuseOperators and before InitSubgraphs.
+  virtual TfLiteStatus BandOperators();
+
   // Hook to pass in subgraph allocations tracked within the interpreter,
   // allowing MicroInterpreterGraph to init / prepare / invoke subgraphs in the
   // model.
@@ -102,6 +129,22 @@ class MicroInterpreterGraph : public MicroGraph {
   MicroResourceVariables* resource_variables_;
   const flatbuffers::Vector<flatbuffers::Offset<SubGraph>>* subgraphs_;
 
+  // State of a folded input quantize, see FoldInputQuantize.
+  TFLMRegistration folded_quantize_registration_ = {};
+  TfLiteEvalTensor* folded_input_ = nullptr;
+  TfLiteEvalTensor* folded_output_ = nullptr;
+  void* folded_input_arena_data_ = nullptr;
+  void* folded_output_arena_data_ = nullptr;
+
+  // Registrations of the fused nodes and of the nodes they absorbed, see
+  // FuseOperators.
+  TFLMRegistration fused_conv_registration_ = {};
+  TFLMRegistration fused_fully_connected_registration_ = {};
+  TFLMRegistration row_band_registration_ = {};
+  TFLMRegistration elided_conv_registration_ = {};
+  TFLMRegistration elided_max_pool_registration_ = {};
+  TFLMRegistration elided_softmax_registration_ = {};
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
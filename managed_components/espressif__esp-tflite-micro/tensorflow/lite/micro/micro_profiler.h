@@ -99,6 +99,8 @@ class ScopedMicroProfiler {
  public:
   explicit ScopedMicroProfiler(const char* tag,
                                MicroProfilerInterface* profiler) {}
+  ScopedMicroProfiler(const char* tag, int subgraph_idx, int node_idx,
+                      MicroProfilerInterface* profiler) {}
 };
 
 #else
@@ -123,6 +125,15 @@ class ScopedMicroProfiler {
     }
   }
 
+  // Same as above, but tells the profiler which node the event belongs to.
+  ScopedMicroProfiler(const char* tag, int subgraph_idx, int node_idx,
+                      MicroProfilerInterface* profiler)
+      : profiler_(profiler) {
+    if (profiler_ != nullptr) {
+      event_handle_ = profiler_->BeginNodeEvent(tag, subgraph_idx, node_idx);
+    }
+  }
+
   ~ScopedMicroProfiler() {
     if (profiler_ != nullptr) {
       profiler_->EndEvent(event_handle_);
@@ -29,6 +29,15 @@ class MicroProfilerInterface {
   // to mark the end of the event via EndEvent.
   virtual uint32_t BeginEvent(const char* tag) = 0;
 
+  // Marks the start of the event for operator `node_idx` of subgraph
+  // `subgraph_idx`. The interpreter calls this for every node it invokes so
+  // that profilers can attribute cost to individual nodes rather than to op
+  // types. The default implementation forwards to BeginEvent.
+  virtual uint32_t BeginNodeEvent(const char* tag, int subgraph_idx,
+                                  int node_idx) {
+    return BeginEvent(tag);
+  }
+
   // Marks the end of an event associated with event_handle.
   virtual void EndEvent(uint32_t event_handle) = 0;
 };
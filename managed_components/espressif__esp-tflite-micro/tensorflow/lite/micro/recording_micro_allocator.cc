@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/memory_helpers.h"
 #include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
 #include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
 #include "tensorflow/lite/micro/micro_log.h"
 
 namespace tflite {
@@ -78,6 +79,8 @@ RecordedAllocation RecordingMicroAllocator::GetRecordedAllocation(
       return recorded_node_and_registration_array_data_;
     case RecordedAllocationType::kOpData:
       return recorded_op_data_;
+    case RecordedAllocationType::kScratchBufferData:
+      return recorded_scratch_buffer_data_;
   }
   MicroPrintf("Invalid allocation type supplied: %d", allocation_type);
   return RecordedAllocation();
@@ -112,6 +115,8 @@ void RecordingMicroAllocator::PrintAllocations() const {
                           "NodeAndRegistration structs");
   PrintRecordedAllocation(RecordedAllocationType::kOpData,
                           "Operator runtime data", "OpData structs");
+  PrintRecordedAllocation(RecordedAllocationType::kScratchBufferData,
+                          "Scratch buffer data", "scratch buffers");
 }
 
 void* RecordingMicroAllocator::AllocatePersistentBuffer(size_t bytes) {
@@ -122,6 +127,17 @@ void* RecordingMicroAllocator::AllocatePersistentBuffer(size_t bytes) {
   return buffer;
 }
 
+TfLiteStatus RecordingMicroAllocator::RequestScratchBufferInArena(
+    size_t bytes, int subgraph_idx, int* buffer_idx) {
+  TF_LITE_ENSURE_STATUS(MicroAllocator::RequestScratchBufferInArena(
+      bytes, subgraph_idx, buffer_idx));
+  recorded_scratch_buffer_data_.requested_bytes += bytes;
+  recorded_scratch_buffer_data_.used_bytes +=
+      AlignSizeUp(bytes, MicroArenaBufferAlignment());
+  recorded_scratch_buffer_data_.count++;
+  return kTfLiteOk;
+}
+
 void RecordingMicroAllocator::PrintRecordedAllocation(
     RecordedAllocationType allocation_type, const char* allocation_name,
     const char* allocation_description) const {
@@ -33,6 +33,7 @@ enum class RecordedAllocationType {
   kTfLiteTensorVariableBufferData,
   kNodeAndRegistrationArray,
   kOpData,
+  kScratchBufferData,
 };
 
 // Container for holding information about allocation recordings by a given
@@ -72,6 +73,9 @@ class RecordingMicroAllocator : public MicroAllocator {
 
   void* AllocatePersistentBuffer(size_t bytes) override;
 
+  TfLiteStatus RequestScratchBufferInArena(size_t bytes, int subgraph_idx,
+                                           int* buffer_idx) override;
+
  protected:
   TfLiteStatus AllocateNodeAndRegistrations(
       const Model* model, SubgraphAllocations* subgraph_allocations) override;
@@ -117,6 +121,10 @@ class RecordingMicroAllocator : public MicroAllocator {
   // TODO(b/187993291): Re-enable OpData allocating tracking.
   RecordedAllocation recorded_op_data_ = {};
 
+  // Scratch buffers are planned in the head along with the activations, so
+  // this records what kernels asked for rather than arena growth.
+  RecordedAllocation recorded_scratch_buffer_data_ = {};
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// esp_jpg_decode() for the luma only. Always runs the software TJpgDec, the
+// ROM copies have no luma-only mode.
+
+#include "esp_jpg_decode.h"
+#include "tjpgd.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
+#include "esp32-hal-log.h"
+#define TAG ""
+#else
+#include "esp_log.h"
+static const char* TAG = "esp_jpg_decode_luma";
+#endif
+
+typedef struct {
+        jpg_reader_cb reader;
+        jpg_writer_cb writer;
+        void * arg;
+        size_t len;
+        size_t index;
+} esp_jpg_luma_decoder_t;
+
+static unsigned int _jpg_write(JDEC *decoder, void *bitmap, JRECT *rect)
+{
+    esp_jpg_luma_decoder_t * jpeg = (esp_jpg_luma_decoder_t *)decoder->device;
+    uint16_t x = rect->left;
+    uint16_t y = rect->top;
+
+    return jpeg->writer(jpeg->arg, x, y, rect->right + 1 - x, rect->bottom + 1 - y, (uint8_t *)bitmap);
+}
+
+static unsigned int _jpg_read(JDEC *decoder, uint8_t *buf, unsigned int len)
+{
+    esp_jpg_luma_decoder_t * jpeg = (esp_jpg_luma_decoder_t *)decoder->device;
+    if (jpeg->len && len > (jpeg->len - jpeg->index)) {
+        len = jpeg->len - jpeg->index;
+    }
+    if (len) {
+        len = jpeg->reader(jpeg->arg, jpeg->index, buf, len);
+        if (!len) {
+            ESP_LOGE(TAG, "Read Fail at %u/%u", (unsigned) jpeg->index, (unsigned) jpeg->len);
+        }
+        jpeg->index += len;
+    }
+    return len;
+}
+
+esp_err_t esp_jpg_decode_luma(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg)
+{
+    static uint8_t work[3100];
+    JDEC decoder;
+    esp_jpg_luma_decoder_t jpeg;
+
+    jpeg.len = len;
+    jpeg.reader = reader;
+    jpeg.writer = writer;
+    jpeg.arg = arg;
+    jpeg.index = 0;
+
+    JRESULT jres = jd_prepare(&decoder, _jpg_read, work, sizeof(work), &jpeg);
+    if (jres != JDR_OK) {
+        ESP_LOGE(TAG, "JPG Header Parse Failed! %d", jres);
+        return ESP_FAIL;
+    }
+
+    uint16_t output_width = decoder.width >> scale;
+    uint16_t output_height = decoder.height >> scale;
+
+    if (!writer(arg, 0, 0, output_width, output_height, NULL)) {
+        return ESP_FAIL;
+    }
+    jres = jd_decomp_luma(&decoder, _jpg_write, (uint8_t)scale);
+    writer(arg, output_width, output_height, output_width, output_height, NULL);
+
+    if (jres != JDR_OK) {
+        ESP_LOGE(TAG, "JPG Decompression Failed! %d", jres);
+        return ESP_FAIL;
+    }
+    //check if all data has been consumed.
+    if (len && jpeg.index < len) {
+        _jpg_read(&decoder, NULL, len - jpeg.index);
+    }
+
+    return ESP_OK;
+}
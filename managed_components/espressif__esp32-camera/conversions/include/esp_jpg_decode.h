@@ -36,6 +36,35 @@ typedef bool (* jpg_writer_cb)(void * arg, uint16_t x, uint16_t y, uint16_t w, u
 
 esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg);
 
+/**
+ * @brief Like esp_jpg_decode(), but decodes only the luma: the writer gets 1 byte per pixel
+ *
+ * The chroma blocks are parsed but not transformed, and there is no color conversion.
+ */
+esp_err_t esp_jpg_decode_luma(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void * arg);
+
+/**
+ * @brief Decodes a JPEG straight to an out_width x out_height grayscale image
+ *
+ * The largest centred crop with the aspect ratio of the output is box downscaled
+ * into `out`, each pixel the rounded mean of the luma it covers, the same as the
+ * camera driver's downscale. The IDCT scaling does as much of the downscale as it
+ * can without dropping below the output size, and only the luma is decoded.
+ * No full size image is stored.
+ *
+ * @param src       JPEG data
+ * @param src_len   Length in bytes of the JPEG data
+ * @param out       Buffer of out_width * out_height bytes, e.g. a model input tensor
+ *
+ * @return true on success
+ */
+bool jpg2gray(const uint8_t *src, size_t src_len, uint8_t *out, uint16_t out_width, uint16_t out_height);
+
+/**
+ * @brief jpg2gray() to int8, every pixel minus 128
+ */
+bool jpg2gray_s8(const uint8_t *src, size_t src_len, int8_t *out, uint16_t out_width, uint16_t out_height);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,193 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// JPEG to model input: luma-only decode at the smallest IDCT scale that still
+// covers the output, then a box downscale of the centred crop as the MCUs
+// arrive. Only a few output rows of sums are kept, never the decoded image.
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_jpg_decode.h"
+
+typedef struct {
+        const uint8_t *input;
+        uint8_t *output;
+        uint8_t xor_mask;
+        uint16_t out_width;
+        uint16_t out_height;
+        uint16_t crop_x;
+        uint16_t crop_y;
+        uint16_t crop_width;
+        uint16_t crop_height;
+        uint16_t rows;          // Output rows in the ring of sums
+        uint16_t out_y;         // Next output row to write
+        uint16_t *x_bound;      // First crop column of every box, out_width + 1
+        uint32_t *acc;          // rows x out_width box sums, output row oy at oy % rows
+} gray_jpg_decoder;
+
+// Size from the baseline or progressive frame header, before decoding.
+static bool jpg_size(const uint8_t *src, size_t len, uint16_t *width, uint16_t *height)
+{
+    size_t i = 2;
+    while (i + 9 <= len && src[i] == 0xFF) {
+        uint8_t marker = src[i + 1];
+        if (marker >= 0xC0 && marker <= 0xC2) {
+            *height = (src[i + 5] << 8) | src[i + 6];
+            *width = (src[i + 7] << 8) | src[i + 8];
+            return *width && *height;
+        }
+        if (marker == 0xDA) {
+            break;
+        }
+        i += 2 + ((src[i + 2] << 8) | src[i + 3]);
+    }
+    return false;
+}
+
+// Largest centred crop of a width x height image with the aspect ratio of the
+// output, the same as the camera driver's.
+static void centred_crop(gray_jpg_decoder *jpeg, uint16_t width, uint16_t height)
+{
+    uint32_t crop_width = width;
+    uint32_t crop_height = height;
+    if ((uint32_t) width * jpeg->out_height > (uint32_t) height * jpeg->out_width) {
+        crop_width = (uint32_t) height * jpeg->out_width / jpeg->out_height;
+    } else {
+        crop_height = (uint32_t) width * jpeg->out_height / jpeg->out_width;
+    }
+    jpeg->crop_x = ((width - crop_width) / 2) & ~1;
+    jpeg->crop_y = (height - crop_height) / 2;
+    jpeg->crop_width = crop_width;
+    jpeg->crop_height = crop_height;
+}
+
+// Writes every output row whose boxes end at or above decoded row `y`.
+static void write_rows(gray_jpg_decoder *jpeg, uint32_t y)
+{
+    while (jpeg->out_y < jpeg->out_height) {
+        uint32_t y0 = (uint32_t) jpeg->out_y * jpeg->crop_height / jpeg->out_height;
+        uint32_t y1 = (uint32_t) (jpeg->out_y + 1) * jpeg->crop_height / jpeg->out_height;
+        if (jpeg->crop_y + y1 > y) {
+            break;
+        }
+        uint32_t *acc = jpeg->acc + (jpeg->out_y % jpeg->rows) * jpeg->out_width;
+        uint8_t *out = jpeg->output + jpeg->out_y * jpeg->out_width;
+        for (int ox = 0; ox < jpeg->out_width; ox++) {
+            uint32_t area = (jpeg->x_bound[ox + 1] - jpeg->x_bound[ox]) * (y1 - y0);
+            out[ox] = ((acc[ox] + area / 2) / area) ^ jpeg->xor_mask;
+            acc[ox] = 0;
+        }
+        jpeg->out_y++;
+    }
+}
+
+static bool _gray_write(void * arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data)
+{
+    gray_jpg_decoder * jpeg = (gray_jpg_decoder *)arg;
+    if (!data) {
+        if (x || y) {
+            //write end
+            write_rows(jpeg, UINT32_MAX);
+        }
+        return true;
+    }
+
+    // MCUs come in raster order: the rows above this one are complete.
+    write_rows(jpeg, y);
+
+    int r0 = y > jpeg->crop_y ? y : jpeg->crop_y;
+    int r1 = y + h < jpeg->crop_y + jpeg->crop_height ? y + h : jpeg->crop_y + jpeg->crop_height;
+    int c0 = x > jpeg->crop_x ? x : jpeg->crop_x;
+    int c1 = x + w < jpeg->crop_x + jpeg->crop_width ? x + w : jpeg->crop_x + jpeg->crop_width;
+    if (c0 >= c1) {
+        return true;
+    }
+    // The box column c0 falls in: the last one starting at or before it.
+    int first_box = ((uint32_t) (c0 - jpeg->crop_x + 1) * jpeg->out_width - 1) / jpeg->crop_width;
+    for (int r = r0; r < r1; r++) {
+        uint32_t oy = ((uint32_t) (r - jpeg->crop_y + 1) * jpeg->out_height - 1) / jpeg->crop_height;
+        uint32_t *acc = jpeg->acc + (oy % jpeg->rows) * jpeg->out_width;
+        const uint8_t *in = data + (r - y) * w + (c0 - x);
+        int box = first_box;
+        int next = jpeg->crop_x + jpeg->x_bound[box + 1];
+        for (int c = c0; c < c1; c++) {
+            if (c == next) {
+                box++;
+                next = jpeg->crop_x + jpeg->x_bound[box + 1];
+            }
+            acc[box] += *in++;
+        }
+    }
+    return true;
+}
+
+//input buffer
+static size_t _jpg_read(void * arg, size_t index, uint8_t *buf, size_t len)
+{
+    gray_jpg_decoder * jpeg = (gray_jpg_decoder *)arg;
+    if (buf) {
+        memcpy(buf, jpeg->input + index, len);
+    }
+    return len;
+}
+
+static bool jpg2gray_xor(const uint8_t *src, size_t src_len, uint8_t *out, uint16_t out_width, uint16_t out_height, uint8_t xor_mask)
+{
+    gray_jpg_decoder jpeg;
+    uint16_t width, height;
+    int scale;
+
+    if (!out_width || !out_height || !jpg_size(src, src_len, &width, &height)) {
+        return false;
+    }
+    jpeg.out_width = out_width;
+    jpeg.out_height = out_height;
+    // The smallest image the IDCT scaling gives whose crop still covers the output
+    for (scale = JPG_SCALE_MAX; scale >= JPG_SCALE_NONE; scale--) {
+        centred_crop(&jpeg, width >> scale, height >> scale);
+        if (jpeg.crop_width >= out_width && jpeg.crop_height >= out_height) {
+            break;
+        }
+    }
+    if (scale < JPG_SCALE_NONE) {
+        return false;
+    }
+
+    // An MCU row is at most 16 decoded rows, which touch at most that many
+    // output rows plus the one carried over from the MCU row above.
+    jpeg.rows = (16 >> scale) + 2;
+    if (jpeg.rows > out_height) {
+        jpeg.rows = out_height;
+    }
+    jpeg.acc = (uint32_t *)calloc(jpeg.rows * out_width, sizeof(uint32_t));
+    jpeg.x_bound = (uint16_t *)malloc((out_width + 1) * sizeof(uint16_t));
+    if (!jpeg.acc || !jpeg.x_bound) {
+        free(jpeg.acc);
+        free(jpeg.x_bound);
+        return false;
+    }
+    for (int i = 0; i <= out_width; i++) {
+        jpeg.x_bound[i] = (uint32_t) i * jpeg.crop_width / out_width;
+    }
+    jpeg.input = src;
+    jpeg.output = out;
+    jpeg.xor_mask = xor_mask;
+    jpeg.out_y = 0;
+
+    bool ok = esp_jpg_decode_luma(src_len, (jpg_scale_t)scale, _jpg_read, _gray_write, (void*)&jpeg) == ESP_OK &&
+              jpeg.out_y == out_height;
+    free(jpeg.acc);
+    free(jpeg.x_bound);
+    return ok;
+}
+
+bool jpg2gray(const uint8_t *src, size_t src_len, uint8_t *out, uint16_t out_width, uint16_t out_height)
+{
+    return jpg2gray_xor(src, src_len, out, out_width, out_height, 0);
+}
+
+bool jpg2gray_s8(const uint8_t *src, size_t src_len, int8_t *out, uint16_t out_width, uint16_t out_height)
+{
+    return jpg2gray_xor(src, src_len, (uint8_t *)out, out_width, out_height, 0x80);
+}
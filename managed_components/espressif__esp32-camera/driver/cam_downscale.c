@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "cam_downscale.h"
+
+#if __has_include("esp_attr.h")
+#include "esp_attr.h"
+#else
+#define IRAM_ATTR
+#endif
+
+// Luma of RGB565 bytes RRRRRGGG GGGBBBBB, (305 * R8 + 600 * G8 + 119 * B8) >> 10
+// folded onto the 5/6-bit channels as in the application's conversion.
+static inline uint32_t luma_rgb565(const uint8_t *pixel)
+{
+    const uint32_t r = pixel[0] >> 3;
+    const uint32_t g = ((pixel[0] & 0x07) << 3) | (pixel[1] >> 5);
+    const uint32_t b = pixel[1] & 0x1F;
+    return (r * 305 + g * 300 + b * 119) >> 7;
+}
+
+bool cam_downscale_init(cam_downscale_t *ds, uint16_t in_width, uint16_t in_height,
+                        cam_downscale_input_t input, uint16_t crop_x, uint16_t crop_y,
+                        uint16_t crop_width, uint16_t crop_height,
+                        uint16_t out_width, uint16_t out_height, bool to_int8)
+{
+    if (out_width == 0 || out_height == 0 || out_width > CAM_DOWNSCALE_MAX_WIDTH) {
+        return false;
+    }
+    if (crop_width == 0 || crop_height == 0) {
+        crop_width = in_width;
+        crop_height = in_height;
+        if ((uint32_t) in_width * out_height > (uint32_t) in_height * out_width) {
+            crop_width = (uint32_t) in_height * out_width / out_height;
+        } else {
+            crop_height = (uint32_t) in_width * out_height / out_width;
+        }
+        crop_x = ((in_width - crop_width) / 2) & ~1;
+        crop_y = (in_height - crop_height) / 2;
+    }
+    if (crop_width < out_width || crop_height < out_height ||
+        crop_x + crop_width > in_width || crop_y + crop_height > in_height) {
+        return false;
+    }
+
+    memset(ds, 0, sizeof(*ds));
+    ds->in_width = in_width;
+    ds->in_height = in_height;
+    ds->in_bytes_per_pixel = input == CAM_DOWNSCALE_Y8 ? 1 : 2;
+    ds->input = input;
+    ds->crop_x = crop_x;
+    ds->crop_y = crop_y;
+    ds->crop_width = crop_width;
+    ds->crop_height = crop_height;
+    ds->out_width = out_width;
+    ds->out_height = out_height;
+    ds->xor_mask = to_int8 ? 0x80 : 0;
+    for (int i = 0; i <= out_width; i++) {
+        ds->x_bound[i] = (uint32_t) i * crop_width / out_width;
+    }
+    cam_downscale_start(ds);
+    return true;
+}
+
+void cam_downscale_start(cam_downscale_t *ds)
+{
+    ds->x = 0;
+    ds->y = 0;
+    ds->out_y = 0;
+    ds->out_y_end = ds->crop_y + (uint32_t) ds->crop_height / ds->out_height;
+    memset(ds->acc, 0, ds->out_width * sizeof(ds->acc[0]));
+}
+
+// Adds `count` pixels of the crop, from crop column `column` on, to the box
+// sums.
+static void IRAM_ATTR accumulate(cam_downscale_t *ds, const uint8_t *in, int column, int count)
+{
+    const uint16_t *x_bound = ds->x_bound;
+    uint32_t *acc = ds->acc;
+    // The box `column` falls in: the last one starting at or before it.
+    int box = ((uint32_t) (column + 1) * ds->out_width - 1) / ds->crop_width;
+    int next = x_bound[box + 1];
+    const int end = column + count;
+
+    switch (ds->input) {
+    case CAM_DOWNSCALE_RGB565:
+        for (; column < end; column++, in += 2) {
+            if (column == next) {
+                next = x_bound[++box + 1];
+            }
+            acc[box] += luma_rgb565(in);
+        }
+        break;
+    case CAM_DOWNSCALE_YUYV:
+        for (; column < end; column++, in += 2) {
+            if (column == next) {
+                next = x_bound[++box + 1];
+            }
+            acc[box] += in[0];
+        }
+        break;
+    default:
+        for (; column < end; column++, in++) {
+            if (column == next) {
+                next = x_bound[++box + 1];
+            }
+            acc[box] += in[0];
+        }
+        break;
+    }
+}
+
+// Writes the rounded box means of the output row just completed to `out`
+// and clears the sums for the next one.
+static void IRAM_ATTR emit_row(cam_downscale_t *ds, uint8_t *out)
+{
+    const uint32_t box_start = ds->crop_y + (uint32_t) ds->out_y * ds->crop_height / ds->out_height;
+    const uint32_t box_height = ds->out_y_end - box_start;
+    for (int ox = 0; ox < ds->out_width; ox++) {
+        const uint32_t area = (ds->x_bound[ox + 1] - ds->x_bound[ox]) * box_height;
+        out[ox] = ((ds->acc[ox] + area / 2) / area) ^ ds->xor_mask;
+        ds->acc[ox] = 0;
+    }
+    ds->out_y++;
+    ds->out_y_end = ds->crop_y + (uint32_t) (ds->out_y + 1) * ds->crop_height / ds->out_height;
+}
+
+size_t IRAM_ATTR cam_downscale_lines(cam_downscale_t *ds, uint8_t *out, const uint8_t *in, size_t len)
+{
+    const int bytes_per_pixel = ds->in_bytes_per_pixel;
+    const int crop_end = ds->crop_x + ds->crop_width;
+    size_t written = 0;
+    size_t pixels = len / bytes_per_pixel;
+
+    while (pixels > 0 && ds->y < ds->in_height) {
+        // The rest of this line, or of the buffer if it ends first
+        int count = ds->in_width - ds->x;
+        if ((size_t) count > pixels) {
+            count = pixels;
+        }
+        if (ds->out_y < ds->out_height && ds->y >= ds->crop_y) {
+            const int first = ds->x > ds->crop_x ? ds->x : ds->crop_x;
+            const int last = ds->x + count < crop_end ? ds->x + count : crop_end;
+            if (first < last) {
+                accumulate(ds, in + (first - ds->x) * bytes_per_pixel, first - ds->crop_x, last - first);
+            }
+        }
+        in += count * bytes_per_pixel;
+        pixels -= count;
+        ds->x += count;
+        if (ds->x < ds->in_width) {
+            break;
+        }
+
+        ds->x = 0;
+        ds->y++;
+        if (ds->out_y < ds->out_height && ds->y == ds->out_y_end) {
+            emit_row(ds, out + written);
+            written += ds->out_width;
+        }
+    }
+    return written;
+}
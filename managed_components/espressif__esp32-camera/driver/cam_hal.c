@@ -131,6 +131,9 @@ static void cam_task(void *arg)
                     //DBG_PIN_SET(1);
                     if(cam_start_frame(&frame_pos)){
                         cam_obj->frames[frame_pos].fb.len = 0;
+                        if (cam_obj->downscale) {
+                            cam_downscale_start(cam_obj->downscale);
+                        }
                         cam_obj->state = CAM_STATE_READ_BUF;
                     }
                     cnt = 0;
@@ -141,6 +144,10 @@ static void cam_task(void *arg)
             case CAM_STATE_READ_BUF: {
                 camera_fb_t * frame_buffer_event = &cam_obj->frames[frame_pos].fb;
                 size_t pixels_per_dma = (cam_obj->dma_half_buffer_size * cam_obj->fb_bytes_per_pixel) / (cam_obj->dma_bytes_per_item * cam_obj->in_bytes_per_pixel);
+                if (cam_obj->downscale) {
+                    // the downscale never writes past the end of the frame
+                    pixels_per_dma = 0;
+                }
 
                 if (cam_event == CAM_IN_SUC_EOF_EVENT) {
                     if(!cam_obj->psram_mode){
@@ -220,6 +227,9 @@ static void cam_task(void *arg)
                         cam_obj->state = CAM_STATE_IDLE;
                     } else {
                         cam_obj->frames[frame_pos].fb.len = 0;
+                        if (cam_obj->downscale) {
+                            cam_downscale_start(cam_obj->downscale);
+                        }
                     }
                     cnt = 0;
                 }
@@ -230,6 +240,48 @@ static void cam_task(void *arg)
     }
 }
 
+static esp_err_t cam_downscale_config(const camera_config_t *config)
+{
+#if CONFIG_IDF_TARGET_ESP32S3
+    cam_downscale_input_t input;
+    if (config->pixel_format == PIXFORMAT_GRAYSCALE) {
+        input = cam_obj->in_bytes_per_pixel == 1 ? CAM_DOWNSCALE_Y8 : CAM_DOWNSCALE_YUYV;
+    } else if (config->pixel_format == PIXFORMAT_YUV422) {
+        input = CAM_DOWNSCALE_YUYV;
+    } else if (config->pixel_format == PIXFORMAT_RGB565) {
+        input = CAM_DOWNSCALE_RGB565;
+    } else {
+        ESP_LOGE(TAG, "Downscale needs GRAYSCALE, YUV422 or RGB565 frames");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#if CONFIG_CAMERA_CONVERTER_ENABLED
+    CAM_CHECK(config->conv_mode == CONV_DISABLE, "Downscale doesn't work with conversion", ESP_ERR_NOT_SUPPORTED);
+#endif
+    CAM_CHECK(!cam_obj->psram_mode, "Downscale doesn't work in EDMA mode", ESP_ERR_NOT_SUPPORTED);
+
+    cam_obj->downscale = (cam_downscale_t *)heap_caps_malloc(sizeof(cam_downscale_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    CAM_CHECK(cam_obj->downscale != NULL, "downscale malloc failed", ESP_ERR_NO_MEM);
+    const camera_downscale_config_t *ds = &config->downscale;
+    if (!cam_downscale_init(cam_obj->downscale, cam_obj->width, cam_obj->height, input,
+                            ds->crop_x, ds->crop_y, ds->crop_width, ds->crop_height,
+                            ds->out_width, ds->out_height, ds->to_int8)) {
+        ESP_LOGE(TAG, "Can't downscale %ux%u frames to %ux%u", cam_obj->width, cam_obj->height,
+                 ds->out_width, ds->out_height);
+        free(cam_obj->downscale);
+        cam_obj->downscale = NULL;
+        return ESP_ERR_INVALID_ARG;
+    }
+    cam_obj->fb_size = ds->out_width * ds->out_height;
+    ESP_LOGI(TAG, "Downscaling %ux%u+%u+%u of %ux%u frames to %ux%u", cam_obj->downscale->crop_width,
+             cam_obj->downscale->crop_height, cam_obj->downscale->crop_x, cam_obj->downscale->crop_y,
+             cam_obj->width, cam_obj->height, ds->out_width, ds->out_height);
+    return ESP_OK;
+#else
+    ESP_LOGE(TAG, "Downscale is only supported on the ESP32-S3");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 static lldesc_t * allocate_dma_descriptors(uint32_t count, uint16_t size, uint8_t * buffer)
 {
     lldesc_t *dma = (lldesc_t *)heap_caps_malloc(count * sizeof(lldesc_t), MALLOC_CAP_DMA);
@@ -385,6 +437,11 @@ esp_err_t cam_config(const camera_config_t *config, framesize_t frame_size, uint
         cam_obj->fb_size = cam_obj->width * cam_obj->height * cam_obj->fb_bytes_per_pixel;
     }
 
+    if (config->downscale.out_width) {
+        ret = cam_downscale_config(config);
+        CAM_CHECK_GOTO(ret == ESP_OK, "cam_downscale_config failed", err);
+    }
+
     ret = cam_dma_config(config);
     CAM_CHECK_GOTO(ret == ESP_OK, "cam_dma_config failed", err);
 
@@ -447,6 +504,9 @@ esp_err_t cam_deinit(void)
     if (cam_obj->dma_buffer) {
         free(cam_obj->dma_buffer);
     }
+    if (cam_obj->downscale) {
+        free(cam_obj->downscale);
+    }
     if (cam_obj->frames) {
         for (int x = 0; x < cam_obj->frame_cnt; x++) {
             free(cam_obj->frames[x].fb.buf - cam_obj->frames[x].fb_offset);
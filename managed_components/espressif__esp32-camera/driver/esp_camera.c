@@ -81,6 +81,7 @@ static const char *TAG = "camera";
 typedef struct {
     sensor_t sensor;
     camera_fb_t fb;
+    camera_downscale_config_t downscale;
 } camera_state_t;
 
 static const char *CAMERA_SENSOR_NVS_KEY = "sensor";
@@ -307,6 +308,7 @@ esp_err_t esp_camera_init(const camera_config_t *config)
 
     s_state->sensor.status.framesize = frame_size;
     s_state->sensor.pixformat = pix_format;
+    s_state->downscale = config->downscale;
 
     ESP_LOGD(TAG, "Setting frame size to %dx%d", resolution[frame_size].width, resolution[frame_size].height);
     if (s_state->sensor.set_framesize(&s_state->sensor, frame_size) != 0) {
@@ -365,7 +367,11 @@ camera_fb_t *esp_camera_fb_get()
     }
     camera_fb_t *fb = cam_take(FB_GET_TIMEOUT);
     //set the frame properties
-    if (fb) {
+    if (fb && s_state->downscale.out_width) {
+        fb->width = s_state->downscale.out_width;
+        fb->height = s_state->downscale.out_height;
+        fb->format = PIXFORMAT_GRAYSCALE;
+    } else if (fb) {
         fb->width = resolution[s_state->sensor.status.framesize].width;
         fb->height = resolution[s_state->sensor.status.framesize].height;
         fb->format = s_state->sensor.pixformat;
@@ -111,6 +111,29 @@ typedef enum {
 } camera_conv_mode_t;
 #endif
 
+/**
+ * @brief Crop and downscale of the frames while they are received
+ *
+ * With out_width and out_height set, the camera task reduces every frame to
+ * out_width x out_height 8-bit grayscale, the box-averaged luma of a region
+ * of interest, line by line as the DMA buffers are drained. The frame
+ * buffers only hold the small frame, so place them in DRAM: the full
+ * resolution frame is never written to or read back from PSRAM. Frames are
+ * handed out as PIXFORMAT_GRAYSCALE of the output size.
+ *
+ * Only on the ESP32-S3, for GRAYSCALE, YUV422 and RGB565 capture without
+ * EDMA (PSRAM DMA) mode or conversion.
+ */
+typedef struct {
+    uint16_t out_width;             /*!< Width of the frames handed out, 0 to hand out the full frames */
+    uint16_t out_height;            /*!< Height of the frames handed out */
+    uint16_t crop_x;                /*!< Left edge of the region of interest */
+    uint16_t crop_y;                /*!< Top edge of the region of interest */
+    uint16_t crop_width;            /*!< Width of the region of interest, 0 for the largest centred one with the aspect ratio of the output */
+    uint16_t crop_height;           /*!< Height of the region of interest */
+    bool to_int8;                   /*!< Subtract 128 from every pixel, for models with int8 input */
+} camera_downscale_config_t;
+
 /**
  * @brief Configuration structure for camera initialization
  */
@@ -155,6 +178,8 @@ typedef struct {
 #endif
 
     int sccb_i2c_port;              /*!< If pin_sccb_sda is -1, use the already configured I2C bus by number */
+
+    camera_downscale_config_t downscale; /*!< Crop and downscale of the frames while they are received */
 } camera_config_t;
 
 /**
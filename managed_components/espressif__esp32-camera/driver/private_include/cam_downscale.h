@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Crop, box downscale and int8 offset of a frame as it is received, line by
+ * line. The DMA half buffers are fed in the order they arrive, and every
+ * output row is written as soon as the last input line of its boxes is in,
+ * so the full resolution frame is never stored.
+ *
+ * Each output pixel is the rounded mean of the luma of the input pixels its
+ * box covers, the same as ConvertToGrayscale() of the application, so the
+ * two give identical frames. Free of ESP-IDF dependencies, to be tested on
+ * the host with synthetic DMA buffers.
+ */
+
+#define CAM_DOWNSCALE_MAX_WIDTH 256
+
+typedef enum {
+    CAM_DOWNSCALE_Y8,       /*!< 1 byte per pixel, the luma */
+    CAM_DOWNSCALE_YUYV,     /*!< 2 bytes per pixel, luma first */
+    CAM_DOWNSCALE_RGB565,   /*!< 2 bytes per pixel, big endian */
+} cam_downscale_input_t;
+
+typedef struct {
+    // Geometry, set by cam_downscale_init()
+    uint16_t in_width;
+    uint16_t in_height;
+    uint8_t in_bytes_per_pixel;
+    cam_downscale_input_t input;
+    uint16_t crop_x;
+    uint16_t crop_y;
+    uint16_t crop_width;
+    uint16_t crop_height;
+    uint16_t out_width;
+    uint16_t out_height;
+    uint8_t xor_mask;
+    uint16_t x_bound[CAM_DOWNSCALE_MAX_WIDTH + 1]; /*!< First crop column of every box */
+
+    // Position in the frame, reset by cam_downscale_start()
+    uint16_t x;             /*!< Next input pixel of the line */
+    uint16_t y;             /*!< Input line being received */
+    uint16_t out_y;         /*!< Output row being accumulated */
+    uint16_t out_y_end;     /*!< First input line of the next output row */
+    uint32_t acc[CAM_DOWNSCALE_MAX_WIDTH];
+} cam_downscale_t;
+
+/**
+ * @brief Sets up the downscale of in_width x in_height frames of `input`
+ *
+ * A crop_width or crop_height of 0 selects the largest centred crop with the
+ * aspect ratio of the output, its left edge even. `to_int8` subtracts 128
+ * from every output pixel, making it the int8 value of the uint8 pixel.
+ *
+ * @return false if the crop doesn't fit in the frame, is smaller than the
+ *         output, or the output is wider than CAM_DOWNSCALE_MAX_WIDTH
+ */
+bool cam_downscale_init(cam_downscale_t *ds, uint16_t in_width, uint16_t in_height,
+                        cam_downscale_input_t input, uint16_t crop_x, uint16_t crop_y,
+                        uint16_t crop_width, uint16_t crop_height,
+                        uint16_t out_width, uint16_t out_height, bool to_int8);
+
+/**
+ * @brief Starts a new frame
+ */
+void cam_downscale_start(cam_downscale_t *ds);
+
+/**
+ * @brief Feeds the next `len` bytes of the frame
+ *
+ * `len` must be a whole number of pixels, but needn't be of lines. The
+ * output rows completed by them are written to `out`, back to back.
+ *
+ * @return Bytes written to `out`, a multiple of out_width
+ */
+size_t cam_downscale_lines(cam_downscale_t *ds, uint8_t *out, const uint8_t *in, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
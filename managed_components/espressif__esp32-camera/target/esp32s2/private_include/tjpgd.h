@@ -13,6 +13,8 @@
 
 /*---------------------------------------------------------------------------*/
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,10 +34,10 @@ typedef unsigned short	USHORT;
 typedef unsigned short	WORD;
 typedef unsigned short	WCHAR;
 
-/* These types must be 32-bit integer */
-typedef long			LONG;
-typedef unsigned long	ULONG;
-typedef unsigned long	DWORD;
+/* These types must be 32-bit integer (long is 64-bit on a 64-bit host) */
+typedef int32_t			LONG;
+typedef uint32_t		ULONG;
+typedef uint32_t		DWORD;
 
 
 /* Error code */
@@ -71,6 +73,7 @@ struct JDEC {
 	BYTE msx, msy;			/* MCU size in unit of block (width, height) */
 	BYTE qtid[3];			/* Quantization table ID of each component */
 	SHORT dcv[3];			/* Previous DC element of each component */
+	BYTE luma;				/* Output the Y component only (jd_decomp_luma) */
 	WORD nrst;				/* Restart inverval */
 	UINT width, height;		/* Size of the input image (pixel) */
 	BYTE* huffbits[2][2];	/* Huffman bit distribution tables [id][dcac] */
@@ -87,9 +90,15 @@ struct JDEC {
 
 
 
-/* TJpgDec API functions */
+/* TJpgDec API functions. Targets with TJpgDec in ROM link this copy too, for
+   jd_decomp_luma(), so it has names of its own. */
+#define jd_prepare	jd_prepare_sw
+#define jd_decomp	jd_decomp_sw
 JRESULT jd_prepare (JDEC*, UINT(*)(JDEC*,BYTE*,UINT), void*, UINT, void*);
 JRESULT jd_decomp (JDEC*, UINT(*)(JDEC*,void*,JRECT*), BYTE);
+/* Like jd_decomp(), but outputs 8-bit luma (1 BYTE/pix) and skips the IDCT
+   of the chroma blocks and the color conversion */
+JRESULT jd_decomp_luma (JDEC*, UINT(*)(JDEC*,void*,JRECT*), BYTE);
 
 
 #ifdef __cplusplus
@@ -535,6 +535,11 @@ bool ll_cam_dma_sizes(cam_obj_t *cam)
 
 size_t IRAM_ATTR ll_cam_memcpy(cam_obj_t *cam, uint8_t *out, const uint8_t *in, size_t len)
 {
+    // Crop and downscale, writing only the output rows the lines complete
+    if (cam->downscale) {
+        return cam_downscale_lines(cam->downscale, out, in, len);
+    }
+
     // YUV to Grayscale
     if (cam->in_bytes_per_pixel == 2 && cam->fb_bytes_per_pixel == 1) {
         size_t end = len / 8;
@@ -30,6 +30,7 @@
 #endif
 #include "esp_log.h"
 #include "esp_camera.h"
+#include "cam_downscale.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
@@ -140,6 +141,9 @@ typedef struct {
 #endif
     uint32_t fb_size;
 
+    //crop and downscale while receiving, NULL for full frames
+    cam_downscale_t *downscale;
+
     cam_state_t state;
 } cam_obj_t;
 
@@ -518,7 +518,8 @@ JRESULT mcu_load (
 		tmp[0] = d * dqf[0] >> 8;				/* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
 
 		/* Extract following 63 AC elements from input stream */
-		for (i = 1; i < 64; i++) tmp[i] = 0;	/* Clear rest of elements */
+		if (!cmp || !jd->luma)
+			for (i = 1; i < 64; i++) tmp[i] = 0;	/* Clear rest of elements */
 		hb = jd->huffbits[id][1];				/* Huffman table for the AC elements */
 		hc = jd->huffcode[id][1];
 		hd = jd->huffdata[id][1];
@@ -542,7 +543,9 @@ JRESULT mcu_load (
 			}
 		} while (++i < 64);		/* Next AC element */
 
-		if (JD_USE_SCALE && jd->scale == 3)
+		if (cmp && jd->luma)
+			;							/* Chroma is only decoded to stay in step with the stream */
+		else if (JD_USE_SCALE && jd->scale == 3)
 			*bp = (*tmp / 256) + 128;	/* If scale ratio is 1/8, IDCT can be ommited and only DC element is used */
 		else
 			block_idct(tmp, bp);		/* Apply IDCT and store the block to the MCU buffer */
@@ -707,6 +710,78 @@ JRESULT mcu_output (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Output an MCU: Descale the Y blocks and output them as 8-bit luma      */
+/*-----------------------------------------------------------------------*/
+
+static
+JRESULT mcu_output_luma (
+	JDEC* jd,	/* Pointer to the decompressor object */
+	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* Luma output function */
+	UINT x,		/* MCU position in the image (left of the MCU) */
+	UINT y		/* MCU position in the image (top of the MCU) */
+)
+{
+	UINT ix, iy, mx, my, rx, ry, bx, by, s, w, ow, sum, i, j;
+	BYTE *py, *op;
+	JRECT rect;
+
+
+	mx = jd->msx * 8; my = jd->msy * 8;					/* MCU size (pixel) */
+	rx = (x + mx <= jd->width) ? mx : jd->width - x;	/* Output rectangular size (it may be clipped at right/bottom end) */
+	ry = (y + my <= jd->height) ? my : jd->height - y;
+	s = JD_USE_SCALE ? jd->scale : 0;
+	rx >>= s; ry >>= s;
+	if (!rx || !ry) return JDR_OK;						/* Skip this MCU if all pixel is to be rounded off */
+	x >>= s; y >>= s;
+	rect.left = x; rect.right = x + rx - 1;				/* Rectangular area in the frame buffer */
+	rect.top = y; rect.bottom = y + ry - 1;
+
+	w = 1 << s;				/* Width of the square averaged into a pixel */
+	ow = mx >> s;			/* Width of the descaled MCU */
+	py = jd->mcubuf;
+	for (by = 0; by < jd->msy; by++) {
+		for (bx = 0; bx < jd->msx; bx++) {	/* Y blocks in raster order, the squares never cross one */
+			op = (BYTE*)jd->workbuf + (by * 8 >> s) * ow + (bx * 8 >> s);
+			if (s == 3) {					/* 1/8: only the DC value was kept */
+				*op = *py;
+			} else if (s == 0) {
+				for (iy = 0; iy < 8; iy++) {
+					for (ix = 0; ix < 8; ix++) op[iy * ow + ix] = py[iy * 8 + ix];
+				}
+			} else {
+				for (iy = 0; iy < 8; iy += w) {
+					for (ix = 0; ix < 8; ix += w) {
+						sum = 0;
+						for (i = 0; i < w; i++) {
+							for (j = 0; j < w; j++) sum += py[(iy + i) * 8 + ix + j];
+						}
+						op[(iy >> s) * ow + (ix >> s)] = (BYTE)(sum >> (s * 2));
+					}
+				}
+			}
+			py += 64;
+		}
+	}
+
+	/* Squeeze up pixel table if a part of MCU is to be truncated */
+	if (rx < ow) {
+		BYTE *src, *d;
+
+		src = d = (BYTE*)jd->workbuf;
+		for (iy = 0; iy < ry; iy++) {
+			for (ix = 0; ix < rx; ix++) *d++ = *src++;
+			src += ow - rx;
+		}
+	}
+
+	/* Output the luma rectangular */
+	return outfunc(jd, jd->workbuf, &rect) ? JDR_OK : JDR_INTR;
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Process restart interval                                              */
 /*-----------------------------------------------------------------------*/
@@ -929,10 +1004,12 @@ JRESULT jd_prepare (
 /* Start to decompress the JPEG picture                                  */
 /*-----------------------------------------------------------------------*/
 
-JRESULT jd_decomp (
+static
+JRESULT decomp (
 	JDEC* jd,								/* Initialized decompression object */
-	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* RGB output function */
-	BYTE scale								/* Output de-scaling factor (0 to 3) */
+	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* RGB or luma output function */
+	BYTE scale,								/* Output de-scaling factor (0 to 3) */
+	BYTE luma								/* Output the Y component only */
 )
 {
 	UINT x, y, mx, my;
@@ -942,6 +1019,7 @@ JRESULT jd_decomp (
 
 	if (scale > (JD_USE_SCALE ? 3 : 0)) return JDR_PAR;
 	jd->scale = scale;
+	jd->luma = luma;
 
 	mx = jd->msx * 8; my = jd->msy * 8;			/* Size of the MCU (pixel) */
 
@@ -958,13 +1036,34 @@ JRESULT jd_decomp (
 			}
 			rc = mcu_load(jd);					/* Load an MCU (decompress huffman coded stream and apply IDCT) */
 			if (rc != JDR_OK) return rc;
-			rc = mcu_output(jd, outfunc, x, y);	/* Output the MCU (color space conversion, scaling and output) */
+			if (luma)
+				rc = mcu_output_luma(jd, outfunc, x, y);	/* Output the MCU (scaling and output) */
+			else
+				rc = mcu_output(jd, outfunc, x, y);	/* Output the MCU (color space conversion, scaling and output) */
 			if (rc != JDR_OK) return rc;
 		}
 	}
 
 	return rc;
 }
+
+JRESULT jd_decomp (
+	JDEC* jd,								/* Initialized decompression object */
+	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* RGB output function */
+	BYTE scale								/* Output de-scaling factor (0 to 3) */
+)
+{
+	return decomp(jd, outfunc, scale, 0);
+}
+
+JRESULT jd_decomp_luma (
+	JDEC* jd,								/* Initialized decompression object */
+	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* Luma output function */
+	BYTE scale								/* Output de-scaling factor (0 to 3) */
+)
+{
+	return decomp(jd, outfunc, scale, 1);
+}
 #endif//SUPPORT_JPEG
 
 
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Packs raw frames into an image pack (see main/image_pack.h) for the
+# `images` partition or the host build.
+#
+#   image_pack.py -o pack.bin sample_images/
+#   image_pack.py -o pack.bin --labels labels.csv recorded/ extra/frame=2
+#
+# Inputs are files or directories of raw width x height x channels frames (a
+# file of several frames back to back gives that many, named file#N). A label,
+# the model category index, can follow a file as FILE=LABEL or come from a
+# CSV of `name,label` lines.
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+MAGIC = b'IPAK'
+VERSION = 1
+HEADER = struct.Struct('<4sHHIHHBBHIII')
+ENTRY = struct.Struct('<IIhH')
+FRAME_ALIGN = 16
+
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+
+def read_frames(path, frame_size):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if not data or len(data) % frame_size:
+        sys.exit('%s: %d bytes is not a multiple of a %d byte frame' % (path, len(data), frame_size))
+    count = len(data) // frame_size
+    base = os.path.basename(path)
+    for i in range(count):
+        name = base if count == 1 else '%s#%d' % (base, i)
+        yield name, data[i * frame_size:(i + 1) * frame_size]
+
+
+def collect(inputs, frame_size):
+    frames = []
+    for arg in inputs:
+        path, _, label = arg.partition('=')
+        if os.path.isdir(path):
+            if label:
+                sys.exit('%s: labels go on files, not directories' % arg)
+            # Dot files and the README next to the sample images are skipped.
+            for entry in sorted(os.listdir(path)):
+                file = os.path.join(path, entry)
+                if entry.startswith('.') or not os.path.isfile(file) or os.path.getsize(file) % frame_size:
+                    continue
+                frames += [(name, pixels, None) for name, pixels in read_frames(file, frame_size)]
+        else:
+            frames += [(name, pixels, int(label) if label else None)
+                       for name, pixels in read_frames(path, frame_size)]
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Packs raw frames into an image pack')
+    parser.add_argument('-o', '--output', required=True, help='pack to write')
+    parser.add_argument('--size', default='96x96', help='frame WIDTHxHEIGHT (default 96x96)')
+    parser.add_argument('--channels', type=int, default=1, help='bytes per pixel (default 1)')
+    parser.add_argument('--int8', action='store_true',
+                        help='store pixels as int8 (pixel - 128) for int8-input models')
+    parser.add_argument('--labels', help='CSV of name,label lines')
+    parser.add_argument('--max-size', type=lambda s: int(s, 0), default=0,
+                        help='fail if the pack is larger, e.g. the partition size')
+    parser.add_argument('inputs', nargs='+', help='frame files or directories, FILE=LABEL to label a file')
+    args = parser.parse_args()
+
+    width, height = (int(v) for v in args.size.lower().split('x'))
+    frame_size = width * height * args.channels
+    frames = collect(args.inputs, frame_size)
+
+    labels = {}
+    if args.labels:
+        with open(args.labels, newline='') as f:
+            labels = {row[0]: int(row[1]) for row in csv.reader(f) if len(row) >= 2 and not row[0].startswith('#')}
+
+    index_offset = align(HEADER.size, 4)
+    frames_offset = align(index_offset + ENTRY.size * len(frames), FRAME_ALIGN)
+    frame_stride = align(frame_size, FRAME_ALIGN)
+    names_offset = frames_offset + frame_stride * len(frames)
+
+    index = b''
+    body = b''
+    names = b''
+    labelled = 0
+    for i, (name, pixels, label) in enumerate(frames):
+        if label is None:
+            label = labels.get(name, -1)
+        labelled += label >= 0
+        if args.int8:
+            pixels = bytes(p ^ 0x80 for p in pixels)
+        index += ENTRY.pack(frames_offset + i * frame_stride, names_offset + len(names), label, 0)
+        body += pixels + bytes(frame_stride - frame_size)
+        names += name.encode() + b'\0'
+
+    total_size = names_offset + len(names)
+    header = HEADER.pack(MAGIC, VERSION, HEADER.size, len(frames), width, height, args.channels,
+                         1 if args.int8 else 0, 0, frame_size, index_offset, total_size)
+    pack = (header + bytes(index_offset - HEADER.size) + index +
+            bytes(frames_offset - index_offset - len(index)) + body + names)
+    assert len(pack) == total_size
+    if args.max_size and total_size > args.max_size:
+        sys.exit('%s: %d frames take %d bytes, more than %d' % (args.output, len(frames), total_size, args.max_size))
+    with open(args.output, 'wb') as f:
+        f.write(pack)
+    print('%s: %d frames, %d labelled, %d bytes' % (args.output, len(frames), labelled, total_size))
+
+
+if __name__ == '__main__':
+    main()